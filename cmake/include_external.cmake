@@ -2,7 +2,11 @@
 file(GLOB external_gd ${CMAKE_SOURCE_DIR}/external/gd/*.cpp)
 file(GLOB external_gd_core 
    ${CMAKE_SOURCE_DIR}/external/gd/gd_arguments.cpp
+   ${CMAKE_SOURCE_DIR}/external/gd/gd_csv.cpp
+   ${CMAKE_SOURCE_DIR}/external/gd/gd_expression_program.cpp
+   ${CMAKE_SOURCE_DIR}/external/gd/gd_expression_token.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_file.cpp
+   ${CMAKE_SOURCE_DIR}/external/gd/gd_parallel.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_parse.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_sql_value.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_table.cpp
@@ -11,6 +15,9 @@ file(GLOB external_gd_core
    ${CMAKE_SOURCE_DIR}/external/gd/gd_table_index.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_table_table.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_table_io.cpp
+   ${CMAKE_SOURCE_DIR}/external/gd/gd_table_io-json.cpp
+   ${CMAKE_SOURCE_DIR}/external/gd/gd_table_view.cpp
+   ${CMAKE_SOURCE_DIR}/external/gd/gd_table_writer.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_types.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_utf8.cpp
    ${CMAKE_SOURCE_DIR}/external/gd/gd_utf8_2.cpp
@@ -1,38 +1,604 @@
-#include <string>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <memory>
 
-#include "gd_utf8.hpp"
+#include "gd_parse.h"
+#include "gd_parallel.h"
 
 #include "gd_csv.h"
 
 _GD_CSV_BEGIN
 
-std::pair<gd::argument::arguments, std::vector<gd::variant>> read( const std::string_view& stringFileName, no_quote )
+/** ---------------------------------------------------------------------------
+ * @brief Find end for record that starts at `pbszBegin`
+ * Line end characters within quoted values are part of value. Quotes are counted
+ * between line end characters, record ends at first line end where number of
+ * quotes is even.
+ * @param pbszBegin start of record
+ * @param pbszEnd end of text
+ * @param options_ csv rules
+ * @return const char* position after line end, nullptr if there is no complete record in text
+*/
+const char* next_record_g( const char* pbszBegin, const char* pbszEnd, const options& options_ )
 {
-   //unsigned uColumnCount;
-   gd::argument::arguments argumentsStats;
-   std::vector< gd::variant > vectorValues;
+   bool bQuote = false;                                                        // true if position is within quoted value
+   const char* pbszPosition = pbszBegin;
+   while( pbszPosition < pbszEnd )
+   {
+      const char* pbszLineEnd = (const char*)memchr( pbszPosition, options_.m_chLineEnd, pbszEnd - pbszPosition );
+      if( pbszLineEnd == nullptr ) return nullptr;
+
+      if( ( std::count( pbszPosition, pbszLineEnd, options_.m_chQuote ) & 1 ) != 0 ) bQuote = !bQuote;
+      if( bQuote == false ) return pbszLineEnd + 1;
+      pbszPosition = pbszLineEnd + 1;
+   }
+   return nullptr;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Split record into values
+ * Quoted values are unquoted in place (two quotes are replaced with one), so
+ * text in record is modified and values point into record. Spaces before and
+ * after quoted values are skipped.
+ * @param pbszBegin start of record
+ * @param pbszEnd end of record, line end character is not part of record
+ * @param options_ csv rules
+ * @param vectorValue gets values in record, values are added to vector
+*/
+void split_record_g( char* pbszBegin, char* pbszEnd, const options& options_, std::vector<std::string_view>& vectorValue )
+{
+   if( pbszEnd > pbszBegin && pbszEnd[-1] == '\r' ) pbszEnd--;
+
+   char* pbszPosition = pbszBegin;
+   while( true )
+   {
+      char* pbszValue = pbszPosition;
+      while( pbszValue < pbszEnd && ( *pbszValue == ' ' || *pbszValue == '\t' ) ) pbszValue++;
+
+      if( pbszValue < pbszEnd && *pbszValue == options_.m_chQuote )
+      {
+         // ## quoted value, copy characters to remove quotes around value and double quotes in value
+         char* pbszRead = pbszValue + 1;
+         char* pbszWrite = pbszRead;
+         char* pbszStart = pbszRead;
+         while( pbszRead < pbszEnd )
+         {
+            if( *pbszRead == options_.m_chQuote )
+            {
+               if( pbszRead + 1 < pbszEnd && pbszRead[1] == options_.m_chQuote ) { *pbszWrite++ = options_.m_chQuote; pbszRead += 2; continue; }
+               pbszRead++;
+               break;
+            }
+            *pbszWrite++ = *pbszRead++;
+         }
+         vectorValue.emplace_back( pbszStart, pbszWrite - pbszStart );
+
+         pbszPosition = (char*)memchr( pbszRead, options_.m_chDelimiter, pbszEnd - pbszRead );
+      }
+      else
+      {
+         char* pbszStart = pbszPosition;
+         pbszPosition = (char*)memchr( pbszPosition, options_.m_chDelimiter, pbszEnd - pbszPosition );
+         vectorValue.emplace_back( pbszStart, ( pbszPosition != nullptr ? pbszPosition : pbszEnd ) - pbszStart );
+      }
+
+      if( pbszPosition == nullptr ) break;
+      pbszPosition++;                                                          // move past delimiter
+   }
+}
+
+namespace {
+   /** ------------------------------------------------------------------------
+    * @brief Convert text to value and set value in cell
+    * Whole text need to be converted, text is trimmed before.
+    * @param bDirect if true value is copied to cell, otherwise value is set with `cell_set`
+    * @return true if text was converted
+   */
+   template<typename TYPE>
+   bool decode_s( gd::table::dto::table& table, uint64_t uRow, unsigned uColumn, const char* pbszText, const char* pbszTextEnd, bool bDirect )
+   {
+      TYPE value_{};
+      if constexpr( std::is_same_v<TYPE, bool> == true )
+      {
+         std::string_view stringBool( pbszText, pbszTextEnd - pbszText );
+         if( stringBool == "1" || stringBool == "true" || stringBool == "TRUE" || stringBool == "True" ) value_ = true;
+         else if( stringBool == "0" || stringBool == "false" || stringBool == "FALSE" || stringBool == "False" ) value_ = false;
+         else return false;
+      }
+      else
+      {
+         if( *pbszText == '+' ) pbszText++;
+         auto result_ = std::from_chars( pbszText, pbszTextEnd, value_ );
+         if( result_.ec != std::errc() || result_.ptr != pbszTextEnd ) return false;
+      }
+
+      if( bDirect == true )
+      {
+         memcpy( table.cell_get( uRow, uColumn ), &value_, sizeof( TYPE ) );
+         if( table.is_null() == true ) table.cell_set_not_null( uRow, uColumn );
+      }
+      else
+      {
+         table.cell_set( uRow, uColumn, gd::variant_view( value_ ) );
+      }
+      return true;
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Select decode for each column in table
+ * @param table table that decoded rows are added to
+*/
+void decoder::compile( const gd::table::dto::table& table )
+{
+   m_vectorDecode.clear();
+   for( unsigned uColumn = 0, uMax = table.get_column_count(); uColumn < uMax; uColumn++ )
+   {
+      const auto& column_ = table.m_vectorColumn[uColumn];
+      enumDecode eDecode = eDecodeConvert;
+      if( column_.is_fixed() == true )
+      {
+         switch( column_.ctype_number() )
+         {
+         case gd::types::eTypeNumberInt8:    eDecode = eDecodeInt8; break;
+         case gd::types::eTypeNumberUInt8:   eDecode = eDecodeUInt8; break;
+         case gd::types::eTypeNumberInt16:   eDecode = eDecodeInt16; break;
+         case gd::types::eTypeNumberUInt16:  eDecode = eDecodeUInt16; break;
+         case gd::types::eTypeNumberInt32:   eDecode = eDecodeInt32; break;
+         case gd::types::eTypeNumberUInt32:  eDecode = eDecodeUInt32; break;
+         case gd::types::eTypeNumberInt64:   eDecode = eDecodeInt64; break;
+         case gd::types::eTypeNumberUInt64:  eDecode = eDecodeUInt64; break;
+         case gd::types::eTypeNumberFloat:   eDecode = eDecodeFloat; break;
+         case gd::types::eTypeNumberDouble:  eDecode = eDecodeDouble; break;
+         case gd::types::eTypeNumberBool:    eDecode = eDecodeBool; break;
+         }
+      }
+      else if( ( column_.type() & gd::types::eTypeGroupString ) != 0 ) eDecode = eDecodeText;
 
-   std::ifstream ifstreamCsv( stringFileName.data() );
-   if( ifstreamCsv.fail() == false ) { return std::pair<gd::argument::arguments, std::vector<gd::variant>>( { {"error", true}, {"information", "Failed to open file"}, {"file", stringFileName.data()}}, {}); }
+      m_vectorDecode.push_back( eDecode );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Decode text and set value in cell
+ * Values for columns that do not store text are trimmed and empty value is null.
+ * @param table table with cell, decoder need to be compiled for table
+ * @param uRow row index for cell
+ * @param uColumn column index for cell
+ * @param stringText text for value
+ * @return true if ok, false if text can't be converted to column type
+*/
+bool decoder::set( gd::table::dto::table& table, uint64_t uRow, unsigned uColumn, const std::string_view& stringText ) const
+{                                                                                                  assert( uColumn < m_vectorDecode.size() );
+   const enumDecode eDecode = m_vectorDecode[uColumn];
+   if( eDecode == eDecodeText ) { table.cell_set( uRow, uColumn, gd::variant_view( stringText ) ); return true; }
+
+   // ## trim value, empty value is null
+   const char* pbszText = stringText.data();
+   const char* pbszTextEnd = pbszText + stringText.length();
+   while( pbszText < pbszTextEnd && ( *pbszText == ' ' || *pbszText == '\t' ) ) pbszText++;
+   while( pbszTextEnd > pbszText && ( pbszTextEnd[-1] == ' ' || pbszTextEnd[-1] == '\t' ) ) pbszTextEnd--;
+   if( pbszText == pbszTextEnd ) return true;
+
+   const bool bDirect = table.is_notify() == false;                            // indexes are updated if value is set with cell_set
+   switch( eDecode )
+   {
+   case eDecodeInt8:    return decode_s<int8_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeUInt8:   return decode_s<uint8_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeInt16:   return decode_s<int16_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeUInt16:  return decode_s<uint16_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeInt32:   return decode_s<int32_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeUInt32:  return decode_s<uint32_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeInt64:   return decode_s<int64_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeUInt64:  return decode_s<uint64_t>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeFloat:   return decode_s<float>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeDouble:  return decode_s<double>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   case eDecodeBool:    return decode_s<bool>( table, uRow, uColumn, pbszText, pbszTextEnd, bDirect );
+   default:             table.cell_set( uRow, uColumn, gd::variant_view( std::string_view( pbszText, pbszTextEnd - pbszText ) ), gd::table::tag_convert{} ); break;
+   }
+   return true;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Decode record and add row to table
+ *
+ * Values are placed in columns in same order as they are in record, values
+ * after last column are skipped and columns without value are null. Empty
+ * values are null in columns that do not store text. If a value can't be
+ * converted the added row is removed.
+ *
+ * @param table table row is added to, columns need to match columns decoder is compiled for
+ * @param pbszBegin start of record
+ * @param pbszEnd end of record, line end is not part of record
+ * @param options_ csv rules
+ * @return int -1 if row was added, otherwise column index for value that can't be converted
+*/
+int decoder::add( gd::table::dto::table& table, char* pbszBegin, char* pbszEnd, const options& options_ )
+{                                                                                                  assert( m_vectorDecode.size() == table.get_column_count() );
+   m_vectorText.clear();
+   split_record_g( pbszBegin, pbszEnd, options_, m_vectorText );
 
-   std::string stringLine;
+   const uint64_t uRow = table.get_row_count();
+   if( table.is_null() == true ) table.row_add( gd::table::tag_null{} );
+   else                          table.row_add();
 
-   if( std::getline( ifstreamCsv, stringLine ) )
+   const unsigned uCount = (unsigned)std::min( m_vectorText.size(), m_vectorDecode.size() );
+   for( unsigned uColumn = 0; uColumn < uCount; uColumn++ )
    {
-      //gd::utf8::split( stringLine, ',', vectorValues );
-      //argumentsStats << { "column_count", (uint32_t)vectorValues.size() };
+      if( set( table, uRow, uColumn, m_vectorText[uColumn] ) == false ) { table.set_row_count( uRow ); return (int)uColumn; }
    }
 
-   while( std::getline( ifstreamCsv, stringLine ) )
+   return -1;
+}
+
+namespace {
+   /** ------------------------------------------------------------------------
+    * @brief Read file in chunks and call callback for each record
+    * Records that do not end in chunk are moved to start of buffer and next
+    * chunk is read after, buffer grows if one record is larger than chunk.
+    * @param stringFileName file to read
+    * @param options_ csv rules
+    * @param progress_ called after each chunk, return false to cancel
+    * @param callback_ called with start and end for record, return false and error text to stop
+    * @return true if ok, false and error information on error
+   */
+   template<typename FUNCTION>
+   std::pair<bool, std::string> read_record_s( const std::string_view& stringFileName, const options& options_, const progress& progress_, FUNCTION&& callback_ )
    {
-      //gd::utf8::split( stringLine, ',', vectorValues );
+      std::filesystem::path pathFile( stringFileName );
+      std::error_code errorcode;
+      uint64_t uFileSize = std::filesystem::file_size( pathFile, errorcode );
+      if( errorcode ) return { false, "Failed to open file: " + std::string( stringFileName ) };
+
+      std::ifstream ifstreamCsv( pathFile, std::ios::in | std::ios::binary );
+      if( ifstreamCsv.is_open() == false ) return { false, "Failed to open file: " + std::string( stringFileName ) };
+
+      std::vector<char> vectorBuffer( options_.m_uChunkSize != 0 ? options_.m_uChunkSize : (uint64_t)options::eSpaceChunkSize );
+      uint64_t uUsed = 0;           // bytes in buffer
+      uint64_t uByteRead = 0;       // bytes read from file
+
+      while( true )
+      {
+         ifstreamCsv.read( vectorBuffer.data() + uUsed, vectorBuffer.size() - uUsed );
+         uint64_t uRead = (uint64_t)ifstreamCsv.gcount();
+         uUsed += uRead;
+         uByteRead += uRead;
+         bool bEnd = uRead == 0;
+
+         // ## call callback for each complete record in buffer
+         char* pbszPosition = vectorBuffer.data();
+         char* pbszEnd = vectorBuffer.data() + uUsed;
+         while( pbszPosition < pbszEnd )
+         {
+            char* pbszNext = (char*)next_record_g( pbszPosition, pbszEnd, options_ );
+            if( pbszNext == nullptr )
+            {
+               if( bEnd == false ) break;
+               auto result_ = callback_( pbszPosition, pbszEnd );              // last record in file do not end with line end
+               if( result_.first == false ) return result_;
+               break;
+            }
+
+            auto result_ = callback_( pbszPosition, pbszNext - 1 );
+            if( result_.first == false ) return result_;
+            pbszPosition = pbszNext;
+         }
+
+         if( bEnd == true ) break;
+
+         // ## move part of record that isn't complete to start of buffer
+         uUsed = pbszEnd - pbszPosition;
+         if( uUsed > 0 ) memmove( vectorBuffer.data(), pbszPosition, uUsed );
+         if( uUsed == vectorBuffer.size() ) vectorBuffer.resize( vectorBuffer.size() * 2 );
+
+         if( progress_ && progress_( uByteRead, uFileSize, 0 ) == false ) return { false, "Canceled" };
+      }
+
+      return { true, "" };
+   }
+}
+
+namespace {
+   /// record without values, line end and '\r' are not part of values
+   inline bool is_empty_record_s( const char* pbszBegin, const char* pbszEnd ) { return pbszBegin == pbszEnd || ( pbszEnd - pbszBegin == 1 && *pbszBegin == '\r' ); }
+
+   /// error text for invalid value
+   std::string error_s( const gd::table::dto::table& table, uint64_t uRecord, int iColumn, const std::string_view& stringText ) {
+      return "Invalid value in record " + std::to_string( uRecord ) + ", column " + std::to_string( iColumn ) + " (" + std::string( table.column_get_name( iColumn ) ) + "): " + std::string( stringText );
    }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Read csv file into table
+ *
+ * File is read in chunks (`m_uChunkSize`) and rows are added to table as records
+ * are read so memory used for reading do not depend on file size. Values are
+ * decoded with `decoder`.
+ *
+ * @code
+gd::table::dto::table tableOrder( gd::table::dto::table::eTableFlagNull32, { { "int64", 0, "id" }, { "rstring", 0, "name" }, { "double", 0, "price" } }, gd::table::tag_prepare{} );
+auto result_ = gd::csv::read( tableOrder, "orders.csv", gd::csv::options( ',', true ), []( uint64_t uRead, uint64_t uSize, uint64_t ) {
+   std::cout << uRead * 100 / uSize << "%\n";
+   return true;
+} );
+ * @endcode
+ * @param table table rows are added to, table need to have columns
+ * @param stringFileName csv file
+ * @param options_ csv rules
+ * @param progress_ called after each chunk, return false to cancel
+ * @return true if ok, false and error information on error
+*/
+std::pair<bool, std::string> read( gd::table::dto::table& table, const std::string_view& stringFileName, const options& options_, const progress& progress_ )
+{                                                                                                  assert( table.get_column_count() > 0 );
+   decoder decoder_( table );
+   bool bHeader = options_.m_bHeader;
+   uint64_t uRecord = 0;                                                       // record index in file, used in error text
+
+   progress progressRow;
+   if( progress_ ) progressRow = [&progress_, &table]( uint64_t uByteRead, uint64_t uByteSize, uint64_t ) { return progress_( uByteRead, uByteSize, table.get_row_count() ); };
+
+   return read_record_s( stringFileName, options_, progressRow, [&]( char* pbszBegin, char* pbszEnd ) -> std::pair<bool, std::string> {
+      uRecord++;
+      if( is_empty_record_s( pbszBegin, pbszEnd ) == true ) return { true, "" };
+      if( bHeader == true ) { bHeader = false; return { true, "" }; }
+
+      int iColumn = decoder_.add( table, pbszBegin, pbszEnd, options_ );
+      if( iColumn != -1 ) return { false, error_s( table, uRecord, iColumn, decoder_.get_value( iColumn ) ) };
+      return { true, "" };
+   } );
+}
+
+namespace {
+   /// part of block in file that is parsed by one task
+   struct part
+   {
+      const char* m_pbszBegin = nullptr;  ///< first position in part
+      const char* m_pbszEnd = nullptr;    ///< position after part
+      uint64_t m_uQuote = 0;              ///< number of quotes in part
+      const char* m_pbszEven = nullptr;   ///< record start if part starts outside quoted value
+      const char* m_pbszOdd = nullptr;    ///< record start if part starts within quoted value
+      const char* m_pbszRecord = nullptr; ///< first record in part, null if no record starts in part
+      const char* m_pbszStop = nullptr;   ///< position where parse stopped
+      uint64_t m_uRecord = 0;             ///< number of records parsed
+      int m_iColumn = -1;                 ///< column with invalid value, -1 if ok
+      std::string m_stringValue;          ///< text for invalid value
+   };
+
+   /// count quotes in part and find first line end after even and odd number of quotes
+   void part_scan_s( part& part_, const options& options_ )
+   {
+      uint64_t uQuote = 0;
+      for( const char* pbszPosition = part_.m_pbszBegin; pbszPosition < part_.m_pbszEnd; )
+      {
+         const char* pbszLineEnd = (const char*)memchr( pbszPosition, options_.m_chLineEnd, part_.m_pbszEnd - pbszPosition );
+         const char* pbszTo = pbszLineEnd != nullptr ? pbszLineEnd : part_.m_pbszEnd;
+         uQuote += std::count( pbszPosition, pbszTo, options_.m_chQuote );
+         if( pbszLineEnd == nullptr ) break;
+
+         if( ( uQuote & 1 ) == 0 ) { if( part_.m_pbszEven == nullptr ) part_.m_pbszEven = pbszLineEnd + 1; }
+         else                      { if( part_.m_pbszOdd == nullptr ) part_.m_pbszOdd = pbszLineEnd + 1; }
+         pbszPosition = pbszLineEnd + 1;
+      }
+      part_.m_uQuote = uQuote;
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Read csv file into table, records are parsed in parallel
+ *
+ * File is read in blocks with one chunk (`m_uChunkSize`) for each part, parts
+ * in block are parsed by tasks in pool. Record boundaries are found in two
+ * passes. First pass counts quotes in each part and finds first line end after
+ * even and odd number of quotes, then quote counts for parts before decide if
+ * part starts within a quoted value and which line end that ends first record.
+ * Each task parses records in part into its own table. Rows for all parts are
+ * added to result table at once and each part table is copied in parallel to
+ * its rows with `plant`, so row order is the same as in file. References are
+ * merged in part order before rows are copied. Tables with indexes append each
+ * part table to get indexes updated.
+ *
+ * @param table table rows are added to, table need to have columns
+ * @param stringFileName csv file
+ * @param options_ csv rules
+ * @param progress_ called after each block, return false to cancel
+ * @param uThreadCount number of threads, 0 uses shared pool with one thread for each core
+ * @return true if ok, false and error information on error
+*/
+std::pair<bool, std::string> read( gd::table::dto::table& table, const std::string_view& stringFileName, const options& options_, const progress& progress_, unsigned uThreadCount )
+{                                                                                                  assert( table.get_column_count() > 0 );
+   if( uThreadCount == 1 ) return read( table, stringFileName, options_, progress_ );
+
+   std::unique_ptr<gd::parallel::task_pool> ppool;
+   if( uThreadCount != 0 ) ppool = std::make_unique<gd::parallel::task_pool>( uThreadCount );
+   gd::parallel::task_pool& pool_ = ppool != nullptr ? *ppool : gd::parallel::task_pool::get_default_s();
+
+   std::filesystem::path pathFile( stringFileName );
+   std::error_code errorcode;
+   uint64_t uFileSize = std::filesystem::file_size( pathFile, errorcode );
+   if( errorcode ) return { false, "Failed to open file: " + std::string( stringFileName ) };
+
+   std::ifstream ifstreamCsv( pathFile, std::ios::in | std::ios::binary );
+   if( ifstreamCsv.is_open() == false ) return { false, "Failed to open file: " + std::string( stringFileName ) };
+
+   const decoder decoder_( table );
+   const uint64_t uPartSize = options_.m_uChunkSize != 0 ? options_.m_uChunkSize : (uint64_t)options::eSpaceChunkSize;
+   const uint64_t uPartCount = (uint64_t)pool_.size() * 2;                    // more parts than threads to even out parts with different work
+
+   std::vector<char> vectorBuffer( uPartSize * uPartCount );
+   uint64_t uUsed = 0;              // bytes in buffer
+   uint64_t uByteRead = 0;          // bytes read from file
+   uint64_t uRecord = 0;            // records before block, used in error text
+   bool bHeader = options_.m_bHeader;
+
+   while( true )
+   {
+      ifstreamCsv.read( vectorBuffer.data() + uUsed, vectorBuffer.size() - uUsed );
+      uint64_t uRead = (uint64_t)ifstreamCsv.gcount();
+      uUsed += uRead;
+      uByteRead += uRead;
+      const bool bEnd = uRead == 0;
+      if( uUsed == 0 ) break;
+
+      char* pbszBegin = vectorBuffer.data();
+      char* pbszEnd = vectorBuffer.data() + uUsed;
+
+      // ## skip header, empty lines before header are skipped
+      while( bHeader == true && pbszBegin < pbszEnd )
+      {
+         char* pbszNext = (char*)next_record_g( pbszBegin, pbszEnd, options_ );
+         if( pbszNext == nullptr ) { pbszNext = bEnd == true ? pbszEnd : nullptr; if( pbszNext == nullptr ) break; }
+         uRecord++;
+         if( is_empty_record_s( pbszBegin, pbszNext[-1] == options_.m_chLineEnd ? pbszNext - 1 : pbszNext ) == false ) bHeader = false;
+         pbszBegin = pbszNext;
+      }
+
+      if( bHeader == true )                                                    // header do not end in block
+      {
+         if( bEnd == true ) break;
+         uUsed = pbszEnd - pbszBegin;
+         memmove( vectorBuffer.data(), pbszBegin, uUsed );
+         if( uUsed == vectorBuffer.size() ) vectorBuffer.resize( vectorBuffer.size() * 2 );
+         continue;
+      }
+
+      // ## split block into parts and find first record in each part
+      std::vector<part> vectorPart( uPartCount );
+      const uint64_t uSize = ( ( pbszEnd - pbszBegin ) + uPartCount - 1 ) / uPartCount;
+      for( uint64_t u = 0; u < uPartCount; u++ )
+      {
+         vectorPart[u].m_pbszBegin = std::min( pbszBegin + u * uSize, pbszEnd );
+         vectorPart[u].m_pbszEnd = std::min( pbszBegin + ( u + 1 ) * uSize, pbszEnd );
+      }
+
+      gd::parallel::parallel_for( pool_, 1, uPartCount, 1, [&]( uint64_t uFrom, uint64_t ) { part_scan_s( vectorPart[uFrom], options_ ); } );
+
+      vectorPart[0].m_pbszRecord = pbszBegin < pbszEnd ? pbszBegin : nullptr;
+      uint64_t uQuote = std::count( vectorPart[0].m_pbszBegin, vectorPart[0].m_pbszEnd, options_.m_chQuote );
+      for( uint64_t u = 1; u < uPartCount; u++ )
+      {
+         vectorPart[u].m_pbszRecord = ( uQuote & 1 ) == 0 ? vectorPart[u].m_pbszEven : vectorPart[u].m_pbszOdd;
+         if( vectorPart[u].m_pbszRecord == pbszEnd ) vectorPart[u].m_pbszRecord = nullptr;
+         uQuote += vectorPart[u].m_uQuote;
+      }
+
+      // ## parse records in parts, each part is parsed into its own table
+      std::vector<gd::table::dto::table> vectorTable( uPartCount );
+      gd::parallel::parallel_for( pool_, 0, uPartCount, 1, [&]( uint64_t uPart, uint64_t ) {
+         part& part_ = vectorPart[uPart];
+         if( part_.m_pbszRecord == nullptr ) return;
+
+         const char* pbszStop = nullptr;                                       // start for record in next part, null for last part with records
+         for( uint64_t u = uPart + 1; u < uPartCount && pbszStop == nullptr; u++ ) pbszStop = vectorPart[u].m_pbszRecord;
+
+         gd::table::dto::table& tablePart = vectorTable[uPart];
+         tablePart = gd::table::dto::table( table, gd::table::tag_columns{} );
+         tablePart.prepare();
+
+         decoder decoderPart( decoder_ );
+         char* pbszPosition = (char*)part_.m_pbszRecord;
+         while( pbszPosition < pbszEnd && ( pbszStop == nullptr || pbszPosition < pbszStop ) )
+         {
+            char* pbszNext = (char*)next_record_g( pbszPosition, pbszEnd, options_ );
+            char* pbszRecordEnd = pbszNext != nullptr ? pbszNext - 1 : pbszEnd;
+            if( pbszNext == nullptr )
+            {
+               if( bEnd == false ) break;                                      // record continues in next block
+               pbszNext = pbszEnd;
+            }
+
+            part_.m_uRecord++;
+            if( is_empty_record_s( pbszPosition, pbszRecordEnd ) == false )
+            {
+               int iColumn = decoderPart.add( tablePart, pbszPosition, pbszRecordEnd, options_ );
+               if( iColumn != -1 ) { part_.m_iColumn = iColumn; part_.m_stringValue = std::string( decoderPart.get_value( iColumn ) ); break; }
+            }
+            pbszPosition = pbszNext;
+         }
+         part_.m_pbszStop = pbszPosition;
+      } );
+
+      // ## add rows for parts in order, parts after part with error are skipped
+      const char* pbszRest = pbszBegin;                                        // first position that isn't parsed
+      std::vector<uint64_t> vectorOffset( uPartCount, 0 );                     // first row in result table for each part
+      uint64_t uPartEnd = 0;                                                   // parts that are added
+      uint64_t uRowCount = table.get_row_count();
+      for( ; uPartEnd < uPartCount; uPartEnd++ )
+      {
+         const part& part_ = vectorPart[uPartEnd];
+         if( part_.m_pbszRecord == nullptr ) continue;
+         if( part_.m_iColumn != -1 ) break;
+         vectorOffset[uPartEnd] = uRowCount;
+         uRowCount += vectorTable[uPartEnd].get_row_count();
+         uRecord += part_.m_uRecord;
+         pbszRest = part_.m_pbszStop;
+      }
+
+      if( table.is_notify() == true )                                          // indexes are updated for each added row
+      {
+         for( uint64_t u = 0; u < uPartEnd; u++ ) { if( vectorPart[u].m_pbszRecord != nullptr ) table.append( vectorTable[u] ); }
+      }
+      else if( uRowCount > table.get_row_count() )
+      {
+         // ## rows are reserved once, references are merged in part order and part tables are copied in parallel
+         std::vector< std::vector<int64_t> > vectorCode( uPartEnd );
+         for( uint64_t u = 0; u < uPartEnd; u++ ) { if( vectorPart[u].m_pbszRecord != nullptr ) table.get_references().merge( vectorTable[u].get_references(), vectorCode[u] ); }
+
+         table.row_add( uRowCount - table.get_row_count() );                    // all values in added rows are written by plant
+         gd::parallel::parallel_for( pool_, 0, uPartEnd, 1, [&]( uint64_t uPart, uint64_t ) {
+            if( vectorPart[uPart].m_pbszRecord == nullptr ) return;
+            table.plant( vectorTable[uPart], vectorOffset[uPart], vectorCode[uPart], gd::table::tag_raw{} );
+         } );
+      }
+
+      if( uPartEnd < uPartCount )
+      {
+         const part& part_ = vectorPart[uPartEnd];
+         return { false, error_s( table, uRecord + part_.m_uRecord, part_.m_iColumn, part_.m_stringValue ) };
+      }
+
+      if( bEnd == true ) break;
+
+      // ## move part of record that isn't complete to start of buffer
+      uUsed = pbszEnd - pbszRest;
+      if( uUsed > 0 ) memmove( vectorBuffer.data(), pbszRest, uUsed );
+      if( uUsed == vectorBuffer.size() ) vectorBuffer.resize( vectorBuffer.size() * 2 );
+
+      if( progress_ && progress_( uByteRead, uFileSize, table.get_row_count() ) == false ) return { false, "Canceled" };
+   }
+
+   return { true, "" };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Read all values in csv file without quote rules
+ * Number of values in first record is returned as "column_count" in arguments.
+ * @param stringFileName csv file
+ * @return arguments with "column_count" and values for all records, on error arguments has "error" and "information"
+*/
+std::pair<gd::argument::arguments, std::vector<gd::variant>> read( const std::string_view& stringFileName, no_quote )
+{
+   gd::argument::arguments argumentsStats;
+   std::vector< gd::variant > vectorValues;
 
+   options options_;
+   options_.m_chQuote = '\0';
+   std::vector<std::string_view> vectorText;
+   auto result_ = read_record_s( stringFileName, options_, nullptr, [&]( char* pbszBegin, char* pbszEnd ) -> std::pair<bool, std::string> {
+      if( pbszBegin == pbszEnd ) return { true, "" };
+      vectorText.clear();
+      split_record_g( pbszBegin, pbszEnd, options_, vectorText );
+      if( argumentsStats.empty() == true ) argumentsStats.append( "column_count", (uint32_t)vectorText.size() );
+      for( const auto& it : vectorText ) vectorValues.emplace_back( gd::variant( std::string( it ) ) );
+      return { true, "" };
+   } );
 
+   if( result_.first == false ) return { { { "error", true }, { "information", result_.second.c_str() }, { "file", std::string( stringFileName ).c_str() } }, {} };
 
-   return std::pair<gd::argument::arguments, std::vector<gd::variant>>();
+   return { std::move( argumentsStats ), std::move( vectorValues ) };
 }
 
 
-_GD_CSV_END
\ No newline at end of file
+_GD_CSV_END
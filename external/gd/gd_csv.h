@@ -1,11 +1,31 @@
+/**
+ * \file gd_csv.h
+ *
+ * \brief Read csv formated files, file is read in chunks and rows are added to table
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 #include <type_traits>
 
+#include "gd_types.h"
 #include "gd_variant.h"
+#include "gd_variant_view.h"
 #include "gd_arguments.h"
+#include "gd_table.h"
+#include "gd_table_column-buffer.h"
 
 #ifndef _GD_CSV_BEGIN
 #  define _GD_CSV_BEGIN namespace gd { namespace csv {
@@ -16,6 +36,104 @@ _GD_CSV_BEGIN
 
 struct no_quote {};
 
+/** ---------------------------------------------------------------------------
+ * @brief Rules and settings for reading csv
+ */
+struct options
+{
+   enum { eSpaceChunkSize = 0x40'0000 };                 // 4 MB
+
+   options() {}
+   options( char chDelimiter ): m_chDelimiter( chDelimiter ) {}
+   options( char chDelimiter, bool bHeader ): m_chDelimiter( chDelimiter ), m_bHeader( bHeader ) {}
+
+   char m_chDelimiter = ',';                             ///< character between values
+   char m_chQuote = '\"';                                ///< quote character, two quotes in quoted value is one quote
+   char m_chLineEnd = '\n';                              ///< character that ends record, '\r' before line end is removed
+   bool m_bHeader = false;                               ///< first record is header and is skipped
+   uint64_t m_uChunkSize = eSpaceChunkSize;              ///< number of bytes read from file each time
+};
+
+/// called after each chunk with bytes read, file size and rows added. return false to cancel read
+using progress = std::function<bool( uint64_t uByteRead, uint64_t uByteSize, uint64_t uRowCount )>;
+
+/** ===========================================================================
+ * \brief Decode csv records into rows in table, decoder is compiled once from table columns
+ *
+ * Each value is converted from text and written to cell in added row. Integer
+ * and decimal values are converted with `std::from_chars` directly to column
+ * type and text values are placed in reference or text columns. Buffer for
+ * values in record is kept in decoder so rows are decoded without allocating
+ * memory, use one decoder for each thread.
+ *
+ \code
+gd::csv::decoder decoder_( tableOrder );
+int iColumn = decoder_.add( tableOrder, pbszRecord, pbszRecordEnd, gd::csv::options() );
+if( iColumn != -1 ) std::cout << "invalid value: " << decoder_.get_value( iColumn );
+ \endcode
+ */
+class decoder
+{
+public:
+   /// how value for column is decoded
+   enum enumDecode : uint8_t
+   {
+      eDecodeInt8,
+      eDecodeUInt8,
+      eDecodeInt16,
+      eDecodeUInt16,
+      eDecodeInt32,
+      eDecodeUInt32,
+      eDecodeInt64,
+      eDecodeUInt64,
+      eDecodeFloat,
+      eDecodeDouble,
+      eDecodeBool,
+      eDecodeText,         ///< text stored in reference or text column
+      eDecodeConvert,      ///< other types, text is converted by table
+   };
+
+// ## construction ------------------------------------------------------------
+public:
+   decoder() {}
+   explicit decoder( const gd::table::dto::table& table ) { compile( table ); }
+
+// ## methods -----------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   /// text for value in last decoded record
+   std::string_view get_value( unsigned uIndex ) const { assert( uIndex < m_vectorText.size() ); return m_vectorText[uIndex]; }
+   /// number of values in last decoded record
+   std::size_t size() const noexcept { return m_vectorText.size(); }
+//@}
+
+/** \name OPERATION
+*///@{
+   /// select decode for each column in table
+   void compile( const gd::table::dto::table& table );
+   /// decode record and add row to table, returns -1 if ok or column index for value that can't be converted
+   int add( gd::table::dto::table& table, char* pbszBegin, char* pbszEnd, const options& options_ );
+   /// decode text and set value in cell, returns false if text can't be converted
+   bool set( gd::table::dto::table& table, uint64_t uRow, unsigned uColumn, const std::string_view& stringText ) const;
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   std::vector<enumDecode> m_vectorDecode;         ///< decode for each column
+   std::vector<std::string_view> m_vectorText;     ///< values in last decoded record
+};
+
+/// find end for record, returns position after line end or nullptr if record do not end before `pbszEnd`
+const char* next_record_g( const char* pbszBegin, const char* pbszEnd, const options& options_ );
+/// split record into values, quoted values are unquoted in buffer
+void split_record_g( char* pbszBegin, char* pbszEnd, const options& options_, std::vector<std::string_view>& vectorValue );
+
+/// read csv file into table, values are placed in columns in same order as in file
+std::pair<bool, std::string> read( gd::table::dto::table& table, const std::string_view& stringFileName, const options& options_, const progress& progress_ = nullptr );
+/// read csv file into table, blocks in file are split into parts that are parsed in parallel. `uThreadCount` 0 = one thread for each core
+std::pair<bool, std::string> read( gd::table::dto::table& table, const std::string_view& stringFileName, const options& options_, const progress& progress_, unsigned uThreadCount );
+
 std::pair<gd::argument::arguments, std::vector<gd::variant>> read( const std::string_view& stringFileName, no_quote );
 
-_GD_CSV_END
\ No newline at end of file
+_GD_CSV_END
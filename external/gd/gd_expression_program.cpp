@@ -0,0 +1,920 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#include "gd_expression_program.h"
+
+_GD_EXPRESSION_BEGIN
+
+namespace {
+   using enumOperator = program::enumOperator;
+   using enumValue = program::enumValue;
+
+   /// compare token with operator text
+   inline bool is_operator_s( const token& token_, const std::string_view& stringOperator ) {
+      return token_.type_number() == token::eTokenTypeOperator && token_.as_string_view() == stringOperator;
+   }
+
+   /// compare label token with keyword, case is ignored
+   inline bool is_keyword_s( const token& token_, const std::string_view& stringKeyword ) {
+      if( token_.type_number() != token::eTokenTypeLabel || token_.length() != stringKeyword.length() ) return false;
+      for( unsigned u = 0; u < token_.length(); u++ ) { if( ( token_.m_pbszData[u] | 0x20 ) != stringKeyword[u] ) return false; }
+      return true;
+   }
+
+   inline bool is_number_s( enumValue eValue ) { return eValue == program::eValueBool || eValue == program::eValueInt64 || eValue == program::eValueDouble; }
+
+   /// make sure vector can hold values for batch and return pointer to data
+   template< typename TYPE >
+   inline TYPE* prepare_s( std::vector<TYPE>& vectorValue, uint64_t uCount ) {
+      if( vectorValue.size() < uCount ) vectorValue.resize( std::max<uint64_t>( uCount, program::eSpaceBatchRows ) );
+      return vectorValue.data();
+   }
+
+   inline bool is_null_s( const program::batch& batch_, uint64_t uIndex ) { return batch_.m_bNull == true && ( ( batch_.m_vectorNull[uIndex >> 6] >> ( uIndex & 63 ) ) & 1 ) != 0; }
+
+   /// copy null bits from batch to batch
+   inline void null_copy_s( const program::batch& batchFrom, program::batch& batchTo, uint64_t uCount ) {
+      batchTo.m_bNull = batchFrom.m_bNull;
+      if( batchFrom.m_bNull == true ) { std::memcpy( prepare_s( batchTo.m_vectorNull, ( uCount + 63 ) >> 6 ), batchFrom.m_vectorNull.data(), ( ( uCount + 63 ) >> 6 ) * sizeof( uint64_t ) ); }
+   }
+
+   /// set boolean values for null values to false, booleans are never null
+   inline void null_clear_s( const program::batch& batch_, uint8_t* pbResult, uint64_t uCount ) {
+      if( batch_.m_bNull == false ) return;
+      for( uint64_t u = 0; u < uCount; u++ ) { if( is_null_s( batch_, u ) == true ) pbResult[u] = 0; }
+   }
+
+   /// read values in column for rows, rows are stepped with stride within contiguous runs
+   template< typename TYPE, typename RESULT >
+   void load_s( const gd::table::dto::table* ptable, unsigned uColumn, uint64_t uFrom, uint64_t uCount, RESULT* pResult ) {
+      unsigned uStride = ptable->cell_get_stride( uColumn );
+      for( uint64_t uIndex = 0; uIndex < uCount; )
+      {
+         uint64_t uEnd = std::min( uCount, uIndex + ptable->row_get_contiguous( uFrom + uIndex ) );
+         const uint8_t* puValue = ptable->cell_get( uFrom + uIndex, uColumn );
+         for( ; uIndex < uEnd; uIndex++, puValue += uStride )
+         {
+            TYPE value_;
+            std::memcpy( &value_, puValue, sizeof( TYPE ) );
+            pResult[uIndex] = (RESULT)value_;
+         }
+      }
+   }
+
+   /// compare reference codes in column with code
+   template< typename CODE >
+   void load_code_s( const gd::table::dto::table* ptable, unsigned uColumn, uint64_t uFrom, uint64_t uCount, uint64_t uCode, bool bEqual, uint8_t* pbResult ) {
+      unsigned uStride = ptable->cell_get_stride( uColumn );
+      for( uint64_t uIndex = 0; uIndex < uCount; )
+      {
+         uint64_t uEnd = std::min( uCount, uIndex + ptable->row_get_contiguous( uFrom + uIndex ) );
+         const uint8_t* puValue = ptable->cell_get( uFrom + uIndex, uColumn );
+         for( ; uIndex < uEnd; uIndex++, puValue += uStride )
+         {
+            CODE code_;
+            std::memcpy( &code_, puValue, sizeof( CODE ) );
+            pbResult[uIndex] = (uint8_t)( ( (uint64_t)code_ == uCode ) == bEqual );
+         }
+      }
+   }
+
+   template< typename TYPE, typename RESULT, typename OPERATION >
+   inline void apply_s( const TYPE* pLeft, const TYPE* pRight, RESULT* pResult, uint64_t uCount, OPERATION operation_ ) {
+      for( uint64_t u = 0; u < uCount; u++ ) pResult[u] = (RESULT)operation_( pLeft[u], pRight[u] );
+   }
+
+   template< typename TYPE >
+   void compare_s( enumOperator eOperator, const TYPE* pLeft, const TYPE* pRight, uint8_t* pbResult, uint64_t uCount ) {
+      switch( eOperator )
+      {
+      case program::eOperatorEqual:        apply_s( pLeft, pRight, pbResult, uCount, std::equal_to<>{} ); break;
+      case program::eOperatorNotEqual:     apply_s( pLeft, pRight, pbResult, uCount, std::not_equal_to<>{} ); break;
+      case program::eOperatorLess:         apply_s( pLeft, pRight, pbResult, uCount, std::less<>{} ); break;
+      case program::eOperatorLessEqual:    apply_s( pLeft, pRight, pbResult, uCount, std::less_equal<>{} ); break;
+      case program::eOperatorGreater:      apply_s( pLeft, pRight, pbResult, uCount, std::greater<>{} ); break;
+      case program::eOperatorGreaterEqual: apply_s( pLeft, pRight, pbResult, uCount, std::greater_equal<>{} ); break;
+      default:                                                                                     assert( false );
+      }
+   }
+
+   /// sort rows on key values, null values are placed first for ascending order
+   template< typename TYPE >
+   void sort_s( const std::vector<TYPE>& vectorKey, const std::vector<uint8_t>& vectorNull, bool bAscending, std::vector<uint64_t>& vectorRow ) {
+      std::stable_sort( vectorRow.begin(), vectorRow.end(), [&]( uint64_t uLeft, uint64_t uRight ) {
+         if( vectorNull[uLeft] != vectorNull[uRight] ) return ( vectorNull[uLeft] > vectorNull[uRight] ) == bAscending;
+         if( vectorNull[uLeft] != 0 ) return false;
+         return bAscending == true ? vectorKey[uLeft] < vectorKey[uRight] : vectorKey[uRight] < vectorKey[uLeft];
+      } );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Compile expression to nodes that can be evaluated for rows in table
+ *
+ * Column names are resolved to column indexes in table, program has to be
+ * compiled again if columns in table are changed.
+ * @code
+gd::expression::program program_;
+auto result_ = program_.compile( "amount * 1.25 >= 100 or name = 'unknown'", &table );
+ * @endcode
+ * @param stringExpression expression to compile
+ * @param ptable table with columns used in expression
+ * @return std::pair<bool, std::string> true if ok, false and error information if not
+*/
+std::pair<bool, std::string> program::compile( const std::string_view& stringExpression, const gd::table::dto::table* ptable )
+{                                                                                                  assert( ptable != nullptr );
+   clear();
+   m_ptable = ptable;
+
+   // ## read tokens in expression
+   std::vector<token> vectorToken;
+   const char* pbszPosition = stringExpression.data();
+   const char* pbszEnd = stringExpression.data() + stringExpression.length();
+   while( pbszPosition != nullptr )
+   {
+      token token_;
+      pbszPosition = token::next_s( pbszPosition, pbszEnd, &token_ );
+      if( token_.type() == 0 && token_.m_pbszData != nullptr )
+      {
+         clear();
+         return { false, "invalid text at position " + std::to_string( token_.m_pbszData - stringExpression.data() ) + " in expression: " + std::string( stringExpression ) };
+      }
+      if( pbszPosition != nullptr ) vectorToken.push_back( token_ );
+   }
+
+   if( vectorToken.empty() == true ) { clear(); return { false, "empty expression" }; }
+
+   // ## parse tokens into nodes
+   std::string stringError;
+   std::size_t uPosition = 0;
+   int iRoot = parse_or( vectorToken, uPosition, stringError );
+   if( iRoot != -1 && uPosition < vectorToken.size() ) { stringError = "unexpected '" + std::string( vectorToken[uPosition].as_string_view() ) + "' in expression"; iRoot = -1; }
+   if( iRoot == -1 ) { clear(); return { false, stringError }; }
+
+   m_iRoot = iRoot;
+   m_vectorBatch.assign( m_vectorNode.size(), batch() );
+   return { true, "" };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Evaluate expression for rows in table
+ * @param uFrom first row
+ * @param uCount number of rows, max `eSpaceBatchRows`
+ * @return const batch& values for rows, read vector for expression type
+*/
+const program::batch& program::evaluate( uint64_t uFrom, uint64_t uCount ) const
+{                                                                                                  assert( m_iRoot != -1 ); assert( uCount <= eSpaceBatchRows ); assert( uFrom + uCount <= m_ptable->get_row_count() );
+   resolve();
+   evaluate( m_iRoot, uFrom, uCount );
+   return m_vectorBatch[m_iRoot];
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Mark rows in selection where expression is true
+ * @code
+gd::table::selection selectionMatch;
+program_.filter( selectionMatch );
+table.filter( "region", gd::table::eFilterEqual, { "north" }, selectionRegion );
+selectionMatch &= selectionRegion;
+ * @endcode
+ * @param uFrom first row to test
+ * @param uCount number of rows to test
+ * @param selectionMatch selection that is reset to table row count and gets rows where expression is true
+*/
+void program::filter( uint64_t uFrom, uint64_t uCount, gd::table::selection& selectionMatch ) const
+{                                                                                                  assert( is_predicate() == true ); assert( uFrom + uCount <= m_ptable->get_row_count() );
+   selectionMatch.reset( m_ptable->get_row_count() );
+   uint64_t* puBit = selectionMatch.data();
+   resolve();
+
+   for( uint64_t uRow = uFrom, uEnd = uFrom + uCount; uRow < uEnd; uRow += eSpaceBatchRows )
+   {
+      uint64_t uBatch = std::min<uint64_t>( eSpaceBatchRows, uEnd - uRow );
+      evaluate( m_iRoot, uRow, uBatch );
+      const uint8_t* pbResult = m_vectorBatch[m_iRoot].m_vectorBool.data();
+
+      if( ( uRow & 63 ) == 0 )                                                 // pack 64 results into each word
+      {
+         for( uint64_t u = 0; u < uBatch; u += 64 )
+         {
+            uint64_t uWord = 0;
+            for( uint64_t uBit = 0, uMax = std::min<uint64_t>( 64, uBatch - u ); uBit < uMax; uBit++ ) uWord |= (uint64_t)pbResult[u + uBit] << uBit;
+            puBit[( uRow + u ) >> 6] |= uWord;
+         }
+      }
+      else
+      {
+         for( uint64_t u = 0; u < uBatch; u++ ) { if( pbResult[u] != 0 ) selectionMatch.set( uRow + u ); }
+      }
+   }
+}
+
+/// rows where expression is true
+std::vector<uint64_t> program::filter( gd::table::tag_row ) const
+{
+   gd::table::selection selectionMatch;
+   filter( selectionMatch );
+   return selectionMatch.to_rows();
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Set expression result in column for each row, works as computed column
+ *
+ * Values are converted if column type differs from expression type, boolean
+ * results are set as 0 or 1. Column in target table should not be used in
+ * expression if target table is the table program reads from.
+ * @code
+table.column_add( "double", 0, "total" );
+...
+program_.compile( "price * qty", &table );
+program_.plant( table, table.column_get_index( "total" ) );
+ * @endcode
+ * @param tableTarget table that gets values, needs at least as many rows as table program reads from
+ * @param uColumn column in target table
+ * @return std::pair<bool, std::string> true if ok, false and error information if not
+*/
+std::pair<bool, std::string> program::plant( gd::table::dto::table& tableTarget, unsigned uColumn ) const
+{                                                                                                  assert( uColumn < tableTarget.get_column_count() );
+   if( m_iRoot == -1 ) return { false, "no compiled expression" };
+   uint64_t uRowCount = m_ptable->get_row_count();
+   if( tableTarget.get_row_count() < uRowCount ) return { false, "target table has " + std::to_string( tableTarget.get_row_count() ) + " rows, needs " + std::to_string( uRowCount ) };
+
+   resolve();
+   enumValue eValue = get_type();
+   for( uint64_t uRow = 0; uRow < uRowCount; uRow += eSpaceBatchRows )
+   {
+      uint64_t uBatch = std::min<uint64_t>( eSpaceBatchRows, uRowCount - uRow );
+      evaluate( m_iRoot, uRow, uBatch );
+      const batch& batch_ = m_vectorBatch[m_iRoot];
+      const uint64_t* puNull = batch_.m_bNull == true ? batch_.m_vectorNull.data() : nullptr;
+      switch( eValue )
+      {
+      case eValueBool:   tableTarget.plant( uColumn, std::span<const uint8_t>( batch_.m_vectorBool.data(), uBatch ), uRow ); break;
+      case eValueInt64:  tableTarget.plant( uColumn, std::span<const int64_t>( batch_.m_vectorInt64.data(), uBatch ), uRow, puNull ); break;
+      case eValueDouble: tableTarget.plant( uColumn, std::span<const double>( batch_.m_vectorDouble.data(), uBatch ), uRow, puNull ); break;
+      case eValueString: tableTarget.plant( uColumn, std::span<const std::string_view>( batch_.m_vectorString.data(), uBatch ), uRow, puNull ); break;
+      default:                                                                                     assert( false );
+      }
+   }
+
+   return { true, "" };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Sort rows on expression result, expression works as sort key
+ *
+ * Expression is calculated once for all rows in table and rows are sorted
+ * with stable sort. Null values are placed first in ascending order.
+ * @code
+std::vector<uint64_t> vectorRow;
+program_.compile( "price * qty", &table );
+program_.sort( vectorRow, false );                                            // rows with highest total first
+ * @endcode
+ * @param vectorRow rows to sort, if empty all rows in table are added and sorted
+ * @param bAscending sort order
+*/
+void program::sort( std::vector<uint64_t>& vectorRow, bool bAscending ) const
+{                                                                                                  assert( m_iRoot != -1 );
+   uint64_t uRowCount = m_ptable->get_row_count();
+   if( vectorRow.empty() == true )
+   {
+      vectorRow.resize( uRowCount );
+      for( uint64_t uRow = 0; uRow < uRowCount; uRow++ ) vectorRow[uRow] = uRow;
+   }
+
+   resolve();
+   enumValue eValue = get_type();
+   std::vector<uint8_t> vectorNull( uRowCount, 0 );
+   std::vector<int64_t> vectorInt64;
+   std::vector<double> vectorDouble;
+   std::vector<std::string_view> vectorString;
+   if( eValue == eValueBool || eValue == eValueInt64 ) vectorInt64.resize( uRowCount );
+   else if( eValue == eValueDouble ) vectorDouble.resize( uRowCount );
+   else vectorString.resize( uRowCount );
+
+   for( uint64_t uRow = 0; uRow < uRowCount; uRow += eSpaceBatchRows )
+   {
+      uint64_t uBatch = std::min<uint64_t>( eSpaceBatchRows, uRowCount - uRow );
+      evaluate( m_iRoot, uRow, uBatch );
+      const batch& batch_ = m_vectorBatch[m_iRoot];
+      switch( eValue )
+      {
+      case eValueBool:   for( uint64_t u = 0; u < uBatch; u++ ) vectorInt64[uRow + u] = batch_.m_vectorBool[u]; break;
+      case eValueInt64:  std::copy_n( batch_.m_vectorInt64.data(), uBatch, vectorInt64.data() + uRow ); break;
+      case eValueDouble: std::copy_n( batch_.m_vectorDouble.data(), uBatch, vectorDouble.data() + uRow ); break;
+      default:           std::copy_n( batch_.m_vectorString.data(), uBatch, vectorString.data() + uRow ); break;
+      }
+      for( uint64_t u = 0; batch_.m_bNull == true && u < uBatch; u++ ) vectorNull[uRow + u] = (uint8_t)is_null_s( batch_, u );
+   }
+
+   if( vectorInt64.empty() == false ) sort_s( vectorInt64, vectorNull, bAscending, vectorRow );
+   else if( vectorDouble.empty() == false ) sort_s( vectorDouble, vectorNull, bAscending, vectorRow );
+   else sort_s( vectorString, vectorNull, bAscending, vectorRow );
+}
+
+// ## parse ---------------------------------------------------------------------
+
+/// `or` and `||`, lowest precedence
+int program::parse_or( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   int iLeft = parse_and( vectorToken, uPosition, stringError );
+   while( iLeft != -1 && uPosition < vectorToken.size() && ( is_keyword_s( vectorToken[uPosition], "or" ) == true || is_operator_s( vectorToken[uPosition], "||" ) == true ) )
+   {
+      uPosition++;
+      int iRight = parse_and( vectorToken, uPosition, stringError );
+      if( iRight == -1 ) return -1;
+      iLeft = add_binary( eOperatorOr, iLeft, iRight, stringError );
+   }
+   return iLeft;
+}
+
+/// `and` and `&&`
+int program::parse_and( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   int iLeft = parse_not( vectorToken, uPosition, stringError );
+   while( iLeft != -1 && uPosition < vectorToken.size() && ( is_keyword_s( vectorToken[uPosition], "and" ) == true || is_operator_s( vectorToken[uPosition], "&&" ) == true ) )
+   {
+      uPosition++;
+      int iRight = parse_not( vectorToken, uPosition, stringError );
+      if( iRight == -1 ) return -1;
+      iLeft = add_binary( eOperatorAnd, iLeft, iRight, stringError );
+   }
+   return iLeft;
+}
+
+/// `not` and `!`
+int program::parse_not( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   if( uPosition < vectorToken.size() && ( is_keyword_s( vectorToken[uPosition], "not" ) == true || is_operator_s( vectorToken[uPosition], "!" ) == true ) )
+   {
+      uPosition++;
+      int iNode = parse_not( vectorToken, uPosition, stringError );
+      if( iNode == -1 ) return -1;
+      return add_unary( eOperatorNot, iNode, stringError );
+   }
+   return parse_compare( vectorToken, uPosition, stringError );
+}
+
+/// compare operators, only one compare without parentheses
+int program::parse_compare( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   int iLeft = parse_add( vectorToken, uPosition, stringError );
+   if( iLeft == -1 || uPosition >= vectorToken.size() || vectorToken[uPosition].type_number() != token::eTokenTypeOperator ) return iLeft;
+
+   std::string_view stringOperator = vectorToken[uPosition].as_string_view();
+   enumOperator eOperator = eOperatorNone;
+   if( stringOperator == "=" || stringOperator == "==" ) eOperator = eOperatorEqual;
+   else if( stringOperator == "!=" || stringOperator == "<>" ) eOperator = eOperatorNotEqual;
+   else if( stringOperator == "<" ) eOperator = eOperatorLess;
+   else if( stringOperator == "<=" ) eOperator = eOperatorLessEqual;
+   else if( stringOperator == ">" ) eOperator = eOperatorGreater;
+   else if( stringOperator == ">=" ) eOperator = eOperatorGreaterEqual;
+   else return iLeft;
+
+   uPosition++;
+   int iRight = parse_add( vectorToken, uPosition, stringError );
+   if( iRight == -1 ) return -1;
+   return add_binary( eOperator, iLeft, iRight, stringError );
+}
+
+/// `+` and `-`
+int program::parse_add( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   int iLeft = parse_multiply( vectorToken, uPosition, stringError );
+   while( iLeft != -1 && uPosition < vectorToken.size() )
+   {
+      enumOperator eOperator = eOperatorNone;
+      if( is_operator_s( vectorToken[uPosition], "+" ) == true ) eOperator = eOperatorAdd;
+      else if( is_operator_s( vectorToken[uPosition], "-" ) == true ) eOperator = eOperatorSubtract;
+      else break;
+
+      uPosition++;
+      int iRight = parse_multiply( vectorToken, uPosition, stringError );
+      if( iRight == -1 ) return -1;
+      iLeft = add_binary( eOperator, iLeft, iRight, stringError );
+   }
+   return iLeft;
+}
+
+/// `*`, `/` and `%`
+int program::parse_multiply( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   int iLeft = parse_unary( vectorToken, uPosition, stringError );
+   while( iLeft != -1 && uPosition < vectorToken.size() )
+   {
+      enumOperator eOperator = eOperatorNone;
+      if( is_operator_s( vectorToken[uPosition], "*" ) == true ) eOperator = eOperatorMultiply;
+      else if( is_operator_s( vectorToken[uPosition], "/" ) == true ) eOperator = eOperatorDivide;
+      else if( is_operator_s( vectorToken[uPosition], "%" ) == true ) eOperator = eOperatorModulo;
+      else break;
+
+      uPosition++;
+      int iRight = parse_unary( vectorToken, uPosition, stringError );
+      if( iRight == -1 ) return -1;
+      iLeft = add_binary( eOperator, iLeft, iRight, stringError );
+   }
+   return iLeft;
+}
+
+/// unary `-` and `+`
+int program::parse_unary( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   if( uPosition < vectorToken.size() && is_operator_s( vectorToken[uPosition], "-" ) == true )
+   {
+      uPosition++;
+      int iNode = parse_unary( vectorToken, uPosition, stringError );
+      if( iNode == -1 ) return -1;
+      return add_unary( eOperatorNegate, iNode, stringError );
+   }
+   if( uPosition < vectorToken.size() && is_operator_s( vectorToken[uPosition], "+" ) == true ) uPosition++;
+   return parse_primary( vectorToken, uPosition, stringError );
+}
+
+/// number, text, column name, boolean constant or expression within parentheses
+int program::parse_primary( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError )
+{
+   if( uPosition >= vectorToken.size() ) { stringError = "unexpected end of expression"; return -1; }
+
+   const token& token_ = vectorToken[uPosition];
+   std::string_view stringToken = token_.as_string_view();
+   uPosition++;
+
+   switch( token_.type_number() )
+   {
+   case token::eTokenTypeNumber:
+   {
+      node node_;
+      node_.m_eNode = eNodeConstant;
+      if( ( token_.type() & token::eTokenGroupDecimal ) == 0 )
+      {
+         auto result_ = std::from_chars( stringToken.data(), stringToken.data() + stringToken.length(), node_.m_iValue );
+         if( result_.ec == std::errc() ) { node_.m_eValue = eValueInt64; return add_node( std::move( node_ ) ); }
+      }
+      std::from_chars( stringToken.data(), stringToken.data() + stringToken.length(), node_.m_dValue );// decimal number or integer that is too large
+      node_.m_eValue = eValueDouble;
+      return add_node( std::move( node_ ) );
+   }
+
+   case token::eTokenTypeString:
+   {
+      node node_;
+      node_.m_eNode = eNodeConstant;
+      node_.m_eValue = eValueString;
+      node_.m_stringValue = stringToken;
+      return add_node( std::move( node_ ) );
+   }
+
+   case token::eTokenTypeLabel:
+   {
+      node node_;
+      if( is_keyword_s( token_, "true" ) == true || is_keyword_s( token_, "false" ) == true )
+      {
+         node_.m_eNode = eNodeConstant;
+         node_.m_eValue = eValueBool;
+         node_.m_iValue = is_keyword_s( token_, "true" ) == true ? 1 : 0;
+         return add_node( std::move( node_ ) );
+      }
+
+      int iColumn = m_ptable->column_find_index( stringToken );
+      if( iColumn == -1 ) { stringError = "unknown column '" + std::string( stringToken ) + "' in expression"; return -1; }
+
+      const auto& column_ = m_ptable->column_get( iColumn );
+      switch( column_.ctype_number() )
+      {
+      case gd::types::eTypeNumberBool: case gd::types::eTypeNumberInt8: case gd::types::eTypeNumberUInt8:
+      case gd::types::eTypeNumberInt16: case gd::types::eTypeNumberUInt16: case gd::types::eTypeNumberInt32:
+      case gd::types::eTypeNumberUInt32: case gd::types::eTypeNumberInt64: case gd::types::eTypeNumberUInt64:
+         node_.m_eValue = eValueInt64;
+         break;
+      case gd::types::eTypeNumberFloat: case gd::types::eTypeNumberDouble:
+         node_.m_eValue = eValueDouble;
+         break;
+      case gd::types::eTypeNumberString: case gd::types::eTypeNumberUtf8String:
+         if( column_.is_length() == true || column_.is_reference() == true ) { node_.m_eValue = eValueString; break; }
+         [[fallthrough]];
+      default:
+         stringError = "type for column '" + std::string( stringToken ) + "' can't be used in expression";
+         return -1;
+      }
+
+      node_.m_eNode = eNodeColumn;
+      node_.m_uColumn = (unsigned)iColumn;
+      return add_node( std::move( node_ ) );
+   }
+
+   case token::eTokenTypeSpecial:
+      if( stringToken == "(" )
+      {
+         int iNode = parse_or( vectorToken, uPosition, stringError );
+         if( iNode == -1 ) return -1;
+         if( uPosition >= vectorToken.size() || vectorToken[uPosition].as_string_view() != ")" ) { stringError = "missing ')' in expression"; return -1; }
+         uPosition++;
+         return iNode;
+      }
+      break;
+   }
+
+   stringError = "unexpected '" + std::string( stringToken ) + "' in expression";
+   return -1;
+}
+
+// ## nodes ---------------------------------------------------------------------
+
+/// convert node value to type, constants are converted directly
+int program::add_cast( int iNode, enumValue eValue )
+{
+   node& nodeFrom = m_vectorNode[iNode];
+   if( nodeFrom.m_eValue == eValue ) return iNode;
+
+   if( nodeFrom.m_eNode == eNodeConstant )
+   {
+      if( eValue == eValueDouble ) nodeFrom.m_dValue = (double)nodeFrom.m_iValue;
+      else if( eValue == eValueBool ) nodeFrom.m_iValue = nodeFrom.m_eValue == eValueDouble ? nodeFrom.m_dValue != 0.0 : nodeFrom.m_iValue != 0;
+      else if( eValue == eValueInt64 && nodeFrom.m_eValue == eValueDouble ) nodeFrom.m_iValue = (int64_t)nodeFrom.m_dValue;
+      nodeFrom.m_eValue = eValue;
+      return iNode;
+   }
+
+   node node_;
+   node_.m_eNode = eNodeCast;
+   node_.m_eValue = eValue;
+   node_.m_iLeft = iNode;
+   return add_node( std::move( node_ ) );
+}
+
+int program::add_unary( enumOperator eOperator, int iNode, std::string& stringError )
+{
+   enumValue eValue = m_vectorNode[iNode].m_eValue;
+   if( eValue == eValueString ) { stringError = std::string( eOperator == eOperatorNot ? "'not'" : "'-'" ) + " can't be used on text"; return -1; }
+
+   node node_;
+   node_.m_eNode = eNodeUnary;
+   node_.m_eOperator = eOperator;
+   if( eOperator == eOperatorNot ) { node_.m_eValue = eValueBool; node_.m_iLeft = add_cast( iNode, eValueBool ); }
+   else { node_.m_eValue = eValue == eValueBool ? eValueInt64 : eValue; node_.m_iLeft = add_cast( iNode, node_.m_eValue ); }
+   return fold( add_node( std::move( node_ ) ) );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add node for operator with two values, values are converted to operator type
+ * @param eOperator operator
+ * @param iLeft left value
+ * @param iRight right value
+ * @param stringError gets error information if values can't be used with operator
+ * @return int index to node or -1 on error
+*/
+int program::add_binary( enumOperator eOperator, int iLeft, int iRight, std::string& stringError )
+{
+   if( iLeft == -1 || iRight == -1 ) return -1;
+   enumValue eLeft = m_vectorNode[iLeft].m_eValue;
+   enumValue eRight = m_vectorNode[iRight].m_eValue;
+
+   node node_;
+   node_.m_eNode = eNodeBinary;
+   node_.m_eOperator = eOperator;
+
+   if( eOperator == eOperatorAnd || eOperator == eOperatorOr )
+   {
+      if( eLeft == eValueString || eRight == eValueString ) { stringError = "'and' and 'or' can't be used on text"; return -1; }
+      node_.m_eValue = eValueBool;
+      node_.m_iLeft = add_cast( iLeft, eValueBool );
+      node_.m_iRight = add_cast( iRight, eValueBool );
+   }
+   else if( eOperator >= eOperatorEqual )                                      // compare
+   {
+      node_.m_eValue = eValueBool;
+      if( eLeft == eValueString || eRight == eValueString )
+      {
+         if( eLeft != eRight ) { stringError = "text can only be compared with text"; return -1; }
+
+         // ## equal compare between reference column and text compares reference codes
+         if( eOperator == eOperatorEqual || eOperator == eOperatorNotEqual )
+         {
+            const node& nodeLeft = m_vectorNode[iLeft];
+            const node& nodeRight = m_vectorNode[iRight];
+            const node* pnodeColumn = nodeLeft.m_eNode == eNodeColumn ? &nodeLeft : ( nodeRight.m_eNode == eNodeColumn ? &nodeRight : nullptr );
+            const node* pnodeConstant = nodeLeft.m_eNode == eNodeConstant ? &nodeLeft : ( nodeRight.m_eNode == eNodeConstant ? &nodeRight : nullptr );
+            if( pnodeColumn != nullptr && pnodeConstant != nullptr && m_ptable->column_get( pnodeColumn->m_uColumn ).is_reference() == true )
+            {
+               node_.m_eNode = eNodeCode;
+               node_.m_uColumn = pnodeColumn->m_uColumn;
+               node_.m_stringValue = pnodeConstant->m_stringValue;
+               return add_node( std::move( node_ ) );
+            }
+         }
+         node_.m_iLeft = iLeft;
+         node_.m_iRight = iRight;
+      }
+      else
+      {
+         enumValue eValue = ( eLeft == eValueDouble || eRight == eValueDouble ) ? eValueDouble : eValueInt64;
+         node_.m_iLeft = add_cast( iLeft, eValue );
+         node_.m_iRight = add_cast( iRight, eValue );
+      }
+   }
+   else                                                                        // arithmetic
+   {
+      if( eLeft == eValueString || eRight == eValueString ) { stringError = "arithmetic can't be used on text"; return -1; }
+      node_.m_eValue = ( eOperator == eOperatorDivide || eLeft == eValueDouble || eRight == eValueDouble ) ? eValueDouble : eValueInt64;
+      node_.m_iLeft = add_cast( iLeft, node_.m_eValue );
+      node_.m_iRight = add_cast( iRight, node_.m_eValue );
+   }
+
+   return fold( add_node( std::move( node_ ) ) );
+}
+
+/// calculate node if all child nodes are constants and make node constant
+int program::fold( int iNode )
+{
+   node& node_ = m_vectorNode[iNode];
+   if( m_vectorNode[node_.m_iLeft].m_eNode != eNodeConstant ) return iNode;
+   if( node_.m_iRight != -1 && m_vectorNode[node_.m_iRight].m_eNode != eNodeConstant ) return iNode;
+
+   m_vectorBatch.resize( m_vectorNode.size() );
+   evaluate( iNode, 0, 1 );
+   const batch& batch_ = m_vectorBatch[iNode];
+   if( batch_.m_bNull == true ) return iNode;                                  // null result is calculated for each row
+
+   switch( node_.m_eValue )
+   {
+   case eValueBool:   node_.m_iValue = batch_.m_vectorBool[0]; break;
+   case eValueInt64:  node_.m_iValue = batch_.m_vectorInt64[0]; break;
+   case eValueDouble: node_.m_dValue = batch_.m_vectorDouble[0]; break;
+   default:           node_.m_stringValue = batch_.m_vectorString[0]; break;
+   }
+   node_.m_eNode = eNodeConstant;
+   node_.m_eOperator = eOperatorNone;
+   node_.m_iLeft = node_.m_iRight = -1;
+   m_vectorBatch[iNode] = batch();
+   return iNode;
+}
+
+// ## evaluate ------------------------------------------------------------------
+
+/// find reference codes for text in code nodes
+void program::resolve() const
+{
+   for( const auto& it : m_vectorNode )
+   {
+      if( it.m_eNode != eNodeCode ) continue;
+      gd::variant_view variantviewFind = m_ptable->column_get( it.m_uColumn ).ctype_number() == gd::types::eTypeNumberUtf8String
+         ? gd::variant_view( gd::variant_type::utf8( it.m_stringValue.data(), it.m_stringValue.length() ) )
+         : gd::variant_view( std::string_view( it.m_stringValue ) );
+      const_cast<node&>( it ).m_iValue = m_ptable->get_references().find( variantviewFind );
+   }
+}
+
+void program::evaluate( int iNode, uint64_t uFrom, uint64_t uCount ) const
+{
+   const node& node_ = m_vectorNode[iNode];
+   batch& batch_ = m_vectorBatch[iNode];
+
+   switch( node_.m_eNode )
+   {
+   case eNodeConstant:
+      if( batch_.m_uConstant >= uCount ) return;                               // constant values are only filled once
+      switch( node_.m_eValue )
+      {
+      case eValueBool:   std::fill_n( prepare_s( batch_.m_vectorBool, uCount ), uCount, (uint8_t)node_.m_iValue ); break;
+      case eValueInt64:  std::fill_n( prepare_s( batch_.m_vectorInt64, uCount ), uCount, node_.m_iValue ); break;
+      case eValueDouble: std::fill_n( prepare_s( batch_.m_vectorDouble, uCount ), uCount, node_.m_dValue ); break;
+      default:           std::fill_n( prepare_s( batch_.m_vectorString, uCount ), uCount, std::string_view( node_.m_stringValue ) ); break;
+      }
+      batch_.m_bNull = false;
+      batch_.m_uConstant = uCount;
+      return;
+
+   case eNodeColumn:
+      evaluate_column( iNode, uFrom, uCount );
+      return;
+
+   case eNodeCode:
+      evaluate_code( iNode, uFrom, uCount );
+      return;
+
+   case eNodeCast:
+   {
+      evaluate( node_.m_iLeft, uFrom, uCount );
+      const batch& batchFrom = m_vectorBatch[node_.m_iLeft];
+      enumValue eFrom = m_vectorNode[node_.m_iLeft].m_eValue;
+      if( node_.m_eValue == eValueBool )
+      {
+         uint8_t* pbResult = prepare_s( batch_.m_vectorBool, uCount );
+         if( eFrom == eValueDouble ) { for( uint64_t u = 0; u < uCount; u++ ) pbResult[u] = batchFrom.m_vectorDouble[u] != 0.0; }
+         else { for( uint64_t u = 0; u < uCount; u++ ) pbResult[u] = batchFrom.m_vectorInt64[u] != 0; }
+         null_clear_s( batchFrom, pbResult, uCount );
+         batch_.m_bNull = false;
+         return;
+      }
+
+      if( node_.m_eValue == eValueDouble )
+      {
+         double* pdResult = prepare_s( batch_.m_vectorDouble, uCount );
+         if( eFrom == eValueBool ) { for( uint64_t u = 0; u < uCount; u++ ) pdResult[u] = (double)batchFrom.m_vectorBool[u]; }
+         else { for( uint64_t u = 0; u < uCount; u++ ) pdResult[u] = (double)batchFrom.m_vectorInt64[u]; }
+      }
+      else
+      {
+         int64_t* piResult = prepare_s( batch_.m_vectorInt64, uCount );
+         if( eFrom == eValueBool ) { for( uint64_t u = 0; u < uCount; u++ ) piResult[u] = (int64_t)batchFrom.m_vectorBool[u]; }
+         else { for( uint64_t u = 0; u < uCount; u++ ) piResult[u] = (int64_t)batchFrom.m_vectorDouble[u]; }
+      }
+      null_copy_s( batchFrom, batch_, uCount );
+      return;
+   }
+
+   case eNodeUnary:
+   {
+      evaluate( node_.m_iLeft, uFrom, uCount );
+      const batch& batchFrom = m_vectorBatch[node_.m_iLeft];
+      if( node_.m_eOperator == eOperatorNot )
+      {
+         uint8_t* pbResult = prepare_s( batch_.m_vectorBool, uCount );
+         for( uint64_t u = 0; u < uCount; u++ ) pbResult[u] = batchFrom.m_vectorBool[u] ^ 1;
+         batch_.m_bNull = false;
+         return;
+      }
+
+      if( node_.m_eValue == eValueDouble )
+      {
+         double* pdResult = prepare_s( batch_.m_vectorDouble, uCount );
+         for( uint64_t u = 0; u < uCount; u++ ) pdResult[u] = -batchFrom.m_vectorDouble[u];
+      }
+      else
+      {
+         int64_t* piResult = prepare_s( batch_.m_vectorInt64, uCount );
+         for( uint64_t u = 0; u < uCount; u++ ) piResult[u] = (int64_t)( 0 - (uint64_t)batchFrom.m_vectorInt64[u] );
+      }
+      null_copy_s( batchFrom, batch_, uCount );
+      return;
+   }
+
+   case eNodeBinary:
+      evaluate( node_.m_iLeft, uFrom, uCount );
+      evaluate( node_.m_iRight, uFrom, uCount );
+      evaluate_binary( iNode, uCount );
+      return;
+   }
+}
+
+/// read column values for rows, integer columns are read as int64 and decimal columns as double
+void program::evaluate_column( int iNode, uint64_t uFrom, uint64_t uCount ) const
+{
+   const node& node_ = m_vectorNode[iNode];
+   batch& batch_ = m_vectorBatch[iNode];
+   const unsigned uColumn = node_.m_uColumn;
+   const auto& column_ = m_ptable->column_get( uColumn );
+
+   batch_.m_bNull = false;
+   if( m_ptable->is_null() == true )
+   {
+      uint64_t* puNull = prepare_s( batch_.m_vectorNull, ( uCount + 63 ) >> 6 );
+      m_ptable->column_get_null( uColumn, uFrom, uCount, puNull );
+      for( uint64_t u = 0, uMax = ( uCount + 63 ) >> 6; u < uMax && batch_.m_bNull == false; u++ ) batch_.m_bNull = puNull[u] != 0;
+   }
+
+   switch( column_.ctype_number() )
+   {
+   case gd::types::eTypeNumberBool:   load_s<uint8_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberInt8:   load_s<int8_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberUInt8:  load_s<uint8_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberInt16:  load_s<int16_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberUInt16: load_s<uint16_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberInt32:  load_s<int32_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberUInt32: load_s<uint32_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberInt64:  load_s<int64_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberUInt64: load_s<uint64_t>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorInt64, uCount ) ); return;
+   case gd::types::eTypeNumberFloat:  load_s<float>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorDouble, uCount ) ); return;
+   case gd::types::eTypeNumberDouble: load_s<double>( m_ptable, uColumn, uFrom, uCount, prepare_s( batch_.m_vectorDouble, uCount ) ); return;
+   }
+
+   // ## text, null cells are skipped because reference codes in null cells are not valid
+   std::string_view* pstringResult = prepare_s( batch_.m_vectorString, uCount );
+   const auto& references_ = m_ptable->get_references();
+   for( uint64_t u = 0; u < uCount; u++ )
+   {
+      if( is_null_s( batch_, u ) == true ) { pstringResult[u] = std::string_view(); continue; }
+      const uint8_t* puValue = m_ptable->cell_get( uFrom + u, uColumn );
+      if( column_.is_length() == true )
+      {
+         uint32_t uLength;
+         std::memcpy( &uLength, puValue, sizeof( uint32_t ) );
+         pstringResult[u] = std::string_view( (const char*)puValue + sizeof( uint32_t ), uLength );
+      }
+      else
+      {
+         const auto* preference = references_.at( m_ptable->cell_get_code( puValue ) );
+         pstringResult[u] = std::string_view( (const char*)preference->data(), preference->length() );
+      }
+   }
+}
+
+/// compare reference codes in column with code for text, text is never read
+void program::evaluate_code( int iNode, uint64_t uFrom, uint64_t uCount ) const
+{
+   const node& node_ = m_vectorNode[iNode];
+   batch& batch_ = m_vectorBatch[iNode];
+   bool bEqual = node_.m_eOperator == eOperatorEqual;
+   uint8_t* pbResult = prepare_s( batch_.m_vectorBool, uCount );
+
+   if( node_.m_iValue == -1 ) std::fill_n( pbResult, uCount, (uint8_t)( bEqual == false ) );// text isn't found, no cell has the text
+   else if( m_ptable->is_dictionary() == true ) load_code_s<uint32_t>( m_ptable, node_.m_uColumn, uFrom, uCount, (uint64_t)node_.m_iValue, bEqual, pbResult );
+   else load_code_s<uint64_t>( m_ptable, node_.m_uColumn, uFrom, uCount, (uint64_t)node_.m_iValue, bEqual, pbResult );
+
+   batch_.m_bNull = false;
+   if( m_ptable->is_null() == true )
+   {
+      uint64_t* puNull = prepare_s( batch_.m_vectorNull, ( uCount + 63 ) >> 6 );
+      m_ptable->column_get_null( node_.m_uColumn, uFrom, uCount, puNull );
+      for( uint64_t u = 0; u < uCount; u++ ) { if( ( ( puNull[u >> 6] >> ( u & 63 ) ) & 1 ) != 0 ) pbResult[u] = 0; }
+   }
+}
+
+/// calculate operator with two values, compare with null is false and arithmetic with null is null
+void program::evaluate_binary( int iNode, uint64_t uCount ) const
+{
+   const node& node_ = m_vectorNode[iNode];
+   batch& batch_ = m_vectorBatch[iNode];
+   const batch& batchLeft = m_vectorBatch[node_.m_iLeft];
+   const batch& batchRight = m_vectorBatch[node_.m_iRight];
+   const enumValue eOperand = m_vectorNode[node_.m_iLeft].m_eValue;
+   const enumOperator eOperator = node_.m_eOperator;
+
+   if( eOperator == eOperatorAnd || eOperator == eOperatorOr )
+   {
+      uint8_t* pbResult = prepare_s( batch_.m_vectorBool, uCount );
+      if( eOperator == eOperatorAnd ) apply_s( batchLeft.m_vectorBool.data(), batchRight.m_vectorBool.data(), pbResult, uCount, std::bit_and<>{} );
+      else apply_s( batchLeft.m_vectorBool.data(), batchRight.m_vectorBool.data(), pbResult, uCount, std::bit_or<>{} );
+      batch_.m_bNull = false;
+      return;
+   }
+
+   if( eOperator >= eOperatorEqual )                                           // compare
+   {
+      uint8_t* pbResult = prepare_s( batch_.m_vectorBool, uCount );
+      switch( eOperand )
+      {
+      case eValueInt64:  compare_s( eOperator, batchLeft.m_vectorInt64.data(), batchRight.m_vectorInt64.data(), pbResult, uCount ); break;
+      case eValueDouble: compare_s( eOperator, batchLeft.m_vectorDouble.data(), batchRight.m_vectorDouble.data(), pbResult, uCount ); break;
+      case eValueString: compare_s( eOperator, batchLeft.m_vectorString.data(), batchRight.m_vectorString.data(), pbResult, uCount ); break;
+      default:                                                                                     assert( false );
+      }
+      null_clear_s( batchLeft, pbResult, uCount );
+      null_clear_s( batchRight, pbResult, uCount );
+      batch_.m_bNull = false;
+      return;
+   }
+
+   // ## arithmetic
+   batch_.m_bNull = batchLeft.m_bNull || batchRight.m_bNull;
+   if( batch_.m_bNull == true )
+   {
+      uint64_t uWordCount = ( uCount + 63 ) >> 6;
+      uint64_t* puNull = prepare_s( batch_.m_vectorNull, uWordCount );
+      for( uint64_t u = 0; u < uWordCount; u++ ) puNull[u] = ( batchLeft.m_bNull == true ? batchLeft.m_vectorNull[u] : 0 ) | ( batchRight.m_bNull == true ? batchRight.m_vectorNull[u] : 0 );
+   }
+
+   if( node_.m_eValue == eValueDouble )
+   {
+      const double* pdLeft = batchLeft.m_vectorDouble.data();
+      const double* pdRight = batchRight.m_vectorDouble.data();
+      double* pdResult = prepare_s( batch_.m_vectorDouble, uCount );
+      switch( eOperator )
+      {
+      case eOperatorAdd:      apply_s( pdLeft, pdRight, pdResult, uCount, std::plus<>{} ); break;
+      case eOperatorSubtract: apply_s( pdLeft, pdRight, pdResult, uCount, std::minus<>{} ); break;
+      case eOperatorMultiply: apply_s( pdLeft, pdRight, pdResult, uCount, std::multiplies<>{} ); break;
+      case eOperatorDivide:   apply_s( pdLeft, pdRight, pdResult, uCount, std::divides<>{} ); break;
+      case eOperatorModulo:   apply_s( pdLeft, pdRight, pdResult, uCount, []( double dLeft, double dRight ) { return std::fmod( dLeft, dRight ); } ); break;
+      default:                                                                                     assert( false );
+      }
+      return;
+   }
+
+   // int64 values are calculated as unsigned to wrap on overflow
+   const int64_t* piLeft = batchLeft.m_vectorInt64.data();
+   const int64_t* piRight = batchRight.m_vectorInt64.data();
+   int64_t* piResult = prepare_s( batch_.m_vectorInt64, uCount );
+   switch( eOperator )
+   {
+   case eOperatorAdd:      apply_s( piLeft, piRight, piResult, uCount, []( int64_t iLeft, int64_t iRight ) { return (int64_t)( (uint64_t)iLeft + (uint64_t)iRight ); } ); break;
+   case eOperatorSubtract: apply_s( piLeft, piRight, piResult, uCount, []( int64_t iLeft, int64_t iRight ) { return (int64_t)( (uint64_t)iLeft - (uint64_t)iRight ); } ); break;
+   case eOperatorMultiply: apply_s( piLeft, piRight, piResult, uCount, []( int64_t iLeft, int64_t iRight ) { return (int64_t)( (uint64_t)iLeft * (uint64_t)iRight ); } ); break;
+   case eOperatorModulo:
+      for( uint64_t u = 0; u < uCount; u++ )
+      {
+         if( piRight[u] != 0 && piRight[u] != -1 ) { piResult[u] = piLeft[u] % piRight[u]; continue; }
+         piResult[u] = 0;
+         if( piRight[u] == -1 ) continue;
+         if( batch_.m_bNull == false ) { std::fill_n( prepare_s( batch_.m_vectorNull, ( uCount + 63 ) >> 6 ), ( uCount + 63 ) >> 6, 0 ); batch_.m_bNull = true; }
+         batch_.m_vectorNull[u >> 6] |= ( 1ULL << ( u & 63 ) );             // modulo by zero is null
+      }
+      break;
+   default:                                                                                        assert( false );
+   }
+}
+
+_GD_EXPRESSION_END
@@ -0,0 +1,226 @@
+/**
+ * \file gd_expression_program.h
+ *
+ * \brief Compile expressions to programs that are evaluated over table rows
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gd_types.h"
+#include "gd_variant.h"
+#include "gd_variant_view.h"
+#include "gd_table.h"
+#include "gd_table_column-buffer.h"
+#include "gd_expression_token.h"
+
+#ifndef _GD_EXPRESSION_BEGIN
+#define _GD_EXPRESSION_BEGIN namespace gd { namespace expression {
+#define _GD_EXPRESSION_END } }
+#endif
+
+_GD_EXPRESSION_BEGIN
+
+/** ===========================================================================
+ * \brief Compiled expression that is evaluated for batches of rows in table
+ *
+ * Expression is compiled once into a tree with typed nodes, column names are
+ * resolved to column indexes and parts with constant values are calculated
+ * in compile. Evaluation runs one node at a time over a batch of rows
+ * (`eSpaceBatchRows`), each node has a typed loop for int64, double or string
+ * values so there is no per value dispatch. Equal compare between reference
+ * string column and text compares reference codes and never reads text.
+ *
+ * Operators: `or` `||`, `and` `&&`, `not` `!`, `=` `==` `!=` `<>` `<` `<=` `>` `>=`,
+ * `+` `-`, `*` `/` `%`, unary `-`. `true` and `false` are boolean constants.
+ * Integer columns are read as int64, decimal columns as double and text columns
+ * as string. Mixed int64 and double values are calculated as double and `/`
+ * always gives double. Arithmetic with null gives null, compare with null is false.
+ *
+ * Program keeps buffers for batch values, it can not be evaluated from more than
+ * one thread at the same time and table must not be modified while program is
+ * evaluated.
+ *
+ \code
+gd::expression::program program_;
+auto result_ = program_.compile( "price * qty > 1000 and status = 'open'", &table );
+if( result_.first == false ) { std::cout << result_.second; return; }
+
+gd::table::selection selectionMatch;
+program_.filter( selectionMatch );                                            // rows where expression is true
+for( auto uRow : selectionMatch.to_rows() ) { ... }
+ \endcode
+ */
+class program
+{
+public:
+   enum { eSpaceBatchRows = 1024 };
+
+   /// value types for nodes
+   enum enumValue : uint8_t
+   {
+      eValueUnknown  = 0,
+      eValueBool     = 1,
+      eValueInt64    = 2,
+      eValueDouble   = 3,
+      eValueString   = 4,
+   };
+
+   /// node types
+   enum enumNode : uint8_t
+   {
+      eNodeConstant  = 1,  ///< constant value
+      eNodeColumn    = 2,  ///< value read from column
+      eNodeCode      = 3,  ///< equal compare between reference column and text, compares reference codes
+      eNodeCast      = 4,  ///< convert value in child node to node type
+      eNodeUnary     = 5,  ///< operator with one child node
+      eNodeBinary    = 6,  ///< operator with two child nodes
+   };
+
+   enum enumOperator : uint8_t
+   {
+      eOperatorNone = 0,
+      eOperatorAdd,
+      eOperatorSubtract,
+      eOperatorMultiply,
+      eOperatorDivide,
+      eOperatorModulo,
+      eOperatorNegate,
+      eOperatorEqual,
+      eOperatorNotEqual,
+      eOperatorLess,
+      eOperatorLessEqual,
+      eOperatorGreater,
+      eOperatorGreaterEqual,
+      eOperatorAnd,
+      eOperatorOr,
+      eOperatorNot,
+   };
+
+   /// node in compiled expression, child nodes are indexes to nodes in program
+   struct node
+   {
+      enumNode m_eNode = eNodeConstant;
+      enumOperator m_eOperator = eOperatorNone;
+      enumValue m_eValue = eValueUnknown;
+      int m_iLeft = -1;             ///< left or only child node
+      int m_iRight = -1;            ///< right child node
+      unsigned m_uColumn = 0;       ///< column index for column and code nodes
+      int64_t m_iValue = 0;         ///< constant int64 or bool value, reference code for code nodes (-1 if text isn't found)
+      double m_dValue = 0.0;        ///< constant double value
+      std::string m_stringValue;    ///< constant text
+   };
+
+   /// values for rows in batch, only vector for node type is used
+   struct batch
+   {
+      std::vector<uint8_t> m_vectorBool;
+      std::vector<int64_t> m_vectorInt64;
+      std::vector<double> m_vectorDouble;
+      std::vector<std::string_view> m_vectorString;
+      std::vector<uint64_t> m_vectorNull;    ///< one bit for each value, set if value is null. Only valid if `m_bNull` is true
+      bool m_bNull = false;                  ///< true if any value in batch is null
+      uint64_t m_uConstant = 0;              ///< number of values filled for constant nodes
+   };
+
+// ## construction ------------------------------------------------------------
+public:
+   program() {}
+   // copy
+   program( const program& o ) { common_construct( o ); }
+   program( program&& o ) noexcept { common_construct( std::move( o ) ); }
+   // assign
+   program& operator=( const program& o ) { common_construct( o ); return *this; }
+   program& operator=( program&& o ) noexcept { common_construct( std::move( o ) ); return *this; }
+
+   ~program() {}
+private:
+   // common copy
+   void common_construct( const program& o ) { m_ptable = o.m_ptable; m_vectorNode = o.m_vectorNode; m_iRoot = o.m_iRoot; m_vectorBatch.assign( o.m_vectorBatch.size(), batch() ); }
+   void common_construct( program&& o ) noexcept { m_ptable = o.m_ptable; m_vectorNode = std::move( o.m_vectorNode ); m_iRoot = o.m_iRoot; m_vectorBatch = std::move( o.m_vectorBatch ); o.m_iRoot = -1; }
+
+// ## methods -----------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   /// table program reads values from
+   const gd::table::dto::table* get_table() const noexcept { return m_ptable; }
+   /// result type for expression
+   enumValue get_type() const noexcept { return m_iRoot != -1 ? m_vectorNode[m_iRoot].m_eValue : eValueUnknown; }
+   /// number of nodes in compiled expression
+   std::size_t size() const noexcept { return m_vectorNode.size(); }
+   bool empty() const noexcept { return m_iRoot == -1; }
+   /// expression result is boolean and program can be used as filter
+   bool is_predicate() const noexcept { return get_type() == eValueBool; }
+   /// expression is constant, it do not read any column
+   bool is_constant() const noexcept { return m_iRoot != -1 && m_vectorNode[m_iRoot].m_eNode == eNodeConstant; }
+//@}
+
+/** \name OPERATION
+*///@{
+   /// compile expression, column names are resolved in table
+   std::pair<bool, std::string> compile( const std::string_view& stringExpression, const gd::table::dto::table* ptable );
+   void clear() { m_ptable = nullptr; m_vectorNode.clear(); m_vectorBatch.clear(); m_iRoot = -1; }
+
+   /// evaluate expression for rows, max `eSpaceBatchRows` rows. Returned batch is valid until program is evaluated again
+   const batch& evaluate( uint64_t uFrom, uint64_t uCount ) const;
+   /// mark rows where expression is true, selection is reset to table row count
+   void filter( gd::table::selection& selectionMatch ) const { filter( 0, m_ptable->get_row_count(), selectionMatch ); }
+   void filter( uint64_t uFrom, uint64_t uCount, gd::table::selection& selectionMatch ) const;
+   /// rows where expression is true
+   std::vector<uint64_t> filter( gd::table::tag_row ) const;
+   /// set expression result in column for all rows, use as computed column
+   std::pair<bool, std::string> plant( gd::table::dto::table& tableTarget, unsigned uColumn ) const;
+   /// sort rows on expression result, use as sort key. If `vectorRow` is empty all rows in table are sorted
+   void sort( std::vector<uint64_t>& vectorRow, bool bAscending ) const;
+//@}
+
+protected:
+/** \name INTERNAL
+*///@{
+   // ## parse expression into nodes
+   int parse_or( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+   int parse_and( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+   int parse_not( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+   int parse_compare( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+   int parse_add( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+   int parse_multiply( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+   int parse_unary( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+   int parse_primary( const std::vector<token>& vectorToken, std::size_t& uPosition, std::string& stringError );
+
+   // ## create typed nodes, child nodes are converted if needed and constant nodes are folded
+   int add_node( node&& node_ ) { m_vectorNode.push_back( std::move( node_ ) ); return (int)m_vectorNode.size() - 1; }
+   int add_cast( int iNode, enumValue eValue );
+   int add_unary( enumOperator eOperator, int iNode, std::string& stringError );
+   int add_binary( enumOperator eOperator, int iLeft, int iRight, std::string& stringError );
+   int fold( int iNode );
+
+   /// resolve reference codes for code nodes, codes may change when table is modified
+   void resolve() const;
+   /// evaluate node and child nodes, values are placed in batch for node
+   void evaluate( int iNode, uint64_t uFrom, uint64_t uCount ) const;
+   void evaluate_column( int iNode, uint64_t uFrom, uint64_t uCount ) const;
+   void evaluate_code( int iNode, uint64_t uFrom, uint64_t uCount ) const;
+   void evaluate_binary( int iNode, uint64_t uCount ) const;
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   const gd::table::dto::table* m_ptable = nullptr;   ///< table with columns used in expression
+   std::vector<node> m_vectorNode;                    ///< nodes in compiled expression
+   int m_iRoot = -1;                                  ///< root node, -1 if nothing is compiled
+   mutable std::vector<batch> m_vectorBatch;          ///< values for each node when evaluated
+};
+
+_GD_EXPRESSION_END
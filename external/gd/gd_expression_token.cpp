@@ -38,20 +38,21 @@ constexpr uint8_t NO = eCharacterClassNumber;      ///< number characters
 constexpr uint8_t NA = eCharacterClassName;        ///< characters for names
 constexpr uint8_t OP = eCharacterClassOperator;    ///< operator characters, some sort of operation 
 constexpr uint8_t PU = eCharacterClassPunctuator;  ///< characters that divide
+constexpr uint8_t ST = eCharacterClassString;      ///< quote characters that start and end text
 constexpr uint8_t EN = eCharacterClassEnd;
 
 const uint8_t pTokenJsClass_g[256] =
 {
    //       0, 1, 2, 3,  4, 5, 6, 7,  8, 9, A, B,  C, D, E, F,
-   /* 0 */ 00,00,00,00, 00,00,00,00, SP,SP,00,00, 00,SP,00,00,  /* 0   - 15  */
+   /* 0 */ 00,00,00,00, 00,00,00,00, 00,SP,SP,00, 00,SP,00,00,  /* 0   - 15  */
    /* 1 */ 00,00,00,00, 00,00,00,00, 00,00,00,00, 00,00,00,00,  /* 16  - 31  */
-   /* 2 */ 00,00,00,00, 00,00,00,00, 00,PU,PU,00, PU,OP,PU,00,  /* 32  - 47  PU = (),.*/
-   /* 3 */ 00,NO,NO,NO, NO,NO,NO,NO, NO,NO,00,EN, 00,00,00,PU,  /* 48  - 63  PU = ? */  
+   /* 2 */ SP,OP,ST,00, 00,OP,OP,ST, PU,PU,OP,OP, PU,OP,PU,OP,  /* 32  - 47  PU = (),. OP = !%&*+-/ ST = "' */
+   /* 3 */ NO,NO,NO,NO, NO,NO,NO,NO, NO,NO,00,EN, OP,OP,OP,PU,  /* 48  - 63  OP = <=> PU = ? */  
 
    /* 4 */ 00,NA,NA,NA, NA,NA,NA,NA, NA,NA,NA,NA, NA,NA,NA,NA,  /* 64  - 79  */
-   /* 5 */ 00,NA,NA,NA, 00,NA,NA,NA, 00,NA,NA,00, 00,00,00,00,  /* 80  - 95  */
+   /* 5 */ NA,NA,NA,NA, NA,NA,NA,NA, NA,NA,NA,00, 00,00,00,NA,  /* 80  - 95  */
    /* 6 */ 00,NA,NA,NA, NA,NA,NA,NA, NA,NA,NA,NA, NA,NA,NA,NA,  /* 96  - 111 */
-   /* 7 */ NA,NA,NA,NA, NA,NA,NA,NA, NA,NA,00,00, 00,00,00,00,  /* 112 - 127 */
+   /* 7 */ NA,NA,NA,NA, NA,NA,NA,NA, NA,NA,NA,00, OP,00,00,00,  /* 112 - 127 OP = | */
 
    /* 8 */ 00,00,00,00, 00,00,00,00, 00,00,00,00, 00,00,00,00,  /* 128 - 143 */
    /* 9 */ 00,00,00,00, 00,00,00,00, 00,00,00,00, 00,00,00,00,  /* 144 - 159 */
@@ -66,30 +67,71 @@ const uint8_t pTokenJsClass_g[256] =
 
 
 
+/** ---------------------------------------------------------------------------
+ * @brief Read next token in expression
+ *
+ * Token types read are number, string (data is text within quotes), label
+ * (names), operator (one or two characters like `>=` or `!=`) and special
+ * for punctuators like `(`, `)` and `,`. Unknown characters get a token with
+ * type 0 and length 1 so caller can report where expression is invalid.
+ * @code
+gd::expression::token token_;
+for( const char* p_ = gd::expression::token::next_s( stringExpression, &token_ ); p_ != nullptr; p_ = gd::expression::token::next_s( p_, pbszEnd, &token_ ) ) { ... }
+ * @endcode
+ * @param pbszBegin start of text to read token from
+ * @param pbszEnd end of text
+ * @param ptoken token that gets information about read token
+ * @return const char* position after token or nullptr if no more tokens (or string isn't closed)
+*/
 const char* token::next_s(const char* pbszBegin, const char* pbszEnd, token* ptoken)
-{
-   using namespace gd::types;
-   const char* pbszPosition = pbszBegin;
+{                                                                                                  assert( ptoken != nullptr );
+   const uint8_t* puPosition = (const uint8_t*)pbszBegin;
+   const uint8_t* puEnd = (const uint8_t*)pbszEnd;
+   while( puPosition < puEnd && pTokenJsClass_g[*puPosition] == eCharacterClassSpace ) puPosition++;
+   if( puPosition >= puEnd ) return nullptr;
 
-   while(pbszPosition < pbszEnd)
+   const char* pbszToken = (const char*)puPosition;
+   switch( pTokenJsClass_g[*puPosition] )
    {
-      uint8_t uType = puCharType_g[*pbszPosition];
-      switch(uType)
-      {
-      case cchartype_g( "space", tag_main_type{}):
-         pbszPosition++;
-         break;
+   case eCharacterClassNumber:
+      return read_number_s( pbszToken, pbszEnd, ptoken );
+
+   case eCharacterClassName:
+      puPosition++;
+      while( puPosition < puEnd && ( pTokenJsClass_g[*puPosition] & ( eCharacterClassName | eCharacterClassNumber ) ) != 0 ) puPosition++;
+      *ptoken = { eTokenTypeLabel, pbszToken, (unsigned)( (const char*)puPosition - pbszToken ) };
+      return (const char*)puPosition;
 
-      case cchartype_g( "digit", tag_main_type{}):                             // found digit, then read number and return
-         pbszPosition = read_s( pbszPosition, pbszEnd, ptoken, tag_digit{});
-         return pbszPosition;
+   case eCharacterClassString:
+   {
+      uint8_t uQuote = *puPosition;
+      const uint8_t* puText = puPosition + 1;
+      puPosition = puText;
+      while( puPosition < puEnd && *puPosition != uQuote ) puPosition++;
+      if( puPosition >= puEnd ) { *ptoken = { 0, pbszToken, (unsigned)( pbszEnd - pbszToken ) }; return nullptr; }// no end quote
+      *ptoken = { eTokenTypeString, (const char*)puText, (unsigned)( puPosition - puText ) };
+      return (const char*)puPosition + 1;
+   }
 
-      case cchartype_g( "alphabet", tag_main_type{}):
-         break;
+   case eCharacterClassOperator:
+   {
+      unsigned uLength = 1;
+      if( puPosition + 1 < puEnd )
+      {
+         uint8_t u0 = puPosition[0], u1 = puPosition[1];
+         if( ( u1 == '=' && ( u0 == '<' || u0 == '>' || u0 == '!' || u0 == '=' ) ) || ( u0 == '<' && u1 == '>' ) || ( u0 == '&' && u1 == '&' ) || ( u0 == '|' && u1 == '|' ) ) uLength = 2;
       }
+      *ptoken = { eTokenTypeOperator, pbszToken, uLength };
+      return pbszToken + uLength;
    }
 
-   return pbszPosition;
+   case eCharacterClassPunctuator:
+      *ptoken = { eTokenTypeSpecial, pbszToken, 1 };
+      return pbszToken + 1;
+   }
+
+   *ptoken = { 0, pbszToken, 1 };                                              // unknown character
+   return pbszToken + 1;
 }
 
 const char* token::read_s(const char* pbszBegin, const char* pbszEnd, token* ptoken, tag_digit)
@@ -128,7 +170,7 @@ const char* token::next_s(const char* pbszBegin, const char* pbszEnd, uint8_t& u
    while( puPosition < (const uint8_t*)pbszEnd )
    {
       uint8_t uToken = pTokenJsClass_g[*puPosition];
-      if( uToken != 0 )
+      if( uToken != 0 && uToken != eCharacterClassSpace )
       {
          uNextToken = uToken;
          return (const char*)puPosition;
@@ -169,38 +211,40 @@ const char* token::read_s(const char* pbszBegin, const char* pbszEnd, uint8_t uC
    return nullptr;
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief Read number, number is integer if no decimal point is found
+ * @param pbszBegin start of number, may start with `-`
+ * @param pbszEnd end of text
+ * @param ptoken token that gets number type with group (integer or decimal) and text
+ * @return const char* position after number
+*/
 const char* token::read_number_s(const char* pbszBegin, const char* pbszEnd, token* ptoken)
 {
-   unsigned uType = eTokenTypeNumber;
-   bool bIsNegative = false;
+   unsigned uType = (unsigned)eTokenTypeNumber | (unsigned)eTokenGroupNumber | (unsigned)eTokenGroupInteger;
    bool bFoundDecimal = false;
-   unsigned uLength = 0;
    const uint8_t* puPosition = (const uint8_t*)pbszBegin;
 
-   if(*puPosition == '-')
+   if( puPosition < (const uint8_t*)pbszEnd && *puPosition == '-' )
    {
       puPosition++;
-      bIsNegative = true;
-      uLength++;
+      uType |= eTokenGroupSigned;
    }
 
    while( puPosition < (const uint8_t*)pbszEnd )
    {
       uint8_t uToken = pTokenJsClass_g[*puPosition];
-      if( uToken == eCharacterClassNumber ) { uLength++; }
-      else if(uToken == eCharacterClassPunctuator && *puPosition == '.')
+      if( uToken == eCharacterClassNumber ) { puPosition++; continue; }
+      if( *puPosition == '.' && bFoundDecimal == false )
       {
-         if( bFoundDecimal == true ) break;
-
-         uLength++;
          bFoundDecimal = true;
-         uType &= eTokenGroupDecimal;
+         uType = ( uType & ~(unsigned)eTokenGroupInteger ) | eTokenGroupDecimal;
+         puPosition++;
+         continue;
       }
-
-      puPosition++;
+      break;
    }
 
-   *ptoken = { uType, pbszBegin, uLength };
+   *ptoken = { uType, pbszBegin, (unsigned)( (const char*)puPosition - pbszBegin ) };
 
    return (const char*)puPosition;
 }
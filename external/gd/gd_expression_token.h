@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include <string_view>
@@ -80,7 +81,10 @@ struct token
    void common_construct(const token& o) { memcpy( this, &o, sizeof(token) ); }
 
    unsigned type() const { return m_uType; }
+   /// token type without group flags
+   unsigned type_number() const { return m_uType & 0xff; }
    unsigned length() const { return m_uLength; }
+   std::string_view as_string_view() const { return std::string_view( m_pbszData, m_uLength ); }
 
 // ## methods -----------------------------------------------------------------
    void set( const char* pbszBegin, unsigned uLength ) { m_pbszData = pbszBegin, m_uLength = uLength; }
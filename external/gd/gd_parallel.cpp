@@ -0,0 +1,148 @@
+#include "gd_parallel.h"
+
+_GD_PARALLEL_BEGIN
+
+namespace {
+   /// pool and queue index for worker thread, used to place tasks submitted by workers in their own queue
+   thread_local task_pool* ppoolWorker_s = nullptr;
+   thread_local unsigned uQueueWorker_s = 0;
+}
+
+task_pool::task_pool( unsigned uThreadCount )
+{
+   if( uThreadCount == 0 ) uThreadCount = std::thread::hardware_concurrency();
+   if( uThreadCount == 0 ) uThreadCount = 1;
+
+   for( unsigned u = 0; u < uThreadCount; u++ ) m_vectorQueue.push_back( std::make_unique<queue>() );
+   for( unsigned u = 0; u < uThreadCount; u++ ) m_vectorThread.emplace_back( [this, u]() { work( u ); } );
+}
+
+/// waiting tasks are run before workers are stopped
+task_pool::~task_pool()
+{
+   {
+      std::lock_guard<std::mutex> lock_( m_mutexIdle );
+      m_bStop.store( true, std::memory_order_release );
+   }
+   m_conditionIdle.notify_all();
+   for( auto& it : m_vectorThread ) it.join();
+}
+
+void task_pool::submit( task&& task_ )
+{
+   push( std::move( task_ ) );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add task that belongs to group
+ * Exceptions from task are kept in group and thrown from `wait`.
+ * @param group_ group task belongs to, group must live until `wait` returns
+ * @param task_ task to run
+*/
+void task_pool::submit( task_group& group_, task&& task_ )
+{
+   group_.m_uCount.fetch_add( 1, std::memory_order_relaxed );
+   push( [&group_, task_ = std::move( task_ )]() {
+      try { task_(); }
+      catch( ... )
+      {
+         std::lock_guard<std::mutex> lock_( group_.m_mutexException );
+         if( group_.m_pexception == nullptr ) group_.m_pexception = std::current_exception();
+      }
+      group_.m_uCount.fetch_sub( 1, std::memory_order_acq_rel );
+   } );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Run tasks until all tasks in group are done
+ * Waiting thread runs tasks from pool (any task, not only tasks in group) so
+ * waiting from task running in pool do not block worker.
+ * @param group_ group to wait for
+*/
+void task_pool::wait( task_group& group_ )
+{
+   while( group_.is_done() == false )
+   {
+      if( run_one() == false ) std::this_thread::yield();                     // tasks in group are running in other threads
+   }
+
+   if( group_.m_pexception != nullptr )
+   {
+      std::exception_ptr pexception = group_.m_pexception;
+      group_.m_pexception = nullptr;
+      std::rethrow_exception( pexception );
+   }
+}
+
+bool task_pool::run_one()
+{
+   task task_;
+   if( pop( task_ ) == false ) return false;
+   task_();
+   return true;
+}
+
+/// add task to queue for current worker or to next queue if caller isn't worker in pool
+void task_pool::push( task&& task_ )
+{
+   unsigned uQueue = ppoolWorker_s == this ? uQueueWorker_s : m_uNextQueue.fetch_add( 1, std::memory_order_relaxed ) % (unsigned)m_vectorQueue.size();
+   {
+      std::lock_guard<std::mutex> lock_( m_vectorQueue[uQueue]->m_mutex );
+      m_vectorQueue[uQueue]->m_dequeTask.push_back( std::move( task_ ) );
+   }
+   m_uWaiting.fetch_add( 1, std::memory_order_release );
+
+   { std::lock_guard<std::mutex> lock_( m_mutexIdle ); }                       // idle worker is either waiting or will see task
+   m_conditionIdle.notify_one();
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Take task, workers take last task in own queue and steal first task from other queues
+ * @param task_ gets task
+ * @return true if task was found
+*/
+bool task_pool::pop( task& task_ )
+{
+   if( m_uWaiting.load( std::memory_order_acquire ) == 0 ) return false;
+
+   const unsigned uQueueCount = (unsigned)m_vectorQueue.size();
+   const bool bWorker = ppoolWorker_s == this;
+   const unsigned uOwn = bWorker == true ? uQueueWorker_s : 0;
+   for( unsigned u = 0; u < uQueueCount; u++ )
+   {
+      unsigned uQueue = ( uOwn + u ) % uQueueCount;
+      queue& queue_ = *m_vectorQueue[uQueue];
+      std::lock_guard<std::mutex> lock_( queue_.m_mutex );
+      if( queue_.m_dequeTask.empty() == true ) continue;
+
+      if( bWorker == true && u == 0 ) { task_ = std::move( queue_.m_dequeTask.back() ); queue_.m_dequeTask.pop_back(); }
+      else                            { task_ = std::move( queue_.m_dequeTask.front() ); queue_.m_dequeTask.pop_front(); }
+      m_uWaiting.fetch_sub( 1, std::memory_order_acq_rel );
+      return true;
+   }
+   return false;
+}
+
+/// worker loop, runs tasks and sleeps when there is nothing to do
+void task_pool::work( unsigned uIndex )
+{
+   ppoolWorker_s = this;
+   uQueueWorker_s = uIndex;
+
+   while( true )
+   {
+      if( run_one() == true ) continue;
+
+      std::unique_lock<std::mutex> lock_( m_mutexIdle );
+      m_conditionIdle.wait( lock_, [this]() { return m_bStop.load( std::memory_order_acquire ) == true || m_uWaiting.load( std::memory_order_acquire ) > 0; } );
+      if( m_bStop.load( std::memory_order_acquire ) == true && m_uWaiting.load( std::memory_order_acquire ) == 0 ) return;
+   }
+}
+
+task_pool& task_pool::get_default_s()
+{
+   static task_pool poolDefault_s;
+   return poolDefault_s;
+}
+
+_GD_PARALLEL_END
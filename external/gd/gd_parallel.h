@@ -0,0 +1,169 @@
+/**
+ * \file gd_parallel.h
+ *
+ * \brief Work stealing task pool and parallel loop over index ranges
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _GD_PARALLEL_BEGIN
+#  define _GD_PARALLEL_BEGIN namespace gd { namespace parallel {
+#  define _GD_PARALLEL_END } }
+#endif
+
+_GD_PARALLEL_BEGIN
+
+/** ---------------------------------------------------------------------------
+ * @brief Counter for tasks that belong together, used to wait for tasks in group
+ * First exception thrown from task in group is kept and thrown again in `wait`.
+ */
+struct task_group
+{
+   task_group() {}
+   task_group( const task_group& ) = delete;
+   task_group& operator=( const task_group& ) = delete;
+
+   bool is_done() const noexcept { return m_uCount.load( std::memory_order_acquire ) == 0; }
+
+   std::atomic<uint64_t> m_uCount{ 0 };   ///< number of tasks in group that isn't done
+   std::mutex m_mutexException;           ///< lock for exception
+   std::exception_ptr m_pexception;       ///< first exception thrown by task in group
+};
+
+/** ===========================================================================
+ * \brief Pool with worker threads where each worker has its own task queue
+ *
+ * Tasks submitted from worker thread are placed in queue for that worker and
+ * are taken from the back (last added first), idle workers steal tasks from
+ * the front in queues for other workers. Tasks submitted from other threads
+ * are spread over worker queues.
+ *
+ * Thread waiting for task group runs tasks while it waits, so tasks may submit
+ * and wait for other tasks without blocking workers.
+ *
+ \code
+gd::parallel::task_pool pool_( 8 );
+gd::parallel::task_group group_;
+for( unsigned u = 0; u < 100; u++ ) pool_.submit( group_, [u]() { work( u ); } );
+pool_.wait( group_ );
+ \endcode
+ */
+class task_pool
+{
+public:
+   using task = std::function<void()>;
+
+   /// task queue for worker
+   struct queue
+   {
+      std::mutex m_mutex;
+      std::deque<task> m_dequeTask;
+   };
+
+// ## construction ------------------------------------------------------------
+public:
+   /// create pool with number of worker threads, 0 = number of cores
+   explicit task_pool( unsigned uThreadCount = 0 );
+   // copy, pool owns threads and can't be copied
+   task_pool( const task_pool& ) = delete;
+   task_pool& operator=( const task_pool& ) = delete;
+
+   ~task_pool();
+
+// ## methods -----------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   /// number of worker threads
+   unsigned size() const noexcept { return (unsigned)m_vectorThread.size(); }
+//@}
+
+/** \name OPERATION
+*///@{
+   /// add task to pool
+   void submit( task&& task_ );
+   /// add task that belongs to group, wait for group with `wait`
+   void submit( task_group& group_, task&& task_ );
+   /// run tasks until all tasks in group are done
+   void wait( task_group& group_ );
+   /// run one task if any task is waiting, returns false if no task was found
+   bool run_one();
+//@}
+
+protected:
+/** \name INTERNAL
+*///@{
+   void push( task&& task_ );
+   bool pop( task& task_ );
+   void work( unsigned uIndex );
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   std::vector< std::unique_ptr<queue> > m_vectorQueue;  ///< one queue for each worker
+   std::vector<std::thread> m_vectorThread;              ///< worker threads
+   std::atomic<uint64_t> m_uWaiting{ 0 };                ///< number of tasks in queues
+   std::atomic<unsigned> m_uNextQueue{ 0 };              ///< queue for next task submitted from thread that isn't worker
+   std::atomic<bool> m_bStop{ false };                   ///< set when pool is destroyed
+   std::mutex m_mutexIdle;                               ///< lock used by idle workers
+   std::condition_variable m_conditionIdle;              ///< wakes idle workers when tasks are added
+
+// ## free functions ------------------------------------------------------------
+public:
+   /// shared pool with one worker for each core, created on first use
+   static task_pool& get_default_s();
+};
+
+/** ---------------------------------------------------------------------------
+ * @brief Call callback for ranges within range, ranges are run as tasks in pool
+ *
+ * Range is split into ranges with `uGrain` items, last range may be smaller.
+ * Ranges only depend on grain and not on number of threads so results that are
+ * merged in range order are the same on all machines.
+ * @code
+std::vector<double> vectorSum( ( uCount + uGrain - 1 ) / uGrain );
+gd::parallel::parallel_for( pool_, 0, uCount, uGrain, [&]( uint64_t uFrom, uint64_t uTo ) { vectorSum[uFrom / uGrain] = sum( uFrom, uTo ); } );
+ * @endcode
+ * @param pool_ pool that runs ranges
+ * @param uBegin first index
+ * @param uEnd index after last index
+ * @param uGrain number of items in each range
+ * @param callback_ called with `uFrom` and `uTo` for each range
+*/
+template< typename FUNCTION >
+void parallel_for( task_pool& pool_, uint64_t uBegin, uint64_t uEnd, uint64_t uGrain, FUNCTION&& callback_ )
+{                                                                                                  assert( uBegin <= uEnd );
+   if( uGrain == 0 ) uGrain = 1;
+   if( uEnd - uBegin <= uGrain || pool_.size() == 0 )
+   {
+      for( uint64_t uFrom = uBegin; uFrom < uEnd; uFrom += uGrain ) callback_( uFrom, uFrom + uGrain < uEnd ? uFrom + uGrain : uEnd );
+      return;
+   }
+
+   task_group group_;
+   for( uint64_t uFrom = uBegin; uFrom < uEnd; uFrom += uGrain )
+   {
+      uint64_t uTo = uFrom + uGrain < uEnd ? uFrom + uGrain : uEnd;
+      pool_.submit( group_, [&callback_, uFrom, uTo]() { callback_( uFrom, uTo ); } );
+   }
+   pool_.wait( group_ );
+}
+
+_GD_PARALLEL_END
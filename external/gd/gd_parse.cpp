@@ -449,7 +449,7 @@ const char* read_boolean_g( const char* pbsz, bool& bValue )
    if( find_ != pbsz )
    {
       bool bRead = true;
-      if( *find_ == '0' || *find_ == 'f' ) bRead = false;
+      if( *pbsz == '0' || *pbsz == 'f' || *pbsz == 'F' ) bRead = false;
 
       bValue = bRead;
    }
@@ -465,7 +465,7 @@ const char* read_boolean_g( const char* pbsz, const char* pbszEnd, bool& bValue
    if( find_ != pbsz )
    {
       bool bRead = true;
-      if( *find_ == '0' || *find_ == 'f' ) bRead = false;
+      if( *pbsz == '0' || *pbsz == 'f' || *pbsz == 'F' ) bRead = false;
 
       bValue = bRead;
    }
@@ -1161,7 +1161,7 @@ std::cout << gd::table::debug::print( tableCodeGroup );
  * @param csv rules for csv file
  * @return true if line value is read, false and position if error
 */
-std::pair<bool, const char*> read_line_g( const char* pbsz, const char* pbszTextEnd, std::vector<gd::variant_view>& vectorValue, std::vector<unsigned> vectorType, const csv& csv, std::function<bool( gd::variant_view&, unsigned )> callback_ )
+std::pair<bool, const char*> read_line_g( const char* pbsz, const char* pbszTextEnd, std::vector<gd::variant_view>& vectorValue, const std::vector<unsigned>& vectorType, const csv& csv, const std::function<bool( gd::variant_view&, unsigned )>& callback_ )
 {
    // bool bLineEndFound = false;      // marks if we have passed lineend character
    const auto* pbszPosition = pbsz; // current possition
@@ -608,7 +608,7 @@ const char* read_quoted_g( const char* pbsz, const char* pbszEnd, std::string_vi
 
 unsigned read_type_g( const char* pbsz, size_t uLength, const unsigned* puCheckType );
 inline const unsigned read_type_g( const std::string_view& stringValue, unsigned* puCheckType ) { return read_type_g( stringValue.data(), stringValue.length(), puCheckType ); }
-inline const unsigned read_type_g( const std::string_view& stringValue, std::vector<unsigned> vectorType ) { return read_type_g( stringValue.data(), stringValue.length(), vectorType.data() ); }
+inline const unsigned read_type_g( const std::string_view& stringValue, const std::vector<unsigned>& vectorType ) { return read_type_g( stringValue.data(), stringValue.length(), vectorType.data() ); }
 
 // ## skip methods - moves position over characters
 
@@ -671,8 +671,8 @@ inline std::string write_line_g(const std::string_view& stringLine, char chBegin
 // ## CSV
 
 /// read line values into vector with variant view objects
-std::pair<bool, const char*> read_line_g( const char* pbsz, const char* pbszTextEnd, std::vector<gd::variant_view>& vectorValue, std::vector<unsigned> vectorType, const csv& csv, std::function<bool( gd::variant_view&, unsigned )> callback_ );
-inline std::pair<bool, const char*> read_line_g( const char* pbsz, const char* pbszEnd, std::vector<gd::variant_view>& vectorValue, std::vector<unsigned> vectorType, const csv& csv ) {
+std::pair<bool, const char*> read_line_g( const char* pbsz, const char* pbszTextEnd, std::vector<gd::variant_view>& vectorValue, const std::vector<unsigned>& vectorType, const csv& csv, const std::function<bool( gd::variant_view&, unsigned )>& callback_ );
+inline std::pair<bool, const char*> read_line_g( const char* pbsz, const char* pbszEnd, std::vector<gd::variant_view>& vectorValue, const std::vector<unsigned>& vectorType, const csv& csv ) {
    return read_line_g( pbsz, pbszEnd, vectorValue, vectorType, csv, nullptr );
 }
 /// Read csv line into vector of strings
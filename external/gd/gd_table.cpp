@@ -80,25 +80,101 @@ void names::reserve(unsigned uSize)
 }
 
 
-references::references( const references& o )
-{
-   for( auto it = std::begin( o.m_vectorReference ), itEnd = std::end(o. m_vectorReference ); it != itEnd; it++ )
+/** ---------------------------------------------------------------------------
+ * @brief copy slabs and move pointers to reference items into copied slabs
+ * Reference items are placed in slabs in the same order as they are added so
+ * slab for each item is found walking slabs forward.
+ * @param o references to copy from
+ */
+void references::common_construct( const references& o )
+{                                                                                                  assert( m_vectorSlab.empty() == true ); assert( m_vectorReference.empty() == true );
+   m_vectorSlab.reserve( o.m_vectorSlab.size() );
+   for( std::size_t u = 0; u < o.m_vectorSlab.size(); u++ )
+   {
+      const slab& slabFrom = o.m_vectorSlab[u];
+      // last slab keeps capacity to have room for more values, filled slabs are copied to used size
+      slab slab_( u + 1 == o.m_vectorSlab.size() ? slabFrom.m_uCapacity : slabFrom.m_uSize );
+      memcpy( slab_.data(), slabFrom.data(), slabFrom.m_uSize );
+      slab_.m_uSize = slabFrom.m_uSize;
+      m_vectorSlab.push_back( std::move( slab_ ) );
+   }
+
+   m_vectorReference.reserve( o.m_vectorReference.size() );
+   std::size_t uSlab = 0;
+   for( const reference* preferenceFrom : o.m_vectorReference )
    {
-      const reference* preferenceFrom = (const reference*)it->get();
-      reference* preference = allocate( *preferenceFrom );
-      copy_data_s( preference, preferenceFrom->data(), preferenceFrom->size() );
+      while( o.m_vectorSlab[uSlab].contains( preferenceFrom ) == false ) { uSlab++; assert( uSlab < o.m_vectorSlab.size() ); }
+      reference* preference = (reference*)( m_vectorSlab[uSlab].data() + ( (const uint8_t*)preferenceFrom - o.m_vectorSlab[uSlab].data() ) );
+#if DEBUG_RELEASE > 0
+      preference->m_puClone_d = nullptr;                                       // clone buffer belongs to copied item
+      preference->clone_d();
+#endif // DEBUG_RELEASE
+      m_vectorReference.push_back( preference );
    }
+
+   m_vectorHash = o.m_vectorHash;                                              // same values at same index, hash table can be copied
+}
+
+/// number of bytes in value without zero termination
+unsigned references::size_s( unsigned uType, unsigned uLength ) noexcept
+{
+   return gd::types::value_size_g( uType, uLength ) - gd::types::value_size_g( uType, 0 );
+}
+
+/// Remove all values
+void references::clear()
+{
+#if DEBUG_RELEASE > 0
+   for( auto it : m_vectorReference ) { if( it->m_puClone_d != nullptr ) it->delete_d(); }
+#endif
+   m_vectorReference.clear();
+   m_vectorSlab.clear();
+   m_vectorHash.clear();
 }
 
-references& references::operator=( const references& o )
+/** ---------------------------------------------------------------------------
+ * @brief Remove values that isn't referenced, values left are packed into new slabs
+ * Values are kept in the same order so codes for values left only moves down.
+ * Reference count for values need to be updated before compact is called, owner
+ * of references (tables) knows how many cells that use each value.
+ * @param vectorMap gets new index for each old index, -1 if value was removed
+ * @return uint64_t number of removed values
+ */
+uint64_t references::compact( std::vector<int64_t>& vectorMap )
 {
-   for( auto it = std::begin( o.m_vectorReference ), itEnd = std::end(o. m_vectorReference ); it != itEnd; it++ )
+   vectorMap.assign( m_vectorReference.size(), -1 );
+
+   std::vector< slab > vectorSlab = std::move( m_vectorSlab );                 // old slabs are kept until values are copied
+   std::vector< reference* > vectorReference = std::move( m_vectorReference );
+   m_vectorSlab.clear();
+   m_vectorReference.clear();
+   m_vectorReference.reserve( vectorReference.size() );
+
+   uint64_t uRemoved = 0;
+   for( std::size_t uIndex = 0; uIndex < vectorReference.size(); uIndex++ )
    {
-      const reference* preferenceFrom = (const reference*)it->get();
-      reference* preference = allocate( *preferenceFrom );
-      copy_data_s( preference, preferenceFrom->data(), preferenceFrom->size() );
+      reference* preferenceFrom = vectorReference[uIndex];
+      if( preferenceFrom->reference_count() <= 0 )
+      {
+#if DEBUG_RELEASE > 0
+         if( preferenceFrom->m_puClone_d != nullptr ) preferenceFrom->delete_d();
+#endif // DEBUG_RELEASE
+         uRemoved++;
+         continue;
+      }
+
+      uint64_t uSize = allocation_size_s( *preferenceFrom );
+      uint8_t* puReference = slab_allocate( uSize );
+      memcpy( puReference, preferenceFrom, uSize );                            // clone buffer in debug moves with item
+      vectorMap[uIndex] = (int64_t)m_vectorReference.size();
+      m_vectorReference.push_back( (reference*)puReference );
+#if DEBUG_RELEASE > 0
+      ((reference*)puReference)->clone_d();                                    // reference count may have changed, clone is compared with item
+#endif // DEBUG_RELEASE
    }
-   return *this;
+
+   hash_rebuild();
+   return uRemoved;
 }
 
 uint64_t references::add( const gd::variant_view& v_ )
@@ -109,32 +185,97 @@ uint64_t references::add( const gd::variant_view& v_ )
    reference* preference = allocate( reference_ );
    copy_data_s( preference, v_.get_value_buffer(), uSize );                                        DEBUG_RELEASE_EXECUTE( preference->assert_valid_d() );
 
+   hash_insert( m_vectorReference.size() - 1 );
    return m_vectorReference.size() - 1;
 }
 
 
 void references::set( uint64_t uIndex, const uint8_t* puData, unsigned uSize )
-{                                                                                                  assert( uIndex < m_vectorReference.capacity() );
-   auto& preference = m_vectorReference[uIndex]; 
-   copy_data_s( (reference*)preference.get(), puData, uSize );
+{                                                                                                  assert( uIndex < m_vectorReference.size() );
+   copy_data_s( at( uIndex ), puData, uSize );
+   hash_rebuild();                                                             // value is changed, slot for value may change
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief Add values from other references, values already stored are reused
+ * Reference count for each value is added to count for value in this.
+ * @param referencesFrom references values are added from
+ * @param vectorMap gets index in this for each index in `referencesFrom`
+ */
+void references::merge( const references& referencesFrom, std::vector<int64_t>& vectorMap )
+{
+   vectorMap.assign( referencesFrom.size(), -1 );
+   for( std::size_t uIndex = 0; uIndex < referencesFrom.size(); uIndex++ )
+   {
+      const reference* preferenceFrom = referencesFrom.at( uIndex );
+      gd::variant_view variantviewValue( preferenceFrom->ctype(), preferenceFrom->data(), preferenceFrom->length() );
+      int64_t iIndex = find( variantviewValue );
+      if( iIndex == -1 )
+      {
+         iIndex = (int64_t)add( variantviewValue );
+         at( iIndex )->set_reference_count( preferenceFrom->reference_count() );
+      }
+      else
+      {
+         at( iIndex )->set_reference_count( at( iIndex )->reference_count() + preferenceFrom->reference_count() );
+      }
+                                                                                                   DEBUG_RELEASE_EXECUTE( at( iIndex )->clone_d() ); // reference count is changed, clone is compared with item
+      vectorMap[uIndex] = iIndex;
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Find index for value, values are looked up in hash table
+ * @param variantviewFindValue value to find
+ * @return int64_t index to value or -1 if not found
+ */
 int64_t references::find( const gd::variant_view& variantviewFindValue ) const noexcept
 {
-   for( auto it = std::begin( m_vectorReference ), itEnd = std::end( m_vectorReference ); it != itEnd; it++ )
+   if( m_vectorHash.empty() == true ) return -1;
+
+   unsigned uSize = size_s( variantviewFindValue.type(), variantviewFindValue.length() );
+   const uint8_t* puFind = (const uint8_t*)variantviewFindValue.get_value_buffer();
+   const uint64_t uMask = m_vectorHash.size() - 1;
+   for( uint64_t uSlot = hash_s( puFind, uSize ) & uMask; m_vectorHash[uSlot] != 0; uSlot = ( uSlot + 1 ) & uMask )
    {
-      const reference* preference = (const reference*)it->get();
-      if( preference->length() == variantviewFindValue.length() )
+      const reference* preference = at( m_vectorHash[uSlot] - 1 );
+      if( preference->length() == variantviewFindValue.length() && size_s( preference->ctype(), preference->length() ) == uSize && memcmp( preference->data(), puFind, uSize ) == 0 ) // compare data
       {
-         if( memcmp( preference->data(), variantviewFindValue.get_value_buffer(), preference->size() ) == 0 ) // compare data
-         {
-            return std::distance( std::begin( m_vectorReference ), it );       // return index to data in list
-         }
+         return (int64_t)m_vectorHash[uSlot] - 1;                              // return index to data in list
       }
    }
    return -1;                                                                  // no match, return -1 meaning that index is not found
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief Insert value at index into hash table, table is rebuilt when more than half of slots are used
+ * @param uIndex index to value in internal list
+ */
+void references::hash_insert( uint64_t uIndex )
+{                                                                                                  assert( uIndex < m_vectorReference.size() ); assert( uIndex < 0xffff'ffff );
+   if( m_vectorReference.size() * 2 > m_vectorHash.size() ) { hash_rebuild(); return; } // rebuild also inserts value at index
+
+   const reference* preference = at( uIndex );
+   const uint64_t uMask = m_vectorHash.size() - 1;
+   uint64_t uSlot = hash_s( preference->data(), size_s( preference->ctype(), preference->length() ) ) & uMask;
+   while( m_vectorHash[uSlot] != 0 ) uSlot = ( uSlot + 1 ) & uMask;
+   m_vectorHash[uSlot] = (uint32_t)( uIndex + 1 );
+}
+
+/// Rebuild hash table for all values, size is at least four times number of values
+void references::hash_rebuild()
+{
+   m_vectorHash.assign( std::max( std::bit_ceil( m_vectorReference.size() * 4 ), (std::size_t)16 ), 0 );
+   const uint64_t uMask = m_vectorHash.size() - 1;
+   for( std::size_t uIndex = 0; uIndex < m_vectorReference.size(); uIndex++ )
+   {
+      const reference* preference = at( uIndex );
+      uint64_t uSlot = hash_s( preference->data(), size_s( preference->ctype(), preference->length() ) ) & uMask;
+      while( m_vectorHash[uSlot] != 0 ) uSlot = ( uSlot + 1 ) & uMask;
+      m_vectorHash[uSlot] = (uint32_t)( uIndex + 1 );
+   }
+}
+
 /** ---------------------------------------------------------------------------
  * @brief allocate reference object and the amount of data that reference describes
  * Reference is used to store blob data in tables. It works like a pointer
@@ -146,39 +287,60 @@ int64_t references::find( const gd::variant_view& variantviewFindValue ) const n
 */
 reference* references::allocate( const reference& referenceToCopy )
 {                                                                                                  assert( referenceToCopy.reference_count() == 1 );
-#if DEBUG_RELEASE > 0
-   auto uSize_d = sizeof(reference) + referenceToCopy.capacity();
-#endif // DEBUG_RELEASE
-   // To avoid errors using sanitizers a custom deleter is used that deletes the memory block allocated
-   // with similar technique as it was allocated.
-   unsigned uTotalSize = sizeof(reference) + referenceToCopy.capacity(); // Total size = reference object size and data
-
-
-   //std::unique_ptr<reference, decltype(&reference::delete_reference_s) > preference = std::unique_ptr<reference, decltype(&reference::delete_reference_s) >( (reference*) new uint8_t[ uTotalSize ], reference::delete_reference_s );
-   
-#if DEBUG_RELEASE > 0
-   // increase allocated size with 2 bytes to add debug markers, this may be deleted when everything is tested and works
-   std::unique_ptr<uint8_t[]> pReference = std::make_unique<uint8_t[]>( uTotalSize + 2 ); 
-#else
-   std::unique_ptr<uint8_t[]> pReference = std::make_unique<uint8_t[]>( uTotalSize );
-#endif // DEBUG_RELEASE
-   
-   reference* preferenceRaw = (reference*)pReference.get();
+   uint8_t* puReference = slab_allocate( allocation_size_s( referenceToCopy ) );
+   reference* preferenceRaw = (reference*)puReference;
    
    memcpy( preferenceRaw, &referenceToCopy, sizeof(reference) );
 #if DEBUG_RELEASE > 0
    *preferenceRaw->data_end( 1 ) = uTailetextMarker_d;
    *preferenceRaw->data_end( 2 ) = uTailetextMarker_d;
-   preferenceRaw->m_uAllocated_d = uTotalSize;
+   preferenceRaw->m_uAllocated_d = sizeof(reference) + referenceToCopy.capacity();
    preferenceRaw->m_puClone_d = nullptr;                                       // this need to be copied as soon as reference value is set
 #endif // DEBUG_RELEASE
 
-
-   m_vectorReference.push_back( std::move( pReference ) );
+   m_vectorReference.push_back( preferenceRaw );
 
    return preferenceRaw;
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief Allocate bytes in last slab, moves used position in slab forward
+ * If last slab do not have room a new slab is added. Values larger than
+ * default slab size gets a slab with the size needed.
+ * @param uSize number of bytes needed, should be aligned for reference items
+ * @return uint8_t* pointer to allocated bytes
+ */
+uint8_t* references::slab_allocate( uint64_t uSize )
+{                                                                                                  assert( uSize % alignof(reference) == 0 );
+   if( m_vectorSlab.empty() == true || m_vectorSlab.back().available() < uSize )
+   {
+      m_vectorSlab.push_back( slab( std::max( uSize, m_uSlabSize_s ) ) );
+   }
+
+   slab& slab_ = m_vectorSlab.back();
+   uint8_t* puAllocated = slab_.data() + slab_.m_uSize;
+   slab_.m_uSize += uSize;
+   return puAllocated;
+}
+
+/// Total number of bytes allocated for slabs
+uint64_t references::slab_capacity() const noexcept
+{
+   uint64_t uCapacity = 0;
+   for( const auto& it : m_vectorSlab ) uCapacity += it.m_uCapacity;
+   return uCapacity;
+}
+
+/// number of bytes reference item and data occupies, size is aligned to keep next item aligned
+uint64_t references::allocation_size_s( const reference& r_ ) noexcept
+{
+   uint64_t uSize = sizeof(reference) + r_.capacity();
+#if DEBUG_RELEASE > 0
+   uSize += 2;                                                                 // two bytes for debug markers after data
+#endif // DEBUG_RELEASE
+   return ( uSize + alignof(reference) - 1 ) & ~( (uint64_t)alignof(reference) - 1 );
+}
+
 
 void references::copy_data_s( reference* preference, const uint8_t* puData, unsigned uSize )
 {                                                                                                  assert( preference->capacity() >= uSize );
@@ -32,6 +32,7 @@ inline constexpr uint8_t uTailetextMarker_d = 0x01;
 #include <string_view>
 #include <vector>
 #include <memory>
+#include <bit>
 
 #if defined( __clang__ )
    #pragma GCC diagnostic push
@@ -81,6 +82,8 @@ struct tag_type_name {};
 struct tag_type_constant {};
 /// used in copy operations
 struct tag_copy {};
+/// copy that shares segments with copied table, shared segment is copied when it is modified
+struct tag_copy_on_write {};
 /// for convert methods
 struct tag_convert {};
 /// prepare (allocate internal buffers) table to be ready for work
@@ -120,6 +123,26 @@ struct tag_text {};
 struct tag_sort_selection {};
 /// tag dispatcher for bubble sort
 struct tag_sort_bubble {};
+/// tag dispatcher for sort that select algorithm based on column type (radix for numbers, introsort for other)
+struct tag_sort_typed {};
+
+/// ## tag dispatchers for join
+/// tag dispatcher for inner join, rows that match in both tables
+struct tag_join_inner {};
+/// tag dispatcher for left join, all rows in first table and matching rows in second
+struct tag_join_left {};
+/// tag dispatcher for anti join, rows in first table without match in second
+struct tag_join_anti {};
+
+/// ## tag dispatchers for index
+/// tag dispatcher for hash index, find rows with equal key values
+struct tag_index_hash {};
+/// tag dispatcher for ordered index, rows sorted on key values for range and prefix search
+struct tag_index_ordered {};
+/// tag dispatcher for zone map, min, max and null count for blocks of rows used to skip blocks in scans
+struct tag_index_zone {};
+/// tag dispatcher for row hash cache, hash for values in rows are kept and calculated again when row is modified
+struct tag_index_row_hash {};
 
 /// Operation on specified row
 struct tag_row {};
@@ -251,7 +274,7 @@ struct row
    // ## construction -------------------------------------------------------------
 
    row() : m_ptable( nullptr ) {}
-   row( TABLE* ptable, uint64_t uRow ): m_ptable(ptable), m_uRow(uRow) {}
+   row( TABLE* ptable, uint64_t uRow ): m_uRow(uRow), m_ptable(ptable) {}
    ~row() {}
 
    cell<TABLE> operator[]( uint32_t uIndex ) { return cell<TABLE>( m_ptable, m_uRow, uIndex ); }
@@ -348,6 +371,44 @@ struct rows
 };
 
 
+/** ---------------------------------------------------------------------------
+ * @brief 64 bit hash for raw bytes, used by hash based table operations (join, group, distinct)
+ * Pass hash from earlier call as seed to combine values from multiple cells.
+ * @param puData pointer to bytes that are hashed
+ * @param uSize number of bytes
+ * @param uSeed start value for hash
+ * @return uint64_t hash value
+ */
+inline uint64_t hash_bytes_g( const uint8_t* puData, std::size_t uSize, uint64_t uSeed = 0x9e37'79b9'7f4a'7c15ull ) noexcept
+{
+   constexpr uint64_t uMultiply = 0x9ddf'ea08'eb38'2d69ull;
+   uint64_t uHash = uSeed ^ ( uSize * uMultiply );
+   uint64_t uWord;
+   while( uSize >= sizeof( uint64_t ) )
+   {
+      memcpy( &uWord, puData, sizeof( uint64_t ) );
+      uHash = ( uHash ^ uWord ) * uMultiply;
+      uHash ^= uHash >> 47;
+      puData += sizeof( uint64_t );
+      uSize -= sizeof( uint64_t );
+   }
+
+   if( uSize > 0 )
+   {
+      uWord = 0;
+      memcpy( &uWord, puData, uSize );
+      uHash = ( uHash ^ uWord ) * uMultiply;
+   }
+
+   // ## final mix, spread bits so that low bits can be used for buckets
+   uHash ^= uHash >> 33;
+   uHash *= 0xff51'afd7'ed55'8ccdull;
+   uHash ^= uHash >> 33;
+   uHash *= 0xc4ce'b9fe'1a85'ec53ull;
+   uHash ^= uHash >> 33;
+   return uHash;
+}
+
 /**
  * @brief range object works on a range area in table
  *
@@ -416,6 +477,131 @@ struct range
 
 };
 
+/**
+ * @brief sort key used to describe one column when rows are sorted on multiple columns
+ *
+ * Keys are compared in order, first key is the most significant.
+ * @code
+table.sort( { { 2, false }, { 0 } }, tag_sort_typed{} );                      // column 2 descending, then column 0 ascending
+ * @endcode
+ */
+struct sort_key
+{
+// ## construction ------------------------------------------------------------
+   sort_key() {}
+   sort_key( unsigned uColumn ) : m_uColumn{ uColumn } {}
+   sort_key( unsigned uColumn, bool bAscending ) : m_uColumn{ uColumn }, m_bAscending{ bAscending } {}
+
+// ## methods -----------------------------------------------------------------
+   unsigned column() const noexcept { return m_uColumn; }
+   bool is_ascending() const noexcept { return m_bAscending; }
+
+// ## attributes --------------------------------------------------------------
+   unsigned m_uColumn = 0;    ///< index to column sorted on
+   bool m_bAscending = true;  ///< sort order for column
+};
+
+/// ## filter operators used when rows are filtered on column values
+enum enumFilter
+{
+   eFilterEqual         = 0,  ///< =
+   eFilterNotEqual      = 1,  ///< !=
+   eFilterLess          = 2,  ///< <
+   eFilterLessEqual     = 3,  ///< <=
+   eFilterGreater       = 4,  ///< >
+   eFilterGreaterEqual  = 5,  ///< >=
+   eFilterBetween       = 6,  ///< value is within two values, both values included
+   eFilterIn            = 7,  ///< value is found in list
+   eFilterNull          = 8,  ///< is null
+   eFilterNotNull       = 9,  ///< is not null
+};
+
+/**
+ * @brief selected rows in table, one bit for each row
+ *
+ * Filter methods in table mark matching rows in selection. Selections from
+ * different filters are combined with `&=` (AND) and `|=` (OR). Use `to_rows`
+ * to get selection vector with indexes to selected rows.
+ * @code
+gd::table::selection selectionAge, selectionName;
+table.filter( "age", gd::table::eFilterGreaterEqual, 18, selectionAge );
+table.filter( "name", gd::table::eFilterNull, {}, selectionName );
+selectionAge |= selectionName;
+for( auto uRow : selectionAge.to_rows() ) { ... }
+ * @endcode
+ */
+struct selection
+{
+// ## construction ------------------------------------------------------------
+   selection() {}
+   selection( uint64_t uRowCount ) : m_uRowCount{ uRowCount }, m_vectorBit( ( uRowCount + 63 ) / 64, 0 ) {}
+
+// ## operator ----------------------------------------------------------------
+   selection& operator&=( const selection& o ) { assert( o.m_uRowCount == m_uRowCount ); for( std::size_t u = 0; u < m_vectorBit.size(); u++ ) m_vectorBit[u] &= o.m_vectorBit[u]; return *this; }
+   selection& operator|=( const selection& o ) { assert( o.m_uRowCount == m_uRowCount ); for( std::size_t u = 0; u < m_vectorBit.size(); u++ ) m_vectorBit[u] |= o.m_vectorBit[u]; return *this; }
+
+// ## methods -----------------------------------------------------------------
+   uint64_t size() const noexcept { return m_uRowCount; }
+   bool empty() const noexcept { return m_uRowCount == 0; }
+   /// clear all and resize to row count
+   void reset( uint64_t uRowCount ) { m_uRowCount = uRowCount; m_vectorBit.assign( ( uRowCount + 63 ) / 64, 0 ); }
+   bool is_set( uint64_t uRow ) const noexcept { assert( uRow < m_uRowCount ); return ( m_vectorBit[uRow >> 6] >> ( uRow & 63 ) ) & 1; }
+   void set( uint64_t uRow ) noexcept { assert( uRow < m_uRowCount ); m_vectorBit[uRow >> 6] |= ( 1ULL << ( uRow & 63 ) ); }
+   void clear( uint64_t uRow ) noexcept { assert( uRow < m_uRowCount ); m_vectorBit[uRow >> 6] &= ~( 1ULL << ( uRow & 63 ) ); }
+   /// flip all bits, selected rows are unselected and unselected rows are selected
+   void invert() noexcept;
+   /// number of selected rows
+   uint64_t count() const noexcept;
+   /// indexes for selected rows
+   std::vector<uint64_t> to_rows() const { std::vector<uint64_t> vectorRow; to_rows( vectorRow ); return vectorRow; }
+   void to_rows( std::vector<uint64_t>& vectorRow ) const;
+
+   uint64_t* data() noexcept { return m_vectorBit.data(); }
+   const uint64_t* data() const noexcept { return m_vectorBit.data(); }
+
+// ## attributes --------------------------------------------------------------
+   uint64_t m_uRowCount = 0;              ///< number of rows in selection
+   std::vector<uint64_t> m_vectorBit;     ///< one bit for each row, bit is set if row is selected
+};
+
+inline void selection::invert() noexcept {
+   for( auto& it : m_vectorBit ) it = ~it;
+   if( ( m_uRowCount & 63 ) != 0 ) m_vectorBit.back() &= ( 1ULL << ( m_uRowCount & 63 ) ) - 1;// bits after last row are not used
+}
+
+inline uint64_t selection::count() const noexcept {
+   uint64_t uCount = 0;
+   for( auto it : m_vectorBit ) uCount += (uint64_t)std::popcount( it );
+   return uCount;
+}
+
+inline void selection::to_rows( std::vector<uint64_t>& vectorRow ) const {
+   vectorRow.reserve( vectorRow.size() + count() );
+   for( std::size_t u = 0; u < m_vectorBit.size(); u++ )
+   {
+      uint64_t uBit = m_vectorBit[u];
+      while( uBit != 0 )
+      {
+         vectorRow.push_back( ( u << 6 ) + (uint64_t)std::countr_zero( uBit ) );
+         uBit &= uBit - 1;                                                     // clear lowest bit
+      }
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Rows that differ between two tables where rows are matched on key columns
+ * Result from `diff` in table, old table is the table diff is called on.
+ */
+struct table_diff
+{
+   bool empty() const noexcept { return m_vectorInsert.empty() == true && m_vectorDelete.empty() == true && m_vectorModify.empty() == true; }
+   void clear() { m_vectorInsert.clear(); m_vectorDelete.clear(); m_vectorModify.clear(); }
+
+   std::vector<uint64_t> m_vectorInsert;                       ///< rows in new table without matching key in old table
+   std::vector<uint64_t> m_vectorDelete;                       ///< rows in old table without matching key in new table
+   std::vector< std::pair<uint64_t, uint64_t> > m_vectorModify;///< rows with same key and other values, row in old table and row in new table
+};
+
 /**
  * @brief Used for columns without name
 */
@@ -452,7 +638,8 @@ struct names
 {
    names(): m_uSize{0}, m_uMaxSize{0}, m_pbBufferNames{nullptr} {}
    names( const names& o ) noexcept : m_uSize{0}, m_uMaxSize{0}, m_pbBufferNames{nullptr} {
-      reserve( m_uMaxSize );
+      if( o.m_uSize == 0 ) return;
+      reserve( o.m_uSize );
       m_uSize = o.m_uSize;
       memcpy( m_pbBufferNames, o.m_pbBufferNames, m_uSize );
    }
@@ -472,6 +659,8 @@ struct names
       return *this; 
    }
    names& operator=( names&& o ) noexcept { 
+      if( this == &o ) return *this;
+      delete [] m_pbBufferNames;
       m_uSize = o.m_uSize;
       m_uMaxSize = o.m_uMaxSize;
       m_pbBufferNames = o.m_pbBufferNames;
@@ -521,10 +710,10 @@ struct names
  * \brief reference store blob data, binary or string
  *
  * Note that reference and references work together and they use a trick to minimize
- * memory allocations. `references` stores a list of reference object and data in same
- * allocated memory block. The first part in memory block is data used by reference object
- * and after comes the data.
- * memory block - [reference... data...]
+ * memory allocations. `references` stores reference object and data after each other in
+ * slabs (large memory blocks). The first part is data used by reference object and after
+ * comes the data.
+ * slab - [reference... data...][reference... data...]...
  */
 struct reference
 {
@@ -545,6 +734,7 @@ struct reference
    int reference_count() const noexcept { return m_iReferenceCount; }
    void add_reference() { m_iReferenceCount++; }
    void release() { m_iReferenceCount--; }
+   void set_reference_count( int iCount ) { m_iReferenceCount = iCount; }
 
    uint8_t* data() const { return (uint8_t*)this + sizeof(reference); }
    uint8_t* data_end() const { return (uint8_t*)this + sizeof(reference) + length(); }
@@ -587,8 +777,17 @@ struct reference
  * \brief container for reference items storing blob data
  *
  * Blob items managed by references should not be deleted until where the data is
- * used is deleted. It is not coded to be able to remove and insert values into
- * references object.
+ * used is deleted. It is not coded to be able to insert values into references
+ * object, unused values are removed with `compact`.
+ *
+ * Reference items are placed after each other in large memory blocks (slabs),
+ * allocating a value moves position in last slab forward and a new slab is only
+ * allocated when the last is full. Copying references copies each slab with one
+ * memcpy and pointers to items are moved to the new slabs.
+ *
+ * References keeps a hash table over stored values, `find` is O(1). Tables only add
+ * values that isn't found so each value is stored once and index for value works
+ * as a dictionary code, equal values in reference columns have equal codes.
  * 
  * @code
 // add three values into and find one of those
@@ -631,31 +830,56 @@ tableTest.cell_set( 1, 2, "789" );
  */
 struct references
 {
+   /// memory block where reference items are stored after each other
+   struct slab
+   {
+      slab() {}
+      slab( uint64_t uCapacity ): m_puData( new uint8_t[uCapacity] ), m_uCapacity( uCapacity ) {}
+
+      uint8_t* data() const noexcept { return m_puData.get(); }
+      /// number of free bytes in slab
+      uint64_t available() const noexcept { return m_uCapacity - m_uSize; }
+      /// check if pointer is within used part of slab
+      bool contains( const void* p_ ) const noexcept { return (const uint8_t*)p_ >= data() && (const uint8_t*)p_ < data() + m_uSize; }
+
+      std::unique_ptr<uint8_t[]> m_puData; ///< memory block
+      uint64_t m_uSize = 0;                ///< number of used bytes in block
+      uint64_t m_uCapacity = 0;            ///< total number of bytes in block
+   };
+
    // ## construction -------------------------------------------------------------
 
    references() {}
-   references( const references& o );
+   references( const references& o ) { common_construct( o ); }
    references( references&& o ) noexcept {
-      m_vectorReference = std::move( m_vectorReference );
+      m_vectorSlab = std::move( o.m_vectorSlab );
+      m_vectorReference = std::move( o.m_vectorReference );
+      m_vectorHash = std::move( o.m_vectorHash );
+   }
+   references& operator=( const references& o ) {
+      if( this != &o ) { clear(); common_construct( o ); }
+      return *this;
    }
-   references& operator=( const references& o );
    references& operator=( references&& o ) noexcept {
+      clear();
+      m_vectorSlab = std::move( o.m_vectorSlab );
       m_vectorReference = std::move( o.m_vectorReference );
+      m_vectorHash = std::move( o.m_vectorHash );
       return *this;
    }
-   ~references() {
-#if DEBUG_RELEASE > 0
-      for( auto& it : m_vectorReference ) { ((reference*)it.get())->delete_d(); }
-#endif
-   }
+   ~references() { clear(); }
+
+protected:
+   void common_construct( const references& o );
 
+public:
    /// adds value to references internal list of values
    uint64_t add( const gd::variant_view& v_ );
    /// set blob value to value with specified index
    void set( uint64_t uIndex, const uint8_t* puData, unsigned uSize );
 
    /// Return pointer to reference item in internal list
-   reference* at( std::size_t uIndex ) const noexcept { return (reference*)m_vectorReference[uIndex].get(); }
+   reference* at( std::size_t uIndex ) const noexcept { assert( uIndex < m_vectorReference.size() ); return m_vectorReference[uIndex]; }
    /// Find index for value if it exist in internal list
    int64_t find( const gd::variant_view& variantviewFindValue ) const noexcept;
    /// Add to reference counter for specific value at index
@@ -664,17 +888,43 @@ struct references
    std::size_t size() const noexcept { return m_vectorReference.size(); }
    /// Returns whether the references is empty (i.e. no references added).
    bool empty() const noexcept { return m_vectorReference.empty(); }
+   /// Remove all values
+   void clear();
+   /// Remove values with reference count zero or lower, `vectorMap` gets new index for each old index (-1 if removed)
+   uint64_t compact( std::vector<int64_t>& vectorMap );
+   /// Add values from other references and add their reference counts, `vectorMap` gets index in this for each index in other (-1 if not used)
+   void merge( const references& referencesFrom, std::vector<int64_t>& vectorMap );
 
    /// Allocate memory for reference object and return pointer to reference item
    reference* allocate( const reference& r_ );
    reference* allocate( const uint8_t* puData ) { return allocate( *(reference*)puData ); }
+   /// Allocate bytes in last slab, new slab is added if last slab do not have room
+   uint8_t* slab_allocate( uint64_t uSize );
+   /// Total number of bytes allocated for slabs
+   uint64_t slab_capacity() const noexcept;
+
+
+   /// Insert value at index into hash table, hash table grows if needed
+   void hash_insert( uint64_t uIndex );
+   /// Rebuild hash table for all values
+   void hash_rebuild();
 
 
    // ## attributes
-   //std::vector<std::unique_ptr< reference, decltype(&reference::delete_reference_s) > > m_vectorReference;
-   std::vector< std::unique_ptr<uint8_t[]> > m_vectorReference;
+   std::vector< slab > m_vectorSlab;           ///< memory blocks where reference items are stored
+   std::vector< reference* > m_vectorReference; ///< pointers to reference items in slabs, index is the code used in tables
+   std::vector< uint32_t > m_vectorHash; ///< hash table with index + 1 for value in slot, 0 for empty slot. size is power of 2
 
    static void copy_data_s( reference* preference, const uint8_t* puData, unsigned uSize );
+   /// number of bytes that reference item and its data occupies in slab
+   static uint64_t allocation_size_s( const reference& r_ ) noexcept;
+   /// hash for value bytes
+   static uint64_t hash_s( const uint8_t* puData, unsigned uSize ) noexcept { return hash_bytes_g( puData, uSize ); }
+   /// number of bytes in value without zero termination, these are hashed and compared when values are looked up
+   static unsigned size_s( unsigned uType, unsigned uLength ) noexcept;
+
+   /// Default slab size in bytes, values larger than this gets its own slab
+   static constexpr uint64_t m_uSlabSize_s = 64 * 1024;
 };
 
 // ## helper object used to pass table information as arguments
@@ -25,6 +25,7 @@
 #include <string_view>
 #include <vector>
 #include <memory>
+#include <thread>
 
 #include "gd/gd_table.h"
 
@@ -35,13 +36,56 @@
 
 _GD_TABLE_BEGIN
 
+/// ## aggregate functions used when rows are grouped
+enum enumAggregate
+{
+   eAggregateCount         = 0,  ///< number of values that isn't null
+   eAggregateSum           = 1,  ///< sum of values, integer columns are summed as int64 and decimal columns as double
+   eAggregateMin           = 2,  ///< min value
+   eAggregateMax           = 3,  ///< max value
+   eAggregateAvg           = 4,  ///< average value, always double
+   eAggregateCountDistinct = 5,  ///< number of unique values that isn't null
+};
+
+/**
+ * @brief describe aggregate column in result for group by
+ * @code
+aggregate_column{ eAggregateSum, 2, "total" }                                 // sum of values in column 2, result column is named "total"
+ * @endcode
+ */
+struct aggregate_column
+{
+// ## construction ------------------------------------------------------------
+   aggregate_column() {}
+   aggregate_column( enumAggregate eAggregate, unsigned uColumn ) : m_eAggregate{ eAggregate }, m_uColumn{ uColumn } {}
+   aggregate_column( enumAggregate eAggregate, unsigned uColumn, const std::string_view& stringName ) : m_eAggregate{ eAggregate }, m_uColumn{ uColumn }, m_stringName{ stringName } {}
+
+// ## methods -----------------------------------------------------------------
+   enumAggregate type() const noexcept { return m_eAggregate; }
+   unsigned column() const noexcept { return m_uColumn; }
+   const std::string& name() const noexcept { return m_stringName; }
+
+// ## attributes --------------------------------------------------------------
+   enumAggregate m_eAggregate = eAggregateCount;   ///< aggregate function
+   unsigned m_uColumn = 0;                         ///< column in source table that is aggregated
+   std::string m_stringName;                       ///< name for column in result table, generated from function and column name if empty
+};
+
  /**
   * \brief aggregate is used to aggregate data from table classes
   *
   * Methods similar to aggregate functions in sql databases are found here.  
   * sum, max, min, average etc.
   *
+  * `group_by` groups rows on key columns with a hash table and writes one row
+  * for each group to result table. With more than one thread, rows are divided
+  * into partitions where each thread aggregates its own partial groups, partial
+  * groups are merged when all threads are done.
+  *
   \code
+  // sum and count values in column 2 for each unique value in column 0
+  dto::table tableResult;
+  aggregate( &table ).group_by( { 0 }, { { eAggregateSum, 2 }, { eAggregateCount, 2, "count" } }, tableResult, 4 );
   \endcode
   */
 template <typename TABLE>
@@ -94,16 +138,90 @@ public:
    template<typename TYPE>
    TYPE sum( unsigned uColumn ) const { return sum<TYPE>( uColumn, 0, m_ptable->get_row_count() ); }
 
+   // ## aggregate functions for values in column, null values are skipped
+
+   uint64_t count( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const { return calculate( uColumn, uBeginRow, uCount ).m_uCount; }
+   uint64_t count( unsigned uColumn ) const { return count( uColumn, 0, m_ptable->get_row_count() ); }
+   gd::variant_view min( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const { return calculate( uColumn, uBeginRow, uCount ).m_variantviewMin; }
+   gd::variant_view min( unsigned uColumn ) const { return min( uColumn, 0, m_ptable->get_row_count() ); }
+   gd::variant_view max( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const { return calculate( uColumn, uBeginRow, uCount ).m_variantviewMax; }
+   gd::variant_view max( unsigned uColumn ) const { return max( uColumn, 0, m_ptable->get_row_count() ); }
+   double avg( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const { return calculate( uColumn, uBeginRow, uCount ).avg(); }
+   double avg( unsigned uColumn ) const { return avg( uColumn, 0, m_ptable->get_row_count() ); }
+   uint64_t count_distinct( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const;
+   uint64_t count_distinct( unsigned uColumn ) const { return count_distinct( uColumn, 0, m_ptable->get_row_count() ); }
+
+   // ## group rows on key columns and aggregate values for each group
+
+   template<typename TABLE_RESULT>
+   void group_by( const std::vector<unsigned>& vectorKey, const std::vector<aggregate_column>& vectorAggregate, TABLE_RESULT& tableResult, unsigned uThreadCount = 1 ) const;
+   template<typename TABLE_RESULT>
+   void group_by( const std::vector<unsigned>& vectorKey, const std::vector<aggregate_column>& vectorAggregate, uint64_t uBeginRow, uint64_t uCount, TABLE_RESULT& tableResult, unsigned uThreadCount ) const;
+
    // ## fix operations performs specific task to handle edge cases
 
    void fix( std::vector<unsigned>& vectorLength, tag_text );
 
    //@}
 
+   /// values collected for one aggregate function, public so partial results for row ranges can be merged
+   struct accumulator
+   {
+      void add( const gd::variant_view& variantviewValue, enumAggregate eAggregate );
+      void merge( accumulator& o );
+      double avg() const noexcept { return m_uCount > 0 ? ( (double)m_iSum + m_dSum ) / (double)m_uCount : 0.0; }
+
+      uint64_t m_uCount = 0;                    ///< number of values that isn't null
+      int64_t m_iSum = 0;                       ///< sum for integer values
+      double m_dSum = 0.0;                      ///< sum for decimal values
+      gd::variant_view m_variantviewMin;        ///< min value, points to value in table
+      gd::variant_view m_variantviewMax;        ///< max value, points to value in table
+      uint64_t m_uDistinct = 0;                 ///< number of unique values, values are stored in `distinct_set`
+   };
+
+   /// count, sum, min and max for values in rows, null values are skipped
+   accumulator calculate( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const;
+
 protected:
    /** \name INTERNAL
    *///@{
 
+   /// hash for value, equal values get same hash
+   static uint64_t hash_s( const gd::variant_view& variantviewValue ) noexcept;
+
+   /// unique values for count distinct, value is identified by group and row where value was found first
+   struct distinct_set
+   {
+      struct entry { uint64_t m_uHash; uint32_t m_uGroup; uint64_t m_uRow; };
+      bool insert( uint64_t uHash, uint32_t uGroup, uint64_t uRow, const TABLE* ptable, unsigned uColumn );
+
+      std::vector<entry> m_vectorEntry;         ///< slots, row is -1 for empty slot
+      std::size_t m_uCount = 0;                 ///< number of values in set
+   };
+
+   /// group with first row found for group, key values are read from that row
+   struct group
+   {
+      uint64_t m_uHash;
+      uint64_t m_uRow;
+      std::vector<accumulator> m_vectorAccumulator;
+   };
+
+   /// hash table for groups, open addressing with linear probing and groups stored in order they are found
+   struct group_map
+   {
+      int64_t find( uint64_t uHash, uint64_t uRow, const aggregate* paggregate, const std::vector<unsigned>& vectorKey ) const;
+      void add( group&& groupAdd );
+
+      std::vector<group> m_vectorGroup;
+      std::vector<uint32_t> m_vectorSlot;       ///< index to group + 1, 0 = empty slot
+      std::vector<distinct_set> m_vectorDistinct;///< unique values for each aggregate, only used for count distinct
+   };
+
+   uint64_t hash_row( uint64_t uRow, const std::vector<unsigned>& vectorKey ) const;
+   bool is_equal( uint64_t uRow1, uint64_t uRow2, const std::vector<unsigned>& vectorKey ) const;
+   void group_collect( const std::vector<unsigned>& vectorKey, const std::vector<aggregate_column>& vectorAggregate, uint64_t uBeginRow, uint64_t uEndRow, group_map& mapGroup ) const;
+
    //@}
 
 public:
@@ -139,6 +257,9 @@ TYPE sum( const TABLE& t_, unsigned uColumn ) { return aggregate( &t_ ).template
 template<typename TYPE, typename TABLE>
 TYPE sum( const TABLE& t_, unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) { return aggregate( &t_ ).template sum<TYPE>( uColumn, uBeginRow, uCount ); }
 
+template<typename TABLE, typename TABLE_RESULT>
+void group_by( const TABLE& t_, const std::vector<unsigned>& vectorKey, const std::vector<aggregate_column>& vectorAggregate, TABLE_RESULT& tableResult, unsigned uThreadCount = 1 ) { aggregate( &t_ ).group_by( vectorKey, vectorAggregate, tableResult, uThreadCount ); }
+
 
 
 
@@ -233,6 +354,364 @@ TYPE aggregate<TABLE>::sum( unsigned uColumn, uint64_t uBeginRow, uint64_t uCoun
    return sum_;
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief count unique values in column, null values are not counted
+ * @param uColumn index to column
+ * @param uBeginRow start row
+ * @param uCount number of rows from start row
+ * @return uint64_t number of unique values
+*/
+template <typename TABLE>
+uint64_t aggregate<TABLE>::count_distinct( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const { assert( m_ptable != nullptr );
+   uint64_t uEndRow = uBeginRow + uCount;
+   if( uEndRow > m_ptable->get_row_count() ) { uEndRow = m_ptable->get_row_count(); }
+
+   distinct_set setDistinct;
+   for( uint64_t uRow = uBeginRow; uRow < uEndRow; uRow++ ) {
+      auto variantviewValue = m_ptable->cell_get_variant_view( uRow, uColumn );
+      if( variantviewValue.is_null() == false ) setDistinct.insert( hash_s( variantviewValue ), 0, uRow, m_ptable, uColumn );
+   }
+   return setDistinct.m_uCount;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief group rows on values in key columns and aggregate values for each group
+ * 
+ * Result table gets key columns followed by aggregate columns, one row for each
+ * group in the order groups are found. If result table is empty columns are added
+ * and table is prepared, otherwise it must have matching columns.
+ * @param vectorKey key columns that rows are grouped on, empty for one group with all rows
+ * @param vectorAggregate aggregate functions calculated for each group
+ * @param uBeginRow start row
+ * @param uCount number of rows from start row
+ * @param tableResult table that gets result (dto::table)
+ * @param uThreadCount number of threads used to aggregate rows, 0 = use number of cores
+*/
+template <typename TABLE>
+template <typename TABLE_RESULT>
+void aggregate<TABLE>::group_by( const std::vector<unsigned>& vectorKey, const std::vector<aggregate_column>& vectorAggregate, uint64_t uBeginRow, uint64_t uCount, TABLE_RESULT& tableResult, unsigned uThreadCount ) const { assert( m_ptable != nullptr );
+   uint64_t uEndRow = uBeginRow + uCount;
+   if( uEndRow > m_ptable->get_row_count() ) { uEndRow = m_ptable->get_row_count(); }
+   if( uBeginRow > uEndRow ) { uBeginRow = uEndRow; }
+
+   // ## aggregate rows, each thread collect groups for its own partition of rows
+   if( uThreadCount == 0 ) uThreadCount = std::thread::hardware_concurrency();
+   constexpr uint64_t uMinimumPartition = 0x4000;                             // do not start threads for small number of rows
+   uint64_t uRowCount = uEndRow - uBeginRow;
+   if( uThreadCount > uRowCount / uMinimumPartition ) uThreadCount = (unsigned)( uRowCount / uMinimumPartition );
+   if( uThreadCount < 1 ) uThreadCount = 1;
+
+   std::vector<group_map> vectorMap( uThreadCount );
+   if( uThreadCount == 1 ) { group_collect( vectorKey, vectorAggregate, uBeginRow, uEndRow, vectorMap[0] ); }
+   else
+   {
+      std::vector<std::thread> vectorThread;
+      uint64_t uPartition = ( uRowCount + uThreadCount - 1 ) / uThreadCount;
+      for( unsigned u = 0; u < uThreadCount; u++ )
+      {
+         uint64_t uFrom = uBeginRow + u * uPartition;
+         uint64_t uTo = uFrom + uPartition < uEndRow ? uFrom + uPartition : uEndRow;
+         vectorThread.emplace_back( [&, uFrom, uTo, u]() { group_collect( vectorKey, vectorAggregate, uFrom, uTo, vectorMap[u] ); } );
+      }
+      for( auto& it : vectorThread ) it.join();
+
+      // ### merge partial groups into first map, partitions are merged in row order so group order is kept
+      group_map& mapGroup = vectorMap[0];
+      std::vector<uint32_t> vectorGroupIndex;                                  // partial group index to group index in first map
+      for( unsigned u = 1; u < uThreadCount; u++ )
+      {
+         group_map& mapPartial = vectorMap[u];
+         vectorGroupIndex.clear();
+         for( auto& itGroup : mapPartial.m_vectorGroup )
+         {
+            int64_t iGroup = mapGroup.find( itGroup.m_uHash, itGroup.m_uRow, this, vectorKey );
+            if( iGroup == -1 )
+            {
+               for( auto& itAccumulator : itGroup.m_vectorAccumulator ) itAccumulator.m_uDistinct = 0;// counted when unique values are merged
+               mapGroup.add( std::move( itGroup ) );
+               iGroup = (int64_t)mapGroup.m_vectorGroup.size() - 1;
+            }
+            else
+            {
+               auto& groupMerge = mapGroup.m_vectorGroup[iGroup];
+               for( std::size_t uAggregate = 0; uAggregate < vectorAggregate.size(); uAggregate++ ) groupMerge.m_vectorAccumulator[uAggregate].merge( itGroup.m_vectorAccumulator[uAggregate] );
+            }
+            vectorGroupIndex.push_back( (uint32_t)iGroup );
+         }
+
+         // ### merge unique values for count distinct
+         for( std::size_t uAggregate = 0; uAggregate < vectorAggregate.size(); uAggregate++ )
+         {
+            if( vectorAggregate[uAggregate].type() != eAggregateCountDistinct ) continue;
+            for( const auto& itEntry : mapPartial.m_vectorDistinct[uAggregate].m_vectorEntry )
+            {
+               if( itEntry.m_uRow == uint64_t(-1) ) continue;
+               uint32_t uGroup = vectorGroupIndex[itEntry.m_uGroup];
+               if( mapGroup.m_vectorDistinct[uAggregate].insert( itEntry.m_uHash, uGroup, itEntry.m_uRow, m_ptable, vectorAggregate[uAggregate].column() ) == true ) mapGroup.m_vectorGroup[uGroup].m_vectorAccumulator[uAggregate].m_uDistinct++;
+            }
+         }
+      }
+   }
+
+   const group_map& mapGroup = vectorMap[0];
+
+   // ## prepare result table if it doesn't have any columns
+   if( tableResult.column_empty() == true )
+   {
+      argument::column column_;
+      for( auto uColumn : vectorKey ) { m_ptable->column_get( uColumn, column_ ); tableResult.column_add( column_ ); }
+      for( const auto& it : vectorAggregate )
+      {
+         static const char* ppbszName_s[] = { "count", "sum", "min", "max", "avg", "count_distinct" };
+         std::string stringName = it.name();
+         if( stringName.empty() == true ) { stringName = ppbszName_s[it.type()]; stringName += "_"; stringName += m_ptable->column_get_name( it.column() ); }
+
+         switch( it.type() )
+         {
+         case eAggregateCount:
+         case eAggregateCountDistinct: tableResult.column_add( (unsigned)gd::types::eTypeUInt64, 0, stringName ); break;
+         case eAggregateSum: tableResult.column_add( gd::types::detail::is_decimal( m_ptable->column_get_ctype( it.column() ) ) == true ? (unsigned)gd::types::eTypeCDouble : (unsigned)gd::types::eTypeInt64, 0, stringName ); break;
+         case eAggregateAvg: tableResult.column_add( (unsigned)gd::types::eTypeCDouble, 0, stringName ); break;
+         default:                                                              // min and max get same type as column
+            m_ptable->column_get( it.column(), column_ );
+            tableResult.column_add( column_.type(), column_.size(), stringName );
+         }
+      }
+                                                                                                   assert( tableResult.get_column_count() <= 64 );
+      tableResult.set_flags( tableResult.get_flags() | ( tableResult.get_column_count() <= 32 ? TABLE_RESULT::eTableFlagNull32 : TABLE_RESULT::eTableFlagNull64 ) );// groups without values get null
+      if( mapGroup.m_vectorGroup.empty() == false ) tableResult.set_reserved_row_count( mapGroup.m_vectorGroup.size() );
+      tableResult.prepare();
+   }
+   else
+   {                                                                                               assert( tableResult.get_column_count() == vectorKey.size() + vectorAggregate.size() );
+      if( mapGroup.m_vectorGroup.empty() == false ) tableResult.row_reserve_add( mapGroup.m_vectorGroup.size() );
+   }
+
+   // ## add one row for each group
+   std::vector<gd::variant_view> vectorValue( vectorKey.size() + vectorAggregate.size() );
+   for( const auto& itGroup : mapGroup.m_vectorGroup )
+   {
+      for( std::size_t u = 0; u < vectorKey.size(); u++ ) vectorValue[u] = m_ptable->cell_get_variant_view( itGroup.m_uRow, vectorKey[u] );
+      for( std::size_t u = 0; u < vectorAggregate.size(); u++ )
+      {
+         const accumulator& accumulator_ = itGroup.m_vectorAccumulator[u];
+         gd::variant_view& v_ = vectorValue[vectorKey.size() + u];
+         v_ = gd::variant_view();
+         switch( vectorAggregate[u].type() )
+         {
+         case eAggregateCount: v_ = gd::variant_view( accumulator_.m_uCount ); break;
+         case eAggregateCountDistinct: v_ = gd::variant_view( accumulator_.m_uDistinct ); break;
+         case eAggregateSum:
+            if( accumulator_.m_uCount == 0 ) break;
+            if( gd::types::detail::is_decimal( m_ptable->column_get_ctype( vectorAggregate[u].column() ) ) == true ) v_ = gd::variant_view( accumulator_.m_dSum );
+            else                                                                                                 v_ = gd::variant_view( accumulator_.m_iSum );
+            break;
+         case eAggregateAvg: if( accumulator_.m_uCount > 0 ) v_ = gd::variant_view( accumulator_.avg() ); break;
+         case eAggregateMin: v_ = accumulator_.m_variantviewMin; break;
+         case eAggregateMax: v_ = accumulator_.m_variantviewMax; break;
+         }
+      }
+      tableResult.row_add( vectorValue );
+   }
+}
+
+template <typename TABLE>
+template <typename TABLE_RESULT>
+void aggregate<TABLE>::group_by( const std::vector<unsigned>& vectorKey, const std::vector<aggregate_column>& vectorAggregate, TABLE_RESULT& tableResult, unsigned uThreadCount ) const {
+   group_by( vectorKey, vectorAggregate, 0, m_ptable->get_row_count(), tableResult, uThreadCount );
+}
+
+/// hash for value, primitive values hash value bytes and other types hash data they point to
+template <typename TABLE>
+uint64_t aggregate<TABLE>::hash_s( const gd::variant_view& variantviewValue ) noexcept {
+   if( variantviewValue.is_null() == true ) return 0;
+   unsigned uTypeNumber = variantviewValue.type_number();
+   std::size_t uSize = variantviewValue.is_primitive() == true ? gd::types::value_size_g( uTypeNumber ) : variantviewValue.length();
+   if( uTypeNumber == gd::types::eTypeNumberWString ) uSize *= sizeof( wchar_t );
+   return hash_bytes_g( variantviewValue.data(), uSize, uTypeNumber );
+}
+
+template <typename TABLE>
+void aggregate<TABLE>::accumulator::add( const gd::variant_view& variantviewValue, enumAggregate eAggregate ) {
+   if( variantviewValue.is_null() == true ) return;
+   m_uCount++;
+   switch( eAggregate )
+   {
+   case eAggregateSum:
+   case eAggregateAvg:
+      if( variantviewValue.is_decimal() == true )      m_dSum += variantviewValue.as_double();
+      else if( variantviewValue.is_integer() == true ) m_iSum += variantviewValue.as_int64();
+      break;
+   case eAggregateMin: if( m_uCount == 1 || variantviewValue.less( m_variantviewMin ) == true ) m_variantviewMin = variantviewValue; break;
+   case eAggregateMax: if( m_uCount == 1 || m_variantviewMax.less( variantviewValue ) == true ) m_variantviewMax = variantviewValue; break;
+   default: break;
+   }
+}
+
+/// merge values collected in other accumulator for same group and aggregate function
+template <typename TABLE>
+void aggregate<TABLE>::accumulator::merge( accumulator& o ) {
+   if( o.m_uCount == 0 ) return;
+   if( m_uCount == 0 || o.m_variantviewMin.less( m_variantviewMin ) == true ) m_variantviewMin = o.m_variantviewMin;
+   if( m_uCount == 0 || m_variantviewMax.less( o.m_variantviewMax ) == true ) m_variantviewMax = o.m_variantviewMax;
+   m_uCount += o.m_uCount;
+   m_iSum += o.m_iSum;
+   m_dSum += o.m_dSum;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief add value to set if it isn't found for group
+ * @param uHash hash for value
+ * @param uGroup index to group value belongs to
+ * @param uRow row where value is found
+ * @param ptable table values are compared in
+ * @param uColumn column for value
+ * @return true if value was added, false if group already has value
+*/
+template <typename TABLE>
+bool aggregate<TABLE>::distinct_set::insert( uint64_t uHash, uint32_t uGroup, uint64_t uRow, const TABLE* ptable, unsigned uColumn ) {
+   if( ( m_uCount + 1 ) * 2 > m_vectorEntry.size() )                          // keep at most half of slots used
+   {
+      std::vector<entry> vectorEntry( m_vectorEntry.empty() == true ? 64 : m_vectorEntry.size() * 2, entry{ 0, 0, uint64_t(-1) } );
+      const std::size_t uMask = vectorEntry.size() - 1;
+      for( const auto& it : m_vectorEntry )
+      {
+         if( it.m_uRow == uint64_t(-1) ) continue;
+         std::size_t uSlot = (std::size_t)( it.m_uHash ^ ( it.m_uGroup * 0x9e37'79b9'7f4a'7c15ull ) ) & uMask;
+         while( vectorEntry[uSlot].m_uRow != uint64_t(-1) ) uSlot = ( uSlot + 1 ) & uMask;
+         vectorEntry[uSlot] = it;
+      }
+      m_vectorEntry = std::move( vectorEntry );
+   }
+
+   const std::size_t uMask = m_vectorEntry.size() - 1;
+   std::size_t uSlot = (std::size_t)( uHash ^ ( uGroup * 0x9e37'79b9'7f4a'7c15ull ) ) & uMask;
+   for( ; m_vectorEntry[uSlot].m_uRow != uint64_t(-1); uSlot = ( uSlot + 1 ) & uMask )
+   {
+      const entry& entry_ = m_vectorEntry[uSlot];
+      if( entry_.m_uHash == uHash && entry_.m_uGroup == uGroup && ptable->cell_get_variant_view( entry_.m_uRow, uColumn ) == ptable->cell_get_variant_view( uRow, uColumn ) ) return false;
+   }
+
+   m_vectorEntry[uSlot] = entry{ uHash, uGroup, uRow };
+   m_uCount++;
+   return true;
+}
+
+/// find group for row, returns index to group or -1 if not found
+template <typename TABLE>
+int64_t aggregate<TABLE>::group_map::find( uint64_t uHash, uint64_t uRow, const aggregate* paggregate, const std::vector<unsigned>& vectorKey ) const {
+   if( m_vectorSlot.empty() == true ) return -1;
+   const std::size_t uMask = m_vectorSlot.size() - 1;
+   for( std::size_t uSlot = (std::size_t)uHash & uMask; m_vectorSlot[uSlot] != 0; uSlot = ( uSlot + 1 ) & uMask )
+   {
+      const group& group_ = m_vectorGroup[m_vectorSlot[uSlot] - 1];
+      if( group_.m_uHash == uHash && paggregate->is_equal( group_.m_uRow, uRow, vectorKey ) == true ) return (int64_t)( m_vectorSlot[uSlot] - 1 );
+   }
+   return -1;
+}
+
+/// add group, slots are doubled when half of them are used
+template <typename TABLE>
+void aggregate<TABLE>::group_map::add( group&& groupAdd ) {
+   m_vectorGroup.push_back( std::move( groupAdd ) );
+   if( m_vectorGroup.size() * 2 > m_vectorSlot.size() )
+   {
+      m_vectorSlot.assign( m_vectorSlot.empty() == true ? 64 : m_vectorSlot.size() * 2, 0 );
+      const std::size_t uMask = m_vectorSlot.size() - 1;
+      for( std::size_t u = 0; u < m_vectorGroup.size(); u++ )
+      {
+         std::size_t uSlot = (std::size_t)m_vectorGroup[u].m_uHash & uMask;
+         while( m_vectorSlot[uSlot] != 0 ) uSlot = ( uSlot + 1 ) & uMask;
+         m_vectorSlot[uSlot] = (uint32_t)( u + 1 );
+      }
+      return;
+   }
+
+   const std::size_t uMask = m_vectorSlot.size() - 1;
+   std::size_t uSlot = (std::size_t)m_vectorGroup.back().m_uHash & uMask;
+   while( m_vectorSlot[uSlot] != 0 ) uSlot = ( uSlot + 1 ) & uMask;
+   m_vectorSlot[uSlot] = (uint32_t)m_vectorGroup.size();
+}
+
+/// collect values for all aggregate functions in one column
+template <typename TABLE>
+typename aggregate<TABLE>::accumulator aggregate<TABLE>::calculate( unsigned uColumn, uint64_t uBeginRow, uint64_t uCount ) const { assert( m_ptable != nullptr );
+   uint64_t uEndRow = uBeginRow + uCount;
+   if( uEndRow > m_ptable->get_row_count() ) { uEndRow = m_ptable->get_row_count(); }
+
+   accumulator accumulatorColumn;
+   for( uint64_t uRow = uBeginRow; uRow < uEndRow; uRow++ ) {
+      auto variantviewValue = m_ptable->cell_get_variant_view( uRow, uColumn );
+      if( variantviewValue.is_null() == true ) continue;
+      accumulatorColumn.m_uCount++;
+      if( variantviewValue.is_decimal() == true )     accumulatorColumn.m_dSum += variantviewValue.as_double();
+      else if( variantviewValue.is_integer() == true ) accumulatorColumn.m_iSum += variantviewValue.as_int64();
+      if( accumulatorColumn.m_uCount == 1 || variantviewValue.less( accumulatorColumn.m_variantviewMin ) == true ) accumulatorColumn.m_variantviewMin = variantviewValue;
+      if( accumulatorColumn.m_uCount == 1 || accumulatorColumn.m_variantviewMax.less( variantviewValue ) == true ) accumulatorColumn.m_variantviewMax = variantviewValue;
+   }
+   return accumulatorColumn;
+}
+
+/// hash for key values in row
+template <typename TABLE>
+uint64_t aggregate<TABLE>::hash_row( uint64_t uRow, const std::vector<unsigned>& vectorKey ) const {
+   uint64_t uHash = 0;
+   for( auto uColumn : vectorKey )
+   {
+      if constexpr( requires( const TABLE* p_ ) { p_->cell_get_code( uRow, uColumn ); } )
+      {
+         int64_t iCode = m_ptable->cell_get_code( uRow, uColumn );           // reference columns are hashed on code for value
+         if( iCode != -1 ) { uHash = ( uHash ^ hash_bytes_g( (const uint8_t*)&iCode, sizeof( iCode ) ) ) * 0x9e37'79b9'7f4a'7c15ull; continue; }
+      }
+      uHash = ( uHash ^ hash_s( m_ptable->cell_get_variant_view( uRow, uColumn ) ) ) * 0x9e37'79b9'7f4a'7c15ull;
+   }
+   return uHash ^ ( uHash >> 29 );
+}
+
+/// compare key values in two rows, values in reference columns are compared on code
+template <typename TABLE>
+bool aggregate<TABLE>::is_equal( uint64_t uRow1, uint64_t uRow2, const std::vector<unsigned>& vectorKey ) const {
+   for( auto uColumn : vectorKey )
+   {
+      if constexpr( requires( const TABLE* p_ ) { p_->cell_get_code( uRow1, uColumn ); } )
+      {
+         int64_t iCode1 = m_ptable->cell_get_code( uRow1, uColumn );
+         int64_t iCode2 = m_ptable->cell_get_code( uRow2, uColumn );
+         if( iCode1 != -1 && iCode2 != -1 ) { if( iCode1 != iCode2 ) return false; continue; }
+      }
+      if( m_ptable->cell_get_variant_view( uRow1, uColumn ) != m_ptable->cell_get_variant_view( uRow2, uColumn ) ) return false;
+   }
+   return true;
+}
+
+/// aggregate rows into groups, called by each thread for its own rows
+template <typename TABLE>
+void aggregate<TABLE>::group_collect( const std::vector<unsigned>& vectorKey, const std::vector<aggregate_column>& vectorAggregate, uint64_t uBeginRow, uint64_t uEndRow, group_map& mapGroup ) const {
+   mapGroup.m_vectorDistinct.resize( vectorAggregate.size() );
+   for( uint64_t uRow = uBeginRow; uRow < uEndRow; uRow++ )
+   {
+      uint64_t uHash = hash_row( uRow, vectorKey );
+      int64_t iGroup = mapGroup.find( uHash, uRow, this, vectorKey );
+      if( iGroup == -1 )
+      {
+         mapGroup.add( group{ uHash, uRow, std::vector<accumulator>( vectorAggregate.size() ) } );
+         iGroup = (int64_t)mapGroup.m_vectorGroup.size() - 1;
+      }
+
+      auto& group_ = mapGroup.m_vectorGroup[iGroup];
+      for( std::size_t u = 0; u < vectorAggregate.size(); u++ )
+      {
+         unsigned uColumn = vectorAggregate[u].column();
+         auto variantviewValue = m_ptable->cell_get_variant_view( uRow, uColumn );
+         group_.m_vectorAccumulator[u].add( variantviewValue, vectorAggregate[u].type() );
+         if( vectorAggregate[u].type() == eAggregateCountDistinct && variantviewValue.is_null() == false )
+         {
+            if( mapGroup.m_vectorDistinct[u].insert( hash_s( variantviewValue ), (uint32_t)iGroup, uRow, m_ptable, uColumn ) == true ) group_.m_vectorAccumulator[u].m_uDistinct++;
+         }
+      }
+   }
+}
+
 template <typename TABLE>
 void aggregate<TABLE>::fix( std::vector<unsigned>& vectorLength, tag_text ) { assert( m_ptable != nullptr ); assert( vectorLength.empty() == false );
    unsigned uColumnCount = (unsigned)vectorLength.size() < m_ptable->get_column_count() ? (unsigned)vectorLength.size() : m_ptable->get_column_count(); // number of columns to check
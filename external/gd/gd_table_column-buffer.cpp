@@ -1,3 +1,9 @@
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <atomic>
+#include <thread>
+
 #include "gd_utf8.h"
 #include "gd_utf8_2.h"
 #include "gd_variant.h"
@@ -11,9 +17,18 @@
 
 #  include <emmintrin.h>
 #  include <smmintrin.h>
+#  include <immintrin.h>
 
 #  define GD_X86
 
+// avx2 code is selected at runtime, functions using avx2 is compiled for avx2 without changing compiler flags for file
+#  if defined( __GNUC__ ) || defined( __clang__ )
+#     define GD_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#  else
+#     include <intrin.h>
+#     define GD_TARGET_AVX2
+#  endif
+
 #else
 
 #  define GD_APPLE
@@ -232,15 +247,31 @@ table_column_buffer::table_column_buffer(const table_column_buffer& o, const ran
 
 
 void table_column_buffer::common_construct( const table_column_buffer& o ) {
+   m_bRowFree           = false;
    m_uFlags             = o.m_uFlags; 
    m_uRowSize           = o.m_uRowSize;  
    m_uRowMetaSize       = o.m_uRowMetaSize;
    m_uRowCount          = o.m_uRowCount; 
    m_uReservedRowCount  = o.m_uReservedRowCount;
+   m_uSegmentShift      = o.m_uSegmentShift;
 
-   delete m_puData;
+   segment_clear();
+   data_delete();
 
-   if( o.m_puData != nullptr )
+   if( o.m_puData != nullptr && o.is_segmented() == true )
+   {
+      // ## copy each segment, segment keeps rows and meta data for rows in segment
+      uint64_t uSegmentSize = segment_get_size();
+      for( auto puSegment : o.m_vectorSegment )
+      {
+         uint8_t* puCopy = new uint8_t[uSegmentSize];
+         memcpy( puCopy, puSegment, uSegmentSize );
+         m_vectorSegment.push_back( puCopy );
+      }
+      m_puData = m_vectorSegment[0];
+      m_puMetaData = m_uRowMetaSize > 0 ? m_puData + ( (uint64_t)m_uRowSize << m_uSegmentShift ) : nullptr;
+   }
+   else if( o.m_puData != nullptr )
    {
       uint64_t uTotalSize = size_reserved_total();
       m_puData = new uint8_t[uTotalSize];
@@ -265,6 +296,41 @@ void table_column_buffer::common_construct( const table_column_buffer& o ) {
 
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief construct table that shares segments with other table (copy on write)
+ * Segment owners are copied, segments are copied when they are modified. Tables
+ * that isn't segmented or do not have shared segments are copied.
+ * @param o table to copy
+*/
+void table_column_buffer::common_construct( const table_column_buffer& o, tag_copy_on_write )
+{
+   if( o.is_segment_shared() == false ) { common_construct( o ); return; }
+
+   m_bRowFree           = false;
+   m_uFlags             = o.m_uFlags;
+   m_uRowSize           = o.m_uRowSize;
+   m_uRowMetaSize       = o.m_uRowMetaSize;
+   m_uRowCount          = o.m_uRowCount;
+   m_uReservedRowCount  = o.m_uReservedRowCount;
+   m_uSegmentShift      = o.m_uSegmentShift;
+
+   segment_clear();
+   data_delete();
+
+   m_vectorSegment      = o.m_vectorSegment;
+   m_vectorSegmentOwner = o.m_vectorSegmentOwner;
+   m_puData             = o.m_puData;
+   m_puMetaData         = o.m_puMetaData;
+
+   m_vectorColumn = o.m_vectorColumn;
+   m_namesColumn = o.m_namesColumn;
+   m_references = o.m_references;
+   m_argumentsProperty = o.m_argumentsProperty;
+#ifndef NDEBUG
+   m_uAllocatedBlockSize_d = size_reserved_total();
+#endif // NDEBUG
+}
+
 /** ---------------------------------------------------------------------------
  * @brief construct table from another table (creates a copy)
  * @note Do not call this method externaly, only for internal use
@@ -277,8 +343,11 @@ void table_column_buffer::common_construct( const table_column_buffer& o, tag_co
    m_uRowMetaSize       = o.m_uRowMetaSize;
    m_uRowCount          = 0; 
    m_uReservedRowCount  = 0;
+   m_uRowGrowBy         = o.m_uRowGrowBy;
+   m_uSegmentShift      = o.m_uSegmentShift;
 
-   delete m_puData;
+   segment_clear();
+   data_delete();
    m_puData = nullptr;
    m_puMetaData = nullptr;
 
@@ -292,8 +361,11 @@ void table_column_buffer::common_construct( const table_column_buffer& o, const
    m_uFlags             = o.m_uFlags; 
    m_uRowCount          = 0; 
    m_uReservedRowCount  = 0;
+   m_uRowGrowBy         = o.m_uRowGrowBy;
+   m_uSegmentShift      = o.m_uSegmentShift;
 
-   delete m_puData;
+   segment_clear();
+   data_delete();
    m_puData = nullptr;
    m_puMetaData = nullptr;
 
@@ -318,11 +390,13 @@ void table_column_buffer::common_construct( const table_column_buffer& o, const
 uint64_t table_column_buffer::get_row_count( uint32_t uState ) const noexcept
 {                                                                                                  assert( m_puMetaData != nullptr );
    uint64_t uCount = 0;
-   auto uRowMetaSize = size_row_meta();
-   auto puPosition = m_puMetaData + uRowMetaSize - eSpaceRowState;
+   auto uRowMetaSize = row_get_state_stride();
+   auto puPosition = reinterpret_cast<const uint8_t*>( row_get_state( 0 ) );
+   uint64_t uContiguousEnd = row_get_contiguous( 0 );                          // end of rows that are stored after each other
    for( auto itRow = 0u; itRow < m_uReservedRowCount; itRow++ )
    {
-      if( *reinterpret_cast<uint32_t*>( puPosition ) == uState ) uCount++;
+      if( itRow == uContiguousEnd ) { puPosition = reinterpret_cast<const uint8_t*>( row_get_state( itRow ) ); uContiguousEnd += row_get_contiguous( itRow ); }
+      if( *reinterpret_cast<const uint32_t*>( puPosition ) == uState ) uCount++;
       puPosition += uRowMetaSize;                                              // move pointer to next row                                                        
    }
 
@@ -1034,6 +1108,81 @@ tableNumber.column_fill( 3, (int64_t)8 );
 */
 std::pair<bool, std::string> table_column_buffer::prepare()
 {                                                                                                  assert( m_vectorColumn.empty() == false ); assert( m_puData == nullptr );
+   m_bRowFree = false;
+   prepare_row_layout();
+   unsigned uRowSize = m_uRowSize;
+   unsigned uMetaDataSize = m_uRowMetaSize;
+
+   if( is_columnar() == true )                                                 // columnar table reserve rows in blocks, column arrays and null bits are then aligned
+   {
+      uint64_t uReserved = m_uReservedRowCount > 0 ? m_uReservedRowCount : (uint64_t)eSpaceFirstAllocate;
+      m_uReservedRowCount = ( ( uReserved + eSpaceColumnarRows - 1 ) / eSpaceColumnarRows ) * eSpaceColumnarRows;
+   }
+
+   if( is_segmented() == true )                                                // segmented table, add segments until reserved rows fits
+   {                                                                                               assert( is_columnar() == false );
+      uint64_t uReserved = m_uReservedRowCount > 0 ? m_uReservedRowCount : (uint64_t)eSpaceFirstAllocate;
+      m_uReservedRowCount = 0;
+      while( m_uReservedRowCount < uReserved ) segment_add();
+      return { true, "" };
+   }
+
+   uint64_t uTotalTableSize = (uRowSize + uMetaDataSize) * m_uReservedRowCount;// calculate size storing table data
+
+   m_puData = new uint8_t[ uTotalTableSize ];
+#ifdef _DEBUG
+   memset( m_puData, 0, uTotalTableSize );                                     // set data to 0 in debug mode
+#endif // _DEBUG
+
+   if( uMetaDataSize > 0 )
+   {
+      m_puMetaData = m_puData + (m_uReservedRowCount * uRowSize);              // set pointer to meta data section
+      memset( m_puMetaData, 0, m_uReservedRowCount * uMetaDataSize );
+   }
+                                                                                                      
+   return { true, "" };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Prepare table to use external data block, values are read from block without copying
+ * Block has the same layout as block allocated by `prepare`, row data for reserved
+ * rows followed by meta data (columnar tables place column arrays after each
+ * other). Table do not delete block, `pDataOwner` is released when table is
+ * cleared or needs to grow and then rows are copied to a block owned by table.
+ * @code
+// table data in memory mapped file, pMap releases mapping when last user is done
+table.prepare( puMapData, uRowCount, uRowCount, pMap );
+ * @endcode
+ * @param puData pointer to external data block
+ * @param uRowCount number of rows with values in block
+ * @param uReservedRowCount number of rows block has room for
+ * @param pDataOwner object that owns data block
+ * @return std::pair<bool, std::string> true if ok, false and error information if fail
+ */
+std::pair<bool, std::string> table_column_buffer::prepare( uint8_t* puData, uint64_t uRowCount, uint64_t uReservedRowCount, std::shared_ptr<void> pDataOwner )
+{                                                                                                  assert( m_vectorColumn.empty() == false ); assert( m_puData == nullptr ); assert( uRowCount <= uReservedRowCount );
+   if( is_segmented() == true ) return { false, "segmented table can not use external data block" };
+   if( is_columnar() == true && ( uReservedRowCount % eSpaceColumnarRows ) != 0 ) return { false, "reserved rows in columnar table need to be a multiple of " + std::to_string( (unsigned)eSpaceColumnarRows ) };
+
+   m_bRowFree = false;
+   prepare_row_layout();
+
+   m_puData = puData;
+   m_puMetaData = m_uRowMetaSize > 0 ? puData + m_uRowSize * uReservedRowCount : nullptr;
+   m_uReservedRowCount = uReservedRowCount;
+   m_uRowCount = uRowCount;
+   m_pDataOwner = std::move( pDataOwner );
+
+   return { true, "" };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Calculate position for each column in row, row size and meta size for row
+ * Positions are offsets in row for row based tables and used to find column array
+ * for columnar tables.
+ */
+void table_column_buffer::prepare_row_layout()
+{
    // ## calculate size for each row
    unsigned uRowSize = 0; // 
 
@@ -1062,7 +1211,7 @@ std::pair<bool, std::string> table_column_buffer::prepare()
          }
          else
          {
-            uSize = sizeof( uint64_t );
+            uSize = is_dictionary() == true ? sizeof( uint32_t ) : sizeof( uint64_t );
             uState |= gd::table::table_column_buffer::eColumnStateReference;   // for reference values length is store in reference object and index to reference is stored as cell value in table
          }
       }
@@ -1077,26 +1226,8 @@ std::pair<bool, std::string> table_column_buffer::prepare()
 
    m_uRowSize = uRowSize;                                                      // final row sizes
 
-
    // ## calculate needed meta data size for each row
-   unsigned uMetaDataSize = size_row_meta();
-
-   m_uRowMetaSize = uMetaDataSize;
-
-   uint64_t uTotalTableSize = (uRowSize + uMetaDataSize) * m_uReservedRowCount;// calculate size storing table data
-
-   m_puData = new uint8_t[ uTotalTableSize ];
-#ifdef _DEBUG
-   memset( m_puData, 0, uTotalTableSize );                                     // set data to 0 in debug mode
-#endif // _DEBUG
-
-   if( uMetaDataSize > 0 )
-   {
-      m_puMetaData = m_puData + (m_uReservedRowCount * uRowSize);              // set pointer to meta data section
-      memset( m_puMetaData, 0, m_uReservedRowCount * uMetaDataSize );
-   }
-                                                                                                      
-   return { true, "" };
+   m_uRowMetaSize = size_row_meta();
 }
 
 /** ---------------------------------------------------------------------------
@@ -1517,7 +1648,20 @@ void table_column_buffer::row_set( uint64_t uRow, const std::vector< std::pair<s
  * @param uRowToCopy row where data is taken from
 */
 void table_column_buffer::row_set(uint64_t uRow, uint64_t uRowToCopy)
-{                                                                                                  assert( uRow < m_uRowCount ); assert( uRowToCopy <= get_column_count() );   
+{                                                                                                  assert( uRow < m_uRowCount ); assert( uRowToCopy < m_uRowCount );   
+   if( is_notify() == true ) index_notify_set( uRow );
+   m_bRowFree = false;                                                         // row state is copied
+   if( is_columnar() == true )                                                 // columnar table, copy value in each column
+   {
+      for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ )
+      {
+         memcpy( cell_get( uRow, uColumn ), cell_get( uRowToCopy, uColumn ), column_get_width( uColumn ) );
+         if( is_null() == true ) { cell_is_null( uRowToCopy, uColumn ) ? cell_set_null( uRow, uColumn ) : cell_set_not_null( uRow, uColumn ); }
+      }
+      if( is_rowstatus() == true ) *row_get_state( uRow ) = *row_get_state( uRowToCopy );
+      return;
+   }
+
    // ## Copy row data
    const uint8_t* puRowToCopy = row_get( uRowToCopy );
    uint8_t* puRow = row_get( uRow );
@@ -1616,6 +1760,49 @@ void table_column_buffer::row_set_range( uint64_t uRow, unsigned uBeginColumn, u
 void table_column_buffer::row_reserve_add( uint64_t uCount )
 {
    uCount += m_uReservedRowCount;
+   if( is_columnar() == true ) uCount = ( ( uCount + eSpaceColumnarRows - 1 ) / eSpaceColumnarRows ) * eSpaceColumnarRows;
+
+   if( is_segmented() == true )                                                // segmented table only adds segments, rows are not moved
+   {
+      while( m_uReservedRowCount < uCount ) segment_add();
+      return;
+   }
+
+   if( is_columnar() == true && m_puData != nullptr )                          // columnar table, each column array and null bits need to be moved
+   {
+      uint64_t uOldCount = m_uReservedRowCount;
+      uint8_t* puDataCopyTo = new uint8_t[ size_reserved_total( uCount ) ];
+
+      // ## copy column arrays
+      for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ )
+      {
+         uint64_t uPosition = m_vectorColumn[uColumn].position();
+         memcpy( puDataCopyTo + uPosition * uCount, m_puData + uPosition * uOldCount, column_get_width( uColumn ) * uOldCount );
+      }
+
+      if( m_puMetaData != nullptr )
+      {
+         // ## copy null bits for each column and row state array
+         uint8_t* puMetaData = puDataCopyTo + (uint64_t)m_uRowSize * uCount;
+         memset( puMetaData, 0, size_meta_total( uCount ) );
+         if( is_null() == true )
+         {
+            for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ ) memcpy( puMetaData + uColumn * (uCount / 8), m_puMetaData + uColumn * (uOldCount / 8), uOldCount / 8 );
+         }
+
+         if( is_rowstatus() == true )
+         {
+            uint64_t uNullSize = (m_uFlags & (eTableFlagNull32|eTableFlagNull64)) * sizeof(uint32_t);
+            memcpy( puMetaData + uNullSize * uCount, m_puMetaData + uNullSize * uOldCount, uOldCount * eSpaceRowState );
+         }
+         m_puMetaData = puMetaData;
+      }
+
+      data_delete();
+      m_puData = puDataCopyTo;
+      m_uReservedRowCount = uCount;
+      return;
+   }
 
    // ## calculate size needed to store added row count and allocate memory
    uint64_t uTotalTableSize = size_reserved_total();                           // total table memory block size for table
@@ -1643,7 +1830,7 @@ void table_column_buffer::row_reserve_add( uint64_t uCount )
       m_puMetaData = puDataCopyTo + ( uTotalTableSizeCopyTo - uTotalMetaSizeCopyTo);// set meta position pointer if meta data is used
    }
 
-   delete [] m_puData;
+   data_delete();                                                              // external block is released, table owns the new block
    m_puData = puDataCopyTo;
 
    m_uReservedRowCount = uCount;
@@ -1658,6 +1845,7 @@ void table_column_buffer::row_reserve_add( uint64_t uCount )
 uint8_t* table_column_buffer::cell_get( uint64_t uRow, unsigned uColumn ) noexcept
 {                                                                                                  assert( uRow < m_uReservedRowCount ); assert( uColumn < m_vectorColumn.size() ); assert( m_puData );
    auto& columnSet = m_vectorColumn[uColumn];
+   if( is_columnar() == true ) return m_puData + (uint64_t)columnSet.position() * m_uReservedRowCount + uRow * column_get_width( uColumn );
    auto puRow = row_get( uRow );
    return puRow + columnSet.position();
 }
@@ -1671,6 +1859,7 @@ uint8_t* table_column_buffer::cell_get( uint64_t uRow, unsigned uColumn ) noexce
 const uint8_t* table_column_buffer::cell_get( uint64_t uRow, unsigned uColumn ) const noexcept
 {                                                                                                  assert( uRow < m_uReservedRowCount ); assert( uColumn < m_vectorColumn.size() ); assert( m_puData );
    auto& columnSet = m_vectorColumn[uColumn];
+   if( is_columnar() == true ) return m_puData + (uint64_t)columnSet.position() * m_uReservedRowCount + uRow * column_get_width( uColumn );
    auto puRow = row_get( uRow );
    return puRow + columnSet.position();
 }
@@ -1748,16 +1937,29 @@ const reference* table_column_buffer::cell_get_reference( uint64_t uRow, unsigne
    if( is_null() == true && cell_is_null( uRow, uColumn ) == true ) return nullptr;
                                                                                                    assert( m_references.size() > 0 );
    const auto& columnGet = m_vectorColumn[uColumn];                                                assert( columnGet.is_reference() );
-   auto puRow = row_get( uRow ); // buffer to row
-   auto puRowValue = puRow + columnGet.position();
+   auto puRowValue = (uint8_t*)cell_get( uRow, uColumn );                      // buffer to value
 
-   uint64_t uIndex = *(uint64_t*)puRowValue;                                                       assert( uIndex < 0x1000'0000 ); assert( uIndex < m_references.size() ); // realistic value?
+   uint64_t uIndex = cell_get_code( puRowValue );                                                  assert( uIndex < 0x1000'0000 ); assert( uIndex < m_references.size() ); // realistic value?
 
    const reference* preference = m_references.at( uIndex );
 
    return preference;
 }
 
+/** ---------------------------------------------------------------------------
+ * Get code for value in reference column. Values in references are stored once,
+ * equal values have the same code and codes can be compared instead of values.
+ * @param uRow row where cell value is
+ * @param uColumn column for cell
+ * @return int64_t code (index to value in references), -1 if cell is null or column isn't a reference column
+*/
+int64_t table_column_buffer::cell_get_code( uint64_t uRow, unsigned uColumn ) const noexcept
+{                                                                                                  assert( uColumn < get_column_count() );
+   if( m_vectorColumn[uColumn].is_reference() == false ) return -1;
+   if( is_null() == true && cell_is_null( uRow, uColumn ) == true ) return -1;
+   return (int64_t)cell_get_code( cell_get( uRow, uColumn ) );
+}
+
 
 /** ---------------------------------------------------------------------------
  * @brief get cell value as variant_view item
@@ -1768,9 +1970,7 @@ const reference* table_column_buffer::cell_get_reference( uint64_t uRow, unsigne
 gd::variant_view table_column_buffer::cell_get_variant_view( uint64_t uRow, unsigned uColumn ) const noexcept
 {                                                                                                  assert( uRow < get_row_count() ); assert( uRow < m_uReservedRowCount ); assert( uColumn < m_vectorColumn.size() ); assert( m_puData != nullptr );
    const auto& columnGet = m_vectorColumn[uColumn];// column information for value
-   auto puRow = row_get( uRow ); // buffer to row
-
-   auto puRowValue = puRow + columnGet.position();
+   auto puRowValue = (uint8_t*)cell_get( uRow, uColumn );                      // buffer to value
 
    if( is_null() == false || cell_is_null( uRow, uColumn ) == false )
    {
@@ -1800,7 +2000,7 @@ gd::variant_view table_column_buffer::cell_get_variant_view( uint64_t uRow, unsi
          }
          else if( columnGet.is_reference() == true )
          {                                                                                         assert( m_references.size() > 0 ); // do we have reference values because they are needed
-            uint64_t uIndex = *(uint64_t*)puRowValue;                                              
+            uint64_t uIndex = cell_get_code( puRowValue );
                                                                                                    assert( uIndex < 0x1000'0000 ); // realistic value?
                                                                                                    assert( uIndex < m_references.size() );
             reference* preference = m_references.at( uIndex );
@@ -1871,9 +2071,7 @@ gd::variant_view table_column_buffer::cell_get_variant_view( uint64_t uRow, cons
 gd::variant_view table_column_buffer::cell_get_variant_view( uint64_t uRow, unsigned uColumn, tag_raw ) const noexcept
 {
    const auto& columnGet = m_vectorColumn[uColumn];// column information for value
-   auto puRow = row_get( uRow ); // buffer to row
-
-   auto puRowValue = puRow + columnGet.position();
+   auto puRowValue = (uint8_t*)cell_get( uRow, uColumn );                      // buffer to value
 
    if( columnGet.is_fixed() == true )                                       // primitive type
    {
@@ -1901,7 +2099,7 @@ gd::variant_view table_column_buffer::cell_get_variant_view( uint64_t uRow, unsi
       }
       else if( columnGet.is_reference() == true )
       {                                                                                         assert( m_references.size() > 0 ); // do we have reference values because they are needed
-         uint64_t uIndex = *(uint64_t*)puRowValue;                                              assert( uIndex < 0x1000'0000 ); // realistic value?
+         uint64_t uIndex = cell_get_code( puRowValue );                                         assert( uIndex < 0x1000'0000 ); // realistic value?
                                                                                                 assert( uIndex < m_references.size() );
          reference* preference = m_references.at( uIndex );
          #if DEBUG_RELEASE > 0
@@ -1915,6 +2113,34 @@ gd::variant_view table_column_buffer::cell_get_variant_view( uint64_t uRow, unsi
    return gd::variant_view();
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief get pointer to value bytes and value size in bytes for cell
+ * For fixed values the size is primitive size, length prefixed values and
+ * reference values returns the data part without length or reference header.
+ * @param uRow row index for cell
+ * @param uColumn column index for cell
+ * @return std::pair<const uint8_t*, unsigned> pointer to value and size in bytes, nullptr if cell is null
+*/
+std::pair<const uint8_t*, unsigned> table_column_buffer::cell_get( uint64_t uRow, unsigned uColumn, tag_raw ) const noexcept
+{                                                                                                  assert( uRow < m_uReservedRowCount ); assert( uColumn < m_vectorColumn.size() );
+   if( is_null() == true && cell_is_null( uRow, uColumn ) == true ) return { nullptr, 0 };
+
+   const auto& columnGet = m_vectorColumn[uColumn];
+   const uint8_t* puValue = cell_get( uRow, uColumn );
+
+   if( columnGet.is_fixed() == true ) return { puValue, columnGet.primitive_size() };
+
+   if( columnGet.is_length() == true )
+   {
+      unsigned uSize = gd::types::value_size_g( columnGet.ctype(), *(const uint32_t*)puValue );
+      return { puValue + sizeof( uint32_t ), uSize };
+   }
+                                                                                                   assert( columnGet.is_reference() == true ); assert( cell_get_code( puValue ) < m_references.size() );
+   const reference* preference = m_references.at( cell_get_code( puValue ) );
+   return { preference->data(), gd::types::value_size_g( preference->ctype(), preference->length() ) };
+}
+
+
 /** ---------------------------------------------------------------------------
  * @brief get cell value and if column is named then column gets the index so it is faster in loops next time value is returned
  * @param uRow row index for cell
@@ -1964,7 +2190,7 @@ void table_column_buffer::cell_set( uint64_t uRow, unsigned uColumn, const gd::v
 
                                                                                                    assert( uRow < m_uReservedRowCount ); assert( uColumn < m_vectorColumn.size() );
    auto& columnSet = m_vectorColumn[uColumn];                                                      assert( columnSet.position() < m_uRowSize );
-   auto puRow = row_get( uRow );
+   if( is_notify() == true ) index_notify_set( uRow, uColumn );     // indexes remove row before value is changed
 
    if( variantviewValue.is_null() == false )
    {
@@ -1980,7 +2206,7 @@ void table_column_buffer::cell_set( uint64_t uRow, unsigned uColumn, const gd::v
 
       auto puBuffer = variantviewValue.get_value_buffer();                     // get pointer to value buffer
 
-      auto puRowValue = puRow + columnSet.position();                          // get position to value in row
+      auto puRowValue = cell_get( uRow, uColumn );                             // get position to value in row
 
       if( columnSet.is_fixed() )
       {
@@ -2009,7 +2235,8 @@ void table_column_buffer::cell_set( uint64_t uRow, unsigned uColumn, const gd::v
                iIndex = (int64_t )m_references.add( variantviewValue );
             }
 
-            memcpy( puRowValue, &iIndex, sizeof( intptr_t ) );                 // copy index value into cell
+            if( is_dictionary() == true ) *(uint32_t*)puRowValue = (uint32_t)iIndex;// 32 bit code in dictionary encoded table
+            else                          memcpy( puRowValue, &iIndex, sizeof( uint64_t ) ); // copy index value into cell
          }
          else { assert(false); }
       }
@@ -2502,13 +2729,15 @@ bool table_column_buffer::row_for_each( uint64_t uFrom, uint64_t uCount, std::fu
  */
 int64_t table_column_buffer::row_get_absolute(uint64_t uRelativeRow, unsigned uStatus) const
 {                                                                                                  assert( m_puMetaData != nullptr ); assert( is_rowstatus() == true ); assert( uRelativeRow < get_row_count() );
-   auto uRowMetaSize = size_row_meta();
-   const auto* puPosition = m_puMetaData;
+   auto uRowMetaSize = row_get_state_stride();
+   const auto* puPosition = reinterpret_cast<const uint8_t*>( row_get_state( 0 ) );
 
    uint64_t uMatchRow = 0;    // rows matched against status
    uint64_t uRow = 0;         // absolute row
+   uint64_t uContiguousEnd = row_get_contiguous( 0 ); // end of rows that are stored after each other
    for( uint64_t uRowCount = get_row_count(); uMatchRow < uRelativeRow && uRow < uRowCount; uRow++ )
    {
+      if( uRow == uContiguousEnd ) { puPosition = reinterpret_cast<const uint8_t*>( row_get_state( uRow ) ); uContiguousEnd += row_get_contiguous( uRow ); }
       if( (*reinterpret_cast<const uint32_t*>( puPosition ) & uStatus ) == uStatus ) uMatchRow++;
       puPosition += uRowMetaSize;
    }
@@ -2521,6 +2750,7 @@ int64_t table_column_buffer::row_get_absolute(uint64_t uRelativeRow, unsigned uS
 
 /** ---------------------------------------------------------------------------
  * @brief find value in column
+ * If column has zone map only blocks where value is within min and max are read.
  * @param uColumn index to column to find value in
  * @param uStartRow Row to start finding for value in
  * @param uCount number of rows to find value
@@ -2528,6 +2758,46 @@ int64_t table_column_buffer::row_get_absolute(uint64_t uRelativeRow, unsigned uS
  * @return int64_t index for row if found, -1 if not found
 */
 int64_t table_column_buffer::find( unsigned uColumn, uint64_t uStartRow, uint64_t uCount, const gd::variant_view& variantviewFind ) const noexcept
+{
+   const index_zone* pzone = m_vectorIndex.empty() == false ? index_get_zone( uColumn ) : nullptr;
+   if( pzone == nullptr || variantviewFind.is_null() == true ) return find( uColumn, uStartRow, uCount, variantviewFind, tag_raw{} );
+
+   gd::variant_view variantviewZone = variantviewFind;                         // value tested against zone map, code for reference columns
+   if( m_vectorColumn[uColumn].is_reference() == true )
+   {
+      int64_t iCode = m_references.find( variantviewFind );
+      if( iCode == -1 ) return -1;
+      variantviewZone = gd::variant_view( (uint64_t)iCode );
+   }
+
+   // ## search blocks where value may be found
+   pzone->update();
+   const unsigned uKey = (unsigned)pzone->find_key( uColumn );
+   const uint64_t uEndRow = uStartRow + uCount;                                                    assert( uEndRow <= get_row_count() );
+   for( uint64_t uRow = uStartRow; uRow < uEndRow; )
+   {
+      uint64_t uBlock = pzone->get_block( uRow );
+      uint64_t uBlockEnd = std::min( ( uBlock + 1 ) * pzone->get_block_rows(), uEndRow );
+      if( pzone->match( uBlock, uKey, eFilterEqual, variantviewZone, variantviewZone ) != index_zone::eMatchNone )
+      {
+         int64_t iRow = find( uColumn, uRow, uBlockEnd - uRow, variantviewFind, tag_raw{} );
+         if( iRow != -1 ) return iRow;
+      }
+      uRow = uBlockEnd;
+   }
+
+   return -1;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief find value in column, all rows are read
+ * @param uColumn index to column to find value in
+ * @param uStartRow Row to start finding for value in
+ * @param uCount number of rows to find value
+ * @param variantviewFind value to find
+ * @return int64_t index for row if found, -1 if not found
+*/
+int64_t table_column_buffer::find( unsigned uColumn, uint64_t uStartRow, uint64_t uCount, const gd::variant_view& variantviewFind, tag_raw ) const noexcept
 {                                                                                                  assert( m_puData );
    auto& columnSet = m_vectorColumn[uColumn];                                                      assert( variantviewFind.type_number() == columnSet.ctype_number() );
    //const uint8_t* puFindValue = variantviewFind.data();
@@ -2540,22 +2810,46 @@ int64_t table_column_buffer::find( unsigned uColumn, uint64_t uStartRow, uint64_
       if( variantviewFind.is_64() == true )                                    // is value a 64 bit value
       {
          uint64_t uFind = *(uint64_t*)variantviewFind.data();
-         for( auto uRow = uStartRow; uRow < uEndRow; uRow++ )
+         const unsigned uStride = cell_get_stride( uColumn );                  // distance to value in next row
+         const uint8_t* puValue = cell_get( uStartRow, uColumn );
+         uint64_t uContiguousEnd = uStartRow + row_get_contiguous( uStartRow );// end of rows that are stored after each other
+         for( auto uRow = uStartRow; uRow < uEndRow; uRow++, puValue += uStride )
          {
-            auto uValue = *(const uint64_t*)cell_get( uRow, uColumn );
-            if( uValue == uFind ) return ( int64_t )uRow;
+            if( uRow == uContiguousEnd ) { puValue = cell_get( uRow, uColumn ); uContiguousEnd += row_get_contiguous( uRow ); }
+            auto uValue = *(const uint64_t*)puValue;
+            if( uValue == uFind && ( is_null() == false || cell_is_null( uRow, uColumn ) == false ) ) return ( int64_t )uRow;
          }
       }
       else
       {                                                                        // 32 bit value (remember that each value is at least 32 bit in table)
          uint32_t uFind = variantviewFind.as_uint();
-         for( auto uRow = uStartRow; uRow < uEndRow; uRow++ )
+         const unsigned uStride = cell_get_stride( uColumn );
+         const uint8_t* puValue = cell_get( uStartRow, uColumn );
+         uint64_t uContiguousEnd = uStartRow + row_get_contiguous( uStartRow );
+         for( auto uRow = uStartRow; uRow < uEndRow; uRow++, puValue += uStride )
          {
-            auto uValue = *(const uint32_t*)cell_get( uRow, uColumn );
-            if( uValue == uFind ) return ( int64_t )uRow;
+            if( uRow == uContiguousEnd ) { puValue = cell_get( uRow, uColumn ); uContiguousEnd += row_get_contiguous( uRow ); }
+            auto uValue = *(const uint32_t*)puValue;
+            if( uValue == uFind && ( is_null() == false || cell_is_null( uRow, uColumn ) == false ) ) return ( int64_t )uRow;
          }
       }
    }
+   else if( columnSet.is_reference() == true )
+   {
+      // ## values in reference column are stored once, compare code for value
+      int64_t iCode = m_references.find( variantviewFind );
+      if( iCode == -1 ) return -1;
+
+      uint64_t uEndRow = uStartRow + uCount;                                                       assert( uEndRow <= get_row_count() );
+      const unsigned uStride = cell_get_stride( uColumn );
+      const uint8_t* puValue = cell_get( uStartRow, uColumn );
+      uint64_t uContiguousEnd = uStartRow + row_get_contiguous( uStartRow );
+      for( auto uRow = uStartRow; uRow < uEndRow; uRow++, puValue += uStride )
+      {
+         if( uRow == uContiguousEnd ) { puValue = cell_get( uRow, uColumn ); uContiguousEnd += row_get_contiguous( uRow ); }
+         if( cell_get_code( puValue ) == (uint64_t)iCode && ( is_null() == false || cell_is_null( uRow, uColumn ) == false ) ) return ( int64_t )uRow;
+      }
+   }
    else
    {
       return find_variant_view( uColumn, uStartRow, uCount, variantviewFind );
@@ -2626,7 +2920,23 @@ int64_t table_column_buffer::find_variant_view( unsigned uColumn, bool bAscendin
 {
    uint64_t uLow = uStartRow;
    uint64_t uHigh = uStartRow + uCount;
-   
+
+   // ## with zone map search is limited to first block where value is within min and max, values are sorted so value can't be in other blocks
+   const index_zone* pzone = m_vectorIndex.empty() == false ? index_get_zone( uColumn ) : nullptr;
+   if( pzone != nullptr && m_vectorColumn[uColumn].is_reference() == false && variantviewFind.is_null() == false && uCount > 0 )
+   {
+      pzone->update();
+      const unsigned uKey = (unsigned)pzone->find_key( uColumn );
+      uint64_t uRow = uLow;
+      for( ; uRow < uHigh; uRow = ( pzone->get_block( uRow ) + 1 ) * pzone->get_block_rows() )
+      {
+         if( pzone->match( pzone->get_block( uRow ), uKey, eFilterEqual, variantviewFind, variantviewFind ) != index_zone::eMatchNone ) break;
+      }
+      if( uRow >= uHigh ) return -1;
+
+      uLow = uRow;
+      uHigh = std::min( ( pzone->get_block( uRow ) + 1 ) * pzone->get_block_rows(), uHigh );
+   }
 
    if( bAscending == true )
    {
@@ -2643,7 +2953,7 @@ int64_t table_column_buffer::find_variant_view( unsigned uColumn, bool bAscendin
          }
          else
          {
-            uHigh = uMid - 1;
+            uHigh = uMid;
          }
       }
    }
@@ -2662,7 +2972,7 @@ int64_t table_column_buffer::find_variant_view( unsigned uColumn, bool bAscendin
          }
          else
          {
-            uHigh = uMid - 1;
+            uHigh = uMid;
          }
       }
    }
@@ -2711,126 +3021,694 @@ range table_column_buffer::find_variant_view( unsigned uColumn, bool bAscending,
 }
 
 
-/** ---------------------------------------------------------------------------
- * @brief Finds first row that isn't marked as in use
- * @param uStartRow index where to start search for free row
- * @return 
-*/
-int64_t table_column_buffer::find_first_free_row( uint64_t uStartRow ) const
-{                                                                                                  assert( m_puMetaData != nullptr ); assert( is_rowstatus() == true );
-   auto uRowMetaSize = size_row_meta();
-   auto puPosition = m_puMetaData + uRowMetaSize - eSpaceRowState;             // set position for first row state value
-   puPosition += uStartRow * uRowMetaSize;                                     // move to specified start row
-   for( auto itRow = uStartRow; itRow < m_uReservedRowCount; itRow++ )
-   {
-#ifdef _DEBUG
-      auto uState_d = *reinterpret_cast<uint32_t*>( puPosition );
-#endif // _DEBUG
-      // if the use flag not set then row is free
-      if( (*reinterpret_cast<uint32_t*>( puPosition ) & eRowStateUse) == 0 ) return itRow;
-      puPosition += uRowMetaSize;                                              // move pointer to next row                                                        
-   }
+namespace {
 
-   return -1;
+#ifdef GD_X86
+/// check if cpu supports avx2, checked once
+bool filter_is_avx2_s()
+{
+#  if defined( __GNUC__ ) || defined( __clang__ )
+   static const bool bAvx2 = __builtin_cpu_supports( "avx2" );
+#  else
+   static const bool bAvx2 = []() {
+      int piInfo[4];
+      __cpuid( piInfo, 0 );
+      if( piInfo[0] < 7 ) return false;
+      __cpuid( piInfo, 1 );
+      if( ( piInfo[2] & ( 1 << 27 ) ) == 0 || ( _xgetbv( 0 ) & 0x6 ) != 0x6 ) return false;// os need to save ymm registers
+      __cpuidex( piInfo, 7, 0 );
+      return ( piInfo[1] & ( 1 << 5 ) ) != 0;
+   }();
+#  endif
+   return bAvx2;
+}
+#endif
+
+/// compare value against filter values, filter is resolved at compile time
+template<typename TYPE, enumFilter FILTER>
+inline bool filter_match_s( TYPE v_, TYPE v1_, TYPE v2_ )
+{
+   if constexpr( FILTER == eFilterEqual ) return v_ == v1_;
+   else if constexpr( FILTER == eFilterNotEqual ) return v_ != v1_;
+   else if constexpr( FILTER == eFilterLess ) return v_ < v1_;
+   else if constexpr( FILTER == eFilterLessEqual ) return v_ <= v1_;
+   else if constexpr( FILTER == eFilterGreater ) return v_ > v1_;
+   else if constexpr( FILTER == eFilterGreaterEqual ) return v_ >= v1_;
+   else return v_ >= v1_ && v_ <= v2_;                                          // eFilterBetween
 }
 
 /** ---------------------------------------------------------------------------
- * @brief Counts number of rows in use
- * Counts all rows that are marked as used in table
- * @note To run this method you row status has to be valid
- * @return uint64_t number of rows used in table
+ * @brief scalar filter, sets one bit for each value that match
+ * @param puValue pointer to first value
+ * @param uStride distance in bytes to next value
+ * @param uCount number of values to test
+ * @param puBit bits where result is written, one 64 bit word for each 64 values
  */
-uint64_t table_column_buffer::count_used_rows() const
-{                                                                                                  assert( is_rowstatus() == true );
-   uint64_t uRowCount = 0;
-   unsigned uRowMetaSize = size_row_meta();
-   const uint8_t* puPosition = m_puMetaData + uRowMetaSize - eSpaceRowState;   // set position for first row state value
-
-   for( uint64_t uRow = 0; uRow < m_uReservedRowCount; uRow++ )
+template<typename TYPE, enumFilter FILTER>
+void filter_scalar_s( const uint8_t* puValue, unsigned uStride, uint64_t uCount, TYPE v1_, TYPE v2_, uint64_t* puBit )
+{
+   for( uint64_t uRow = 0; uRow < uCount; uRow += 64 )
    {
-#ifdef _DEBUG
-      auto uState_d = *reinterpret_cast<const uint32_t*>( puPosition );
-#endif // _DEBUG
-      // if the use flag not set then row is free
-      if( (*reinterpret_cast<const uint32_t*>( puPosition ) & eRowStateUse) != 0 ) { uRowCount++; }
-      puPosition += uRowMetaSize;                                              // move pointer to next row                                                        
+      uint64_t uWord = 0;
+      unsigned uEnd = ( uCount - uRow ) < 64 ? (unsigned)( uCount - uRow ) : 64u;
+      for( unsigned u = 0; u < uEnd; u++, puValue += uStride )
+      {
+         uWord |= (uint64_t)filter_match_s<TYPE, FILTER>( *(const TYPE*)puValue, v1_, v2_ ) << u;
+      }
+      puBit[uRow >> 6] = uWord;
    }
+}
+
+#ifdef GD_X86
 
-   return uRowCount;
+/// load 8 (32 bit) or 4 (64 bit) values, values after each other are loaded directly and values in rows are gathered
+template<typename TYPE>
+GD_TARGET_AVX2 inline __m256i filter_avx2_load_s( const uint8_t* puValue, bool bPacked, __m256i iIndex )
+{
+   if( bPacked == true ) return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( puValue ) );
+   if constexpr( sizeof( TYPE ) == sizeof( uint32_t ) ) return _mm256_i32gather_epi32( reinterpret_cast<const int*>( puValue ), iIndex, 1 );
+   else                                                 return _mm256_i32gather_epi64( reinterpret_cast<const long long*>( puValue ), _mm256_castsi256_si128( iIndex ), 1 );
 }
 
-/** ---------------------------------------------------------------------------
- * @brief Counts free rows, rows without the mark for being used
- * @note To run this method you row status has to be valid
- * @return uint64_t number of free rows used in table
- */
-uint64_t table_column_buffer::count_free_rows() const
-{                                                                                                  assert( is_rowstatus() == true );
-   uint64_t uRowCount = 0;
-   unsigned uRowMetaSize = size_row_meta();
-   const uint8_t* puPosition = m_puMetaData + uRowMetaSize - eSpaceRowState;   // set position for first row state value
+template<unsigned SIZE>
+GD_TARGET_AVX2 inline __m256i filter_avx2_eq_s( __m256i i1, __m256i i2 ) { if constexpr( SIZE == 4 ) return _mm256_cmpeq_epi32( i1, i2 ); else return _mm256_cmpeq_epi64( i1, i2 ); }
+template<unsigned SIZE>
+GD_TARGET_AVX2 inline __m256i filter_avx2_gt_s( __m256i i1, __m256i i2 ) { if constexpr( SIZE == 4 ) return _mm256_cmpgt_epi32( i1, i2 ); else return _mm256_cmpgt_epi64( i1, i2 ); }
 
-   for( uint64_t uRow = 0; uRow < m_uReservedRowCount; uRow++ )
+/// compare loaded values and return one bit for each value that match filter
+template<typename TYPE, enumFilter FILTER>
+GD_TARGET_AVX2 inline unsigned filter_avx2_mask_s( __m256i iValue, __m256i i1, __m256i i2 )
+{
+   constexpr unsigned uSize = sizeof( TYPE );
+   if constexpr( std::is_floating_point_v<TYPE> == true )
    {
-#ifdef _DEBUG
-      auto uState_d = *reinterpret_cast<const uint32_t*>( puPosition );
-#endif // _DEBUG
-      // if the use flag not set then row is free
-      if( (*reinterpret_cast<const uint32_t*>( puPosition ) & eRowStateUse) == 0 ) { uRowCount++; }
-      puPosition += uRowMetaSize;                                              // move pointer to next row                                                        
+      // ## decimal values, predicates are ordered except != that is true for NaN (same as scalar compare)
+      constexpr int iPredicate = FILTER == eFilterEqual ? _CMP_EQ_OQ : FILTER == eFilterNotEqual ? _CMP_NEQ_UQ : FILTER == eFilterLess ? _CMP_LT_OQ :
+                                 FILTER == eFilterLessEqual ? _CMP_LE_OQ : FILTER == eFilterGreater ? _CMP_GT_OQ : _CMP_GE_OQ;
+      if constexpr( uSize == 4 )
+      {
+         __m256 dValue = _mm256_castsi256_ps( iValue );
+         if constexpr( FILTER == eFilterBetween ) return (unsigned)_mm256_movemask_ps( _mm256_and_ps( _mm256_cmp_ps( dValue, _mm256_castsi256_ps( i1 ), _CMP_GE_OQ ), _mm256_cmp_ps( dValue, _mm256_castsi256_ps( i2 ), _CMP_LE_OQ ) ) );
+         else                                     return (unsigned)_mm256_movemask_ps( _mm256_cmp_ps( dValue, _mm256_castsi256_ps( i1 ), iPredicate ) );
+      }
+      else
+      {
+         __m256d dValue = _mm256_castsi256_pd( iValue );
+         if constexpr( FILTER == eFilterBetween ) return (unsigned)_mm256_movemask_pd( _mm256_and_pd( _mm256_cmp_pd( dValue, _mm256_castsi256_pd( i1 ), _CMP_GE_OQ ), _mm256_cmp_pd( dValue, _mm256_castsi256_pd( i2 ), _CMP_LE_OQ ) ) );
+         else                                     return (unsigned)_mm256_movemask_pd( _mm256_cmp_pd( dValue, _mm256_castsi256_pd( i1 ), iPredicate ) );
+      }
    }
+   else
+   {
+      // ## integer values, only equal and greater are available so other filters are built from these
+      __m256i iMatch;
+      bool bInvert = false;
+      if constexpr( FILTER == eFilterEqual )             { iMatch = filter_avx2_eq_s<uSize>( iValue, i1 ); }
+      else if constexpr( FILTER == eFilterNotEqual )     { iMatch = filter_avx2_eq_s<uSize>( iValue, i1 ); bInvert = true; }
+      else if constexpr( FILTER == eFilterLess )         { iMatch = filter_avx2_gt_s<uSize>( i1, iValue ); }
+      else if constexpr( FILTER == eFilterLessEqual )    { iMatch = filter_avx2_gt_s<uSize>( iValue, i1 ); bInvert = true; }
+      else if constexpr( FILTER == eFilterGreater )      { iMatch = filter_avx2_gt_s<uSize>( iValue, i1 ); }
+      else if constexpr( FILTER == eFilterGreaterEqual ) { iMatch = filter_avx2_gt_s<uSize>( i1, iValue ); bInvert = true; }
+      else                                               { iMatch = _mm256_or_si256( filter_avx2_gt_s<uSize>( i1, iValue ), filter_avx2_gt_s<uSize>( iValue, i2 ) ); bInvert = true; }
 
-   return uRowCount;
+      unsigned uMask;
+      if constexpr( uSize == 4 ) uMask = (unsigned)_mm256_movemask_ps( _mm256_castsi256_ps( iMatch ) );
+      else                       uMask = (unsigned)_mm256_movemask_pd( _mm256_castsi256_pd( iMatch ) );
+      return bInvert == false ? uMask : uMask ^ ( ( 1u << ( 32 / uSize ) ) - 1 );
+   }
 }
 
 /** ---------------------------------------------------------------------------
- * @brief Fill column with values
- * @param uColumn index for column that is filled with values
- * @param variantviewValue value to fill cells in column with
- * @param uFromRow from row index value are inserted to
- * @param uToRow to row index value are inserted to
-*/
-void table_column_buffer::column_fill( unsigned uColumn, const gd::variant_view& variantviewValue, uint64_t uFromRow, uint64_t uToRow )
-{                                                                                                  assert( uFromRow >= 0 && uFromRow < m_uRowCount ); assert( uToRow >= 0 && uToRow <= m_uRowCount ); assert( uFromRow <= uToRow );
-   for( auto uRow = uFromRow; uRow < uToRow; uRow++ )
+ * @brief avx2 filter for 32 and 64 bit values, rows after last full block of 64 rows are filtered with scalar code
+ * Unsigned values are compared as signed after the sign bit is flipped.
+ */
+template<typename TYPE, enumFilter FILTER>
+GD_TARGET_AVX2 void filter_avx2_s( const uint8_t* puValue, unsigned uStride, uint64_t uCount, TYPE v1_, TYPE v2_, uint64_t* puBit )
+{                                                                                                  static_assert( sizeof( TYPE ) == 4 || sizeof( TYPE ) == 8 ); assert( uStride < 0x1000'0000 );
+   constexpr unsigned uLane = 32 / sizeof( TYPE );                             // values in each register
+   const bool bPacked = uStride == sizeof( TYPE );
+   const int iStride = (int)uStride;
+   __m256i iIndex = uLane == 8 ? _mm256_setr_epi32( 0, iStride, 2 * iStride, 3 * iStride, 4 * iStride, 5 * iStride, 6 * iStride, 7 * iStride ) : _mm256_setr_epi32( 0, iStride, 2 * iStride, 3 * iStride, 0, 0, 0, 0 );
+
+   // ## filter values to registers, unsigned values are moved to signed range
+   __m256i i1, i2, iSign;
+   if constexpr( sizeof( TYPE ) == 4 )
    {
-      cell_set( uRow, uColumn, variantviewValue );
+      int32_t i1_, i2_;
+      memcpy( &i1_, &v1_, sizeof( TYPE ) ); memcpy( &i2_, &v2_, sizeof( TYPE ) );
+      iSign = _mm256_set1_epi32( (int32_t)0x8000'0000u );
+      i1 = _mm256_set1_epi32( i1_ ); i2 = _mm256_set1_epi32( i2_ );
+   }
+   else
+   {
+      long long i1_, i2_;
+      memcpy( &i1_, &v1_, sizeof( TYPE ) ); memcpy( &i2_, &v2_, sizeof( TYPE ) );
+      iSign = _mm256_set1_epi64x( (long long)0x8000'0000'0000'0000ull );
+      i1 = _mm256_set1_epi64x( i1_ ); i2 = _mm256_set1_epi64x( i2_ );
+   }
+   constexpr bool bUnsigned = std::is_unsigned_v<TYPE>;
+   if constexpr( bUnsigned == true ) { i1 = _mm256_xor_si256( i1, iSign ); i2 = _mm256_xor_si256( i2, iSign ); }
+
+   const uint64_t uBlockCount = uCount / 64;
+   for( uint64_t uBlock = 0; uBlock < uBlockCount; uBlock++ )
+   {
+      uint64_t uWord = 0;
+      for( unsigned u = 0; u < 64; u += uLane )
+      {
+         __m256i iValue = filter_avx2_load_s<TYPE>( puValue, bPacked, iIndex );
+         if constexpr( bUnsigned == true ) iValue = _mm256_xor_si256( iValue, iSign );
+         uWord |= (uint64_t)filter_avx2_mask_s<TYPE, FILTER>( iValue, i1, i2 ) << u;
+         puValue += (uint64_t)uLane * uStride;
+      }
+      puBit[uBlock] = uWord;
    }
+
+   if( ( uCount % 64 ) != 0 ) filter_scalar_s<TYPE, FILTER>( puValue, uStride, uCount % 64, v1_, v2_, puBit + uBlockCount );
 }
 
-/** ---------------------------------------------------------------------------
- * @brief Fill column with values, if column values do not match type it tries to convert to proper type
- * @param uColumn index for column that is filled with values
- * @param variantviewValue value to fill cells in column with
- * @param uFromRow from row index value are inserted to
- * @param uToRow to row index value are inserted to
-*/
-void table_column_buffer::column_fill( unsigned uColumn, const gd::variant_view& variantviewValue, uint64_t uFromRow, uint64_t uToRow, tag_convert )
-{                                                                                                  assert( uFromRow >= 0 && uFromRow < get_row_count() ); assert( uToRow >= 0 && uToRow <= get_row_count() ); assert( uFromRow <= uToRow );
-   const auto& columnSet = m_vectorColumn[uColumn];                                                assert( columnSet.position() < m_uRowSize );
-   auto uColumnType = columnSet.ctype_number();
-   gd::variant variantConvertTo;
-   bool bOk = variantviewValue.convert_to( uColumnType,  variantConvertTo );
+#endif // GD_X86
 
-   for( auto uRow = uFromRow; uRow < uToRow; uRow++ )
+/// run filter with avx2 if cpu supports it and type is 32 or 64 bit, otherwise scalar
+template<typename TYPE, enumFilter FILTER>
+void filter_run_s( const uint8_t* puValue, unsigned uStride, uint64_t uCount, TYPE v1_, TYPE v2_, uint64_t* puBit )
+{
+#ifdef GD_X86
+   if constexpr( sizeof( TYPE ) == 4 || sizeof( TYPE ) == 8 )
    {
-      cell_set( uRow, uColumn, *(gd::variant_view*)&variantConvertTo );
+      if( filter_is_avx2_s() == true ) { filter_avx2_s<TYPE, FILTER>( puValue, uStride, uCount, v1_, v2_, puBit ); return; }
    }
+#endif
+   filter_scalar_s<TYPE, FILTER>( puValue, uStride, uCount, v1_, v2_, puBit );
 }
 
-
-/** ---------------------------------------------------------------------------
- * @brief Fill column with values
- * @param uColumn index for column that is filled with values
- * @param pvariantviewValue pointer to variant buffer holding values to insert to column
- * @param uCount number of items in variant buffer
- * @param uFromRow from row index value are inserted to
-*/
-void table_column_buffer::column_fill( unsigned uColumn, const gd::variant_view* pvariantviewValue, size_t uCount, uint64_t uFromRow )
-{                                                                                                  assert( uFromRow >= 0 && uFromRow < m_uRowCount ); assert( (uFromRow + uCount) <= m_uRowCount ); 
-   for( auto uIndex = 0; uIndex < uCount; uIndex++ )
+/// select filter implementation for filter operator
+template<typename TYPE>
+void filter_typed_s( const uint8_t* puValue, unsigned uStride, uint64_t uCount, enumFilter eFilter, TYPE v1_, TYPE v2_, uint64_t* puBit )
+{
+   switch( eFilter )
    {
-      cell_set( uFromRow + uIndex, uColumn, pvariantviewValue[uIndex]);
+   case eFilterEqual:        filter_run_s<TYPE, eFilterEqual>( puValue, uStride, uCount, v1_, v2_, puBit ); break;
+   case eFilterNotEqual:     filter_run_s<TYPE, eFilterNotEqual>( puValue, uStride, uCount, v1_, v2_, puBit ); break;
+   case eFilterLess:         filter_run_s<TYPE, eFilterLess>( puValue, uStride, uCount, v1_, v2_, puBit ); break;
+   case eFilterLessEqual:    filter_run_s<TYPE, eFilterLessEqual>( puValue, uStride, uCount, v1_, v2_, puBit ); break;
+   case eFilterGreater:      filter_run_s<TYPE, eFilterGreater>( puValue, uStride, uCount, v1_, v2_, puBit ); break;
+   case eFilterGreaterEqual: filter_run_s<TYPE, eFilterGreaterEqual>( puValue, uStride, uCount, v1_, v2_, puBit ); break;
+   case eFilterBetween:      filter_run_s<TYPE, eFilterBetween>( puValue, uStride, uCount, v1_, v2_, puBit ); break;
+   default: assert( false );
+   }
+}
+
+/// filter value converted to column type, `iSide` is -1 if value is below range for type and 1 if above
+template<typename TYPE>
+struct filter_bound
+{
+   int iSide;
+   TYPE value_;
+};
+
+/// convert decimal value without fraction to bound for column type
+template<typename TYPE>
+filter_bound<TYPE> filter_bound_s( double dValue )
+{
+   if( dValue < (double)std::numeric_limits<TYPE>::lowest() ) return { -1, TYPE() };
+   if( dValue >= (double)std::numeric_limits<TYPE>::max() + 1.0 ) return { 1, TYPE() };  // max + 1 is exact also for 64 bit types
+   return { 0, (TYPE)dValue };
+}
+
+/// convert integer value to bound for column type
+template<typename TYPE, typename VALUE>
+filter_bound<TYPE> filter_bound_s( VALUE value_, tag_raw )
+{
+   if( std::cmp_less( value_, std::numeric_limits<TYPE>::lowest() ) == true ) return { -1, TYPE() };
+   if( std::cmp_greater( value_, std::numeric_limits<TYPE>::max() ) == true ) return { 1, TYPE() };
+   return { 0, (TYPE)value_ };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Get closest values in column type below and above filter value
+ * Both bounds are the same if filter value can be stored in column type.
+ * @param v_ filter value
+ * @param floor_ highest value in column type that is less or equal to filter value
+ * @param ceil_ lowest value in column type that is greater or equal to filter value
+*/
+template<typename TYPE>
+void filter_bound_s( const gd::variant_view& v_, filter_bound<TYPE>& floor_, filter_bound<TYPE>& ceil_ )
+{
+   if constexpr( std::is_floating_point_v<TYPE> == true )
+   {
+      double dValue = v_.as_double();
+      TYPE value_ = (TYPE)dValue;
+      floor_ = { 0, value_ };
+      ceil_ = { 0, value_ };
+      if( (double)value_ > dValue )      floor_.value_ = std::nextafter( value_, -std::numeric_limits<TYPE>::infinity() );
+      else if( (double)value_ < dValue ) ceil_.value_ = std::nextafter( value_, std::numeric_limits<TYPE>::infinity() );
+   }
+   else if( v_.is_integer() == true || v_.is_bool() == true )
+   {
+      if( v_.type_number() == gd::types::eTypeNumberUInt64 ) floor_ = filter_bound_s<TYPE>( v_.as_uint64(), tag_raw{} );
+      else                                                   floor_ = filter_bound_s<TYPE>( v_.as_int64(), tag_raw{} );
+      ceil_ = floor_;
+   }
+   else
+   {
+      double dValue = v_.as_double();                                                              assert( std::isnan( dValue ) == false );
+      floor_ = filter_bound_s<TYPE>( std::floor( dValue ) );
+      ceil_ = filter_bound_s<TYPE>( std::ceil( dValue ) );
+   }
+}
+
+/// set bits for all or no values
+inline void filter_fill_s( uint64_t uCount, bool bMatch, uint64_t* puBit )
+{
+   for( uint64_t uRow = 0; uRow < uCount; uRow += 64 )
+   {
+      uint64_t uRest = uCount - uRow;
+      puBit[uRow >> 6] = bMatch == false ? 0 : ( uRest >= 64 ? ~0ULL : ( 1ULL << uRest ) - 1 );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Convert filter values to column type and run filter
+ *
+ * Filter values are not truncated to column type. Values with fraction or
+ * outside range for column type change the bound and operator so result is the
+ * same as comparing each value at full precision, `v < 2.5` is `v < 3` for
+ * integers and `v == 300` matches nothing in int8 column. Operators that always
+ * or never match set all bits without reading values.
+*/
+template<typename TYPE>
+void filter_bound_run_s( const uint8_t* puValue, unsigned uStride, uint64_t uCount, enumFilter eFilter, const gd::variant_view& v1_, const gd::variant_view& v2_, uint64_t* puBit )
+{
+   if constexpr( std::is_floating_point_v<TYPE> == false )
+   {
+      if( ( v1_.is_decimal() == true && std::isnan( v1_.as_double() ) == true ) || ( eFilter == eFilterBetween && v2_.is_decimal() == true && std::isnan( v2_.as_double() ) == true ) )
+      {
+         filter_fill_s( uCount, eFilter == eFilterNotEqual, puBit );              // NaN is only not equal to values
+         return;
+      }
+   }
+
+   filter_bound<TYPE> floor1_, ceil1_;
+   filter_bound_s<TYPE>( v1_, floor1_, ceil1_ );
+   const bool bExact = floor1_.iSide == 0 && ceil1_.iSide == 0 && floor1_.value_ == ceil1_.value_;
+
+   switch( eFilter )
+   {
+   case eFilterEqual:
+      if( bExact == true ) filter_typed_s<TYPE>( puValue, uStride, uCount, eFilter, floor1_.value_, floor1_.value_, puBit );
+      else                 filter_fill_s( uCount, false, puBit );
+      break;
+   case eFilterNotEqual:
+      if( bExact == true ) filter_typed_s<TYPE>( puValue, uStride, uCount, eFilter, floor1_.value_, floor1_.value_, puBit );
+      else                 filter_fill_s( uCount, true, puBit );
+      break;
+   case eFilterLess:                                                           // v < c is v < ceil(c)
+   case eFilterGreaterEqual:                                                   // v >= c is v >= ceil(c)
+      if( ceil1_.iSide != 0 ) filter_fill_s( uCount, ( ceil1_.iSide > 0 ) == ( eFilter == eFilterLess ), puBit );
+      else                    filter_typed_s<TYPE>( puValue, uStride, uCount, eFilter, ceil1_.value_, ceil1_.value_, puBit );
+      break;
+   case eFilterLessEqual:                                                      // v <= c is v <= floor(c)
+   case eFilterGreater:                                                        // v > c is v > floor(c)
+      if( floor1_.iSide != 0 ) filter_fill_s( uCount, ( floor1_.iSide > 0 ) == ( eFilter == eFilterLessEqual ), puBit );
+      else                     filter_typed_s<TYPE>( puValue, uStride, uCount, eFilter, floor1_.value_, floor1_.value_, puBit );
+      break;
+   case eFilterBetween:
+   {
+      filter_bound<TYPE> floor2_, ceil2_;
+      filter_bound_s<TYPE>( v2_, floor2_, ceil2_ );
+      if( ceil1_.iSide > 0 || floor2_.iSide < 0 ) { filter_fill_s( uCount, false, puBit ); break; }
+      TYPE lower_ = ceil1_.iSide < 0 ? std::numeric_limits<TYPE>::lowest() : ceil1_.value_;
+      TYPE upper_ = floor2_.iSide > 0 ? std::numeric_limits<TYPE>::max() : floor2_.value_;
+      filter_typed_s<TYPE>( puValue, uStride, uCount, eFilter, lower_, upper_, puBit );
+   }
+   break;
+   default: assert( false );
+   }
+}
+
+/// run filter for column type, returns false if column type is not a primitive number
+bool filter_number_s( const uint8_t* puValue, unsigned uStride, uint64_t uCount, unsigned uTypeNumber, enumFilter eFilter, const gd::variant_view& v1_, const gd::variant_view& v2_, uint64_t* puBit )
+{
+   switch( uTypeNumber )
+   {
+   case gd::types::eTypeNumberBool:
+   case gd::types::eTypeNumberUInt8:  filter_bound_run_s<uint8_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberInt8:   filter_bound_run_s<int8_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberUInt16: filter_bound_run_s<uint16_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberInt16:  filter_bound_run_s<int16_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberUInt32: filter_bound_run_s<uint32_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberInt32:  filter_bound_run_s<int32_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberUInt64: filter_bound_run_s<uint64_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberInt64:  filter_bound_run_s<int64_t>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberFloat:  filter_bound_run_s<float>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   case gd::types::eTypeNumberDouble: filter_bound_run_s<double>( puValue, uStride, uCount, eFilter, v1_, v2_, puBit ); break;
+   default: return false;
+   }
+   return true;
+}
+
+/// compare values that are not primitive numbers (text, binary, reference values)
+bool filter_variant_view_s( const gd::variant_view& v_, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue )
+{                                                                                                  assert( vectorValue.empty() == false );
+   const auto& v1_ = vectorValue[0];
+   switch( eFilter )
+   {
+   case eFilterEqual:        return v_ == v1_;
+   case eFilterNotEqual:     return v_ != v1_;
+   case eFilterLess:         return v_ < v1_;
+   case eFilterLessEqual:    return ( v1_ < v_ ) == false;
+   case eFilterGreater:      return v1_ < v_;
+   case eFilterGreaterEqual: return ( v_ < v1_ ) == false;
+   case eFilterBetween:      return ( v_ < v1_ ) == false && ( vectorValue[1] < v_ ) == false;
+   case eFilterIn:           for( const auto& it : vectorValue ) { if( v_ == it ) return true; } return false;
+   default: assert( false );
+   }
+   return false;
+}
+
+} // namespace
+
+/** ---------------------------------------------------------------------------
+ * @brief filter rows on value in column, rows that match are marked in selection
+ *
+ * Columns with primitive number types are filtered with avx2 if cpu supports it
+ * (scalar code otherwise). Values in columnar tables are loaded directly and
+ * values in row based tables are gathered. Filter values are converted to column
+ * type. Reference columns compare codes for values with equal, not equal and in
+ * filters. Null cells only match `eFilterNull`. If column has zone map, blocks
+ * where no value can match are skipped.
+ * @code
+gd::table::selection selectionRow;
+table.filter( 0, gd::table::eFilterBetween, { 10, 20 }, selectionRow );
+table.filter( 1, gd::table::eFilterIn, { "A", "B", "C" }, selectionRow, true ); // AND with rows selected in column 0
+ * @endcode
+ * @param uColumn index for column to filter
+ * @param eFilter filter operator
+ * @param vectorValue values used by filter, two values for `eFilterBetween`, list for `eFilterIn`, none for null filters and one for other
+ * @param selectionResult selection that gets matching rows (resized to number of rows in table)
+*/
+void table_column_buffer::filter( unsigned uColumn, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue, selection& selectionResult ) const
+{                                                                                                  assert( uColumn < get_column_count() ); assert( eFilter <= eFilterNotNull );
+   const uint64_t uRowCount = get_row_count();
+   selectionResult.reset( uRowCount );
+   if( uRowCount == 0 ) return;
+
+   uint64_t* puBit = selectionResult.data();
+
+   // ## null filters only read null bits
+   if( eFilter == eFilterNull || eFilter == eFilterNotNull )
+   {
+      if( is_null() == true )
+      {
+         if( is_columnar() == true ) { memcpy( puBit, column_get_null( uColumn ), selectionResult.m_vectorBit.size() * sizeof( uint64_t ) ); }
+         else { for( uint64_t uRow = 0; uRow < uRowCount; uRow++ ) { if( cell_is_null( uRow, uColumn ) == true ) selectionResult.set( uRow ); } }
+      }
+      if( eFilter == eFilterNotNull ) selectionResult.invert();
+      else if( ( uRowCount & 63 ) != 0 ) selectionResult.m_vectorBit.back() &= ( 1ULL << ( uRowCount & 63 ) ) - 1;
+      return;
+   }
+                                                                                                   assert( vectorValue.empty() == false ); assert( eFilter != eFilterBetween || vectorValue.size() == 2 );
+   const auto& columnFilter = m_vectorColumn[uColumn];
+   const unsigned uStride = cell_get_stride( uColumn );
+   bool bNumber = columnFilter.is_fixed() == true && gd::types::is_primitive_g( columnFilter.ctype() ) == true;
+
+   // ## zone map for column, blocks where no value match are skipped and blocks where all values match are selected without reading values
+   const index_zone* pzone = m_vectorIndex.empty() == false ? index_get_zone( uColumn ) : nullptr;
+   const unsigned uKey = pzone != nullptr ? (unsigned)pzone->find_key( uColumn ) : 0;
+   if( pzone != nullptr ) pzone->update();
+
+   // filter number values in runs of rows stored after each other, segmented tables have one run for each segment
+   auto filter_number_ = [&]( unsigned uTypeNumber, enumFilter eFilterRun, const gd::variant_view& v1_, const gd::variant_view& v2_, uint64_t* puBitRun ) -> bool
+   {
+      for( uint64_t uRow = 0; uRow < uRowCount; )
+      {
+         uint64_t uCount = std::min( row_get_contiguous( uRow ), uRowCount - uRow );                assert( uRow % 64 == 0 ); // segments are multiple of 64 rows
+         if( pzone != nullptr )
+         {
+            uint64_t uBlock = pzone->get_block( uRow );
+            uCount = std::min( uCount, ( uBlock + 1 ) * pzone->get_block_rows() - uRow );
+            auto eMatch = pzone->match( uBlock, uKey, eFilterRun, v1_, v2_ );
+            if( eMatch != index_zone::eMatchSome )
+            {
+               uint64_t* puWord = puBitRun + uRow / 64;
+               for( uint64_t u = 0; u < uCount; u += 64, puWord++ )
+               {
+                  *puWord = eMatch == index_zone::eMatchNone ? 0 : ( uCount - u >= 64 ? ~0ULL : ( 1ULL << ( uCount - u ) ) - 1 );
+               }
+               uRow += uCount;
+               continue;
+            }
+         }
+         if( filter_number_s( cell_get( uRow, uColumn ), uStride, uCount, uTypeNumber, eFilterRun, v1_, v2_, puBitRun + uRow / 64 ) == false ) return false;
+         uRow += uCount;
+      }
+      return true;
+   };
+
+   if( columnFilter.is_reference() == true && ( eFilter == eFilterEqual || eFilter == eFilterNotEqual || eFilter == eFilterIn ) )
+   {
+      // ## values in reference columns are stored once, codes for values are compared
+      unsigned uCodeType = is_dictionary() == true ? gd::types::eTypeNumberUInt32 : gd::types::eTypeNumberUInt64;
+      std::vector<uint64_t> vectorBit( selectionResult.m_vectorBit.size() );
+      for( const auto& it : vectorValue )
+      {
+         int64_t iCode = m_references.find( it );
+         if( iCode != -1 )
+         {
+            gd::variant_view variantviewCode( (uint64_t)iCode );
+            filter_number_( uCodeType, eFilterEqual, variantviewCode, variantviewCode, vectorBit.data() );
+            for( std::size_t u = 0; u < vectorBit.size(); u++ ) puBit[u] |= vectorBit[u];
+         }
+         if( eFilter != eFilterIn ) break;                                     // equal and not equal use first value
+      }
+
+      if( eFilter == eFilterNotEqual ) selectionResult.invert();
+      bNumber = true;                                                          // null values are removed below
+   }
+   else if( bNumber == true && eFilter == eFilterIn )
+   {
+      // ## in list for numbers, each value is filtered and result is combined
+      std::vector<uint64_t> vectorBit( selectionResult.m_vectorBit.size() );
+      for( const auto& it : vectorValue )
+      {
+         bNumber = filter_number_( columnFilter.ctype_number(), eFilterEqual, it, it, vectorBit.data() );
+         if( bNumber == false ) break;
+         for( std::size_t u = 0; u < vectorBit.size(); u++ ) puBit[u] |= vectorBit[u];
+      }
+   }
+   else if( bNumber == true )
+   {
+      const auto& v2_ = vectorValue.size() > 1 ? vectorValue[1] : vectorValue[0];
+      bNumber = filter_number_( columnFilter.ctype_number(), eFilter, vectorValue[0], v2_, puBit );
+   }
+
+   if( bNumber == false )
+   {
+      // ## types that are not numbers are compared as variant_view values
+      selectionResult.reset( uRowCount );
+      puBit = selectionResult.data();
+      for( uint64_t uRow = 0; uRow < uRowCount; uRow++ )
+      {
+         auto variantviewValue = cell_get_variant_view( uRow, uColumn );
+         if( variantviewValue.is_null() == false && filter_variant_view_s( variantviewValue, eFilter, vectorValue ) == true ) selectionResult.set( uRow );
+      }
+      return;
+   }
+
+   // ## remove null values from result
+   if( is_null() == true )
+   {
+      if( is_columnar() == true )
+      {
+         const uint64_t* puNull = column_get_null( uColumn );
+         for( std::size_t u = 0, uMax = selectionResult.m_vectorBit.size(); u < uMax; u++ ) puBit[u] &= ~puNull[u];
+      }
+      else
+      {
+         for( uint64_t uRow = 0; uRow < uRowCount; uRow++ ) { if( cell_is_null( uRow, uColumn ) == true ) selectionResult.clear( uRow ); }
+      }
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief filter rows and combine result with rows already selected
+ * @param uColumn index for column to filter
+ * @param eFilter filter operator
+ * @param vectorValue values used by filter
+ * @param selectionResult selection that is combined with filter result
+ * @param bAnd true to keep rows that are selected in both (AND), false to add matching rows (OR)
+*/
+void table_column_buffer::filter( unsigned uColumn, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue, selection& selectionResult, bool bAnd ) const
+{                                                                                                  assert( selectionResult.size() == get_row_count() );
+   selection selectionFilter;
+   filter( uColumn, eFilter, vectorValue, selectionFilter );
+   if( bAnd == true ) selectionResult &= selectionFilter;
+   else               selectionResult |= selectionFilter;
+}
+
+
+/** ---------------------------------------------------------------------------
+ * @brief Finds first row that isn't marked as in use
+ * @param uStartRow index where to start search for free row
+ * @return 
+*/
+int64_t table_column_buffer::find_first_free_row( uint64_t uStartRow ) const
+{                                                                                                  assert( m_puMetaData != nullptr ); assert( is_rowstatus() == true );
+   if( uStartRow >= m_uReservedRowCount ) return -1;
+   if( m_bRowFree == false || m_selectionRowFree.size() != m_uReservedRowCount ) row_free_build();
+   if( m_uRowFreeCount == 0 ) return -1;
+
+   const uint64_t* puBit = m_selectionRowFree.data();
+   const uint64_t uWordCount = ( m_uReservedRowCount + 63 ) / 64;
+   bool bFromFirst = uStartRow <= ( m_uRowFreeFirst << 6 );                    // no free rows are skipped before first word with free rows
+   uint64_t uWord = uStartRow >> 6;
+   uint64_t uBits = puBit[uWord] & ( ~0ULL << ( uStartRow & 63 ) );
+   if( uWord < m_uRowFreeFirst ) { uWord = m_uRowFreeFirst; uBits = uWord < uWordCount ? puBit[uWord] : 0; }
+
+   while( uBits == 0 )
+   {
+      uWord++;
+      if( uWord >= uWordCount ) return -1;
+      uBits = puBit[uWord];
+   }
+
+   if( bFromFirst == true ) m_uRowFreeFirst = uWord;                           // words before do not have free rows
+   return (int64_t)( ( uWord << 6 ) + (uint64_t)std::countr_zero( uBits ) );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Counts number of rows in use
+ * Counts all rows that are marked as used in table, count is taken from free
+ * row bitmap that is built first time rows are counted
+ * @return number of rows in use
+*/
+uint64_t table_column_buffer::count_used_rows() const
+{                                                                                                  assert( is_rowstatus() == true );
+   if( m_bRowFree == false || m_selectionRowFree.size() != m_uReservedRowCount ) row_free_build();
+   return m_uReservedRowCount - m_uRowFreeCount;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Counts free rows, rows without the mark for being used
+ * @return number of free rows in reserved rows
+*/
+uint64_t table_column_buffer::count_free_rows() const
+{                                                                                                  assert( is_rowstatus() == true );
+   if( m_bRowFree == false || m_selectionRowFree.size() != m_uReservedRowCount ) row_free_build();
+   return m_uRowFreeCount;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Build bitmap with free rows, rows without flag `eRowStateUse`
+ *
+ * Bitmap is used to find free rows and count rows without reading row state
+ * for each row. When row state is changed with `row_set_state` bitmap and
+ * counters are updated. Operations that move rows (erase, sort, swap, vacuum)
+ * mark bitmap as invalid and it is built again next time it is needed.
+*/
+void table_column_buffer::row_free_build() const
+{                                                                                                  assert( is_rowstatus() == true );
+   m_selectionRowFree.reset( m_uReservedRowCount );
+   m_uRowFreeCount = 0;
+   m_uRowFreeFirst = 0;
+   m_bRowFree = true;
+   if( m_uReservedRowCount == 0 || m_puMetaData == nullptr ) return;
+
+   unsigned uRowMetaSize = row_get_state_stride();
+   const uint8_t* puPosition = reinterpret_cast<const uint8_t*>( row_get_state( 0 ) );// set position for first row state value
+   uint64_t uContiguousEnd = row_get_contiguous( 0 );                          // end of rows that are stored after each other
+
+   for( uint64_t uRow = 0; uRow < m_uReservedRowCount; uRow++ )
+   {
+      if( uRow == uContiguousEnd ) { puPosition = reinterpret_cast<const uint8_t*>( row_get_state( uRow ) ); uContiguousEnd += row_get_contiguous( uRow ); }
+      if( (*reinterpret_cast<const uint32_t*>( puPosition ) & eRowStateUse) == 0 ) { m_selectionRowFree.set( uRow ); m_uRowFreeCount++; }
+      puPosition += uRowMetaSize;                                              // move pointer to next row
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Move rows in use to start of table and remove rows that are not in use
+ *
+ * Rows marked with `eRowStateUse` are moved in one pass and keep their order,
+ * row count is set to number of used rows and values in references that no
+ * cell uses are removed.
+ * @code
+table.row_set_state( 10, gd::table::dto::table::eRowStateDeleted );            // row 10 is not used
+auto uRemoved = table.vacuum();                                                // uRemoved = 1, row 11 is now row 10
+ * @endcode
+ * @return uint64_t number of removed rows
+*/
+uint64_t table_column_buffer::vacuum()
+{                                                                                                  assert( is_rowstatus() == true );
+   uint64_t uRowCount = get_row_count();
+   uint64_t uUseCount = 0;                                                     // rows in use, also position where next row in use is moved to
+   for( uint64_t uRow = 0; uRow < uRowCount; uRow++ )
+   {
+      if( row_is_use( uRow ) == false ) continue;
+      if( uRow != uUseCount ) row_set( uUseCount, uRow );
+      uUseCount++;
+   }
+
+   uint64_t uRemoved = uRowCount - uUseCount;
+   if( uRemoved > 0 )
+   {
+      for( uint64_t uRow = uUseCount; uRow < uRowCount; uRow++ ) row_set_state( uRow, 0 );// rows after used rows are free
+      set_row_count( uUseCount );
+   }
+
+   references_compact();
+   m_bRowFree = false;
+   return uRemoved;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Fill column with values
+ * @param uColumn index for column that is filled with values
+ * @param variantviewValue value to fill cells in column with
+ * @param uFromRow from row index value are inserted to
+ * @param uToRow to row index value are inserted to
+*/
+void table_column_buffer::column_fill( unsigned uColumn, const gd::variant_view& variantviewValue, uint64_t uFromRow, uint64_t uToRow )
+{                                                                                                  assert( uFromRow >= 0 && uFromRow < m_uRowCount ); assert( uToRow >= 0 && uToRow <= m_uRowCount ); assert( uFromRow <= uToRow );
+   for( auto uRow = uFromRow; uRow < uToRow; uRow++ )
+   {
+      cell_set( uRow, uColumn, variantviewValue );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Fill column with values, if column values do not match type it tries to convert to proper type
+ * @param uColumn index for column that is filled with values
+ * @param variantviewValue value to fill cells in column with
+ * @param uFromRow from row index value are inserted to
+ * @param uToRow to row index value are inserted to
+*/
+void table_column_buffer::column_fill( unsigned uColumn, const gd::variant_view& variantviewValue, uint64_t uFromRow, uint64_t uToRow, tag_convert )
+{                                                                                                  assert( uFromRow >= 0 && uFromRow < get_row_count() ); assert( uToRow >= 0 && uToRow <= get_row_count() ); assert( uFromRow <= uToRow );
+   const auto& columnSet = m_vectorColumn[uColumn];                                                assert( columnSet.position() < m_uRowSize );
+   auto uColumnType = columnSet.ctype_number();
+   gd::variant variantConvertTo;
+   bool bOk = variantviewValue.convert_to( uColumnType,  variantConvertTo );
+
+   for( auto uRow = uFromRow; uRow < uToRow; uRow++ )
+   {
+      cell_set( uRow, uColumn, *(gd::variant_view*)&variantConvertTo );
+   }
+}
+
+
+/** ---------------------------------------------------------------------------
+ * @brief Fill column with values
+ * @param uColumn index for column that is filled with values
+ * @param pvariantviewValue pointer to variant buffer holding values to insert to column
+ * @param uCount number of items in variant buffer
+ * @param uFromRow from row index value are inserted to
+*/
+void table_column_buffer::column_fill( unsigned uColumn, const gd::variant_view* pvariantviewValue, size_t uCount, uint64_t uFromRow )
+{                                                                                                  assert( uFromRow >= 0 && uFromRow < m_uRowCount ); assert( (uFromRow + uCount) <= m_uRowCount ); 
+   for( auto uIndex = 0; uIndex < uCount; uIndex++ )
+   {
+      cell_set( uFromRow + uIndex, uColumn, pvariantviewValue[uIndex]);
    }
 }
 
@@ -3022,19 +3900,22 @@ void table_column_buffer::append( const table_column_buffer& tableFrom, uint64_t
 */
 void table_column_buffer::clear()
 {
+   m_bRowFree = false;
    m_uFlags = 0;
    m_uRowSize = 0;
    m_uRowMetaSize = 0;
    m_uRowCount = 0;
    m_uReservedRowCount = 0;
 
-   if( m_puData != nullptr ) delete [] m_puData;
-   m_puData = nullptr;
+   segment_clear();
+   data_delete();
    m_puMetaData = nullptr;
+   m_uSegmentShift = std::countr_zero( (unsigned)eSpaceSegmentRows );
 
    m_vectorColumn.clear();
    m_namesColumn.clear();
    m_argumentsProperty.clear();
+   m_vectorIndex.clear();
 }
 
 /** ---------------------------------------------------------------------------
@@ -3063,6 +3944,39 @@ bool table_column_buffer::equal( const table_column_buffer& tableEqualTo, uint64
    return true;
 }
 
+namespace {
+   /// add hash for cell value to row hash, null values and empty values get different hash
+   inline uint64_t cell_hash_s( const table_column_buffer* ptable, uint64_t uRow, unsigned uColumn, uint64_t uHash )
+   {
+      auto value_ = ptable->cell_get( uRow, uColumn, tag_raw{} );
+      if( value_.first == nullptr ) return hash_bytes_g( nullptr, 0, ~uHash );
+      return hash_bytes_g( value_.first, value_.second, uHash );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Calculate hash for values in row
+ * Hash is calculated on raw bytes for values, values in reference columns are
+ * hashed on referenced value. Rows with equal values in tables with same column
+ * types get the same hash.
+ * @param uRow row index
+ * @return uint64_t hash for values in all columns
+*/
+uint64_t table_column_buffer::row_hash( uint64_t uRow ) const
+{                                                                                                  assert( uRow < get_row_count() );
+   uint64_t uHash = 0;
+   for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ ) uHash = cell_hash_s( this, uRow, uColumn, uHash );
+   return uHash;
+}
+
+/// hash for values in selected columns in row
+uint64_t table_column_buffer::row_hash( uint64_t uRow, const std::vector<unsigned>& vectorColumn ) const
+{                                                                                                  assert( uRow < get_row_count() );
+   uint64_t uHash = 0;
+   for( auto uColumn : vectorColumn ) uHash = cell_hash_s( this, uRow, uColumn, uHash );
+   return uHash;
+}
+
 /** ---------------------------------------------------------------------------
  * @brief harvest row values into vector with arguments
  * @param uBeginRow start row
@@ -3278,43 +4192,247 @@ void table_column_buffer::plant( unsigned uColumn, const gd::variant_view& varia
    }
 }
 
-
-
 /** ---------------------------------------------------------------------------
- * @brief Swap data in one row into another row and that rows data is inserted in first row
+ * @brief Copy all rows from table with same layout into rows in this table
+ *
+ * Rows are copied in blocks, row tables copy rows and row meta data (null flags
+ * and row state) with memcpy for each run of rows that are stored after each
+ * other, columnar tables copy each column. Codes in reference columns are mapped
+ * to codes in this table with `vectorCode` that is filled by merging references
+ * from `tableFrom` into this table with `references::merge`.
+ *
+ * Only rows from `uTo` are written so different threads can plant tables into
+ * different rows, null flags in columnar tables that are shared with rows next
+ * to range are updated with atomic operations. Indexes are not notified.
+ *
  * @code
-   table_column_buffer tableM1( table_column_buffer::eTableFlagNull32, { { "double", 0, "mean"}, { "double", 0, "variance"}, { "double", 0, "error"}, { "uint64", 0, "count"}}, tag_prepare{});
+std::vector<int64_t> vectorCode;
+table.get_references().merge( tablePart.get_references(), vectorCode ); // not thread safe
+table.plant( tablePart, uRow, vectorCode, gd::table::tag_raw{} );
+ * @endcode
+ * @param tableFrom table with same columns and flags as this table
+ * @param uTo first row values are copied to, rows need to be added
+ * @param vectorCode code in this table for each code in `tableFrom`
+*/
+void table_column_buffer::plant( const table_column_buffer& tableFrom, uint64_t uTo, const std::vector<int64_t>& vectorCode, tag_raw )
+{                                                                                                  assert( get_column_count() == tableFrom.get_column_count() ); assert( m_uRowSize == tableFrom.m_uRowSize );
+                                                                                                   assert( ( m_uFlags & ~eTableFlagSegmented ) == ( tableFrom.m_uFlags & ~eTableFlagSegmented ) ); assert( ( uTo + tableFrom.get_row_count() ) <= get_row_count() );
+   const uint64_t uCount = tableFrom.get_row_count();
+   if( uCount == 0 ) return;
+
+   std::vector<unsigned> vectorReference;                                      // reference columns, codes are mapped
+   for( unsigned uColumn = 0; uColumn < get_column_count(); uColumn++ ) { if( m_vectorColumn[uColumn].is_reference() == true ) vectorReference.push_back( uColumn ); }
+
+   // map codes in rows stored after each other, null cells are skipped (null flags are read in source table)
+   auto map_code_ = [&]( uint64_t uRowFrom, unsigned uColumn, uint8_t* puValue, unsigned uStride, uint64_t uRun ) {
+      for( uint64_t u = 0; u < uRun; u++, puValue += uStride )
+      {
+         if( is_null() == true && tableFrom.cell_is_null( uRowFrom + u, uColumn ) == true ) continue;
+         uint64_t uCode = cell_get_code( puValue );                                               assert( uCode < vectorCode.size() ); assert( vectorCode[uCode] != -1 );
+         if( is_dictionary() == true ) *(uint32_t*)puValue = (uint32_t)vectorCode[uCode];
+         else                          *(uint64_t*)puValue = (uint64_t)vectorCode[uCode];
+      }
+   };
 
-   for( auto i = 0; i < 5; i++ )
+   if( is_columnar() == false )
    {
-      tableM1.row_add( {i,i,i,i}, tag_convert{} );
+      // ## copy runs where rows are after each other in both tables, segmented tables have one run for each segment
+      for( uint64_t uRow = 0; uRow < uCount; )
+      {
+         uint64_t uRun = std::min( { uCount - uRow, row_get_contiguous( uTo + uRow ), tableFrom.row_get_contiguous( uRow ) } );
+         std::memcpy( row_get( uTo + uRow ), tableFrom.row_get( uRow ), uRun * m_uRowSize );
+         if( m_uRowMetaSize > 0 ) std::memcpy( row_get_meta( uTo + uRow ), tableFrom.row_get_meta( uRow ), uRun * m_uRowMetaSize );
+         for( auto uColumn : vectorReference ) map_code_( uRow, uColumn, row_get( uTo + uRow ) + m_vectorColumn[uColumn].position(), m_uRowSize, uRun );
+         uRow += uRun;
+      }
+      return;
    }
 
-   std::cout << gd::table::debug::print( tableM1 ) << "\n";
-   tableM1.swap( 0, 1 );
-   tableM1.swap( 2, 3 );
-   std::cout << gd::table::debug::print( tableM1 ) << "\n";
- * @endcode
- * @param uRow1 index to row that get data from the other row
- * @param uRow2 index to other row that get data from first row
-*/
-void table_column_buffer::swap( uint64_t uRow1, uint64_t uRow2 )
-{                                                                                                  assert( uRow1 != uRow2 ); assert( uRow1 < get_row_count() ); assert( uRow2 < get_row_count() );
-   const unsigned u128Length = (sizeof(uint64_t) + sizeof(uint64_t));          // 128 bit length in bytes
+   // ## columnar table, copy values for each column
+   for( unsigned uColumn = 0; uColumn < get_column_count(); uColumn++ )
+   {
+      unsigned uWidth = column_get_width( uColumn );
+      std::memcpy( column_get_data( uColumn ) + uTo * uWidth, tableFrom.column_get_data( uColumn ), uCount * uWidth );
+   }
 
-   unsigned uCount128 = m_uRowSize / (sizeof(uint64_t) + sizeof(uint64_t)); // number of 128 bit sections
-   unsigned uTail = m_uRowSize % (sizeof(uint64_t) + sizeof(uint64_t));     // trailing 32 bit values (each row is allways 4 byte aligned)
+   if( is_null() == true )
+   {
+      // ## null flags, words that only has rows in range are written and words shared with other rows are updated with atomic and/or
+      const uint64_t uWordFirst = uTo >> 6;
+      const uint64_t uWordLast = ( uTo + uCount - 1 ) >> 6;
+      for( unsigned uColumn = 0; uColumn < get_column_count(); uColumn++ )
+      {
+         const uint64_t* puFrom = tableFrom.column_get_null( uColumn );
+         uint64_t* puTo = column_get_null( uColumn );
+         for( uint64_t uWord = uWordFirst; uWord <= uWordLast; uWord++ )
+         {
+            // bits for rows in word, source rows start at bit `uTo & 63` in first word
+            int64_t iRow = (int64_t)( uWord << 6 ) - (int64_t)uTo;               // row in source for bit 0 in word
+            uint64_t uBits = 0, uMask = ~0ULL;
+            if( iRow < 0 ) { uBits = puFrom[0] << -iRow; uMask <<= -iRow; }
+            else
+            {
+               unsigned uShift = (unsigned)( iRow & 63 );
+               uBits = puFrom[iRow >> 6] >> uShift;
+               if( uShift != 0 && (uint64_t)( ( iRow >> 6 ) + 1 ) * 64 < uCount ) uBits |= puFrom[( iRow >> 6 ) + 1] << ( 64 - uShift );
+            }
+            int64_t iRest = (int64_t)uCount - iRow;                              // rows in source from bit 0 in word
+            if( iRest < 64 ) uMask &= ( 1ULL << iRest ) - 1;
 
-   auto pRow1 = row_get( uRow1 );                                              // pointer to first row data
-   auto pRow2 = row_get( uRow2 );                                              // pointer to second row data
+            if( uMask == ~0ULL ) { puTo[uWord] = uBits; continue; }
+            std::atomic_ref<uint64_t> atomicWord( puTo[uWord] );
+            atomicWord.fetch_and( ~uMask | uBits );
+            atomicWord.fetch_or( uBits & uMask );
+         }
+      }
+   }
 
-   // ## swap data between rows
-   for( unsigned u = 0; u < uCount128; u++ )
-   {
-#ifdef GD_X86X
-      __m128i iSwapData = _mm_loadu_si128( reinterpret_cast<const __m128i* >( pRow1 ) );
-      _mm_storeu_si128( reinterpret_cast<__m128i* >(pRow1), _mm_loadu_si128( reinterpret_cast<const __m128i* >( pRow2 ) ) );
-      _mm_storeu_si128( reinterpret_cast<__m128i* >(pRow2), iSwapData );
+   if( is_rowstatus() == true ) std::memcpy( row_get_state( uTo ), tableFrom.row_get_state( 0 ), uCount * eSpaceRowState );
+
+   for( auto uColumn : vectorReference ) map_code_( 0, uColumn, column_get_data( uColumn ) + uTo * column_get_width( uColumn ), column_get_width( uColumn ), uCount );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Set null flags for rows in column from bit array
+ * Columnar tables copy words when first row is at word boundary in null array.
+ * @param uColumn column null flags are set for
+ * @param uFrom first row
+ * @param uCount number of rows
+ * @param puNull bit array with one bit for each row, bit set means null. If nullptr all cells in range are marked as not null
+*/
+void table_column_buffer::column_set_null( unsigned uColumn, uint64_t uFrom, uint64_t uCount, const uint64_t* puNull )
+{                                                                                                  assert( is_null() == true ); assert( uColumn < get_column_count() ); assert( (uFrom + uCount) <= m_uReservedRowCount );
+   if( is_columnar() == true && ( uFrom & 63 ) == 0 )
+   {
+      uint64_t* puBit = column_get_null( uColumn ) + ( uFrom >> 6 );
+      uint64_t uWordCount = uCount >> 6;
+      if( puNull != nullptr ) std::memcpy( puBit, puNull, uWordCount * sizeof( uint64_t ) );
+      else                    std::memset( puBit, 0, uWordCount * sizeof( uint64_t ) );
+
+      if( ( uCount & 63 ) != 0 )                                               // last word, keep bits for rows after range
+      {
+         uint64_t uMask = ( 1ULL << ( uCount & 63 ) ) - 1;
+         uint64_t uValue = puNull != nullptr ? puNull[uWordCount] : 0;
+         puBit[uWordCount] = ( puBit[uWordCount] & ~uMask ) | ( uValue & uMask );
+      }
+      return;
+   }
+
+   for( uint64_t u = 0; u < uCount; u++ )
+   {
+      if( puNull != nullptr && ( ( puNull[u >> 6] >> ( u & 63 ) ) & 1 ) != 0 ) cell_set_null( uFrom + u, uColumn );
+      else                                                                     cell_set_not_null( uFrom + u, uColumn );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Read null flags for rows in column into bit array
+ * @param uColumn column null flags are read from
+ * @param uFrom first row
+ * @param uCount number of rows
+ * @param puNull bit array that gets one bit for each row, needs space for `(uCount + 63) / 64` words
+*/
+void table_column_buffer::column_get_null( unsigned uColumn, uint64_t uFrom, uint64_t uCount, uint64_t* puNull ) const
+{                                                                                                  assert( uColumn < get_column_count() ); assert( (uFrom + uCount) <= m_uReservedRowCount );
+   uint64_t uWordCount = ( uCount + 63 ) >> 6;
+   if( is_null() == false ) { std::memset( puNull, 0, uWordCount * sizeof( uint64_t ) ); return; }
+
+   if( is_columnar() == true && ( uFrom & 63 ) == 0 )
+   {
+      std::memcpy( puNull, column_get_null( uColumn ) + ( uFrom >> 6 ), uWordCount * sizeof( uint64_t ) );
+      if( ( uCount & 63 ) != 0 ) puNull[uWordCount - 1] &= ( 1ULL << ( uCount & 63 ) ) - 1;// clear bits after range
+      return;
+   }
+
+   std::memset( puNull, 0, uWordCount * sizeof( uint64_t ) );
+   if( is_columnar() == true )
+   {
+      for( uint64_t u = 0; u < uCount; u++ )
+      {
+         if( cell_is_null( uFrom + u, uColumn ) == true ) puNull[u >> 6] |= ( 1ULL << ( u & 63 ) );
+      }
+      return;
+   }
+
+   // ## null flags for rows are stepped with meta size within contiguous rows
+   const uint64_t uColumnBit = 1ULL << uColumn;
+   for( uint64_t uIndex = 0; uIndex < uCount; )
+   {
+      uint64_t uEnd = std::min( uCount, uIndex + row_get_contiguous( uFrom + uIndex ) );
+      const uint8_t* puRowNull = row_get_null( uFrom + uIndex );
+      for( ; uIndex < uEnd; uIndex++, puRowNull += m_uRowMetaSize )
+      {
+         uint64_t uNullRow = is_null32() == true ? (uint64_t)*(const uint32_t*)puRowNull : *(const uint64_t*)puRowNull;
+         if( ( uNullRow & uColumnBit ) != 0 ) puNull[uIndex >> 6] |= ( 1ULL << ( uIndex & 63 ) );
+      }
+   }
+}
+
+
+
+/** ---------------------------------------------------------------------------
+ * @brief Swap data in one row into another row and that rows data is inserted in first row
+ * @code
+   table_column_buffer tableM1( table_column_buffer::eTableFlagNull32, { { "double", 0, "mean"}, { "double", 0, "variance"}, { "double", 0, "error"}, { "uint64", 0, "count"}}, tag_prepare{});
+
+   for( auto i = 0; i < 5; i++ )
+   {
+      tableM1.row_add( {i,i,i,i}, tag_convert{} );
+   }
+
+   std::cout << gd::table::debug::print( tableM1 ) << "\n";
+   tableM1.swap( 0, 1 );
+   tableM1.swap( 2, 3 );
+   std::cout << gd::table::debug::print( tableM1 ) << "\n";
+ * @endcode
+ * @param uRow1 index to row that get data from the other row
+ * @param uRow2 index to other row that get data from first row
+*/
+void table_column_buffer::swap( uint64_t uRow1, uint64_t uRow2 )
+{                                                                                                  assert( uRow1 != uRow2 ); assert( uRow1 < get_row_count() ); assert( uRow2 < get_row_count() );
+   if( is_notify() == true ) { index_notify_set( uRow1 ); index_notify_set( uRow2 ); }
+   m_bRowFree = false;                                                         // row state is moved with row
+   if( is_columnar() == true )                                                 // columnar table, swap value in each column
+   {
+      uint8_t puSwap[256];
+      for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ )
+      {
+         uint8_t* pCell1 = cell_get( uRow1, uColumn );
+         uint8_t* pCell2 = cell_get( uRow2, uColumn );
+         for( unsigned uOffset = 0, uWidth = column_get_width( uColumn ); uOffset < uWidth; uOffset += sizeof( puSwap ) )
+         {
+            unsigned uSize = std::min( (unsigned)sizeof( puSwap ), uWidth - uOffset );
+            memcpy( puSwap, pCell1 + uOffset, uSize );
+            memcpy( pCell1 + uOffset, pCell2 + uOffset, uSize );
+            memcpy( pCell2 + uOffset, puSwap, uSize );
+         }
+
+         if( is_null() == true )
+         {
+            bool bNull1 = cell_is_null( uRow1, uColumn );
+            cell_is_null( uRow2, uColumn ) ? cell_set_null( uRow1, uColumn ) : cell_set_not_null( uRow1, uColumn );
+            bNull1 ? cell_set_null( uRow2, uColumn ) : cell_set_not_null( uRow2, uColumn );
+         }
+      }
+      if( is_rowstatus() == true ) std::swap( *row_get_state( uRow1 ), *row_get_state( uRow2 ) );
+      return;
+   }
+
+   const unsigned u128Length = (sizeof(uint64_t) + sizeof(uint64_t));          // 128 bit length in bytes
+
+   unsigned uCount128 = m_uRowSize / (sizeof(uint64_t) + sizeof(uint64_t)); // number of 128 bit sections
+   unsigned uTail = m_uRowSize % (sizeof(uint64_t) + sizeof(uint64_t));     // trailing 32 bit values (each row is allways 4 byte aligned)
+
+   auto pRow1 = row_get( uRow1 );                                              // pointer to first row data
+   auto pRow2 = row_get( uRow2 );                                              // pointer to second row data
+
+   // ## swap data between rows
+   for( unsigned u = 0; u < uCount128; u++ )
+   {
+#ifdef GD_X86X
+      __m128i iSwapData = _mm_loadu_si128( reinterpret_cast<const __m128i* >( pRow1 ) );
+      _mm_storeu_si128( reinterpret_cast<__m128i* >(pRow1), _mm_loadu_si128( reinterpret_cast<const __m128i* >( pRow2 ) ) );
+      _mm_storeu_si128( reinterpret_cast<__m128i* >(pRow2), iSwapData );
 #else
       int64_t iSwapData = *(int64_t*)pRow1;
       *(int64_t*)pRow1 = *(int64_t*)pRow2;
@@ -3492,6 +4610,372 @@ void table_column_buffer::sort( unsigned uColumn, bool bAscending, uint64_t uFro
    }
 }
 
+namespace {
+
+/// check if column values can be converted to unsigned keys used in radix sort
+bool sort_is_radix_s( const table_column_buffer::column& column_ )
+{
+   if( column_.is_fixed() == false ) return false;
+   switch( column_.ctype_number() )
+   {
+   case gd::types::eTypeNumberBool:
+   case gd::types::eTypeNumberInt8:
+   case gd::types::eTypeNumberUInt8:
+   case gd::types::eTypeNumberInt16:
+   case gd::types::eTypeNumberUInt16:
+   case gd::types::eTypeNumberInt32:
+   case gd::types::eTypeNumberUInt32:
+   case gd::types::eTypeNumberInt64:
+   case gd::types::eTypeNumberUInt64:
+   case gd::types::eTypeNumberFloat:
+   case gd::types::eTypeNumberDouble:
+      return true;
+   default:
+      return false;
+   }
+}
+
+/// read value and convert it to unsigned key where unsigned order is the same as value order
+uint64_t sort_radix_key_s( const uint8_t* puValue, unsigned uTypeNumber )
+{
+   switch( uTypeNumber )
+   {
+   case gd::types::eTypeNumberBool:
+   case gd::types::eTypeNumberUInt8:  return *(const uint8_t*)puValue;
+   case gd::types::eTypeNumberInt8:   return (uint8_t)( *(const uint8_t*)puValue ^ 0x80u );
+   case gd::types::eTypeNumberUInt16: return *(const uint16_t*)puValue;
+   case gd::types::eTypeNumberInt16:  return (uint16_t)( *(const uint16_t*)puValue ^ 0x8000u );
+   case gd::types::eTypeNumberUInt32: return *(const uint32_t*)puValue;
+   case gd::types::eTypeNumberInt32:  return *(const uint32_t*)puValue ^ 0x8000'0000u;
+   case gd::types::eTypeNumberUInt64: return *(const uint64_t*)puValue;
+   case gd::types::eTypeNumberInt64:  return *(const uint64_t*)puValue ^ 0x8000'0000'0000'0000ull;
+   case gd::types::eTypeNumberFloat:
+   {
+      uint32_t uBits = *(const uint32_t*)puValue;                              // negative values flip all bits, positive only the sign bit
+      return ( uBits & 0x8000'0000u ) ? (uint32_t)~uBits : ( uBits | 0x8000'0000u );
+   }
+   case gd::types::eTypeNumberDouble:
+   {
+      uint64_t uBits = *(const uint64_t*)puValue;
+      return ( uBits & 0x8000'0000'0000'0000ull ) ? ~uBits : ( uBits | 0x8000'0000'0000'0000ull );
+   }
+   default: assert( false );
+   }
+   return 0;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief LSD radix sort for keys, rows are moved together with keys
+ * Sort is stable and that is needed when multiple columns are sorted one after another.
+ * @param vectorKey unsigned keys to sort on
+ * @param vectorRow rows that belong to keys
+ * @param uKeySize number of bytes in key that are used
+ */
+void sort_radix_s( std::vector<uint64_t>& vectorKey, std::vector<uint64_t>& vectorRow, unsigned uKeySize )
+{                                                                                                  assert( vectorKey.size() == vectorRow.size() ); assert( uKeySize <= sizeof(uint64_t) );
+   const std::size_t uCount = vectorKey.size();
+   if( uCount < 2 ) return;
+
+   std::vector<uint64_t> vectorKeyBuffer( uCount );
+   std::vector<uint64_t> vectorRowBuffer( uCount );
+   uint64_t* puKey = vectorKey.data();
+   uint64_t* puRow = vectorRow.data();
+   uint64_t* puKeyTo = vectorKeyBuffer.data();
+   uint64_t* puRowTo = vectorRowBuffer.data();
+
+   for( unsigned uShift = 0; uShift < uKeySize * 8; uShift += 8 )
+   {
+      std::size_t puOffset[256] = { 0 };
+      for( std::size_t u = 0; u < uCount; u++ ) puOffset[(puKey[u] >> uShift) & 0xff]++;
+
+      if( puOffset[(puKey[0] >> uShift) & 0xff] == uCount ) continue;          // all keys have same byte, nothing to sort in this pass
+
+      std::size_t uTotal = 0;
+      for( unsigned u = 0; u < 256; u++ )                                      // convert counters to offsets
+      {
+         std::size_t uDigitCount = puOffset[u];
+         puOffset[u] = uTotal;
+         uTotal += uDigitCount;
+      }
+
+      for( std::size_t u = 0; u < uCount; u++ )
+      {
+         std::size_t uTo = puOffset[(puKey[u] >> uShift) & 0xff]++;
+         puKeyTo[uTo] = puKey[u];
+         puRowTo[uTo] = puRow[u];
+      }
+
+      std::swap( puKey, puKeyTo );
+      std::swap( puRow, puRowTo );
+   }
+
+   if( puRow != vectorRow.data() ) vectorRow.swap( vectorRowBuffer );          // sorted rows ended up in buffer
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief compare cell values in same column for two rows
+ * Values are compared using raw bytes in table, null is less than any value.
+ * @param ptable table with values to compare
+ * @param uColumn column index
+ * @param uRow1 first row
+ * @param uRow2 second row
+ * @return int less than 0 if first is less, 0 if equal and greater than 0 if first is greater
+ */
+int sort_compare_s( const table_column_buffer* ptable, unsigned uColumn, uint64_t uRow1, uint64_t uRow2 )
+{
+   if( ptable->is_null() == true )
+   {
+      bool bNull1 = ptable->cell_is_null( uRow1, uColumn );
+      bool bNull2 = ptable->cell_is_null( uRow2, uColumn );
+      if( bNull1 == true || bNull2 == true ) return (int)bNull2 - (int)bNull1;
+   }
+
+   const auto& column_ = ptable->m_vectorColumn[uColumn];
+   const uint8_t* puValue1 = ptable->cell_get( uRow1, uColumn );
+   const uint8_t* puValue2 = ptable->cell_get( uRow2, uColumn );
+
+   if( column_.is_fixed() == true )
+   {
+      if( sort_is_radix_s( column_ ) == true )
+      {
+         uint64_t uKey1 = sort_radix_key_s( puValue1, column_.ctype_number() );
+         uint64_t uKey2 = sort_radix_key_s( puValue2, column_.ctype_number() );
+         return ( uKey1 < uKey2 ) ? -1 : ( uKey2 < uKey1 ? 1 : 0 );
+      }
+      return memcmp( puValue1, puValue2, column_.primitive_size() );
+   }
+
+   unsigned uSize1, uSize2;                                                    // size in bytes for values
+   if( column_.is_length() == true )
+   {
+      uSize1 = gd::types::value_size_g( column_.ctype(), *(const uint32_t*)puValue1 );
+      uSize2 = gd::types::value_size_g( column_.ctype(), *(const uint32_t*)puValue2 );
+      puValue1 += sizeof( uint32_t );
+      puValue2 += sizeof( uint32_t );
+   }
+   else
+   {                                                                                               assert( column_.is_reference() == true );
+      const reference* preference1 = ptable->m_references.at( ptable->cell_get_code( puValue1 ) );
+      const reference* preference2 = ptable->m_references.at( ptable->cell_get_code( puValue2 ) );
+      if( preference1 == preference2 ) return 0;
+      uSize1 = gd::types::value_size_g( preference1->ctype(), preference1->length() );
+      uSize2 = gd::types::value_size_g( preference2->ctype(), preference2->length() );
+      puValue1 = preference1->data();
+      puValue2 = preference2->data();
+   }
+
+   int iCompare = memcmp( puValue1, puValue2, std::min( uSize1, uSize2 ) );
+   if( iCompare != 0 ) return iCompare;
+   return ( uSize1 < uSize2 ) ? -1 : ( uSize2 < uSize1 ? 1 : 0 );
+}
+
+} // namespace
+
+/** ---------------------------------------------------------------------------
+ * @brief sort table rows on one or more columns, algorithm is selected from column types
+ *
+ * Sorted row order is calculated first and then rows are moved to their new
+ * position in one single pass. Read the permutation `sort` method for more
+ * information on how values are compared.
+ * @code
+table_column_buffer table( table_column_buffer::eTableFlagNull32, { { "int32", 0, "key"}, { "double", 0, "value"}, { "rstring", 0, "name"} }, tag_prepare{});
+for( int i = 0; i < 1000; i++ ) table.row_add( { i % 10, (double)i, std::to_string( i ) }, tag_convert{} );
+table.sort( { { 0, false }, { 2 } }, tag_sort_typed{} );                       // key descending and name ascending
+table.sort( "value", true, tag_sort_typed{} );
+ * @endcode
+ * @param vectorKey columns to sort on, first key is most significant
+ * @param uFrom from what row to sort
+ * @param uCount number of rows to sort
+ * @param bStable if true then rows with equal keys keep their order
+*/
+void table_column_buffer::sort( const std::vector<sort_key>& vectorKey, uint64_t uFrom, uint64_t uCount, bool bStable, tag_sort_typed )
+{                                                                                                  assert( (uFrom + uCount) <= get_row_count() );
+   if( uCount < 2 || vectorKey.empty() == true ) return;
+
+   std::vector<uint64_t> vectorRow;
+   sort( vectorKey, uFrom, uCount, bStable, vectorRow, tag_sort_typed{} );
+   row_reorder( uFrom, vectorRow );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief calculate sorted row order for rows in table, table is not modified
+ *
+ * If all sort columns are numbers (integer or decimal) LSD radix sort is used,
+ * one stable pass for each column starting with the least significant key.
+ * For other column types values are compared with raw bytes in table using
+ * introsort (`std::sort`) or merge sort (`std::stable_sort`) if stable sort
+ * is requested. Null values are placed first in ascending order and last in
+ * descending order.
+ * @param vectorKey columns to sort on, first key is most significant
+ * @param uFrom from what row to sort
+ * @param uCount number of rows to sort
+ * @param bStable if true then rows with equal keys keep their order
+ * @param vectorRow gets row indexes in sorted order
+*/
+void table_column_buffer::sort( const std::vector<sort_key>& vectorKey, uint64_t uFrom, uint64_t uCount, bool bStable, std::vector<uint64_t>& vectorRow, tag_sort_typed ) const
+{                                                                                                  assert( (uFrom + uCount) <= get_row_count() );
+   vectorRow.resize( uCount );
+   for( uint64_t u = 0; u < uCount; u++ ) vectorRow[u] = uFrom + u;
+   sort( vectorKey, bStable, vectorRow, tag_sort_typed{} );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief sort row indexes, table is not modified
+ *
+ * Same as sorting range of rows but rows to sort are passed in vector, this
+ * is used to sort selected rows without moving them in table.
+ * @param vectorKey columns to sort on, first key is most significant
+ * @param bStable if true then rows with equal keys keep their order
+ * @param vectorRow row indexes that are sorted
+*/
+void table_column_buffer::sort( const std::vector<sort_key>& vectorKey, bool bStable, std::vector<uint64_t>& vectorRow, tag_sort_typed ) const
+{
+   const uint64_t uCount = vectorRow.size();
+   if( uCount < 2 || vectorKey.empty() == true ) return;
+
+   bool bNull = is_null();
+   bool bRadix = std::all_of( vectorKey.begin(), vectorKey.end(), [this]( const auto& key_ ) { return sort_is_radix_s( m_vectorColumn[key_.column()] ); } );
+
+   if( bRadix == true )
+   {
+      std::vector<uint64_t> vectorNull;                                        // rows with null value for key, these keep order
+      std::vector<uint64_t> vectorValue;                                       // rows with value for key
+      std::vector<uint64_t> vectorKeyValue;                                    // keys for rows with value
+      vectorValue.reserve( uCount );
+      vectorKeyValue.reserve( uCount );
+
+      // ## sort on least significant key first, each pass is stable so order from earlier passes is kept
+      for( auto it = vectorKey.rbegin(); it != vectorKey.rend(); it++ )
+      {
+         unsigned uColumn = it->column();                                                          assert( uColumn < get_column_count() );
+         unsigned uTypeNumber = m_vectorColumn[uColumn].ctype_number();
+         unsigned uKeySize = gd::types::value_size_g( uTypeNumber );
+         uint64_t uMask = uKeySize >= sizeof( uint64_t ) ? ~0ull : ( ( 1ull << ( uKeySize * 8 ) ) - 1 );
+
+         vectorNull.clear();
+         vectorValue.clear();
+         vectorKeyValue.clear();
+         for( auto uRow : vectorRow )
+         {
+            if( bNull == true && cell_is_null( uRow, uColumn ) == true ) { vectorNull.push_back( uRow ); continue; }
+
+            uint64_t uKey = sort_radix_key_s( cell_get( uRow, uColumn ), uTypeNumber );
+            if( it->is_ascending() == false ) uKey = ~uKey & uMask;            // reverse order for descending sort
+            vectorValue.push_back( uRow );
+            vectorKeyValue.push_back( uKey );
+         }
+
+         sort_radix_s( vectorKeyValue, vectorValue, uKeySize );
+
+         if( it->is_ascending() == true )
+         {
+            std::copy( vectorNull.begin(), vectorNull.end(), vectorRow.begin() );
+            std::copy( vectorValue.begin(), vectorValue.end(), vectorRow.begin() + vectorNull.size() );
+         }
+         else
+         {
+            std::copy( vectorValue.begin(), vectorValue.end(), vectorRow.begin() );
+            std::copy( vectorNull.begin(), vectorNull.end(), vectorRow.begin() + vectorValue.size() );
+         }
+      }
+   }
+   else
+   {
+      auto compare_ = [this, &vectorKey]( uint64_t uRow1, uint64_t uRow2 ) -> bool {
+         for( const auto& key_ : vectorKey )
+         {
+            int iCompare = sort_compare_s( this, key_.column(), uRow1, uRow2 );
+            if( iCompare != 0 ) return key_.is_ascending() == true ? iCompare < 0 : iCompare > 0;
+         }
+         return false;
+      };
+
+      if( bStable == true ) std::stable_sort( vectorRow.begin(), vectorRow.end(), compare_ );
+      else                  std::sort( vectorRow.begin(), vectorRow.end(), compare_ );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief reorder rows in table, rows are gathered into temporary buffer and copied back
+ * @code
+// reverse the first three rows
+table.row_reorder( 0, { 2, 1, 0 } );
+ * @endcode
+ * @param uFrom first row that is reordered
+ * @param vectorRow row indexes where data is taken from, each row should be within the reordered rows and only once
+*/
+void table_column_buffer::row_reorder( uint64_t uFrom, const std::vector<uint64_t>& vectorRow )
+{                                                                                                  assert( (uFrom + vectorRow.size()) <= get_row_count() );
+   const uint64_t uCount = vectorRow.size();
+   if( uCount == 0 ) return;
+   m_bRowFree = false;                                                         // row state is moved with row
+
+   if( is_columnar() == true )                                                 // columnar table, gather values for each column
+   {
+      std::vector<uint8_t> vectorBuffer;
+      for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ )
+      {
+         unsigned uWidth = column_get_width( uColumn );
+         vectorBuffer.resize( uCount * uWidth );
+         uint8_t* puTo = vectorBuffer.data();
+         for( auto uRow : vectorRow ) { memcpy( puTo, cell_get( uRow, uColumn ), uWidth ); puTo += uWidth; }
+         memcpy( cell_get( uFrom, uColumn ), vectorBuffer.data(), uCount * uWidth );
+
+         if( is_null() == true )
+         {
+            std::vector<bool> vectorNull;
+            vectorNull.reserve( uCount );
+            for( auto uRow : vectorRow ) vectorNull.push_back( cell_is_null( uRow, uColumn ) );
+            for( uint64_t u = 0; u < uCount; u++ ) { column_set_null( uColumn, uFrom + u, vectorNull[u] ); }
+         }
+      }
+
+      if( is_rowstatus() == true )
+      {
+         std::vector<uint32_t> vectorState;
+         vectorState.reserve( uCount );
+         for( auto uRow : vectorRow ) vectorState.push_back( *row_get_state( uRow ) );
+         memcpy( row_get_state( uFrom ), vectorState.data(), uCount * sizeof( uint32_t ) );
+      }
+      if( is_notify() == true ) index_notify_move( uFrom, vectorRow );
+      return;
+   }
+
+   // ## gather row data
+   std::unique_ptr<uint8_t[]> puBuffer( new uint8_t[uCount * m_uRowSize] );
+   uint8_t* puTo = puBuffer.get();
+   for( auto uRow : vectorRow )
+   {                                                                                               assert( uRow >= uFrom ); assert( uRow < (uFrom + uCount) );
+      memcpy( puTo, row_get( uRow ), m_uRowSize );
+      puTo += m_uRowSize;
+   }
+
+   // ## gather meta data if any
+   std::unique_ptr<uint8_t[]> puMetaBuffer;
+   if( is_rowmeta() == true )
+   {
+      puMetaBuffer.reset( new uint8_t[uCount * m_uRowMetaSize] );
+      puTo = puMetaBuffer.get();
+      for( auto uRow : vectorRow )
+      {
+         memcpy( puTo, row_get_meta( uRow ), m_uRowMetaSize );
+         puTo += m_uRowMetaSize;
+      }
+   }
+
+   // ## copy back, rows are copied in blocks of rows stored after each other (one block if table isn't segmented)
+   if( is_segment_shared() == true ) segment_write( uFrom, uCount );
+   for( uint64_t uRow = uFrom, uEnd = uFrom + uCount; uRow < uEnd; )
+   {
+      uint64_t uBlock = std::min( row_get_contiguous( uRow ), uEnd - uRow );
+      memcpy( row_get( uRow ), puBuffer.get() + ( uRow - uFrom ) * m_uRowSize, uBlock * m_uRowSize );
+      if( puMetaBuffer != nullptr ) memcpy( row_get_meta( uRow ), puMetaBuffer.get() + ( uRow - uFrom ) * m_uRowMetaSize, uBlock * m_uRowMetaSize );
+      uRow += uBlock;
+   }
+
+   if( is_notify() == true ) index_notify_move( uFrom, vectorRow );
+}
+
 /** ---------------------------------------------------------------------------
  * @brief Split table into new tables with max amount of rows
  * @code
@@ -3590,6 +5074,38 @@ void table_column_buffer::erase( uint64_t uFrom, uint64_t uCount )
    uint64_t uEraseDataSize = uCount * m_uRowSize;  // data size to be erased
    uint64_t uEraseMetaSize = uCount * uMetaSize;   // meta size to be erased
 
+   if( is_notify() == true ) index_notify_erase( uFrom, uCount );   // indexes read values in erased rows
+   m_bRowFree = false;                                                         // row state is moved with row
+
+   if( is_columnar() == true )                                                 // columnar table, move values in each column
+   {
+      uint64_t uMoveCount = uRowCount - (uFrom + uCount);                      // rows after erased rows
+      for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ )
+      {
+         memmove( cell_get( uFrom, uColumn ), cell_get( uFrom + uCount, uColumn ), uMoveCount * column_get_width( uColumn ) );
+         if( is_null() == true )
+         {
+            for( uint64_t u = 0; u < uMoveCount; u++ ) { column_set_null( uColumn, uFrom + u, cell_is_null( uFrom + uCount + u, uColumn ) ); }
+         }
+      }
+      if( is_rowstatus() == true ) memmove( row_get_state( uFrom ), row_get_state( uFrom + uCount ), uMoveCount * eSpaceRowState );
+
+      m_uRowCount -= uCount;
+      return;
+   }
+
+   if( is_segmented() == true )                                                // segmented table, rows after erased rows are moved one by one
+   {
+      for( uint64_t uRow = uFrom, uEnd = uRowCount - uCount; uRow < uEnd; uRow++ )
+      {
+         memcpy( row_get( uRow ), row_get( uRow + uCount ), m_uRowSize );
+         if( m_puMetaData != nullptr ) memcpy( row_get_meta( uRow ), row_get_meta( uRow + uCount ), m_uRowMetaSize );
+      }
+
+      m_uRowCount -= uCount;
+      return;
+   }
+
    // ## move meta data if meta is set
    if( m_puMetaData != nullptr )
    {
@@ -3613,43 +5129,360 @@ void table_column_buffer::erase( uint64_t uFrom, uint64_t uCount )
    m_uRowCount -= uCount;
 }
 
-
 /** ---------------------------------------------------------------------------
- * @brief Convert names to column indexes in table
- * @param tablecolumnbuffer table to get column indexes from
- * @param vectorName names to match for column indexes are returned for.
- * @return std::vector<int32_t> indexes to columns in table
-*/
-std::vector<int32_t> table_column_buffer::column_get_index_s( const table_column_buffer& tablecolumnbuffer, const std::vector<std::string>& vectorName )
+ * @brief Remove values in references that no cell uses and update codes in reference columns
+ * Values in references are never removed when cells are changed, cells only
+ * store code (index) to value. This counts how many cells that use each value,
+ * packs used values into new slabs and writes new codes to cells.
+ * @code
+table.cell_set( 0, 0, "Stockholm" );
+table.cell_set( 0, 0, "Oslo" );                                                // "Stockholm" is kept in references
+auto uRemoved = table.references_compact();                                    // "Stockholm" is removed, uRemoved = 1
+ * @endcode
+ * @return uint64_t number of removed values
+ */
+uint64_t table_column_buffer::references_compact()
 {
-   std::vector<int32_t> vectorColumnIndex;
-   for( const auto& it : vectorName )
+   if( m_references.empty() == true ) return 0;
+
+   std::vector<unsigned> vectorColumn;                                         // reference columns
+   for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ )
    {
-      vectorColumnIndex.push_back( tablecolumnbuffer.column_get_index( it ) );
+      if( m_vectorColumn[uColumn].is_reference() == true ) vectorColumn.push_back( uColumn );
    }
-   return vectorColumnIndex;
-}
 
-/** ---------------------------------------------------------------------------
- * @brief Match columns based on names between two tables, index for matched columns are returned in vector as pair's objects
- * @param t1_ table one to match against table two
- * @param t2_ table two to match against table one
- * @return std::vector< std::pair< unsigned, unsigned > > vector with matched column indexes
-*/
-std::vector< std::pair< unsigned, unsigned > > table_column_buffer::column_match_s( const table_column_buffer& t1_, const table_column_buffer& t2_, tag_name )
-{
-   std::vector< std::pair< unsigned, unsigned > > vectorMatch;
-   for( unsigned u = 0, uMax = t1_.get_column_count(); u != uMax; u++ )
+   // ## count cells using each value
+   for( std::size_t u = 0; u < m_references.size(); u++ ) { m_references.at( u )->set_reference_count( 0 ); }
+
+   uint64_t uRowCount = get_row_count();
+   for( auto uColumn : vectorColumn )
    {
-      auto name_ = t1_.column_get_name( u );
-      int iFindColumn = t2_.column_find_index( name_ );
-      if( iFindColumn != -1 ) { vectorMatch.push_back( { u, (unsigned)iFindColumn } ); }
+      for( uint64_t uRow = 0; uRow < uRowCount; uRow++ )
+      {
+         int64_t iCode = cell_get_code( uRow, uColumn );
+         if( iCode >= 0 && (uint64_t)iCode < m_references.size() ) m_references.add_reference( (std::size_t)iCode );
+      }
    }
 
-   return vectorMatch;
-}
+   std::vector<int64_t> vectorMap;
+   uint64_t uRemoved = m_references.compact( vectorMap );
+   if( uRemoved == 0 ) return 0;
 
-/** ---------------------------------------------------------------------------
+   // ## write new codes to cells
+   if( is_segment_shared() == true ) segment_write( 0, uRowCount );
+   for( auto uColumn : vectorColumn )
+   {
+      for( uint64_t uRow = 0; uRow < uRowCount; uRow++ )
+      {
+         int64_t iCode = cell_get_code( uRow, uColumn );
+         if( iCode < 0 || (uint64_t)iCode >= vectorMap.size() ) continue;
+         int64_t iNewCode = vectorMap[iCode];                                                      assert( iNewCode >= 0 );
+         uint8_t* puValue = cell_get( uRow, uColumn );
+         if( is_dictionary() == true ) *(uint32_t*)puValue = (uint32_t)iNewCode;
+         else                          memcpy( puValue, &iNewCode, sizeof( uint64_t ) );
+      }
+   }
+
+   return uRemoved;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Set number of rows in each segment for segmented table
+ * Segment row count is a power of 2 and a multiple of 64, row index to segment
+ * is then a shift and bit operations on rows within segment works on whole words.
+ * @code
+gd::table::table_column_buffer table( gd::table::table_column_buffer::eTableFlagSegmented, 100'000 );
+table.segment_set_row_count( 65536 );
+table.column_add( { { "int64", 0, "id" }, { "rstring", 0, "name" } }, gd::table::tag_type_name{} );
+table.prepare();                                                               // two segments are allocated
+ * @endcode
+ * @param uRowCount number of rows in each segment
+ */
+void table_column_buffer::segment_set_row_count( uint64_t uRowCount )
+{                                                                                                  assert( m_puData == nullptr ); assert( std::has_single_bit( uRowCount ) == true ); assert( uRowCount >= 64 );
+   m_uSegmentShift = (unsigned)std::countr_zero( uRowCount );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add segment to segmented table, reserved row count is increased with segment row count
+ * First segment is table data block `m_puData` and meta data for first segment
+ * is `m_puMetaData`.
+ */
+void table_column_buffer::segment_add()
+{                                                                                                  assert( is_segmented() == true ); assert( is_columnar() == false ); assert( m_uRowSize > 0 );
+   uint64_t uRowCount = segment_get_row_count();
+   uint64_t uSegmentSize = segment_get_size();
+   uint8_t* puSegment = new uint8_t[uSegmentSize];
+   if( is_segment_shared() == true ) m_vectorSegmentOwner.emplace_back( puSegment );
+#ifdef _DEBUG
+   memset( puSegment, 0, uSegmentSize );                                       // set data to 0 in debug mode
+#endif // _DEBUG
+   if( m_uRowMetaSize > 0 ) memset( puSegment + m_uRowSize * uRowCount, 0, m_uRowMetaSize * uRowCount );
+
+   if( m_vectorSegment.empty() == true )
+   {                                                                                               assert( m_puData == nullptr );
+      m_puData = puSegment;
+      m_puMetaData = m_uRowMetaSize > 0 ? puSegment + m_uRowSize * uRowCount : nullptr;
+   }
+
+   m_vectorSegment.push_back( puSegment );
+   m_uReservedRowCount += uRowCount;
+}
+
+/// delete segments owned by table, first segment is deleted with `m_puData` if segments isn't shared
+void table_column_buffer::segment_clear() noexcept
+{
+   if( is_segment_shared() == true )
+   {
+      m_vectorSegmentOwner.clear();                                            // segments are deleted when last owner is released
+      m_puData = nullptr;
+      m_puMetaData = nullptr;
+   }
+   else
+   {
+      for( std::size_t u = 1; u < m_vectorSegment.size(); u++ ) delete [] m_vectorSegment[u];
+   }
+   m_vectorSegment.clear();
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Segments get shared owners, table can then be copied with `tag_copy_on_write`
+ * Copy on write copies share segments with table, segment is copied when rows in
+ * segment are modified by table methods (cell_set, row_set, erase, sort ...).
+ * Data that is modified through pointers to table data do not copy segments, call
+ * `segment_write` before data is modified that way.
+ * @code
+gd::table::dto::table table( gd::table::dto::table::eTableFlagSegmented, { { "int64", 0, "id" } }, gd::table::tag_prepare{} );
+table.segment_share();
+gd::table::dto::table tableEdit( table, gd::table::tag_copy_on_write{} );      // no rows are copied
+tableEdit.cell_set( 0, 0, (int64_t)1 );                                       // first segment is copied
+ * @endcode
+ */
+void table_column_buffer::segment_share()
+{                                                                                                  assert( is_segmented() == true );
+   if( is_segment_shared() == true ) return;
+
+   m_vectorSegmentOwner.reserve( m_vectorSegment.size() );
+   for( auto puSegment : m_vectorSegment ) m_vectorSegmentOwner.emplace_back( puSegment );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Make segments for rows private, segments used by other tables are copied
+ * @param uFrom first row that is modified
+ * @param uCount number of rows that are modified
+ */
+void table_column_buffer::segment_write( uint64_t uFrom, uint64_t uCount )
+{                                                                                                  assert( is_segment_shared() == true ); assert( m_vectorSegment.size() == m_vectorSegmentOwner.size() );
+   if( uCount == 0 ) return;
+   const uint64_t uSegmentSize = segment_get_size();
+   const std::size_t uLast = std::min( (std::size_t)( ( uFrom + uCount - 1 ) >> m_uSegmentShift ), m_vectorSegment.size() - 1 );
+   for( std::size_t u = (std::size_t)( uFrom >> m_uSegmentShift ); u <= uLast; u++ )
+   {
+      if( m_vectorSegmentOwner[u].use_count() == 1 ) continue;                // only this table use segment
+
+      uint8_t* puSegment = new uint8_t[uSegmentSize];
+      memcpy( puSegment, m_vectorSegment[u], uSegmentSize );
+      m_vectorSegmentOwner[u].reset( puSegment );                             // other tables still holds old segment
+      m_vectorSegment[u] = puSegment;
+      if( u == 0 )
+      {
+         m_puData = puSegment;
+         m_puMetaData = m_uRowMetaSize > 0 ? puSegment + ( (uint64_t)m_uRowSize << m_uSegmentShift ) : nullptr;
+      }
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add hash index for key columns, rows in table are indexed when index is searched
+ * Table owns index and keeps it in sync when rows are added, modified, erased or moved.
+ * @code
+auto pindex = table.index_add( { 0, 1 }, gd::table::tag_index_hash{} );
+table.cell_set( 10, 1, 2024 );                                                 // index is updated
+int64_t iRow = pindex->find( { "Stockholm", 2024 } );
+ * @endcode
+ * @param vectorColumn key columns
+ * @return index_hash* pointer to index, valid until index is removed or table is cleared
+ */
+index_hash* table_column_buffer::index_add( const std::vector<unsigned>& vectorColumn, tag_index_hash )
+{                                                                                                  assert( vectorColumn.empty() == false );
+#ifndef NDEBUG
+   for( auto uColumn : vectorColumn ) { assert( uColumn < get_column_count() ); }
+#endif // NDEBUG
+   auto pindex = new index_hash( this, vectorColumn );
+   m_vectorIndex.push_back( std::unique_ptr<index_column>( pindex ) );
+   pindex->on_add( 0, get_row_count() );
+   return pindex;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add ordered index for key columns, rows in table are indexed when index is searched
+ * @code
+auto pindex = table.index_add( { 2 }, gd::table::tag_index_ordered{} );
+std::vector<uint64_t> vectorRow;
+pindex->range( { 10 }, { 20 }, vectorRow );
+ * @endcode
+ * @param vectorColumn key columns
+ * @return index_ordered* pointer to index, valid until index is removed or table is cleared
+ */
+index_ordered* table_column_buffer::index_add( const std::vector<unsigned>& vectorColumn, tag_index_ordered )
+{                                                                                                  assert( vectorColumn.empty() == false );
+#ifndef NDEBUG
+   for( auto uColumn : vectorColumn ) { assert( uColumn < get_column_count() ); }
+#endif // NDEBUG
+   auto pindex = new index_ordered( this, vectorColumn );
+   m_vectorIndex.push_back( std::unique_ptr<index_column>( pindex ) );
+   pindex->on_add( 0, get_row_count() );
+   return pindex;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add zone map for key columns, `find` and `filter` skip blocks where value can't match
+ * @code
+table.index_add( { 0 }, 4096, gd::table::tag_index_zone{} );
+int64_t iRow = table.find( 0, (int64_t)1700000000 );                          // only blocks with value in min and max are read
+ * @endcode
+ * @param vectorColumn key columns, statistics is kept for each column
+ * @param uBlockRows rows in block, power of 2 and at least 64
+ * @return index_zone* pointer to zone map, valid until zone map is removed or table is cleared
+ */
+index_zone* table_column_buffer::index_add( const std::vector<unsigned>& vectorColumn, unsigned uBlockRows, tag_index_zone )
+{                                                                                                  assert( vectorColumn.empty() == false );
+#ifndef NDEBUG
+   for( auto uColumn : vectorColumn ) { assert( uColumn < get_column_count() ); }
+#endif // NDEBUG
+   auto pindex = new index_zone( this, vectorColumn, uBlockRows );
+   m_vectorIndex.push_back( std::unique_ptr<index_column>( pindex ) );
+   pindex->on_add( 0, get_row_count() );
+   return pindex;
+}
+
+/// get zone map with statistics for column, nullptr if column do not have zone map
+const index_zone* table_column_buffer::index_get_zone( unsigned uColumn ) const noexcept
+{
+   for( const auto& it : m_vectorIndex )
+   {
+      const index_zone* pzone = dynamic_cast<const index_zone*>( it.get() );
+      if( pzone != nullptr && pzone->find_key( uColumn ) != -1 ) return pzone;
+   }
+   return nullptr;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add cache with hash for values in rows
+ * Hash for row is calculated when it is read and kept until row is modified.
+ * @param vectorColumn columns hashed for each row
+ * @return index_row_hash* pointer to cache, valid until it is removed or table is cleared
+*/
+index_row_hash* table_column_buffer::index_add( const std::vector<unsigned>& vectorColumn, tag_index_row_hash )
+{                                                                                                  assert( vectorColumn.empty() == false );
+#ifndef NDEBUG
+   for( auto uColumn : vectorColumn ) { assert( uColumn < get_column_count() ); }
+#endif // NDEBUG
+   auto pindex = new index_row_hash( this, vectorColumn );
+   m_vectorIndex.push_back( std::unique_ptr<index_column>( pindex ) );
+   pindex->on_add( 0, get_row_count() );
+   return pindex;
+}
+
+/// get row hash cache where all columns in table are hashed in column order, nullptr if table do not have one
+const index_row_hash* table_column_buffer::index_get_row_hash() const noexcept
+{
+   for( const auto& it : m_vectorIndex )
+   {
+      const index_row_hash* pindex = dynamic_cast<const index_row_hash*>( it.get() );
+      if( pindex == nullptr || pindex->get_columns().size() != get_column_count() ) continue;
+
+      bool bAll = true;
+      for( unsigned u = 0; u < get_column_count(); u++ ) { if( pindex->get_columns()[u] != u ) { bAll = false; break; } }
+      if( bAll == true ) return pindex;
+   }
+   return nullptr;
+}
+
+/// remove index from table, index is deleted
+void table_column_buffer::index_remove( const index_column* pindex )
+{
+   auto it = std::find_if( m_vectorIndex.begin(), m_vectorIndex.end(), [pindex]( const auto& p_ ) { return p_.get() == pindex; } );
+   if( it != m_vectorIndex.end() ) m_vectorIndex.erase( it );
+}
+
+/// rows are added to table
+void table_column_buffer::index_notify_add( uint64_t uFrom, uint64_t uCount )
+{
+   if( is_segment_shared() == true ) segment_write( uFrom, uCount );          // added rows may be in last segment that is shared
+   for( auto& it : m_vectorIndex ) it->on_add( uFrom, uCount );
+}
+
+/// value in column for row is about to change, only indexes with column as key are notified
+void table_column_buffer::index_notify_set( uint64_t uRow, unsigned uColumn )
+{
+   if( is_segment_shared() == true ) segment_write( uRow, 1 );
+   for( auto& it : m_vectorIndex ) { if( it->is_key( uColumn ) == true ) it->on_set( uRow ); }
+}
+
+/// values in row is about to change
+void table_column_buffer::index_notify_set( uint64_t uRow )
+{
+   if( is_segment_shared() == true ) segment_write( uRow, 1 );
+   for( auto& it : m_vectorIndex ) it->on_set( uRow );
+}
+
+/// rows are about to be erased
+void table_column_buffer::index_notify_erase( uint64_t uFrom, uint64_t uCount )
+{
+   if( is_segment_shared() == true ) segment_write( uFrom, m_uRowCount - uFrom );// rows after erased rows are moved
+   for( auto& it : m_vectorIndex ) it->on_erase( uFrom, uCount );
+}
+
+/// rows has been reordered, row at uFrom + n has got data from row in vectorRow[n]
+void table_column_buffer::index_notify_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow )
+{
+   for( auto& it : m_vectorIndex ) it->on_move( uFrom, vectorRow );
+}
+
+/// all rows are removed
+void table_column_buffer::index_notify_clear()
+{
+   for( auto& it : m_vectorIndex ) it->on_clear();
+}
+
+
+/** ---------------------------------------------------------------------------
+ * @brief Convert names to column indexes in table
+ * @param tablecolumnbuffer table to get column indexes from
+ * @param vectorName names to match for column indexes are returned for.
+ * @return std::vector<int32_t> indexes to columns in table
+*/
+std::vector<int32_t> table_column_buffer::column_get_index_s( const table_column_buffer& tablecolumnbuffer, const std::vector<std::string>& vectorName )
+{
+   std::vector<int32_t> vectorColumnIndex;
+   for( const auto& it : vectorName )
+   {
+      vectorColumnIndex.push_back( tablecolumnbuffer.column_get_index( it ) );
+   }
+   return vectorColumnIndex;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Match columns based on names between two tables, index for matched columns are returned in vector as pair's objects
+ * @param t1_ table one to match against table two
+ * @param t2_ table two to match against table one
+ * @return std::vector< std::pair< unsigned, unsigned > > vector with matched column indexes
+*/
+std::vector< std::pair< unsigned, unsigned > > table_column_buffer::column_match_s( const table_column_buffer& t1_, const table_column_buffer& t2_, tag_name )
+{
+   std::vector< std::pair< unsigned, unsigned > > vectorMatch;
+   for( unsigned u = 0, uMax = t1_.get_column_count(); u != uMax; u++ )
+   {
+      auto name_ = t1_.column_get_name( u );
+      int iFindColumn = t2_.column_find_index( name_ );
+      if( iFindColumn != -1 ) { vectorMatch.push_back( { u, (unsigned)iFindColumn } ); }
+   }
+
+   return vectorMatch;
+}
+
+/** ---------------------------------------------------------------------------
  * @brief Match columns based on alias between two tables, index for matched columns are returned in vector as pair's objects
  * @param t1_ table one to match against table two
  * @param t2_ table two to match against table one
@@ -3728,6 +5561,342 @@ void table_column_buffer::join_s(const table_column_buffer* pT1_, unsigned uColu
    }
 }
 
+namespace {
+
+/// join types used internally by hash join
+enum enumJoin { eJoinInner, eJoinLeft, eJoinAnti };
+
+/// row with hash for key values, used in hash join
+struct join_row
+{
+   uint64_t m_uHash;
+   uint64_t m_uRow;
+};
+
+/// calculate hash for key values in row, returns false if any key value is null (null never match)
+bool join_hash_s( const table_column_buffer* ptable, uint64_t uRow, const std::vector<unsigned>& vectorColumn, uint64_t& uHash )
+{
+   uHash = 0;
+   for( auto uColumn : vectorColumn )
+   {
+      auto value_ = ptable->cell_get( uRow, uColumn, tag_raw{} );
+      if( value_.first == nullptr ) return false;
+      uHash = hash_bytes_g( value_.first, value_.second, uHash );
+   }
+   return true;
+}
+
+/// compare raw key values for rows in two tables
+bool join_equal_s( const table_column_buffer* pT1_, uint64_t uRow1, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, uint64_t uRow2, const std::vector<unsigned>& vectorColumn2 )
+{
+   for( std::size_t u = 0; u < vectorColumn1.size(); u++ )
+   {
+      auto v1_ = pT1_->cell_get( uRow1, vectorColumn1[u], tag_raw{} );
+      auto v2_ = pT2_->cell_get( uRow2, vectorColumn2[u], tag_raw{} );
+      if( v1_.second != v2_.second || memcmp( v1_.first, v2_.first, v1_.second ) != 0 ) return false;
+   }
+   return true;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief collect hash for key values in all rows, rows with null keys are placed in null vector
+ * Rows are kept in table order also when several threads are used.
+ */
+void join_collect_s( const table_column_buffer* ptable, const std::vector<unsigned>& vectorColumn, unsigned uThreadCount, std::vector<join_row>& vectorRow, std::vector<uint64_t>& vectorNull )
+{
+   auto collect_ = [ptable, &vectorColumn]( uint64_t uFrom, uint64_t uTo, std::vector<join_row>& vectorRow_, std::vector<uint64_t>& vectorNull_ ) {
+      vectorRow_.reserve( uTo - uFrom );
+      uint64_t uHash;
+      for( uint64_t uRow = uFrom; uRow < uTo; uRow++ )
+      {
+         if( join_hash_s( ptable, uRow, vectorColumn, uHash ) == true ) vectorRow_.push_back( { uHash, uRow } );
+         else                                                           vectorNull_.push_back( uRow );
+      }
+   };
+
+   uint64_t uRowCount = ptable->get_row_count();
+   if( uThreadCount <= 1 ) { collect_( 0, uRowCount, vectorRow, vectorNull ); return; }
+
+   std::vector< std::vector<join_row> > vectorPartRow( uThreadCount );
+   std::vector< std::vector<uint64_t> > vectorPartNull( uThreadCount );
+   std::vector<std::thread> vectorThread;
+   uint64_t uStep = ( uRowCount + uThreadCount - 1 ) / uThreadCount;
+   for( unsigned u = 0; u < uThreadCount; u++ )
+   {
+      uint64_t uFrom = std::min( uRowCount, u * uStep );
+      uint64_t uTo = std::min( uRowCount, uFrom + uStep );
+      vectorThread.emplace_back( collect_, uFrom, uTo, std::ref( vectorPartRow[u] ), std::ref( vectorPartNull[u] ) );
+   }
+   for( auto& it : vectorThread ) it.join();
+
+   for( unsigned u = 0; u < uThreadCount; u++ )
+   {
+      vectorRow.insert( vectorRow.end(), vectorPartRow[u].begin(), vectorPartRow[u].end() );
+      vectorNull.insert( vectorNull.end(), vectorPartNull[u].begin(), vectorPartNull[u].end() );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief build hash table for rows in build table and probe it with rows from probe table
+ * Pairs added to result always have row from first table as first value.
+ * @param pBuild table hash table is built for
+ * @param vectorBuild rows with hash for build table
+ * @param pProbe table used to probe hash table
+ * @param vectorProbe rows with hash for probe table
+ * @param bBuildIsFirst true if build table is the first table in join
+ * @param eJoin join type
+ * @param vectorMatch gets result pairs
+ */
+void join_partition_s( const table_column_buffer* pBuild, const std::vector<unsigned>& vectorBuildColumn, const std::vector<join_row>& vectorBuild,
+                       const table_column_buffer* pProbe, const std::vector<unsigned>& vectorProbeColumn, const std::vector<join_row>& vectorProbe,
+                       bool bBuildIsFirst, enumJoin eJoin, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch )
+{
+   constexpr uint64_t uEnd_ = uint64_t(-1);
+
+   // ## build hash table, buckets with chained rows. rows are inserted backwards to keep table order in chain
+   std::size_t uBucketCount = 16;
+   while( uBucketCount < vectorBuild.size() ) uBucketCount <<= 1;
+   const uint64_t uMask = uBucketCount - 1;
+   std::vector<uint64_t> vectorBucket( uBucketCount, uEnd_ );
+   std::vector<uint64_t> vectorNext( vectorBuild.size() );
+   for( std::size_t u = vectorBuild.size(); u-- > 0; )
+   {
+      uint64_t uBucket = vectorBuild[u].m_uHash & uMask;
+      vectorNext[u] = vectorBucket[uBucket];
+      vectorBucket[uBucket] = u;
+   }
+
+   std::vector<uint8_t> vectorBuildMatch;                                      // marks matched build rows when build table is first and all rows from first are needed
+   if( bBuildIsFirst == true && eJoin != eJoinInner ) vectorBuildMatch.resize( vectorBuild.size(), 0 );
+
+   // ## probe hash table
+   for( const auto& probe_ : vectorProbe )
+   {
+      bool bMatch = false;
+      for( uint64_t u = vectorBucket[probe_.m_uHash & uMask]; u != uEnd_; u = vectorNext[u] )
+      {
+         const auto& build_ = vectorBuild[u];
+         if( build_.m_uHash != probe_.m_uHash ) continue;
+         if( join_equal_s( pBuild, build_.m_uRow, vectorBuildColumn, pProbe, probe_.m_uRow, vectorProbeColumn ) == false ) continue;
+
+         bMatch = true;
+         if( bBuildIsFirst == true )
+         {
+            if( eJoin != eJoinInner ) vectorBuildMatch[u] = 1;
+            if( eJoin != eJoinAnti ) vectorMatch.push_back( { build_.m_uRow, probe_.m_uRow } );
+         }
+         else
+         {
+            if( eJoin == eJoinAnti ) break;                                    // one match is enough to remove row
+            vectorMatch.push_back( { probe_.m_uRow, build_.m_uRow } );
+         }
+      }
+
+      if( bBuildIsFirst == false && bMatch == false && eJoin != eJoinInner ) vectorMatch.push_back( { probe_.m_uRow, uEnd_ } );
+   }
+
+   // ## rows in first table without match when first table is the build table
+   if( vectorBuildMatch.empty() == false )
+   {
+      for( std::size_t u = 0; u < vectorBuild.size(); u++ )
+      {
+         if( vectorBuildMatch[u] == 0 ) vectorMatch.push_back( { vectorBuild[u].m_uRow, uEnd_ } );
+      }
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief check that key columns can be joined, raw values are compared so types need to match
+ * @return true if ok, false and error information if keys can't be compared
+ */
+std::pair<bool, std::string> join_check_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2 )
+{
+   if( vectorColumn1.empty() == true || vectorColumn1.size() != vectorColumn2.size() ) return { false, "Join needs same number of key columns in both tables" };
+
+   for( std::size_t u = 0; u < vectorColumn1.size(); u++ )
+   {
+      unsigned uColumn1 = vectorColumn1[u], uColumn2 = vectorColumn2[u];
+      if( uColumn1 >= pT1_->get_column_count() || uColumn2 >= pT2_->get_column_count() ) return { false, "Join key column is out of range, key: " + std::to_string( u ) };
+
+      unsigned uType1 = pT1_->column_get_ctype_number( uColumn1 ), uType2 = pT2_->column_get_ctype_number( uColumn2 );
+      if( uType1 != uType2 )
+      {
+         std::string stringError = "Join key columns have different types, key: " + std::to_string( u );
+         stringError += " (" + std::string( gd::types::type_name_g( uType1 ) ) + " and " + std::string( gd::types::type_name_g( uType2 ) ) + ")";
+         return { false, stringError };
+      }
+   }
+   return { true, "" };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief hash join between two tables on one or more key columns
+ * Hash table is built for the smaller table. If more than one thread is used
+ * rows are partitioned on hash and each partition is joined in its own thread.
+ * @return true if ok, false and error information if key columns can't be compared
+ */
+std::pair<bool, std::string> join_hash_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, unsigned uThreadCount, enumJoin eJoin )
+{
+   auto result_ = join_check_s( pT1_, vectorColumn1, pT2_, vectorColumn2 );
+   if( result_.first == false ) return result_;
+   if( uThreadCount == 0 ) uThreadCount = 1;
+
+   std::vector<join_row> vectorRow1, vectorRow2;
+   std::vector<uint64_t> vectorNull1, vectorNull2;
+   join_collect_s( pT1_, vectorColumn1, uThreadCount, vectorRow1, vectorNull1 );
+   join_collect_s( pT2_, vectorColumn2, uThreadCount, vectorRow2, vectorNull2 );
+
+   bool bBuildIsFirst = vectorRow1.size() < vectorRow2.size();
+   const table_column_buffer* pBuild = bBuildIsFirst ? pT1_ : pT2_;
+   const table_column_buffer* pProbe = bBuildIsFirst ? pT2_ : pT1_;
+   const auto& vectorBuildColumn = bBuildIsFirst ? vectorColumn1 : vectorColumn2;
+   const auto& vectorProbeColumn = bBuildIsFirst ? vectorColumn2 : vectorColumn1;
+   const auto& vectorBuild = bBuildIsFirst ? vectorRow1 : vectorRow2;
+   const auto& vectorProbe = bBuildIsFirst ? vectorRow2 : vectorRow1;
+
+   if( uThreadCount == 1 )
+   {
+      join_partition_s( pBuild, vectorBuildColumn, vectorBuild, pProbe, vectorProbeColumn, vectorProbe, bBuildIsFirst, eJoin, vectorMatch );
+   }
+   else
+   {
+      // ## partition rows on high bits in hash, low bits are used for buckets
+      unsigned uPartitionBits = 0;
+      while( ( 1u << uPartitionBits ) < uThreadCount * 4 ) uPartitionBits++;
+      const unsigned uPartitionCount = 1u << uPartitionBits;
+      std::vector< std::vector<join_row> > vectorPartBuild( uPartitionCount ), vectorPartProbe( uPartitionCount );
+      for( const auto& it : vectorBuild ) vectorPartBuild[it.m_uHash >> ( 64 - uPartitionBits )].push_back( it );
+      for( const auto& it : vectorProbe ) vectorPartProbe[it.m_uHash >> ( 64 - uPartitionBits )].push_back( it );
+
+      std::vector< std::vector< std::pair<uint64_t, uint64_t> > > vectorPartMatch( uPartitionCount );
+      std::atomic<unsigned> uNextPartition{ 0 };
+      auto join_ = [&]() {
+         for( unsigned u = uNextPartition++; u < uPartitionCount; u = uNextPartition++ )
+         {
+            join_partition_s( pBuild, vectorBuildColumn, vectorPartBuild[u], pProbe, vectorProbeColumn, vectorPartProbe[u], bBuildIsFirst, eJoin, vectorPartMatch[u] );
+         }
+      };
+
+      std::vector<std::thread> vectorThread;
+      for( unsigned u = 0; u < uThreadCount; u++ ) vectorThread.emplace_back( join_ );
+      for( auto& it : vectorThread ) it.join();
+
+      for( const auto& it : vectorPartMatch ) vectorMatch.insert( vectorMatch.end(), it.begin(), it.end() );
+   }
+
+   // ## rows in first table with null keys are kept in left and anti join
+   if( eJoin != eJoinInner )
+   {
+      for( auto uRow : vectorNull1 ) vectorMatch.push_back( { uRow, uint64_t(-1) } );
+   }
+
+   return { true, "" };
+}
+
+} // namespace
+
+/** ---------------------------------------------------------------------------
+ * @brief inner join, all pairs of rows where key values match in both tables
+ * @code
+std::vector< std::pair<uint64_t, uint64_t> > vectorMatch;
+table_column_buffer::join_s( &tableOrder, { 0, 1 }, &tableCustomer, { 0, 2 }, vectorMatch, tag_join_inner{} );
+ * @endcode
+ * Key values are compared using raw bytes in table, so column types for keys need to match.
+ * Types are checked before rows are read and error is returned if they differ.
+ * @param pT1_ first table
+ * @param vectorColumn1 key columns in first table
+ * @param pT2_ second table
+ * @param vectorColumn2 key columns in second table, same number of columns as for first table
+ * @param vectorMatch gets row pairs, first is row in first table and second is row in second table
+ * @param uThreadCount number of threads used to join, 1 = no threads and pairs are in order of the probed table
+ * @return true if ok, false and error information if key columns can't be joined
+*/
+std::pair<bool, std::string> table_column_buffer::join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, unsigned uThreadCount, tag_join_inner )
+{
+   return join_hash_s( pT1_, vectorColumn1, pT2_, vectorColumn2, vectorMatch, uThreadCount, eJoinInner );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief left join, all rows in first table with matching rows in second table
+ * Rows in first table without match get `uint64_t(-1)` as row for second table.
+ * @see join_s with tag_join_inner for parameters
+*/
+std::pair<bool, std::string> table_column_buffer::join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, unsigned uThreadCount, tag_join_left )
+{
+   return join_hash_s( pT1_, vectorColumn1, pT2_, vectorColumn2, vectorMatch, uThreadCount, eJoinLeft );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief anti join, rows in first table that do not have any match in second table
+ * Second value in pairs is always `uint64_t(-1)`.
+ * @see join_s with tag_join_inner for parameters
+*/
+std::pair<bool, std::string> table_column_buffer::join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, unsigned uThreadCount, tag_join_anti )
+{
+   return join_hash_s( pT1_, vectorColumn1, pT2_, vectorColumn2, vectorMatch, uThreadCount, eJoinAnti );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief create table with values from joined rows
+ * If join table do not have any columns, columns from first table and then
+ * columns from second table are added. Columns in second table with names that
+ * are already used gets the name as alias. Rows without match in second table
+ * (`uint64_t(-1)`) get null values for second table columns.
+ * @code
+dto::table tableJoin;
+table_column_buffer::join_s( &tableOrder, { 1 }, &tableCustomer, { 0 }, tableJoin, 1, tag_join_left{} );
+ * @endcode
+ * @param pT1_ first table
+ * @param pT2_ second table
+ * @param vectorMatch row pairs from join
+ * @param tableJoin table that gets joined rows
+*/
+void table_column_buffer::join_s( const table_column_buffer* pT1_, const table_column_buffer* pT2_, const std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, table_column_buffer& tableJoin )
+{
+   const unsigned uColumnCount1 = pT1_->get_column_count();
+   const unsigned uColumnCount2 = pT2_->get_column_count();
+
+   if( tableJoin.column_empty() == true )
+   {
+      argument::column column_;
+      for( unsigned u = 0; u < uColumnCount1; u++ ) { pT1_->column_get( u, column_ ); tableJoin.column_add( column_ ); }
+      for( unsigned u = 0; u < uColumnCount2; u++ )
+      {
+         pT2_->column_get( u, column_ );
+         if( column_.name().empty() == false && tableJoin.column_find_index( column_.name() ) != -1 ) // name already used by first table, keep name as alias
+         {
+            if( column_.alias().empty() == true ) column_.alias( column_.name() );
+            column_.name( std::string_view{} );
+         }
+         tableJoin.column_add( column_ );
+      }
+
+      bool bNull = pT1_->is_null() || pT2_->is_null() || std::any_of( vectorMatch.begin(), vectorMatch.end(), []( const auto& it ) { return it.second == uint64_t(-1); } );
+      if( bNull == true && tableJoin.is_null() == false )                      // null values are needed, turn on null flags
+      {                                                                                            assert( (uColumnCount1 + uColumnCount2) <= 64 );
+         tableJoin.set_flags( tableJoin.m_uFlags | ( (uColumnCount1 + uColumnCount2) <= 32 ? eTableFlagNull32 : eTableFlagNull64 ) );
+      }
+
+      if( vectorMatch.empty() == false ) tableJoin.set_reserved_row_count( vectorMatch.size() );
+      tableJoin.prepare();
+   }
+   else
+   {                                                                                               assert( tableJoin.get_column_count() == (uColumnCount1 + uColumnCount2) );
+      if( vectorMatch.empty() == false ) tableJoin.row_reserve_add( vectorMatch.size() );
+   }
+
+   std::vector<gd::variant_view> vectorValue( uColumnCount1 + uColumnCount2 );
+   for( const auto& it : vectorMatch )
+   {
+      for( unsigned u = 0; u < uColumnCount1; u++ ) vectorValue[u] = pT1_->cell_get_variant_view( it.first, u );
+      for( unsigned u = 0; u < uColumnCount2; u++ )
+      {
+         vectorValue[uColumnCount1 + u] = it.second != uint64_t(-1) ? pT2_->cell_get_variant_view( it.second, u ) : gd::variant_view();
+      }
+      tableJoin.row_add( vectorValue );
+   }
+}
+
 
 
 _GD_TABLE_END
@@ -3825,4 +5994,234 @@ std::string debug::print_row( const table_column_buffer& table, uint64_t uRow )
 }
 
 
+/** ---------------------------------------------------------------------------
+ * @brief Compare table with new version of table, rows are matched on key columns
+ *
+ * Rows in old table (this table) are hashed on key values and rows in new
+ * table are looked up in hash table, this is done in O(n). Matched rows where
+ * hash for all values differ are modified. Tables with row hash cache
+ * (`index_add( ..., tag_index_row_hash{} )`) for all columns use cached hash.
+ * Rows with null in any key column never match. Values are compared on hash,
+ * tables need to have same column types.
+ * @code
+gd::table::table_diff diff_ = tableOld.diff( tableNew, { 0 } );                // column 0 is key
+for( auto it : diff_.m_vectorModify ) { std::cout << "row " << it.first << " is modified\n"; }
+tableOld.apply( tableNew, diff_ );                                             // tableOld has same rows as tableNew
+ * @endcode
+ * @param tableNew new version of table
+ * @param vectorKey key columns, same columns in both tables
+ * @param diff_ gets inserted, deleted and modified rows
+*/
+void table_column_buffer::diff( const table_column_buffer& tableNew, const std::vector<unsigned>& vectorKey, table_diff& diff_ ) const
+{                                                                                                  assert( get_column_count() == tableNew.get_column_count() ); assert( vectorKey.empty() == false );
+   diff_.clear();
+
+   // ## hash key values in old table
+   std::vector<join_row> vectorOld;
+   join_collect_s( this, vectorKey, 1, vectorOld, diff_.m_vectorDelete );     // rows with null key values are deleted
+
+   // ## open addressing hash table with index to row in old rows
+   const uint64_t uSlotCount = std::bit_ceil( (uint64_t)vectorOld.size() * 2 + 2 );
+   const uint64_t uMask = uSlotCount - 1;
+   std::vector<uint64_t> vectorSlot( uSlotCount, (uint64_t)-1 );
+   for( uint64_t u = 0; u < vectorOld.size(); u++ )
+   {
+      uint64_t uSlot = vectorOld[u].m_uHash & uMask;
+      while( vectorSlot[uSlot] != (uint64_t)-1 ) uSlot = ( uSlot + 1 ) & uMask;
+      vectorSlot[uSlot] = u;
+   }
+
+   const index_row_hash* pindexOld = m_vectorIndex.empty() == false ? index_get_row_hash() : nullptr;
+   const index_row_hash* pindexNew = tableNew.m_vectorIndex.empty() == false ? tableNew.index_get_row_hash() : nullptr;
+
+   // ## probe with rows in new table, rows with equal keys are matched in row order
+   std::vector<uint8_t> vectorMatch( vectorOld.size(), 0 );
+   for( uint64_t uRow = 0, uMax = tableNew.get_row_count(); uRow < uMax; uRow++ )
+   {
+      uint64_t uHash;
+      if( join_hash_s( &tableNew, uRow, vectorKey, uHash ) == false ) { diff_.m_vectorInsert.push_back( uRow ); continue; }
+
+      uint64_t uOld = (uint64_t)-1;
+      for( uint64_t uSlot = uHash & uMask; vectorSlot[uSlot] != (uint64_t)-1; uSlot = ( uSlot + 1 ) & uMask )
+      {
+         uint64_t u = vectorSlot[uSlot];
+         if( vectorMatch[u] == 0 && vectorOld[u].m_uHash == uHash && join_equal_s( this, vectorOld[u].m_uRow, vectorKey, &tableNew, uRow, vectorKey ) == true ) { uOld = u; break; }
+      }
+
+      if( uOld == (uint64_t)-1 ) { diff_.m_vectorInsert.push_back( uRow ); continue; }
+
+      vectorMatch[uOld] = 1;
+      uint64_t uRowOld = vectorOld[uOld].m_uRow;
+      uint64_t uHashOld = pindexOld != nullptr ? pindexOld->get( uRowOld ) : row_hash( uRowOld );
+      uint64_t uHashNew = pindexNew != nullptr ? pindexNew->get( uRow ) : tableNew.row_hash( uRow );
+      if( uHashOld != uHashNew ) diff_.m_vectorModify.push_back( { uRowOld, uRow } );
+   }
+
+   for( uint64_t u = 0; u < vectorOld.size(); u++ ) { if( vectorMatch[u] == 0 ) diff_.m_vectorDelete.push_back( vectorOld[u].m_uRow ); }
+   std::sort( diff_.m_vectorDelete.begin(), diff_.m_vectorDelete.end() );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Patch table with differences from `diff`
+ * Modified rows only set cells with other values, inserted rows are added at
+ * the end and deleted rows are removed last, rows after deleted rows are moved
+ * up. Table need to be the old table used in `diff` and not modified after diff.
+ * @param tableNew new version of table that values are read from
+ * @param diff_ differences from `diff`
+*/
+void table_column_buffer::apply( const table_column_buffer& tableNew, const table_diff& diff_ )
+{                                                                                                  assert( get_column_count() == tableNew.get_column_count() );
+   const unsigned uColumnCount = get_column_count();
+
+   // ## modified rows
+   for( const auto& it : diff_.m_vectorModify )
+   {                                                                                               assert( it.first < get_row_count() ); assert( it.second < tableNew.get_row_count() );
+      for( unsigned uColumn = 0; uColumn < uColumnCount; uColumn++ )
+      {
+         auto vOld_ = cell_get( it.first, uColumn, tag_raw{} );
+         auto vNew_ = tableNew.cell_get( it.second, uColumn, tag_raw{} );
+         if( ( vOld_.first == nullptr ) == ( vNew_.first == nullptr ) && vOld_.second == vNew_.second && ( vOld_.first == nullptr || memcmp( vOld_.first, vNew_.first, vOld_.second ) == 0 ) ) continue;
+         cell_set( it.first, uColumn, tableNew.cell_get_variant_view( it.second, uColumn ) );
+      }
+   }
+
+   // ## inserted rows
+   if( diff_.m_vectorInsert.empty() == false )
+   {
+      uint64_t uRow = get_row_count();
+      if( is_null() == true ) row_add( diff_.m_vectorInsert.size(), tag_null{} );
+      else                    row_add( diff_.m_vectorInsert.size() );
+      for( auto uRowNew : diff_.m_vectorInsert )
+      {
+         for( unsigned uColumn = 0; uColumn < uColumnCount; uColumn++ ) cell_set( uRow, uColumn, tableNew.cell_get_variant_view( uRowNew, uColumn ) );
+         if( is_rowstatus() == true && tableNew.is_rowstatus() == true ) row_set_state( uRow, *tableNew.row_get_state( uRowNew ) );
+         uRow++;
+      }
+   }
+
+   // ## deleted rows, rows that are kept are moved up in one pass
+   if( diff_.m_vectorDelete.empty() == false )
+   {                                                                                               assert( std::is_sorted( diff_.m_vectorDelete.begin(), diff_.m_vectorDelete.end() ) == true );
+      std::size_t uIndex = 0;
+      uint64_t uTo = diff_.m_vectorDelete[0];
+      for( uint64_t uRow = uTo, uMax = get_row_count(); uRow < uMax; uRow++ )
+      {
+         if( uIndex < diff_.m_vectorDelete.size() && diff_.m_vectorDelete[uIndex] == uRow ) { uIndex++; continue; }
+         row_set( uTo, uRow );
+         uTo++;
+      }
+      set_row_count( uTo );
+   }
+}
+
+namespace {
+   /// compare raw values in columns for two rows in table, null is equal to null
+   bool distinct_equal_s( const table_column_buffer* ptable, uint64_t uRow1, uint64_t uRow2, const std::vector<unsigned>& vectorColumn )
+   {
+      for( auto uColumn : vectorColumn )
+      {
+         auto v1_ = ptable->cell_get( uRow1, uColumn, tag_raw{} );
+         auto v2_ = ptable->cell_get( uRow2, uColumn, tag_raw{} );
+         if( ( v1_.first == nullptr ) != ( v2_.first == nullptr ) || v1_.second != v2_.second ) return false;
+         if( v1_.first != nullptr && memcmp( v1_.first, v2_.first, v1_.second ) != 0 ) return false;
+      }
+      return true;
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Find first row for each unique value in columns
+ *
+ * Rows are hashed on raw values in columns (reference values are hashed on
+ * referenced value) and placed in open addressing hash table with one slot
+ * for each unique value, table is not sorted and rows are returned in table
+ * order. Hash table grows when half of slots are used so memory depends on
+ * number of unique values and not on number of rows.
+ *
+ * Rows with equal hash are compared on raw values. Null is equal to null and
+ * never equal to a value, so null in key column is one distinct value. Count
+ * for unique value is number of rows that matched first row, first row included.
+ * @code
+std::vector<uint64_t> vectorRow, vectorCount;
+table_.distinct( { 0, 2 }, vectorRow, &vectorCount );      // vectorCount[u] = number of rows with same values as vectorRow[u]
+ * @endcode
+ * @param vectorColumn columns with values, empty for all columns
+ * @param vectorRow gets first row for each unique value
+ * @param pvectorCount if not null, gets number of rows for each unique value
+*/
+void table_column_buffer::distinct( const std::vector<unsigned>& vectorColumn, std::vector<uint64_t>& vectorRow, std::vector<uint64_t>* pvectorCount ) const
+{
+   vectorRow.clear();
+   if( pvectorCount != nullptr ) pvectorCount->clear();
+
+   std::vector<unsigned> vectorAll;
+   if( vectorColumn.empty() == true ) { for( unsigned u = 0, uMax = get_column_count(); u < uMax; u++ ) vectorAll.push_back( u ); }
+   const std::vector<unsigned>& vectorKey = vectorColumn.empty() == true ? vectorAll : vectorColumn;
+
+   struct slot { uint64_t m_uHash; uint64_t m_uIndex; };                      // index to unique value, -1 for empty slot
+   uint64_t uSlotCount = 1024;
+   uint64_t uMask = uSlotCount - 1;
+   std::vector<slot> vectorSlot( uSlotCount, slot{ 0, (uint64_t)-1 } );
+
+   for( uint64_t uRow = 0, uMax = get_row_count(); uRow < uMax; uRow++ )
+   {
+      uint64_t uHash = row_hash( uRow, vectorKey );
+      uint64_t uSlot = uHash & uMask;
+      for( ; vectorSlot[uSlot].m_uIndex != (uint64_t)-1; uSlot = ( uSlot + 1 ) & uMask )
+      {
+         const slot& slot_ = vectorSlot[uSlot];
+         if( slot_.m_uHash == uHash && distinct_equal_s( this, vectorRow[slot_.m_uIndex], uRow, vectorKey ) == true ) break;
+      }
+
+      if( vectorSlot[uSlot].m_uIndex != (uint64_t)-1 )
+      {
+         if( pvectorCount != nullptr ) (*pvectorCount)[vectorSlot[uSlot].m_uIndex]++;
+         continue;
+      }
+
+      vectorSlot[uSlot] = slot{ uHash, vectorRow.size() };
+      vectorRow.push_back( uRow );
+      if( pvectorCount != nullptr ) pvectorCount->push_back( 1 );
+
+      // ## grow hash table when half of slots are used, slots are placed with stored hash
+      if( vectorRow.size() * 2 > uSlotCount )
+      {
+         uSlotCount *= 2;
+         uMask = uSlotCount - 1;
+         std::vector<slot> vectorGrow( uSlotCount, slot{ 0, (uint64_t)-1 } );
+         for( const auto& it : vectorSlot )
+         {
+            if( it.m_uIndex == (uint64_t)-1 ) continue;
+            uint64_t uTo = it.m_uHash & uMask;
+            while( vectorGrow[uTo].m_uIndex != (uint64_t)-1 ) uTo = ( uTo + 1 ) & uMask;
+            vectorGrow[uTo] = it;
+         }
+         vectorSlot.swap( vectorGrow );
+      }
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Copy unique values in columns to table
+ * If table do not have columns then selected columns are added and null flags
+ * are taken from this table, otherwise unique values are added as rows.
+ * @param vectorColumn columns with values, empty for all columns
+ * @param tableDistinct table that gets one row for each unique value
+*/
+void table_column_buffer::distinct( const std::vector<unsigned>& vectorColumn, table_column_buffer& tableDistinct ) const
+{                                                                                                  assert( &tableDistinct != this );
+   std::vector<unsigned> vectorAll;
+   if( vectorColumn.empty() == true ) { for( unsigned u = 0, uMax = get_column_count(); u < uMax; u++ ) vectorAll.push_back( u ); }
+   const std::vector<unsigned>& vectorKey = vectorColumn.empty() == true ? vectorAll : vectorColumn;
+
+   if( tableDistinct.column_empty() == true && tableDistinct.get_flags() == 0 )
+   {
+      tableDistinct.set_flags( get_flags() & ( eTableFlagNull32 | eTableFlagNull64 ) );
+   }
+
+   std::vector<uint64_t> vectorRow;
+   distinct( vectorKey, vectorRow, nullptr );
+   harvest( vectorKey, vectorRow, tableDistinct );
+}
+
 _GD_TABLE_END
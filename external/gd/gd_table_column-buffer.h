@@ -1,8 +1,11 @@
 ﻿#pragma once
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <functional>
+#include <memory>
+#include <span>
 #include <string_view>
 #include <string>
 #include <tuple>
@@ -11,6 +14,7 @@
 
 #include "gd_arguments.h"
 #include "gd_table.h"
+#include "gd_table_index.h"
 #include "gd_types.h"
 #include "gd_variant_view.h"
 
@@ -59,6 +63,42 @@ All is stored in one single memory block.
 If table need to grow memory block it creates a new block that is larger and data
 is copied to that block, old block is deleted.
 
+*Columnar storage*
+
+If table is prepared with flag `eTableFlagColumnar` values for each column are
+stored in its own array (struct of arrays) instead of interleaved in rows. Column
+arrays are placed after each other in the same memory block, column position
+multiplied with reserved row count is the offset to column array. Null flags are
+stored as one bit array for each column and row state is stored in array after null
+bits. Reserved row count is rounded up to `eSpaceColumnarRows` so each column array
+and bit array starts at a 64 byte boundary relative to block.
+Scanning values in one column only touches memory for that column. Use `cell_get`
+and the `column_get_data` methods to access values, `row_get` do not work for
+columnar tables.
+
+    ╔═══════╗╔════════════╗╔═════════════════════════╗╔════╗
+    ║ int32 ║║   int64    ║║         string          ║║int8║
+    ║ ...   ║║   ...      ║║         ...             ║║... ║
+    ╚═══════╝╚════════════╝╚═════════════════════════╝╚════╝
+
+*Segmented storage*
+
+If table is prepared with flag `eTableFlagSegmented` rows are stored in segments,
+memory blocks with a fixed number of rows (power of 2, default `eSpaceSegmentRows`).
+Each segment has row data followed by meta data for rows in segment. When table
+needs to grow a new segment is added to the segment directory, rows already added
+are not moved. `row_get` finds segment with row index shifted and position in
+segment with row index masked. Rows are only stored after each other within a
+segment, `row_get_contiguous` returns number of rows that can be stepped with row
+size. Segmented tables are row based and can not be combined with columnar.
+
+    ╔═════════════════════════╗ ╔═════════════════════════╗
+    ║ segment 0 rows | meta   ║ ║ segment 1 rows | meta   ║ ...
+    ╚═════════════════════════╝ ╚═════════════════════════╝
+    ╔═══════════════════════════════════════════════╗
+    ║ null bits column 0 | column 1 | ... row state ║
+    ╚═══════════════════════════════════════════════╝
+
 *Sample data layout*
 
     ╔═══════╦════════════╦═════════════════════════╦════╗
@@ -133,7 +173,10 @@ public:
       eTableFlagNull64        = 0x0002,                                        ///< reserve 64 bit for each row to mark null for column if no value
       eTableStateRowStatus    = 0x0004,                                        ///< enable row status (if row is valid, modified, deleted)
       eTableFlagRowStatus     = 0x0004,                                        ///< enable row status (if row is valid, modified, deleted)
-      eTableStateMAX          = 0x0010,                                        ///< max state value
+      eTableFlagColumnar      = 0x0008,                                        ///< store values for each column in own array (struct of arrays), selected when table is prepared
+      eTableFlagDictionary    = 0x0010,                                        ///< reference columns store 32 bit code for value in deduplicated references (dictionary encoded)
+      eTableFlagSegmented     = 0x0020,                                        ///< store rows in fixed size segments, table grows with new segments and rows are never moved
+      eTableStateMAX          = 0x0040,                                        ///< max state value
 
       // ## size information used to calculate space needed by table
       eSpaceNull32Columns     = sizeof( uint32_t ),                            ///< space marking null columns
@@ -141,6 +184,8 @@ public:
       eSpaceRowState          = sizeof( uint32_t ),                            ///< space where row state data is placed
       eSpaceRowGrowBy         = 10,                                            ///< default number of rows to grow by
       eSpaceFirstAllocate     = 10,                                            ///< number of rows to allocate before any values is added
+      eSpaceColumnarRows      = 64,                                            ///< reserved rows in columnar table is a multiple of this value
+      eSpaceSegmentRows       = 4096,                                          ///< default number of rows in each segment for segmented table
 
    };
 
@@ -332,6 +377,7 @@ public:
 // copy
    table_column_buffer( const table_column_buffer& o ): m_puData(nullptr) { common_construct( o ); }
    table_column_buffer( const table_column_buffer& o, tag_columns ): m_puData(nullptr) { common_construct( o, tag_columns{}); }
+   table_column_buffer( const table_column_buffer& o, tag_copy_on_write ): m_puData(nullptr) { common_construct( o, tag_copy_on_write{}); }
    table_column_buffer( table_column_buffer&& o ) noexcept : m_puData(nullptr) { common_construct( std::move( o ) ); }
    table_column_buffer( const table_column_buffer& o, uint64_t uFrom, uint64_t uCount );
    table_column_buffer( const table_column_buffer& o, const std::vector<uint64_t> vectorRow );
@@ -342,7 +388,8 @@ public:
 
    ~table_column_buffer() 
    { 
-      delete[] m_puData;
+      segment_clear();
+      if( m_pDataOwner == nullptr ) delete[] m_puData;
    }
    ///@}
 
@@ -350,6 +397,7 @@ private:
 // common copy
    void common_construct( const table_column_buffer& o );
    void common_construct( const table_column_buffer& o, tag_columns );
+   void common_construct( const table_column_buffer& o, tag_copy_on_write );
    void common_construct( const table_column_buffer& o, const std::vector<unsigned>& vectorColumn, tag_columns );
    void common_construct( table_column_buffer&& o ) noexcept;
 
@@ -387,7 +435,7 @@ public:
    uint64_t get_row_count( uint32_t uFlags ) const noexcept;
    /// Last valid row index where to insert cell values
    uint64_t get_row_back() const noexcept { assert( m_puData != nullptr ); return m_uRowCount - 1; }
-   void set_row_count( uint64_t uCount ) { assert( uCount <= m_uReservedRowCount ); m_uRowCount = uCount; }
+   void set_row_count( uint64_t uCount );
    void set_reserved_row_count( uint64_t uCount ) { assert( uCount >= m_uRowCount ); m_uReservedRowCount = uCount; }
 
    // ## state methods, check state flags
@@ -397,6 +445,11 @@ public:
    bool is_null64() const { return m_uFlags & eTableFlagNull64; }
    bool is_rowstatus() const { return m_uFlags & eTableFlagRowStatus; }
    bool is_rowmeta() const { return m_puMetaData != nullptr; }
+   bool is_columnar() const { return m_uFlags & eTableFlagColumnar; }
+   bool is_dictionary() const { return m_uFlags & eTableFlagDictionary; }
+   bool is_segmented() const { return m_uFlags & eTableFlagSegmented; }
+   /// data block is external (like memory mapped file) and not owned by table
+   bool is_data_external() const noexcept { return m_pDataOwner != nullptr; }
 
    unsigned size_row() const noexcept { return m_uRowSize; }
    unsigned size_row_meta() const noexcept;
@@ -410,6 +463,9 @@ public:
    uint64_t size_reserved_total( uint64_t uRowCount ) const noexcept { return (m_uRowSize + size_row_meta()) * uRowCount; }
 
    const names& get_names() const noexcept { return m_namesColumn; }
+   /// values for reference columns, equal values share code (index to value)
+   const references& get_references() const noexcept { return m_references; }
+   references& get_references() noexcept { return m_references; }
 
 //@}
 
@@ -490,6 +546,14 @@ public:
    void column_set_size( unsigned uIndex, unsigned uSize ) { assert( uIndex < get_column_count() ); m_vectorColumn.at(uIndex).size( uSize ); }
    void column_set_size( const std::string_view& stringName, unsigned uSize ) { column_set_size( column_get_index( stringName ), uSize ); }
    unsigned column_get_primitive_size( unsigned uIndex ) const noexcept { assert( uIndex < get_column_count() ); return m_vectorColumn.at(uIndex).primitive_size(); }
+   /// buffer size in bytes for each value in column (aligned size that value occupies in table)
+   unsigned column_get_width( unsigned uIndex ) const noexcept;
+   /// columnar table: pointer to first value in column array
+   uint8_t* column_get_data( unsigned uIndex ) const noexcept { assert( is_columnar() == true ); assert( uIndex < get_column_count() ); return m_puData + (uint64_t)m_vectorColumn[uIndex].position() * m_uReservedRowCount; }
+   /// columnar table: pointer to null bits for column, one bit for each row
+   uint64_t* column_get_null( unsigned uIndex ) const noexcept { assert( is_columnar() == true ); assert( is_null() == true ); return reinterpret_cast<uint64_t*>( m_puMetaData + uIndex * (m_uReservedRowCount / 8) ); }
+   /// set or clear null flag for row in columnar table, used when rows are moved (indexes are not notified)
+   void column_set_null( unsigned uIndex, uint64_t uRow, bool bNull ) noexcept { uint64_t* puNull = column_get_null( uIndex ) + (uRow >> 6); bNull ? *puNull |= (1ULL << (uRow & 63)) : *puNull &= ~(1ULL << (uRow & 63)); }
    std::string_view column_get_name( unsigned uIndex ) const;
    std::string_view column_get_name( const column& column ) const;
    std::vector<std::string_view> column_get_name() const;
@@ -551,22 +615,34 @@ public:
 
    /// Prepares table for use, this has to be called before adding values to table
    std::pair<bool, std::string> prepare();
+   /// Prepares table to use external data block (rows followed by meta data), `pDataOwner` keeps block alive and table do not delete it
+   std::pair<bool, std::string> prepare( uint8_t* puData, uint64_t uRowCount, uint64_t uReservedRowCount, std::shared_ptr<void> pDataOwner );
+protected:
+   /// calculate position for each column and row sizes
+   void prepare_row_layout();
+   /// delete data block if owned by table, external block is released
+   void data_delete() noexcept { if( m_pDataOwner == nullptr ) delete [] m_puData; m_pDataOwner.reset(); m_puData = nullptr; }
+public:
 
 
    // ## row methods, row related functionality 
 
-   void row_set_state( uint64_t uRow, unsigned uFlags ) { assert( uRow < m_uReservedRowCount ); *row_get_state( uRow ) = uFlags; }
+   void row_set_state( uint64_t uRow, unsigned uFlags ) { assert( uRow < m_uReservedRowCount ); if( is_segment_shared() == true ) segment_write( uRow, 1 ); *row_get_state( uRow ) = uFlags; if( m_bRowFree == true ) row_free_update( uRow, uFlags ); }
    void row_set_state( uint64_t uRow, unsigned uSet, unsigned uClear ); 
-   uint8_t* row_get( uint64_t uRow ) const noexcept { assert( uRow < m_uReservedRowCount ); return m_puData + uRow * m_uRowSize; }
+   uint8_t* row_get( uint64_t uRow ) const noexcept;
+   /// number of rows from row that are stored after each other in memory (distance between rows is row size)
+   uint64_t row_get_contiguous( uint64_t uRow ) const noexcept;
    uint8_t* row_get_meta( uint64_t uRow ) const noexcept { return row_get_null( uRow ); }
    /// return pointer to section holding null column information
    uint8_t* row_get_null( uint64_t uRow ) const noexcept;
    /// Get pointer to row state part
    uint32_t* row_get_state( uint64_t uRow ) const noexcept;
+   /// number of bytes between row state values for two following rows
+   unsigned row_get_state_stride() const noexcept { return is_columnar() == false ? m_uRowMetaSize : (unsigned)eSpaceRowState; }
    /// if row is in used (when state information is used for row)
    bool row_is_use( uint64_t uRow ) const noexcept;
    /// Get pointer to row part used to mark null columns
-   uint64_t* row_get_null_columns( uint64_t uRow ) const noexcept { assert( uRow < m_uReservedRowCount ); return reinterpret_cast<uint64_t*>(m_puData + uRow * m_uRowSize); }
+   uint64_t* row_get_null_columns( uint64_t uRow ) const noexcept { assert( uRow < m_uReservedRowCount ); return reinterpret_cast<uint64_t*>( row_get( uRow ) ); }
 
 
    // ### edit rows (add or remove)
@@ -640,14 +716,14 @@ public:
    /// clears all rows in table
    ///@{
    /// Clears all rows in table (just set the row count to 0)
-   void row_clear() { m_uRowCount = 0; }
+   void row_clear() { m_uRowCount = 0; if( is_notify() == true ) index_notify_clear(); }
    ///@}
 
     /// @name row_delete
    /// deletes last row in table
    ///@{
    /// Deletes last row in table (by decreasing the row count)
-   void row_delete() { if (m_uRowCount > 0) m_uRowCount--; }
+   void row_delete() { if (m_uRowCount > 0) { if( is_notify() == true ) index_notify_erase( m_uRowCount - 1, 1 ); m_uRowCount--; } }
    ///@}
 
    /// @name row_reserve_add
@@ -713,6 +789,8 @@ public:
 
    uint8_t* cell_get( uint64_t uRow, unsigned uColumn ) noexcept;
    const uint8_t* cell_get( uint64_t uRow, unsigned uColumn ) const noexcept;
+   /// number of bytes between values for two following rows in column
+   unsigned cell_get_stride( unsigned uColumn ) const noexcept { return is_columnar() == false ? m_uRowSize : column_get_width( uColumn ); }
    uint8_t* cell_get( uint64_t uRow, const std::string_view& stringName ) noexcept;
    uint8_t* cell_get( uint64_t uRow, const std::string_view& stringAlias, tag_alias ) noexcept;
    uint8_t* cell_get( uint64_t uRow, const std::string_view& stringWildcard, tag_wildcard ) noexcept;
@@ -724,6 +802,10 @@ public:
 
    bool cell_is_null( uint64_t uRow, unsigned uColumn ) const noexcept;
    const reference* cell_get_reference( uint64_t uRow, unsigned uColumn ) const noexcept;
+   /// return code (index in references) for value in reference column, -1 if null or column isn't reference column
+   int64_t cell_get_code( uint64_t uRow, unsigned uColumn ) const noexcept;
+   /// return code stored in reference cell, width for code depends on `eTableFlagDictionary`
+   uint64_t cell_get_code( const uint8_t* puValue ) const noexcept { return is_dictionary() == true ? (uint64_t)*(const uint32_t*)puValue : *(const uint64_t*)puValue; }
 
    gd::variant_view cell_get_variant_view( uint64_t uRow, unsigned uColumn ) const noexcept;
    std::vector< gd::variant_view > cell_get_variant_view( uint64_t uRow, unsigned uFromColumn, unsigned uToColumn ) const;
@@ -734,6 +816,8 @@ public:
    gd::variant_view cell_get_variant_view( const std::string_view& stringAlias, tag_alias ) const noexcept { assert(m_uRowCount != 0); return cell_get_variant_view( m_uRowCount -1, stringAlias, tag_alias{}); }
    /// return value without any checks, use this if you know about the internals and just need the value
    gd::variant_view cell_get_variant_view( uint64_t uRow, unsigned uColumn, tag_raw ) const noexcept;
+   /// return pointer to value bytes and size in bytes for value, null values returns nullptr
+   std::pair<const uint8_t*, unsigned> cell_get( uint64_t uRow, unsigned uColumn, tag_raw ) const noexcept;
    /// get cell value using name or column index, if name then column gets index to speed up the process next time value is returned
    gd::variant_view cell_get_variant_view( uint64_t uRow, std::variant< unsigned, std::string_view >* pvariantColumn ) const noexcept;
 
@@ -768,6 +852,8 @@ public:
    int64_t find( const std::string_view& stringName, const gd::variant_view& variantviewFind ) const noexcept { return find_variant_view( stringName, 0, get_row_count(), variantviewFind ); }
    int64_t find( unsigned uColumn, bool bAscending, const gd::variant_view& variantviewFind ) const noexcept { return find_variant_view( uColumn, bAscending, 0, get_row_count(), variantviewFind ); }
    int64_t find( unsigned uColumn, uint64_t uStartRow, uint64_t uCount, const gd::variant_view& variantviewFind ) const noexcept;
+   /// find value reading all rows, zone map is not used
+   int64_t find( unsigned uColumn, uint64_t uStartRow, uint64_t uCount, const gd::variant_view& variantviewFind, tag_raw ) const noexcept;
 
    int64_t find_variant_view( unsigned uColumn, uint64_t uStartRow, uint64_t uCount, const gd::variant_view& variantviewFind ) const noexcept;
    int64_t find_variant_view( const std::string_view& stringName, uint64_t uStartRow, uint64_t uCount, const gd::variant_view& variantviewFind ) const noexcept;
@@ -779,6 +865,17 @@ public:
    int64_t find_variant_view( const std::string_view& stringName, const gd::variant_view& variantviewFind ) const noexcept { return find_variant_view( column_get_index( stringName ), 0, get_row_count(), variantviewFind); }
    range find_variant_view( unsigned uColumn, bool bAscending, const gd::variant_view& variantviewFind, tag_range ) const noexcept { return find_variant_view( uColumn, bAscending, 0, get_row_count(), variantviewFind, tag_range{}); }
 
+   // ## filter methods, mark rows that match filter in selection
+
+   void filter( unsigned uColumn, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue, selection& selectionResult ) const;
+   void filter( unsigned uColumn, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue, selection& selectionResult, bool bAnd ) const;
+   void filter( unsigned uColumn, enumFilter eFilter, const std::initializer_list<gd::variant_view>& listValue, selection& selectionResult ) const { filter( uColumn, eFilter, std::vector<gd::variant_view>( listValue ), selectionResult ); }
+   void filter( unsigned uColumn, enumFilter eFilter, const std::initializer_list<gd::variant_view>& listValue, selection& selectionResult, bool bAnd ) const { filter( uColumn, eFilter, std::vector<gd::variant_view>( listValue ), selectionResult, bAnd ); }
+   void filter( unsigned uColumn, enumFilter eFilter, const gd::variant_view& variantviewValue, selection& selectionResult ) const { filter( uColumn, eFilter, std::vector<gd::variant_view>{ variantviewValue }, selectionResult ); }
+   void filter( const std::string_view& stringName, enumFilter eFilter, const gd::variant_view& variantviewValue, selection& selectionResult ) const { filter( column_get_index( stringName ), eFilter, std::vector<gd::variant_view>{ variantviewValue }, selectionResult ); }
+   void filter( const std::string_view& stringName, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue, selection& selectionResult ) const { filter( column_get_index( stringName ), eFilter, vectorValue, selectionResult ); }
+   selection filter( unsigned uColumn, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue ) const { selection selectionResult; filter( uColumn, eFilter, vectorValue, selectionResult ); return selectionResult; }
+
    /// Find first row marked as free (flag `eRowStateUse` is not used)
    int64_t find_first_free_row( uint64_t uStartRow ) const;
    int64_t find_first_free_row() const { return find_first_free_row( 0 ); }
@@ -788,6 +885,18 @@ public:
    /// count number of free rows
    uint64_t count_free_rows() const;
 
+   // ## free row bitmap, rows without `eRowStateUse` are marked in bitmap that is built when needed and updated in `row_set_state`
+
+   /// build free row bitmap from row state values
+   void row_free_build() const;
+   /// mark bitmap as invalid, call this if row state is modified without `row_set_state`
+   void row_free_invalidate() const noexcept { m_bRowFree = false; }
+   /// move rows in use to start of table and remove rows that are not in use, returns number of removed rows
+   uint64_t vacuum();
+protected:
+   void row_free_update( uint64_t uRow, uint32_t uState ) const noexcept;
+public:
+
 
    // ## property methods for table - set or get property values for table and other property methods
 
@@ -828,6 +937,28 @@ public:
    bool equal( const table_column_buffer& tableEqualTo ) const noexcept { return equal( tableEqualTo, 0, get_row_count() ); }
    ///@}
 
+   /// @name row hash and diff, find rows that differ between tables and patch table with differences
+   ///@{
+   /// hash for values in row, reference values are hashed on value so tables with other references get same hash
+   uint64_t row_hash( uint64_t uRow ) const;
+   uint64_t row_hash( uint64_t uRow, const std::vector<unsigned>& vectorColumn ) const;
+   /// compare with new version of table, rows are matched on key columns
+   void diff( const table_column_buffer& tableNew, const std::vector<unsigned>& vectorKey, table_diff& diff_ ) const;
+   table_diff diff( const table_column_buffer& tableNew, const std::vector<unsigned>& vectorKey ) const { table_diff diff_; diff( tableNew, vectorKey, diff_ ); return diff_; }
+   /// patch table with differences from `diff`, values are read from new table
+   void apply( const table_column_buffer& tableNew, const table_diff& diff_ );
+   ///@}
+
+   /// @name distinct, unique values in columns without sorting table. null values are equal to each other
+   ///@{
+   /// first row for each unique value in columns, rows are in table order
+   std::vector<uint64_t> distinct( const std::vector<unsigned>& vectorColumn, tag_row ) const { std::vector<uint64_t> vectorRow; distinct( vectorColumn, vectorRow, nullptr ); return vectorRow; }
+   /// first row and number of rows for each unique value in columns
+   void distinct( const std::vector<unsigned>& vectorColumn, std::vector<uint64_t>& vectorRow, std::vector<uint64_t>* pvectorCount ) const;
+   /// copy unique values in columns to table, table gets selected columns if it do not have columns
+   void distinct( const std::vector<unsigned>& vectorColumn, table_column_buffer& tableDistinct ) const;
+   ///@}
+
    /// harvest, read, copy (what word is best ?)
 
    /// @name harvest values from table into other type of container objects
@@ -850,6 +981,9 @@ public:
    std::vector< TYPE > harvest( const std::string_view& stringColumnName ) const { return harvest<TYPE>( column_get_index(stringColumnName), ( uint64_t )0, get_row_count()); }
    template<typename TYPE>
    std::vector< TYPE > harvest( const std::string_view& stringColumnName, tag_null ) const { return harvest<TYPE>( column_get_index(stringColumnName), ( uint64_t )0, get_row_count(), tag_null{}); }
+   /// copy values in column to span, starting at row `uFrom`
+   template<typename TYPE>
+   void harvest( unsigned uColumn, uint64_t uFrom, std::span<TYPE> spanValue, uint64_t* puNull = nullptr ) const;
 
    /// harvest row values into vector with arguments
    void harvest( uint64_t uBeginRow, uint64_t uCount, std::vector<gd::argument::arguments>& vectorArguments ) const;
@@ -897,6 +1031,17 @@ public:
 
    void plant( unsigned uColumn, const gd::variant_view& variantviewValue );
    void plant( unsigned uColumn, const gd::variant_view& variantviewValue, uint64_t uFrom, uint64_t uCount );
+   /// copy values from span to column, starting at row `uFrom`
+   template< typename TYPE >
+   void plant( unsigned uColumn, std::span<const TYPE> spanValue, uint64_t uFrom, const uint64_t* puNull = nullptr );
+
+   /// copy all rows from table with same layout into rows from `uTo`, reference codes are mapped with codes from `references::merge`
+   void plant( const table_column_buffer& tableFrom, uint64_t uTo, const std::vector<int64_t>& vectorCode, tag_raw );
+
+   /// set null flags for rows in column from bit array, bit set means null value (nullptr clears null flags)
+   void column_set_null( unsigned uColumn, uint64_t uFrom, uint64_t uCount, const uint64_t* puNull );
+   /// read null flags for rows in column into bit array
+   void column_get_null( unsigned uColumn, uint64_t uFrom, uint64_t uCount, uint64_t* puNull ) const;
 
    void swap( uint64_t uRow1, uint64_t uRow2 );
 
@@ -904,6 +1049,17 @@ public:
 
    void sort( unsigned uColumn, bool bAscending, uint64_t uFrom, uint64_t uCount, tag_sort_selection );
    void sort( unsigned uColumn, bool bAscending, uint64_t uFrom, uint64_t uCount, tag_sort_bubble );
+   void sort( unsigned uColumn, bool bAscending, uint64_t uFrom, uint64_t uCount, tag_sort_typed ) { sort( std::vector<sort_key>{ sort_key( uColumn, bAscending ) }, uFrom, uCount, false, tag_sort_typed{} ); }
+   void sort( const std::vector<sort_key>& vectorKey, uint64_t uFrom, uint64_t uCount, bool bStable, tag_sort_typed );
+   void sort( const std::vector<sort_key>& vectorKey, bool bStable, tag_sort_typed ) { sort( vectorKey, 0, get_row_count(), bStable, tag_sort_typed{} ); }
+   void sort( const std::vector<sort_key>& vectorKey, tag_sort_typed ) { sort( vectorKey, 0, get_row_count(), false, tag_sort_typed{} ); }
+   /// calculate sorted row order without moving rows, vectorRow gets row indexes in sorted order
+   void sort( const std::vector<sort_key>& vectorKey, uint64_t uFrom, uint64_t uCount, bool bStable, std::vector<uint64_t>& vectorRow, tag_sort_typed ) const;
+   /// sort row indexes in vectorRow, rows can be any rows in table and in any order
+   void sort( const std::vector<sort_key>& vectorKey, bool bStable, std::vector<uint64_t>& vectorRow, tag_sort_typed ) const;
+
+   /// reorder rows starting at uFrom, row at uFrom + n gets data from row in vectorRow[n]
+   void row_reorder( uint64_t uFrom, const std::vector<uint64_t>& vectorRow );
 
    void sort( unsigned uColumn, bool bAscending ) { sort( uColumn, bAscending, 0, get_row_count(), tag_sort_selection{} ); }
 
@@ -937,6 +1093,70 @@ public:
    void erase( uint64_t uFrom, uint64_t uCount );
    void erase( uint64_t uRow ) { erase( uRow, 1 ); }
 
+   /// remove values in references that no cell uses, codes in reference columns are updated
+   uint64_t references_compact();
+
+/** \name SEGMENT
+* Segmented tables store rows in memory blocks with fixed number of rows, table grows by adding segments
+*///@{
+   /// set number of rows in each segment, has to be power of 2 and set before table is prepared
+   void segment_set_row_count( uint64_t uRowCount );
+   /// number of rows in each segment
+   uint64_t segment_get_row_count() const noexcept { return 1ULL << m_uSegmentShift; }
+   /// number of allocated segments
+   std::size_t segment_size() const noexcept { return m_vectorSegment.size(); }
+   /// get pointer to first row in segment
+   uint8_t* segment_get( std::size_t uIndex ) const noexcept { assert( uIndex < m_vectorSegment.size() ); return m_vectorSegment[uIndex]; }
+   /// size in bytes for segment memory block (rows and meta data)
+   uint64_t segment_get_size() const noexcept { return (uint64_t)( m_uRowSize + m_uRowMetaSize ) << m_uSegmentShift; }
+   /// segments get shared owners, table can then be copied with `tag_copy_on_write` where copy shares segments
+   void segment_share();
+   /// check if segments have shared owners (copy on write)
+   bool is_segment_shared() const noexcept { return m_vectorSegmentOwner.empty() == false; }
+   /// make segments for rows private, segments that are shared with other tables are copied
+   void segment_write( uint64_t uFrom, uint64_t uCount );
+protected:
+   void segment_add();
+   void segment_clear() noexcept;
+public:
+//@}
+
+/** \name INDEX
+* Indexes attached to table, table keeps indexes in sync when rows are added, modified, erased or moved
+*///@{
+   /// add hash index for key columns, table owns the index
+   index_hash* index_add( const std::vector<unsigned>& vectorColumn, tag_index_hash );
+   /// add ordered index for key columns, table owns the index
+   index_ordered* index_add( const std::vector<unsigned>& vectorColumn, tag_index_ordered );
+   /// add zone map for key columns, scans on key columns skip blocks that can't match
+   index_zone* index_add( const std::vector<unsigned>& vectorColumn, tag_index_zone ) { return index_add( vectorColumn, index_zone::eSpaceZoneRows, tag_index_zone{} ); }
+   index_zone* index_add( const std::vector<unsigned>& vectorColumn, unsigned uBlockRows, tag_index_zone );
+   /// get zone map with statistics for column, nullptr if column do not have zone map
+   const index_zone* index_get_zone( unsigned uColumn ) const noexcept;
+   /// add cache with hash for values in rows, used by `diff` if all columns are in cache
+   index_row_hash* index_add( const std::vector<unsigned>& vectorColumn, tag_index_row_hash );
+   /// get row hash cache with all columns in table, nullptr if table do not have one
+   const index_row_hash* index_get_row_hash() const noexcept;
+   /// number of indexes attached to table
+   std::size_t index_size() const noexcept { return m_vectorIndex.size(); }
+   /// get index at position
+   index_column* index_get( std::size_t uIndex ) const { assert( uIndex < m_vectorIndex.size() ); return m_vectorIndex[uIndex].get(); }
+   /// remove index from table, index is deleted
+   void index_remove( const index_column* pindex );
+   /// remove all indexes from table
+   void index_clear() { m_vectorIndex.clear(); }
+
+   /// check if indexes or shared segments need to be notified before rows are modified
+   bool is_notify() const noexcept { return m_vectorIndex.empty() == false || m_vectorSegmentOwner.empty() == false; }
+   // ## notify indexes about changes in table, called internally when rows are modified, shared segments are copied before they are modified
+   void index_notify_add( uint64_t uFrom, uint64_t uCount );
+   void index_notify_set( uint64_t uRow, unsigned uColumn );
+   void index_notify_set( uint64_t uRow );
+   void index_notify_erase( uint64_t uFrom, uint64_t uCount );
+   void index_notify_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow );
+   void index_notify_clear();
+//@}
+
 //@}
 
 protected:
@@ -966,6 +1186,15 @@ public:
    references m_references;            ///< Stores blob data
    names m_namesColumn;                ///< names for columns in table. this works like a data store for const text values
    std::vector<column> m_vectorColumn; ///< information about each column in table
+   std::vector< std::unique_ptr<index_column> > m_vectorIndex; ///< indexes attached to table, indexes are not copied with table
+   std::vector< uint8_t* > m_vectorSegment; ///< segment directory for segmented table, first segment is `m_puData`, other segments are owned by table
+   std::vector< std::shared_ptr<uint8_t[]> > m_vectorSegmentOwner; ///< owner for each segment if segments are shared (copy on write), empty if table owns segments
+   unsigned m_uSegmentShift = std::countr_zero( (unsigned)eSpaceSegmentRows ); ///< row index shifted with this value is index to segment
+   std::shared_ptr<void> m_pDataOwner; ///< owner for external data block, if set `m_puData` is not deleted by table
+   mutable selection m_selectionRowFree; ///< bit is set for reserved rows without `eRowStateUse`, valid if `m_bRowFree` is true
+   mutable uint64_t m_uRowFreeCount = 0;///< number of free rows in bitmap
+   mutable uint64_t m_uRowFreeFirst = 0;///< words in bitmap before this word do not have free rows
+   mutable bool m_bRowFree = false;    ///< true if free row bitmap match row state values
 
 #ifndef NDEBUG
    uint64_t m_uAllocatedBlockSize_d = 0;
@@ -999,6 +1228,24 @@ public:
 
    static void join_s( const table_column_buffer* pT1_, unsigned uColumn1, const table_column_buffer* pT2_, unsigned uColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch );
 
+   // ## hash join, hash table is built on smaller table. if thread count is more than one, work is partitioned on hash and order for pairs is not preserved
+   //    key columns need to have same types in both tables, error is returned if types differ
+   static std::pair<bool, std::string> join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, unsigned uThreadCount, tag_join_inner );
+   static std::pair<bool, std::string> join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, unsigned uThreadCount, tag_join_left );
+   static std::pair<bool, std::string> join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, unsigned uThreadCount, tag_join_anti );
+   template<typename TAG_JOIN>
+   static std::pair<bool, std::string> join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, TAG_JOIN tag_ ) { return join_s( pT1_, vectorColumn1, pT2_, vectorColumn2, vectorMatch, 1u, tag_ ); }
+   /// materialize join result, table gets columns from first table followed by columns from second table
+   static void join_s( const table_column_buffer* pT1_, const table_column_buffer* pT2_, const std::vector< std::pair<uint64_t, uint64_t> >& vectorMatch, table_column_buffer& tableJoin );
+   template<typename TAG_JOIN>
+   static std::pair<bool, std::string> join_s( const table_column_buffer* pT1_, const std::vector<unsigned>& vectorColumn1, const table_column_buffer* pT2_, const std::vector<unsigned>& vectorColumn2, table_column_buffer& tableJoin, unsigned uThreadCount, TAG_JOIN tag_ ) {
+      std::vector< std::pair<uint64_t, uint64_t> > vectorMatch;
+      auto result_ = join_s( pT1_, vectorColumn1, pT2_, vectorColumn2, vectorMatch, uThreadCount, tag_ );
+      if( result_.first == false ) return result_;
+      join_s( pT1_, pT2_, vectorMatch, tableJoin );
+      return { true, "" };
+   }
+
 };
 
 inline void table_column_buffer::common_construct( table_column_buffer&& o ) noexcept {            assert( m_puData == nullptr );
@@ -1009,10 +1256,17 @@ inline void table_column_buffer::common_construct( table_column_buffer&& o ) noe
    m_uReservedRowCount = o.m_uReservedRowCount;
    m_puData          = o.m_puData; o.m_puData = nullptr;
    m_puMetaData      = o.m_puMetaData; o.m_puMetaData = nullptr;
+   m_vectorSegment   = std::move( o.m_vectorSegment ); o.m_vectorSegment.clear();
+   m_vectorSegmentOwner = std::move( o.m_vectorSegmentOwner ); o.m_vectorSegmentOwner.clear();
+   m_pDataOwner      = std::move( o.m_pDataOwner );
+   m_uSegmentShift   = o.m_uSegmentShift;
    m_vectorColumn    = std::move( o.m_vectorColumn );
    m_namesColumn     = std::move( o.m_namesColumn );
    m_references      = std::move( o.m_references );
    m_argumentsProperty = std::move( o.m_argumentsProperty );
+   m_vectorIndex     = std::move( o.m_vectorIndex );
+   for( auto& it : m_vectorIndex ) it->set_table( this );
+   m_bRowFree        = false; o.m_bRowFree = false;
 #ifndef NDEBUG
    m_uAllocatedBlockSize_d = o.m_uAllocatedBlockSize_d;
 #endif // NDEBUG
@@ -1058,6 +1312,16 @@ inline unsigned table_column_buffer::size_row_meta() const noexcept {
    return uMetaDataSize;
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief buffer size for values in column, this is the distance to next column in row
+ * @param uIndex column index
+ * @return unsigned number of bytes each value in column occupies
+*/
+inline unsigned table_column_buffer::column_get_width( unsigned uIndex ) const noexcept {          assert( uIndex < get_column_count() ); assert( m_uRowSize > 0 );
+   unsigned uEnd = ( uIndex + 1 ) < get_column_count() ? m_vectorColumn[uIndex + 1].position() : m_uRowSize;
+   return uEnd - m_vectorColumn[uIndex].position();
+}
+
 /** ---------------------------------------------------------------------------
  * @brief Add row to table (note that table has "taken" rows and reserved or allocated rows)
  * 
@@ -1071,10 +1335,24 @@ inline void table_column_buffer::row_add( uint64_t uCount ) {
    m_uRowCount += uCount; 
    if( m_uRowCount > m_uReservedRowCount ) {
       uint64_t uAddRowCount = m_uRowCount - m_uReservedRowCount;               // number of rows to grow
-      if( m_uRowGrowBy == 0 ) { uAddRowCount += m_uRowCount / 2; }             // add 50% extra rows
+      if( is_segmented() == true ) {}                                          // segmented table grows with one segment at a time
+      else if( m_uRowGrowBy == 0 ) { uAddRowCount += m_uRowCount / 2; }        // add 50% extra rows
       else                    { uAddRowCount += m_uRowGrowBy; }                // add with grow by
       row_reserve_add( uAddRowCount );                                         // increase memory block
    }
+   if( is_notify() == true ) index_notify_add( m_uRowCount - uCount, uCount );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Set number of rows in table, rows need to be reserved
+ * @param uCount number of rows in table
+*/
+inline void table_column_buffer::set_row_count( uint64_t uCount ) {                                assert( uCount <= m_uReservedRowCount );
+   if( is_notify() == true ) {
+      if( uCount < m_uRowCount ) index_notify_erase( uCount, m_uRowCount - uCount );
+      else if( uCount > m_uRowCount ) index_notify_add( m_uRowCount, uCount - m_uRowCount );
+   }
+   m_uRowCount = uCount;
 }
 
 /** ---------------------------------------------------------------------------
@@ -1190,10 +1468,31 @@ void table_column_buffer::column_fill( const std::string_view& stringName, const
  * @param uRow index for row null value is returned for
  * @return uint8_t* pointer to row null value section
 */
-inline uint8_t* table_column_buffer::row_get_null( uint64_t uRow ) const noexcept { assert( uRow < m_uReservedRowCount ); assert( m_puMetaData != nullptr ); 
+inline uint8_t* table_column_buffer::row_get_null( uint64_t uRow ) const noexcept { assert( uRow < m_uReservedRowCount ); assert( m_puMetaData != nullptr ); assert( is_columnar() == false );
+   if( is_segmented() == true )                                                // meta data is placed after rows in segment
+   {
+      const uint64_t uMask = ( 1ULL << m_uSegmentShift ) - 1;
+      return m_vectorSegment[uRow >> m_uSegmentShift] + ( (uint64_t)m_uRowSize << m_uSegmentShift ) + ( uRow & uMask ) * m_uRowMetaSize;
+   }
    return reinterpret_cast<uint8_t*>( m_puMetaData + (uRow * m_uRowMetaSize) );
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief Return pointer to row data
+ * @param uRow index for row
+ * @return uint8_t* pointer to first byte in row
+*/
+inline uint8_t* table_column_buffer::row_get( uint64_t uRow ) const noexcept { assert( uRow < m_uReservedRowCount ); assert( is_columnar() == false );
+   if( is_segmented() == true ) return m_vectorSegment[uRow >> m_uSegmentShift] + ( uRow & ( ( 1ULL << m_uSegmentShift ) - 1 ) ) * m_uRowSize;
+   return m_puData + uRow * m_uRowSize;
+}
+
+/// number of rows from row that are stored after each other in memory, for segmented table this is the rows left in segment
+inline uint64_t table_column_buffer::row_get_contiguous( uint64_t uRow ) const noexcept { assert( uRow <= m_uReservedRowCount );
+   if( is_segmented() == true ) return ( 1ULL << m_uSegmentShift ) - ( uRow & ( ( 1ULL << m_uSegmentShift ) - 1 ) );
+   return m_uReservedRowCount - uRow;
+}
+
 /** ---------------------------------------------------------------------------
  * @brief get position in buffer to row state information for row at index
  * @param uRow index to row where state is located
@@ -1203,7 +1502,8 @@ inline uint32_t* table_column_buffer::row_get_state( uint64_t uRow ) const noexc
    // calculate number of bytes used to store flags for culumns marked as null (cant be over sizeof(uint32_t) * 2 or 8 bytes)
    // note that state cant be set to both 32 and 64 columns
    unsigned uNullSize = (m_uFlags & (eTableFlagNull32|eTableFlagNull64)) * sizeof(uint32_t);     assert( uNullSize <= (sizeof(uint32_t) * 2) );
-   return reinterpret_cast<uint32_t*>( m_puMetaData + (uRow * m_uRowMetaSize) + uNullSize ); // return pointer to state value
+   if( is_columnar() == true ) return reinterpret_cast<uint32_t*>( m_puMetaData + (uNullSize * m_uReservedRowCount) + (uRow * eSpaceRowState) ); // state array is placed after null bits
+   return reinterpret_cast<uint32_t*>( row_get_null( uRow ) + uNullSize );    // return pointer to state value
 }
 
 /** ---------------------------------------------------------------------------
@@ -1213,9 +1513,11 @@ inline uint32_t* table_column_buffer::row_get_state( uint64_t uRow ) const noexc
  * @param uClear flags cleared
 */
 inline void table_column_buffer::row_set_state( uint64_t uRow, unsigned uSet, unsigned uClear ) { assert( uRow < m_uReservedRowCount ); 
+   if( is_segment_shared() == true ) segment_write( uRow, 1 );
    uint32_t* puFlags = row_get_state( uRow );
    *puFlags |= uSet;
    *puFlags &= ~uClear;
+   if( m_bRowFree == true ) row_free_update( uRow, *puFlags );
 }
 
 /** ---------------------------------------------------------------------------
@@ -1224,10 +1526,29 @@ inline void table_column_buffer::row_set_state( uint64_t uRow, unsigned uSet, un
  * @return bool true if row is used, false if not
 */
 inline bool table_column_buffer::row_is_use( uint64_t uRow ) const noexcept { assert( uRow < m_uReservedRowCount ); assert( is_rowstatus() == true ); 
-   // calculate number of bytes used to store flags for culumns marked as null (cant be over sizeof(uint32_t) * 2 or 8 bytes)
-   // note that state cant be set to both 32 and 64 columns
-   unsigned uNullSize = (m_uFlags & (eTableFlagNull32|eTableFlagNull64)) * sizeof(uint32_t);     assert( uNullSize <= (sizeof(uint32_t) * 2) );
-   return (*reinterpret_cast<uint32_t*>( m_puMetaData + (uRow * m_uRowMetaSize) + uNullSize ) & (uint32_t)eRowStateUse) == (uint32_t)eRowStateUse; // return if row is used
+   return (*row_get_state( uRow ) & (uint32_t)eRowStateUse) == (uint32_t)eRowStateUse; // return if row is used
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief update free row bitmap and free row count for row with new state
+ * @param uRow index to row that got new state
+ * @param uState new state for row
+*/
+inline void table_column_buffer::row_free_update( uint64_t uRow, uint32_t uState ) const noexcept { assert( m_bRowFree == true ); assert( uRow < m_uReservedRowCount );
+   if( m_selectionRowFree.size() != m_uReservedRowCount ) { m_bRowFree = false; return; } // reserved rows changed, bitmap is built again when needed
+   bool bFree = ( uState & (uint32_t)eRowStateUse ) == 0;
+   if( bFree == m_selectionRowFree.is_set( uRow ) ) return;
+   if( bFree == true )
+   {
+      m_selectionRowFree.set( uRow );
+      m_uRowFreeCount++;
+      if( ( uRow >> 6 ) < m_uRowFreeFirst ) m_uRowFreeFirst = uRow >> 6;
+   }
+   else
+   {
+      m_selectionRowFree.clear( uRow );                                                             assert( m_uRowFreeCount > 0 );
+      m_uRowFreeCount--;
+   }
 }
 
 
@@ -1236,6 +1557,11 @@ inline bool table_column_buffer::row_is_use( uint64_t uRow ) const noexcept { as
  * @param uRow index to row where values are set to null
 */
 inline void table_column_buffer::row_set_null( uint64_t uRow ) { assert( uRow < m_uReservedRowCount ); assert( is_null() == true );
+   if( is_notify() == true ) index_notify_set( uRow );
+   if( is_columnar() == true ) {
+      for( unsigned u = 0, uMax = get_column_count(); u < uMax; u++ ) column_get_null( u )[uRow >> 6] |= (1ULL << (uRow & 63));
+      return;
+   }
    auto puRow = row_get_null( uRow );
 
    if( is_null32() ) *(uint32_t*)puRow =((uint32_t)-1);
@@ -1303,6 +1629,7 @@ TYPE table_column_buffer::cell_get( uint64_t uRow, unsigned uColumn ) const noex
  * @return true if null, false if not null
 */
 inline bool table_column_buffer::cell_is_null( uint64_t uRow, unsigned uColumn ) const noexcept { assert( uRow < m_uReservedRowCount ); assert( m_uFlags & (eTableFlagNull32|eTableFlagNull64) );
+   if( is_columnar() == true ) return (column_get_null( uColumn )[uRow >> 6] & (1ULL << (uRow & 63))) != 0;
    uint64_t uNullRow = 0;
    auto puRow = row_get_null( uRow );
    if( is_null32() ) uNullRow = (uint64_t)*(uint32_t*)puRow;
@@ -1317,6 +1644,8 @@ inline bool table_column_buffer::cell_is_null( uint64_t uRow, unsigned uColumn )
  * @param uColumn cell column
 */
 inline void table_column_buffer::cell_set_null( uint64_t uRow, unsigned uColumn ) { assert( uRow < m_uReservedRowCount ); assert( m_uFlags & (eTableFlagNull32|eTableFlagNull64) );
+   if( is_notify() == true ) index_notify_set( uRow, uColumn );
+   if( is_columnar() == true ) { column_get_null( uColumn )[uRow >> 6] |= (1ULL << (uRow & 63)); return; }
    auto puRow = row_get_null( uRow );
 
 #ifdef _DEBUG
@@ -1349,6 +1678,8 @@ inline void table_column_buffer::cell_set_null( uint64_t uRow, const std::string
 
 inline void table_column_buffer::cell_set_not_null( uint64_t uRow, unsigned uColumn ) { 
                                                                                                    assert( uRow < m_uReservedRowCount ); assert( m_uFlags & (eTableFlagNull32|eTableFlagNull64) );
+   if( is_notify() == true ) index_notify_set( uRow, uColumn );
+   if( is_columnar() == true ) { column_get_null( uColumn )[uRow >> 6] &= ~(1ULL << (uRow & 63)); return; }
    auto puRow = row_get_null( uRow );
 
 #ifdef _DEBUG
@@ -1447,6 +1778,10 @@ template <typename TYPE>
 std::vector<TYPE> table_column_buffer::harvest( uint64_t uRow, unsigned uColumn, unsigned uCount, tag_row ) const noexcept { assert( (uColumn + uCount) <= get_column_count() ); assert( column_get_primitive_size( uColumn ) == sizeof(TYPE) );
    std::vector<TYPE> vectorType; // vector that gets values in row
    vectorType.reserve( uCount );
+   if( is_columnar() == true ) {                                               // columnar table, values in row are not placed after each other
+      for( auto u = 0u; u < uCount; u++ ) vectorType.emplace_back( *(const TYPE*)cell_get( uRow, uColumn + u ) );
+      return vectorType;
+   }
    const TYPE* p_ = (const TYPE*)cell_get( uRow, uColumn );                    // first cell position in row
    for( auto u = 0; u < uCount; u++ ) { 
       vectorType.emplace_back( p_[u] ); 
@@ -1599,6 +1934,118 @@ inline void table_column_buffer::plant( unsigned uColumn, const gd::variant_view
    plant( uColumn, variantviewValue, 0, get_row_count() );
 }
 
+/** ---------------------------------------------------------------------------
+ * @brief Copy values from span into column
+ *
+ * If span type match column type values are copied directly to cells, with
+ * `memcpy` for columnar tables and with a strided copy for row tables. Other
+ * types (and `std::string_view` for string columns) are set with `cell_set`.
+ * Rows need to be added to table before values are planted.
+ * @code
+std::vector<double> vectorValue = { 1.0, 2.0, 3.0 };
+table.row_add( vectorValue.size(), gd::table::tag_null{} );
+table.plant( 1, std::span<const double>( vectorValue ), 0 );
+ * @endcode
+ * @param uColumn column values are copied to
+ * @param spanValue values copied to column, one value for each row
+ * @param uFrom first row
+ * @param puNull optional bit array with one bit for each value, bit set means that value is null
+*/
+template< typename TYPE >
+void table_column_buffer::plant( unsigned uColumn, std::span<const TYPE> spanValue, uint64_t uFrom, const uint64_t* puNull ) { assert( uColumn < get_column_count() ); assert( (uFrom + spanValue.size()) <= get_row_count() );
+   const auto& columnPlant = m_vectorColumn[uColumn];
+   const uint64_t uCount = spanValue.size();
+   if constexpr( std::is_arithmetic_v<TYPE> == true )
+   {
+      constexpr unsigned uType = (unsigned)gd::types::type_g<TYPE>( gd::types::tag_ask_compiler{} ) & 0xff;
+      if( uType == columnPlant.ctype_number() && columnPlant.primitive_size() == sizeof( TYPE ) && columnPlant.is_fixed() == true && is_notify() == false )
+      {
+         if( is_columnar() == true )
+         {
+            unsigned uWidth = column_get_width( uColumn );
+            uint8_t* puValue = column_get_data( uColumn ) + uFrom * uWidth;
+            if( uWidth == sizeof( TYPE ) ) { std::memcpy( puValue, spanValue.data(), uCount * sizeof( TYPE ) ); }
+            else { for( uint64_t u = 0; u < uCount; u++, puValue += uWidth ) std::memcpy( puValue, &spanValue[u], sizeof( TYPE ) ); }
+         }
+         else
+         {
+            for( uint64_t uIndex = 0; uIndex < uCount; )
+            {
+               uint64_t uEnd = std::min( uCount, uIndex + row_get_contiguous( uFrom + uIndex ) );// rows stored after each other
+               uint8_t* puValue = row_get( uFrom + uIndex ) + columnPlant.position();
+               for( ; uIndex < uEnd; uIndex++, puValue += m_uRowSize ) std::memcpy( puValue, &spanValue[uIndex], sizeof( TYPE ) );
+            }
+         }
+
+         if( is_null() == true ) column_set_null( uColumn, uFrom, uCount, puNull );
+         return;
+      }
+   }
+
+   for( uint64_t u = 0; u < uCount; u++ )
+   {
+      if( puNull != nullptr && ( ( puNull[u >> 6] >> ( u & 63 ) ) & 1 ) != 0 ) { cell_set( uFrom + u, uColumn, gd::variant_view() ); continue; }
+      cell_set( uFrom + u, uColumn, gd::variant_view( spanValue[u] ), tag_convert{} );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Copy values in column into span
+ *
+ * If span type match column type values are copied directly from cells,
+ * otherwise values are converted. `std::string_view` can be used for string
+ * columns and views are valid as long as table isn't modified.
+ * Values for null cells are not set for direct copies, check null bits.
+ * @param uColumn column values are copied from
+ * @param uFrom first row
+ * @param spanValue span that gets values, number of values is span size
+ * @param puNull optional bit array that gets one bit for each value, bit is set if value is null
+*/
+template< typename TYPE >
+void table_column_buffer::harvest( unsigned uColumn, uint64_t uFrom, std::span<TYPE> spanValue, uint64_t* puNull ) const { assert( uColumn < get_column_count() ); assert( (uFrom + spanValue.size()) <= get_row_count() );
+   const auto& columnHarvest = m_vectorColumn[uColumn];
+   const uint64_t uCount = spanValue.size();
+   if( puNull != nullptr ) column_get_null( uColumn, uFrom, uCount, puNull );
+
+   if constexpr( std::is_arithmetic_v<TYPE> == true )
+   {
+      constexpr unsigned uType = (unsigned)gd::types::type_g<TYPE>( gd::types::tag_ask_compiler{} ) & 0xff;
+      if( uType == columnHarvest.ctype_number() && columnHarvest.primitive_size() == sizeof( TYPE ) && columnHarvest.is_fixed() == true )
+      {
+         if( is_columnar() == true )
+         {
+            unsigned uWidth = column_get_width( uColumn );
+            const uint8_t* puValue = column_get_data( uColumn ) + uFrom * uWidth;
+            if( uWidth == sizeof( TYPE ) ) { std::memcpy( spanValue.data(), puValue, uCount * sizeof( TYPE ) ); }
+            else { for( uint64_t u = 0; u < uCount; u++, puValue += uWidth ) std::memcpy( &spanValue[u], puValue, sizeof( TYPE ) ); }
+         }
+         else
+         {
+            for( uint64_t uIndex = 0; uIndex < uCount; )
+            {
+               uint64_t uEnd = std::min( uCount, uIndex + row_get_contiguous( uFrom + uIndex ) );// rows stored after each other
+               const uint8_t* puValue = row_get( uFrom + uIndex ) + columnHarvest.position();
+               for( ; uIndex < uEnd; uIndex++, puValue += m_uRowSize ) std::memcpy( &spanValue[uIndex], puValue, sizeof( TYPE ) );
+            }
+         }
+         return;
+      }
+   }
+
+   gd::variant variantConverted;
+   for( uint64_t u = 0; u < uCount; u++ )
+   {
+      auto variantviewValue = cell_get_variant_view( uFrom + u, uColumn );
+      if( variantviewValue.is_null() == true ) { spanValue[u] = TYPE{}; continue; }
+      if constexpr( std::is_same_v<TYPE, std::string_view> == true ) { spanValue[u] = variantviewValue.as_string_view(); }
+      else
+      {
+         variantviewValue.convert_to( gd::types::type_g<TYPE>( gd::types::tag_ask_compiler{} ), variantConverted );
+         spanValue[u] = (TYPE)variantConverted;
+      }
+   }
+}
+
 
 namespace serialize {
    template<typename ARCHIVE>
@@ -1,9 +1,14 @@
 #include "gd_table_index.h"
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <utility>
 
 #include "gd_table_index.h"
 #include "gd_variant.h"
 #include "gd_table_index.h"
+#include "gd_table_column-buffer.h"
 
 _GD_TABLE_BEGIN
 
@@ -81,4 +86,886 @@ std::pair<bool, uint64_t> index_string::find( const std::string_view& stringFind
 
 
 
-_GD_TABLE_END
\ No newline at end of file
+// ----------------------------------------------------------------------------
+// --------------------------------------------------------------- index_column
+// ----------------------------------------------------------------------------
+
+/// check if column is part of key for index
+bool index_column::is_key( unsigned uColumn ) const noexcept
+{
+   for( auto it : m_vectorColumn ) { if( it == uColumn ) return true; }
+   return false;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief number of rows in index, pending rows are inserted before rows are counted
+ * @return uint64_t number of indexed rows
+ */
+uint64_t index_column::size() const
+{
+   flush();
+   return (uint64_t)std::count( m_vectorState.begin(), m_vectorState.end(), (uint8_t)eRowStateIndexed );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief rows are added to table, added rows are marked as pending
+ * @param uFrom first added row
+ * @param uCount number of added rows
+ */
+void index_column::on_add( uint64_t uFrom, uint64_t uCount )
+{                                                                                                  assert( uFrom <= m_vectorState.size() );
+   m_vectorState.resize( uFrom + uCount, eRowStatePending );
+   for( uint64_t uRow = uFrom, uEnd = uFrom + uCount; uRow < uEnd; uRow++ ) { m_vectorState[uRow] = eRowStatePending; m_vectorPending.push_back( uRow ); }
+   if( uCount > 0 ) m_bPending = true;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief value in key column is about to be changed, row is removed from index and marked as pending
+ * @param uRow row that is modified
+ */
+void index_column::on_set( uint64_t uRow )
+{
+   if( uRow >= m_vectorState.size() || m_vectorState[uRow] == eRowStatePending ) return; // row isn't added or already pending
+
+   if( m_vectorState[uRow] == eRowStateIndexed ) remove( uRow );              // values in table still holds indexed values
+   m_vectorState[uRow] = eRowStatePending;
+   m_vectorPending.push_back( uRow );
+   m_bPending = true;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief rows are about to be erased, erased rows are removed and rows after erased rows are moved up
+ * @param uFrom first row that is erased
+ * @param uCount number of rows that are erased
+ */
+void index_column::on_erase( uint64_t uFrom, uint64_t uCount )
+{                                                                                                  assert( (uFrom + uCount) <= m_vectorState.size() );
+   const uint64_t uEnd = uFrom + uCount;
+   for( uint64_t uRow = uFrom; uRow < uEnd; uRow++ )
+   {
+      if( m_vectorState[uRow] == eRowStateIndexed ) remove( uRow );
+   }
+
+   m_vectorState.erase( m_vectorState.begin() + uFrom, m_vectorState.begin() + uEnd );
+   shift( uEnd, uCount );
+
+   // ## remove erased rows from pending and move rows after erased rows
+   auto itEnd = std::remove_if( m_vectorPending.begin(), m_vectorPending.end(), [uFrom, uEnd]( uint64_t uRow ) { return uRow >= uFrom && uRow < uEnd; } );
+   m_vectorPending.erase( itEnd, m_vectorPending.end() );
+   for( auto& uRow : m_vectorPending ) { if( uRow >= uEnd ) uRow -= uCount; }
+   m_bPending = m_vectorPending.empty() == false;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief rows are reordered in table, row at uFrom + n has got data from row in vectorRow[n]
+ * @param uFrom first row in reordered rows
+ * @param vectorRow rows (absolute) that was moved to position
+ */
+void index_column::on_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow )
+{                                                                                                  assert( (uFrom + vectorRow.size()) <= m_vectorState.size() );
+   const uint64_t uCount = vectorRow.size();
+   std::vector<uint64_t> vectorNewRow( uCount );
+   std::vector<uint8_t> vectorState( m_vectorState.begin() + uFrom, m_vectorState.begin() + uFrom + uCount );
+   for( uint64_t u = 0; u < uCount; u++ )
+   {                                                                                               assert( vectorRow[u] >= uFrom && vectorRow[u] < (uFrom + uCount) );
+      vectorNewRow[vectorRow[u] - uFrom] = uFrom + u;
+      m_vectorState[uFrom + u] = vectorState[vectorRow[u] - uFrom];
+   }
+
+   renumber( uFrom, vectorNewRow );
+   for( auto& uRow : m_vectorPending ) { if( uRow >= uFrom && uRow < (uFrom + uCount) ) uRow = vectorNewRow[uRow - uFrom]; }
+}
+
+/// all rows in table are removed
+void index_column::on_clear()
+{
+   reset();
+   m_vectorState.clear();
+   m_vectorPending.clear();
+   m_bPending = false;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief insert pending rows into index
+ * Index is logically const when searched, pending rows are inserted before search.
+ * Threads that search at the same time are serialized on `m_mutexFlush` until
+ * pending rows are inserted, after that flush only reads the pending flag.
+ * Rows with null in any key column are not indexed.
+ */
+void index_column::flush() const
+{
+   if( m_bPending.load( std::memory_order_acquire ) == false ) return;
+
+   std::lock_guard<std::mutex> lock_( m_mutexFlush );
+   if( m_bPending.load( std::memory_order_relaxed ) == false ) return;       // other thread inserted pending rows
+
+   std::vector<uint64_t> vectorRow;
+   vectorRow.reserve( m_vectorPending.size() );
+   for( auto uRow : m_vectorPending )
+   {                                                                                               assert( m_vectorState[uRow] == eRowStatePending );
+      if( is_null( uRow ) == true ) { m_vectorState[uRow] = eRowStateNone; continue; }
+      m_vectorState[uRow] = eRowStateIndexed;
+      vectorRow.push_back( uRow );
+   }
+   m_vectorPending.clear();
+
+   if( vectorRow.empty() == false ) insert( vectorRow );
+   m_bPending.store( false, std::memory_order_release );
+}
+
+/// check if any key value in row is null
+bool index_column::is_null( uint64_t uRow ) const
+{
+   if( m_ptable->is_null() == false ) return false;
+   for( auto uColumn : m_vectorColumn ) { if( m_ptable->cell_is_null( uRow, uColumn ) == true ) return true; }
+   return false;
+}
+
+/// compare key values in two rows, returns -1 if first row is less, 1 if greater and 0 for equal
+int index_column::compare( uint64_t uRow1, uint64_t uRow2 ) const
+{
+   for( auto uColumn : m_vectorColumn )
+   {
+      int iCompare = compare_s( m_ptable->cell_get_variant_view( uRow1, uColumn ), m_ptable->cell_get_variant_view( uRow2, uColumn ) );
+      if( iCompare != 0 ) return iCompare;
+   }
+   return 0;
+}
+
+/// compare key values in row with key, only leading key columns with value in key are compared
+int index_column::compare( uint64_t uRow, const std::vector<gd::variant_view>& vectorKey ) const
+{                                                                                                  assert( vectorKey.size() <= m_vectorColumn.size() );
+   for( std::size_t u = 0; u < vectorKey.size(); u++ )
+   {
+      int iCompare = compare_s( m_ptable->cell_get_variant_view( uRow, m_vectorColumn[u] ), vectorKey[u] );
+      if( iCompare != 0 ) return iCompare;
+   }
+   return 0;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief convert key values to types used in key columns
+ * Text is not converted between text types, text is compared and hashed on bytes.
+ * @param vectorKey key values to convert
+ * @param vectorValue gets converted values
+ * @param vectorBuffer storage for values that needed conversion
+ * @return true if all values was converted, false if key has null values or can't be converted
+ */
+bool index_column::convert( const std::vector<gd::variant_view>& vectorKey, std::vector<gd::variant_view>& vectorValue, std::vector<gd::variant>& vectorBuffer ) const
+{                                                                                                  assert( vectorKey.size() <= m_vectorColumn.size() );
+   vectorValue.clear();
+   vectorBuffer.clear();
+   vectorBuffer.reserve( vectorKey.size() );                                   // values in buffer can't move, vectorValue points to them
+
+   for( std::size_t u = 0; u < vectorKey.size(); u++ )
+   {
+      const auto& v_ = vectorKey[u];
+      if( v_.is_null() == true ) return false;
+
+      unsigned uColumn = m_vectorColumn[u];
+      unsigned uTypeNumber = m_ptable->column_get_ctype_number( uColumn );
+      bool bText = ( uTypeNumber == gd::types::eTypeNumberString || uTypeNumber == gd::types::eTypeNumberUtf8String );
+      if( v_.type_number() == uTypeNumber || ( bText == true && v_.is_char_string() == true ) )
+      {
+         vectorValue.push_back( v_ );
+         continue;
+      }
+
+      vectorBuffer.push_back( v_.convert_to( m_ptable->column_get_ctype( uColumn ) ) );
+      if( vectorBuffer.back().is_null() == true ) return false;
+      vectorValue.push_back( vectorBuffer.back().as_variant_view() );
+   }
+   return true;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief compare two values
+ * Null is less than any value. Text values are compared as bytes (also if text
+ * types differ), other values need to have same type to be compared.
+ * @return int -1 if v1 is less than v2, 1 if v1 is greater and 0 if equal
+ */
+int index_column::compare_s( const gd::variant_view& v1, const gd::variant_view& v2 )
+{
+   if( v1.is_null() == true || v2.is_null() == true ) return (int)v2.is_null() - (int)v1.is_null();
+
+   if( v1.is_char_string() == true && v2.is_char_string() == true )
+   {
+      int iCompare = v1.as_string_view().compare( v2.as_string_view() );
+      return iCompare < 0 ? -1 : ( iCompare > 0 ? 1 : 0 );
+   }
+
+   if( v1.type_number() != v2.type_number() ) return v1.type_number() < v2.type_number() ? -1 : 1;
+
+   if( v1.less( v2 ) == true ) return -1;
+   if( v2.less( v1 ) == true ) return 1;
+   return 0;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief hash for value, pass hash for earlier value as seed to combine values
+ * @param variantviewValue value to hash
+ * @param uSeed seed for hash
+ * @return uint64_t hash value
+ */
+uint64_t index_column::hash_s( const gd::variant_view& variantviewValue, uint64_t uSeed )
+{
+   if( variantviewValue.is_null() == true ) return hash_bytes_g( nullptr, 0, uSeed );
+
+   if( variantviewValue.is_char_string() == true )
+   {
+      auto string_ = variantviewValue.as_string_view();
+      return hash_bytes_g( (const uint8_t*)string_.data(), string_.length(), uSeed );
+   }
+
+   unsigned uTypeNumber = variantviewValue.type_number();
+   std::size_t uSize = variantviewValue.is_primitive() == true ? gd::types::value_size_g( uTypeNumber ) : variantviewValue.length();
+   if( uTypeNumber == gd::types::eTypeNumberWString ) uSize *= sizeof( wchar_t );
+   return hash_bytes_g( (const uint8_t*)variantviewValue.data(), uSize, uSeed );
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------- index_hash
+// ----------------------------------------------------------------------------
+
+/** ---------------------------------------------------------------------------
+ * @brief find first row with key values
+ * @param vectorKey value for each key column
+ * @return int64_t row with key values or -1 if not found
+ */
+int64_t index_hash::find( const std::vector<gd::variant_view>& vectorKey ) const
+{                                                                                                  assert( vectorKey.size() == m_vectorColumn.size() );
+   flush();
+   if( m_uCount == 0 ) return -1;
+
+   std::vector<gd::variant_view> vectorValue;
+   std::vector<gd::variant> vectorBuffer;
+   if( convert( vectorKey, vectorValue, vectorBuffer ) == false ) return -1;
+
+   uint64_t uHash = 0;
+   for( const auto& it : vectorValue ) uHash = hash_s( it, uHash );
+
+   const uint64_t uMask = m_vectorSlot.size() - 1;
+   for( uint64_t uSlot = uHash & uMask; m_vectorSlot[uSlot].m_uRow != eSlotEmpty; uSlot = ( uSlot + 1 ) & uMask )
+   {
+      const auto& slot_ = m_vectorSlot[uSlot];
+      if( slot_.m_uHash == uHash && slot_.m_uRow != eSlotDeleted && compare( slot_.m_uRow, vectorValue ) == 0 ) return (int64_t)slot_.m_uRow;
+   }
+
+   return -1;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief find all rows with key values
+ * @param vectorKey value for each key column
+ * @param vectorRow gets rows with key values, rows are in no specific order
+ */
+void index_hash::find( const std::vector<gd::variant_view>& vectorKey, std::vector<uint64_t>& vectorRow ) const
+{                                                                                                  assert( vectorKey.size() == m_vectorColumn.size() );
+   flush();
+   if( m_uCount == 0 ) return;
+
+   std::vector<gd::variant_view> vectorValue;
+   std::vector<gd::variant> vectorBuffer;
+   if( convert( vectorKey, vectorValue, vectorBuffer ) == false ) return;
+
+   uint64_t uHash = 0;
+   for( const auto& it : vectorValue ) uHash = hash_s( it, uHash );
+
+   const uint64_t uMask = m_vectorSlot.size() - 1;
+   for( uint64_t uSlot = uHash & uMask; m_vectorSlot[uSlot].m_uRow != eSlotEmpty; uSlot = ( uSlot + 1 ) & uMask )
+   {
+      const auto& slot_ = m_vectorSlot[uSlot];
+      if( slot_.m_uHash == uHash && slot_.m_uRow != eSlotDeleted && compare( slot_.m_uRow, vectorValue ) == 0 ) vectorRow.push_back( slot_.m_uRow );
+   }
+}
+
+/// calculate hash for key values in row
+uint64_t index_hash::hash( uint64_t uRow ) const
+{
+   uint64_t uHash = 0;
+   for( auto uColumn : m_vectorColumn ) uHash = hash_s( m_ptable->cell_get_variant_view( uRow, uColumn ), uHash );
+   return uHash;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief make room for more rows, hash table is rebuilt when more than half of slots are used
+ * @param uCount number of rows that is about to be inserted
+ */
+void index_hash::reserve( uint64_t uCount ) const
+{
+   if( ( m_uUsed + uCount ) * 2 <= m_vectorSlot.size() ) return;
+
+   std::vector<slot> vectorSlot( std::max( std::bit_ceil( ( m_uCount + uCount ) * 4 ), (uint64_t)16 ), slot{ 0, eSlotEmpty } );
+   const uint64_t uMask = vectorSlot.size() - 1;
+   for( const auto& it : m_vectorSlot )
+   {
+      if( it.m_uRow >= eSlotDeleted ) continue;                                // empty or deleted slot
+      uint64_t uSlot = it.m_uHash & uMask;
+      while( vectorSlot[uSlot].m_uRow != eSlotEmpty ) uSlot = ( uSlot + 1 ) & uMask;
+      vectorSlot[uSlot] = it;
+   }
+
+   m_vectorSlot = std::move( vectorSlot );
+   m_uUsed = m_uCount;
+}
+
+void index_hash::insert( uint64_t uRow ) const
+{
+   reserve( 1 );
+   uint64_t uHash = hash( uRow );
+   const uint64_t uMask = m_vectorSlot.size() - 1;
+   uint64_t uSlot = uHash & uMask;
+   while( m_vectorSlot[uSlot].m_uRow < eSlotDeleted ) uSlot = ( uSlot + 1 ) & uMask; // find empty or deleted slot
+
+   if( m_vectorSlot[uSlot].m_uRow == eSlotEmpty ) m_uUsed++;
+   m_vectorSlot[uSlot] = slot{ uHash, uRow };
+   m_uCount++;
+}
+
+void index_hash::insert( const std::vector<uint64_t>& vectorRow ) const
+{
+   reserve( vectorRow.size() );
+   for( auto uRow : vectorRow ) insert( uRow );
+}
+
+void index_hash::remove( uint64_t uRow )
+{
+   uint64_t uHash = hash( uRow );
+   const uint64_t uMask = m_vectorSlot.size() - 1;
+   for( uint64_t uSlot = uHash & uMask; m_vectorSlot[uSlot].m_uRow != eSlotEmpty; uSlot = ( uSlot + 1 ) & uMask )
+   {
+      if( m_vectorSlot[uSlot].m_uRow == uRow )
+      {
+         m_vectorSlot[uSlot].m_uRow = eSlotDeleted;
+         m_uCount--;
+         return;
+      }
+   }
+                                                                                                   assert( false ); // row not found in index, values in row has been changed without notifying index
+}
+
+void index_hash::shift( uint64_t uFrom, uint64_t uCount )
+{
+   for( auto& it : m_vectorSlot )
+   {
+      if( it.m_uRow < eSlotDeleted && it.m_uRow >= uFrom ) it.m_uRow -= uCount;
+   }
+}
+
+void index_hash::renumber( uint64_t uFrom, const std::vector<uint64_t>& vectorNewRow )
+{
+   const uint64_t uEnd = uFrom + vectorNewRow.size();
+   for( auto& it : m_vectorSlot )
+   {
+      if( it.m_uRow >= uFrom && it.m_uRow < uEnd ) it.m_uRow = vectorNewRow[it.m_uRow - uFrom];
+   }
+}
+
+// ----------------------------------------------------------------------------
+// -------------------------------------------------------------- index_ordered
+// ----------------------------------------------------------------------------
+
+/** ---------------------------------------------------------------------------
+ * @brief find first row in key order with values in leading key columns
+ * @param vectorKey values for leading key columns
+ * @return int64_t row or -1 if not found
+ */
+int64_t index_ordered::find( const std::vector<gd::variant_view>& vectorKey ) const
+{
+   flush();
+   std::vector<gd::variant_view> vectorValue;
+   std::vector<gd::variant> vectorBuffer;
+   if( convert( vectorKey, vectorValue, vectorBuffer ) == false ) return -1;
+
+   std::size_t uPosition = lower_bound( vectorValue );
+   if( uPosition < m_vectorRow.size() && compare( m_vectorRow[uPosition], vectorValue ) == 0 ) return (int64_t)m_vectorRow[uPosition];
+   return -1;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief find all rows with values in leading key columns
+ * @param vectorKey values for leading key columns
+ * @param vectorRow gets rows in key order
+ */
+void index_ordered::find( const std::vector<gd::variant_view>& vectorKey, std::vector<uint64_t>& vectorRow ) const
+{
+   flush();
+   std::vector<gd::variant_view> vectorValue;
+   std::vector<gd::variant> vectorBuffer;
+   if( convert( vectorKey, vectorValue, vectorBuffer ) == false ) return;
+
+   for( std::size_t u = lower_bound( vectorValue ); u < m_vectorRow.size() && compare( m_vectorRow[u], vectorValue ) == 0; u++ ) vectorRow.push_back( m_vectorRow[u] );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief rows with key values from low to high, both low and high are included
+ * Low and high can have values for leading key columns only.
+ * @code
+ * std::vector<uint64_t> vectorRow;
+ * pindex->range( { 10 }, { 20 }, vectorRow );      // 10 <= key <= 20
+ * pindex->range( { "M" }, {}, vectorRow );         // key >= "M"
+ * @endcode
+ * @param vectorLow low values, empty for no low limit
+ * @param vectorHigh high values, empty for no high limit
+ * @param vectorRow gets rows in key order
+ */
+void index_ordered::range( const std::vector<gd::variant_view>& vectorLow, const std::vector<gd::variant_view>& vectorHigh, std::vector<uint64_t>& vectorRow ) const
+{
+   flush();
+   std::vector<gd::variant_view> vectorLowValue, vectorHighValue;
+   std::vector<gd::variant> vectorLowBuffer, vectorHighBuffer;
+   if( convert( vectorLow, vectorLowValue, vectorLowBuffer ) == false ) return;
+   if( convert( vectorHigh, vectorHighValue, vectorHighBuffer ) == false ) return;
+
+   std::size_t u = vectorLowValue.empty() == true ? 0 : lower_bound( vectorLowValue );
+   for( ; u < m_vectorRow.size(); u++ )
+   {
+      if( vectorHighValue.empty() == false && compare( m_vectorRow[u], vectorHighValue ) > 0 ) break;
+      vectorRow.push_back( m_vectorRow[u] );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief rows where text in first key column starts with prefix
+ * @param stringPrefix text that value in first key column starts with
+ * @param vectorRow gets rows in key order
+ */
+void index_ordered::prefix( const std::string_view& stringPrefix, std::vector<uint64_t>& vectorRow ) const
+{
+   flush();
+   const unsigned uColumn = m_vectorColumn[0];
+   auto itBegin = std::partition_point( m_vectorRow.begin(), m_vectorRow.end(), [this, uColumn, &stringPrefix]( uint64_t uRow ) {
+      return m_ptable->cell_get_variant_view( uRow, uColumn ).as_string_view() < stringPrefix;
+   });
+
+   for( auto it = itBegin; it != m_vectorRow.end(); it++ )
+   {
+      if( m_ptable->cell_get_variant_view( *it, uColumn ).as_string_view().starts_with( stringPrefix ) == false ) break;
+      vectorRow.push_back( *it );
+   }
+}
+
+/// position for first row with key values that isn't less than key
+std::size_t index_ordered::lower_bound( const std::vector<gd::variant_view>& vectorKey ) const
+{
+   auto it = std::partition_point( m_vectorRow.begin(), m_vectorRow.end(), [this, &vectorKey]( uint64_t uRow ) { return compare( uRow, vectorKey ) < 0; } );
+   return (std::size_t)( it - m_vectorRow.begin() );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief insert rows, removed rows are removed first and then rows are sorted and merged with indexed rows
+ * Cost is O(n + k log k) for k rows, rows are not inserted one by one.
+ * @param vectorRow rows to insert
+ */
+void index_ordered::insert( const std::vector<uint64_t>& vectorRow ) const
+{
+   compact();
+
+   auto less_ = [this]( uint64_t u1, uint64_t u2 ) { return less( u1, u2 ); };
+   std::size_t uMiddle = m_vectorRow.size();
+   m_vectorRow.insert( m_vectorRow.end(), vectorRow.begin(), vectorRow.end() );
+   std::sort( m_vectorRow.begin() + uMiddle, m_vectorRow.end(), less_ );
+   std::inplace_merge( m_vectorRow.begin(), m_vectorRow.begin() + uMiddle, m_vectorRow.end(), less_ );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief remove rows collected by `remove` from sorted rows in one pass
+ * Rows are found on row number, values in table may have been changed after row was removed.
+ */
+void index_ordered::compact() const
+{
+   if( m_vectorRemove.empty() == true ) return;
+
+   std::sort( m_vectorRemove.begin(), m_vectorRemove.end() );
+   auto itEnd = std::remove_if( m_vectorRow.begin(), m_vectorRow.end(), [this]( uint64_t uRow ) { return std::binary_search( m_vectorRemove.begin(), m_vectorRemove.end(), uRow ); } );
+                                                                                                   assert( (std::size_t)( m_vectorRow.end() - itEnd ) == m_vectorRemove.size() ); // row not found in index, values in row has been changed without notifying index
+   m_vectorRow.erase( itEnd, m_vectorRow.end() );
+   m_vectorRemove.clear();
+}
+
+void index_ordered::shift( uint64_t uFrom, uint64_t uCount )
+{
+   compact();                                                                  // removed rows are erased rows, remove them before rows are moved
+   for( auto& uRow : m_vectorRow ) { if( uRow >= uFrom ) uRow -= uCount; }     // order is kept, all moved rows are moved the same distance
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief rows are moved, key order is the same but rows with equal key values are sorted on new row number
+ * @param uFrom first moved row
+ * @param vectorNewRow new row for row at uFrom + n
+ */
+void index_ordered::renumber( uint64_t uFrom, const std::vector<uint64_t>& vectorNewRow )
+{
+   compact();
+   const uint64_t uEnd = uFrom + vectorNewRow.size();
+   for( auto& uRow : m_vectorRow ) { if( uRow >= uFrom && uRow < uEnd ) uRow = vectorNewRow[uRow - uFrom]; }
+
+   // ## sort rows with equal key values on row number
+   for( std::size_t uBegin = 0, uMax = m_vectorRow.size(); uBegin < uMax; )
+   {
+      std::size_t uNext = uBegin + 1;
+      while( uNext < uMax && compare( m_vectorRow[uBegin], m_vectorRow[uNext] ) == 0 ) uNext++;
+      if( uNext - uBegin > 1 ) std::sort( m_vectorRow.begin() + uBegin, m_vectorRow.begin() + uNext );
+      uBegin = uNext;
+   }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------- index_zone
+// ----------------------------------------------------------------------------
+
+namespace {
+   /// set min to highest and max to lowest value, first value sets both
+   void zone_reset_s( index_zone::zone& zone_, index_zone::enumKind eKind )
+   {
+      if( eKind == index_zone::eKindInt64 ) { zone_.m_min.i = std::numeric_limits<int64_t>::max(); zone_.m_max.i = std::numeric_limits<int64_t>::min(); }
+      else if( eKind == index_zone::eKindDouble ) { zone_.m_min.d = std::numeric_limits<double>::infinity(); zone_.m_max.d = -std::numeric_limits<double>::infinity(); }
+      else { zone_.m_min.u = std::numeric_limits<uint64_t>::max(); zone_.m_max.u = 0; }
+      zone_.m_uNullCount = 0;
+      zone_.m_uNaN = 0;
+   }
+
+   /// widen min and max with values, returns true if decimal value is NaN
+   template<typename TYPE, typename VALUE>
+   bool zone_widen_s( const uint8_t* puValue, unsigned uStride, uint64_t uCount, VALUE& min_, VALUE& max_ )
+   {
+      bool bNaN = false;
+      for( uint64_t u = 0; u < uCount; u++, puValue += uStride )
+      {
+         VALUE v_ = (VALUE)*(const TYPE*)puValue;
+         if constexpr( std::is_floating_point_v<VALUE> == true ) { if( v_ != v_ ) { bNaN = true; continue; } }
+         if( v_ < min_ ) min_ = v_;
+         if( v_ > max_ ) max_ = v_;
+      }
+      return bNaN;
+   }
+
+   /// test filter against min and max in block
+   template<typename VALUE>
+   index_zone::enumMatch zone_match_s( VALUE min_, VALUE max_, enumFilter eFilter, VALUE v1_, VALUE v2_ )
+   {
+      switch( eFilter )
+      {
+      case eFilterEqual:        if( v1_ < min_ || v1_ > max_ ) return index_zone::eMatchNone; return ( min_ == v1_ && max_ == v1_ ) ? index_zone::eMatchAll : index_zone::eMatchSome;
+      case eFilterNotEqual:     if( min_ == v1_ && max_ == v1_ ) return index_zone::eMatchNone; return ( v1_ < min_ || v1_ > max_ ) ? index_zone::eMatchAll : index_zone::eMatchSome;
+      case eFilterLess:         if( ( min_ < v1_ ) == false ) return index_zone::eMatchNone; return max_ < v1_ ? index_zone::eMatchAll : index_zone::eMatchSome;
+      case eFilterLessEqual:    if( min_ > v1_ ) return index_zone::eMatchNone; return max_ <= v1_ ? index_zone::eMatchAll : index_zone::eMatchSome;
+      case eFilterGreater:      if( ( max_ > v1_ ) == false ) return index_zone::eMatchNone; return min_ > v1_ ? index_zone::eMatchAll : index_zone::eMatchSome;
+      case eFilterGreaterEqual: if( max_ < v1_ ) return index_zone::eMatchNone; return min_ >= v1_ ? index_zone::eMatchAll : index_zone::eMatchSome;
+      case eFilterBetween:      if( max_ < v1_ || min_ > v2_ ) return index_zone::eMatchNone; return ( min_ >= v1_ && max_ <= v2_ ) ? index_zone::eMatchAll : index_zone::eMatchSome;
+      default: return index_zone::eMatchSome;
+      }
+   }
+
+   /// range for integer column type
+   template<typename TYPE>
+   std::pair<double, double> zone_range_s() { return { (double)std::numeric_limits<TYPE>::lowest(), (double)std::numeric_limits<TYPE>::max() + 1.0 }; }
+
+   /** ------------------------------------------------------------------------
+    * @brief Convert filter value to integer column type if value can be stored in column
+    * Values with fraction or outside range can't be compared with min and max
+    * for block, block is then filtered with values.
+    * @return true if value is converted, false if value do not have exact value in column type
+   */
+   template<typename VALUE>
+   bool zone_integer_s( const gd::variant_view& v_, unsigned uTypeNumber, VALUE& value_ )
+   {
+      std::pair<double, double> pairRange;                                     // lowest value and max + 1, exact also for 64 bit types
+      switch( uTypeNumber )
+      {
+      case gd::types::eTypeNumberBool:
+      case gd::types::eTypeNumberUInt8:  pairRange = zone_range_s<uint8_t>(); break;
+      case gd::types::eTypeNumberInt8:   pairRange = zone_range_s<int8_t>(); break;
+      case gd::types::eTypeNumberUInt16: pairRange = zone_range_s<uint16_t>(); break;
+      case gd::types::eTypeNumberInt16:  pairRange = zone_range_s<int16_t>(); break;
+      case gd::types::eTypeNumberUInt32: pairRange = zone_range_s<uint32_t>(); break;
+      case gd::types::eTypeNumberInt32:  pairRange = zone_range_s<int32_t>(); break;
+      case gd::types::eTypeNumberUInt64: pairRange = zone_range_s<uint64_t>(); break;
+      default:                           pairRange = zone_range_s<int64_t>(); break;
+      }
+
+      if( v_.is_integer() == true || v_.is_bool() == true )
+      {
+         if( v_.type_number() == gd::types::eTypeNumberUInt64 )
+         {
+            uint64_t uValue = v_.as_uint64();
+            if( (double)uValue >= pairRange.second || std::in_range<VALUE>( uValue ) == false ) return false;
+            value_ = (VALUE)uValue;
+         }
+         else
+         {
+            int64_t iValue = v_.as_int64();
+            if( (double)iValue < pairRange.first || (double)iValue >= pairRange.second || std::in_range<VALUE>( iValue ) == false ) return false;
+            value_ = (VALUE)iValue;
+         }
+         return true;
+      }
+
+      double dValue = v_.as_double();
+      if( ( dValue >= pairRange.first && dValue < pairRange.second ) == false || dValue != std::floor( dValue ) ) return false; // NaN fails range check
+      value_ = (VALUE)dValue;
+      return true;
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief create zone map for key columns
+ * @param ptable table zone map is attached to
+ * @param vectorColumn key columns, statistics is kept for each column
+ * @param uBlockRows rows in block, power of 2 and at least 64 (filter works on 64 rows)
+ */
+index_zone::index_zone( const table_column_buffer* ptable, const std::vector<unsigned>& vectorColumn, unsigned uBlockRows )
+   : index_column( ptable, vectorColumn ), m_uBlockShift( (unsigned)std::countr_zero( uBlockRows ) )
+{                                                                                                  assert( std::has_single_bit( uBlockRows ) == true ); assert( uBlockRows >= 64 );
+   for( auto uColumn : m_vectorColumn )
+   {
+      const auto* pcolumn = ptable->column_get( uColumn, tag_pointer{} );
+      enumKind eKind = eKindNone;
+      if( pcolumn->is_reference() == true ) eKind = eKindCode;
+      else if( pcolumn->is_fixed() == true )
+      {
+         switch( pcolumn->ctype_number() )
+         {
+         case gd::types::eTypeNumberInt8: case gd::types::eTypeNumberInt16: case gd::types::eTypeNumberInt32: case gd::types::eTypeNumberInt64:
+            eKind = eKindInt64; break;
+         case gd::types::eTypeNumberBool: case gd::types::eTypeNumberUInt8: case gd::types::eTypeNumberUInt16: case gd::types::eTypeNumberUInt32: case gd::types::eTypeNumberUInt64:
+            eKind = eKindUInt64; break;
+         case gd::types::eTypeNumberFloat: case gd::types::eTypeNumberDouble:
+            eKind = eKindDouble; break;
+         default: break;
+         }
+      }
+      m_vectorKind.push_back( eKind );
+   }
+}
+
+/// key index for column, -1 if column isn't in zone map
+int index_zone::find_key( unsigned uColumn ) const noexcept
+{
+   for( std::size_t u = 0; u < m_vectorColumn.size(); u++ ) { if( m_vectorColumn[u] == uColumn ) return (int)u; }
+   return -1;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief summarize rows that isn't summarized
+ * Blocks where rows have been added at the end only reads added rows, blocks
+ * that are invalidated are summarized from first row. Like `flush` threads that
+ * read zone map at the same time are serialized until blocks are summarized.
+ */
+void index_zone::update() const
+{
+   if( m_bPending.load( std::memory_order_acquire ) == false ) return;
+
+   std::lock_guard<std::mutex> lock_( m_mutexFlush );
+   if( m_bPending.load( std::memory_order_relaxed ) == false ) return;       // other thread summarized blocks
+
+   const std::size_t uKeyCount = m_vectorColumn.size();
+   for( uint64_t uBlock = 0, uBlockCount = get_block_count(); uBlock < uBlockCount; uBlock++ )
+   {
+      const uint64_t uRowCount = get_block_row_count( uBlock );
+      uint32_t& uSummarized = m_vectorRowCount[uBlock];
+      if( uSummarized == uRowCount ) continue;
+
+      zone* pzoneBlock = &m_vectorZone[uBlock * uKeyCount];
+      if( uSummarized == 0 ) { for( std::size_t u = 0; u < uKeyCount; u++ ) zone_reset_s( pzoneBlock[u], m_vectorKind[u] ); }
+
+      const uint64_t uFirst = uBlock << m_uBlockShift;
+      for( std::size_t u = 0; u < uKeyCount; u++ ) summarize( (unsigned)u, uFirst + uSummarized, uFirst + uRowCount, &pzoneBlock[u] );
+      uSummarized = (uint32_t)uRowCount;
+   }
+   m_bPending.store( false, std::memory_order_release );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief add values in rows to statistics for key column
+ * Null cells are counted, values in null cells are included in min and max. This
+ * makes min and max wider than needed for some blocks but blocks are never skipped
+ * by mistake.
+ * @param uKey index for key column
+ * @param uFrom first row
+ * @param uEnd row after last row
+ * @param pzone statistics that is updated
+ */
+void index_zone::summarize( unsigned uKey, uint64_t uFrom, uint64_t uEnd, zone* pzone ) const
+{
+   const enumKind eKind = m_vectorKind[uKey];
+   if( eKind == eKindNone ) return;
+
+   const unsigned uColumn = m_vectorColumn[uKey];
+   const unsigned uTypeNumber = m_ptable->column_get_ctype_number( uColumn );
+   const unsigned uStride = m_ptable->cell_get_stride( uColumn );
+   for( uint64_t uRow = uFrom; uRow < uEnd; )
+   {
+      const uint64_t uCount = std::min( m_ptable->row_get_contiguous( uRow ), uEnd - uRow );
+      const uint8_t* puValue = m_ptable->cell_get( uRow, uColumn );
+      bool bNaN = false;
+      if( eKind == eKindCode )
+      {
+         if( m_ptable->is_dictionary() == true ) zone_widen_s<uint32_t>( puValue, uStride, uCount, pzone->m_min.u, pzone->m_max.u );
+         else                                    zone_widen_s<uint64_t>( puValue, uStride, uCount, pzone->m_min.u, pzone->m_max.u );
+      }
+      else
+      {
+         switch( uTypeNumber )
+         {
+         case gd::types::eTypeNumberInt8:   zone_widen_s<int8_t>( puValue, uStride, uCount, pzone->m_min.i, pzone->m_max.i ); break;
+         case gd::types::eTypeNumberInt16:  zone_widen_s<int16_t>( puValue, uStride, uCount, pzone->m_min.i, pzone->m_max.i ); break;
+         case gd::types::eTypeNumberInt32:  zone_widen_s<int32_t>( puValue, uStride, uCount, pzone->m_min.i, pzone->m_max.i ); break;
+         case gd::types::eTypeNumberInt64:  zone_widen_s<int64_t>( puValue, uStride, uCount, pzone->m_min.i, pzone->m_max.i ); break;
+         case gd::types::eTypeNumberBool:
+         case gd::types::eTypeNumberUInt8:  zone_widen_s<uint8_t>( puValue, uStride, uCount, pzone->m_min.u, pzone->m_max.u ); break;
+         case gd::types::eTypeNumberUInt16: zone_widen_s<uint16_t>( puValue, uStride, uCount, pzone->m_min.u, pzone->m_max.u ); break;
+         case gd::types::eTypeNumberUInt32: zone_widen_s<uint32_t>( puValue, uStride, uCount, pzone->m_min.u, pzone->m_max.u ); break;
+         case gd::types::eTypeNumberUInt64: zone_widen_s<uint64_t>( puValue, uStride, uCount, pzone->m_min.u, pzone->m_max.u ); break;
+         case gd::types::eTypeNumberFloat:  bNaN = zone_widen_s<float>( puValue, uStride, uCount, pzone->m_min.d, pzone->m_max.d ); break;
+         case gd::types::eTypeNumberDouble: bNaN = zone_widen_s<double>( puValue, uStride, uCount, pzone->m_min.d, pzone->m_max.d ); break;
+         default: assert( false );
+         }
+      }
+      if( bNaN == true ) pzone->m_uNaN = 1;
+      uRow += uCount;
+   }
+
+   if( m_ptable->is_null() == true )
+   {
+      for( uint64_t uRow = uFrom; uRow < uEnd; uRow++ ) { if( m_ptable->cell_is_null( uRow, uColumn ) == true ) pzone->m_uNullCount++; }
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief test filter against statistics for block
+ * Null values never match, block with only null values returns `eMatchNone`.
+ * `eMatchAll` means that all values that isn't null match, table removes null values.
+ * Reference columns only test equal with code for value as filter value.
+ * @param uBlock block to test
+ * @param uKey index for key column
+ * @param eFilter filter operator
+ * @param v1_ filter value (code for reference columns)
+ * @param v2_ second filter value for `eFilterBetween`
+ * @return enumMatch if none, some or all values in block may match
+ */
+index_zone::enumMatch index_zone::match( uint64_t uBlock, unsigned uKey, enumFilter eFilter, const gd::variant_view& v1_, const gd::variant_view& v2_ ) const
+{                                                                                                  assert( uKey < m_vectorColumn.size() ); assert( m_vectorRowCount[uBlock] == get_block_row_count( uBlock ) ); // call update before match
+   const zone& zone_ = get( uBlock, uKey );
+   if( m_vectorKind[uKey] == eKindNone || eFilter == eFilterNull || eFilter == eFilterNotNull || eFilter == eFilterIn ) return eMatchSome;
+   if( zone_.m_uNullCount >= get_block_row_count( uBlock ) ) return eMatchNone;
+
+   enumMatch eMatch = eMatchSome;
+   const unsigned uTypeNumber = m_ptable->column_get_ctype_number( m_vectorColumn[uKey] );
+   switch( m_vectorKind[uKey] )
+   {
+   case eKindInt64:
+   {
+      int64_t i1, i2;
+      if( zone_integer_s( v1_, uTypeNumber, i1 ) == false || zone_integer_s( v2_, uTypeNumber, i2 ) == false ) return eMatchSome;
+      eMatch = zone_match_s<int64_t>( zone_.m_min.i, zone_.m_max.i, eFilter, i1, i2 );
+   }
+   break;
+   case eKindUInt64:
+   {
+      uint64_t u1, u2;
+      if( zone_integer_s( v1_, uTypeNumber, u1 ) == false || zone_integer_s( v2_, uTypeNumber, u2 ) == false ) return eMatchSome;
+      eMatch = zone_match_s<uint64_t>( zone_.m_min.u, zone_.m_max.u, eFilter, u1, u2 );
+   }
+   break;
+   case eKindDouble:                                                           // float values are exact as double, filter value is compared at full precision
+      if( zone_.m_uNaN != 0 ) return eMatchSome;
+      eMatch = zone_match_s<double>( zone_.m_min.d, zone_.m_max.d, eFilter, v1_.as_double(), v2_.as_double() );
+      break;
+   case eKindCode:
+      if( eFilter == eFilterEqual ) eMatch = zone_match_s<uint64_t>( zone_.m_min.u, zone_.m_max.u, eFilter, v1_.as_uint64(), v1_.as_uint64() );
+      break;
+   default: break;
+   }
+
+   return eMatch;
+}
+
+/// rows are added at end of table, added rows are summarized when zone map is read
+void index_zone::on_add( uint64_t uFrom, uint64_t uCount )
+{                                                                                                  assert( uFrom == m_uRowCount );
+   m_uRowCount = uFrom + uCount;
+   uint64_t uBlockCount = ( m_uRowCount + get_block_rows() - 1 ) >> m_uBlockShift;
+   m_vectorRowCount.resize( uBlockCount, 0 );
+   m_vectorZone.resize( uBlockCount * m_vectorColumn.size() );
+   if( uCount > 0 ) m_bPending = true;
+}
+
+/// value in row is about to change, block is summarized again if row is summarized
+void index_zone::on_set( uint64_t uRow )
+{
+   uint64_t uBlock = get_block( uRow );
+   if( uBlock < get_block_count() && ( uRow & ( get_block_rows() - 1 ) ) < m_vectorRowCount[uBlock] ) { m_vectorRowCount[uBlock] = 0; m_bPending = true; }
+}
+
+/// rows are about to be erased, rows after erased rows are moved so blocks from first erased row are summarized again
+void index_zone::on_erase( uint64_t uFrom, uint64_t uCount )
+{                                                                                                  assert( (uFrom + uCount) <= m_uRowCount );
+   invalidate( uFrom, m_uRowCount - uFrom );
+   m_uRowCount -= uCount;
+   uint64_t uBlockCount = ( m_uRowCount + get_block_rows() - 1 ) >> m_uBlockShift;
+   m_vectorRowCount.resize( uBlockCount );
+   m_vectorZone.resize( uBlockCount * m_vectorColumn.size() );
+}
+
+/// rows are reordered, blocks with moved rows are summarized again
+void index_zone::on_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow )
+{
+   invalidate( uFrom, vectorRow.size() );
+}
+
+/// all rows in table are removed
+void index_zone::on_clear()
+{
+   reset();
+   m_uRowCount = 0;
+}
+
+/// mark blocks for rows as not summarized
+void index_zone::invalidate( uint64_t uFrom, uint64_t uCount )
+{
+   if( uCount == 0 || get_block_count() == 0 ) return;
+   uint64_t uLast = std::min( get_block( uFrom + uCount - 1 ), get_block_count() - 1 );
+   for( uint64_t uBlock = get_block( uFrom ); uBlock <= uLast && uBlock < get_block_count(); uBlock++ ) m_vectorRowCount[uBlock] = 0;
+   m_bPending = true;
+}
+
+/// hash for row, hash is calculated if row has been modified since hash was read. Threads may calculate the same hash, cell is accessed with atomic_ref
+uint64_t index_row_hash::get( uint64_t uRow ) const
+{                                                                                                  assert( uRow < m_vectorHash.size() );
+   std::atomic_ref<uint64_t> atomicHash( m_vectorHash[uRow] );
+   uint64_t uHash = atomicHash.load( std::memory_order_relaxed );
+   if( uHash == eHashNone )
+   {
+      uHash = m_ptable->row_hash( uRow, m_vectorColumn );
+      if( uHash == eHashNone ) uHash = 1;
+      atomicHash.store( uHash, std::memory_order_relaxed );
+   }
+   return uHash;
+}
+
+/// rows are added at end of table, hash is calculated when it is read
+void index_row_hash::on_add( uint64_t uFrom, uint64_t uCount )
+{                                                                                                  assert( uFrom == m_vectorHash.size() );
+   m_vectorHash.resize( uFrom + uCount, eHashNone );
+}
+
+/// rows are about to be erased, hash for rows after erased rows are moved
+void index_row_hash::on_erase( uint64_t uFrom, uint64_t uCount )
+{                                                                                                  assert( (uFrom + uCount) <= m_vectorHash.size() );
+   m_vectorHash.erase( m_vectorHash.begin() + uFrom, m_vectorHash.begin() + uFrom + uCount );
+}
+
+/// rows are reordered, hash follows row
+void index_row_hash::on_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow )
+{                                                                                                  assert( (uFrom + vectorRow.size()) <= m_vectorHash.size() );
+   std::vector<uint64_t> vectorHash( m_vectorHash.begin() + uFrom, m_vectorHash.begin() + uFrom + vectorRow.size() );
+   for( std::size_t u = 0; u < vectorRow.size(); u++ )
+   {
+      uint64_t uRowFrom = vectorRow[u];
+      if( uRowFrom >= uFrom && uRowFrom < uFrom + vectorRow.size() ) m_vectorHash[uFrom + u] = vectorHash[uRowFrom - uFrom];
+      else                                                           m_vectorHash[uFrom + u] = eHashNone;
+   }
+}
+
+_GD_TABLE_END
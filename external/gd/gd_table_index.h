@@ -1,13 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string_view>
 #include <vector>
 
 #include "gd_types.h"
+#include "gd_variant.h"
 #include "gd_variant_view.h"
 #include "gd_table.h"
 
 _GD_TABLE_BEGIN
 
+class table_column_buffer;
+
 class index_base
 {
 };
@@ -136,8 +145,427 @@ public:
 };
 
 
+/** ===========================================================================
+ * \brief base for indexes attached to table, table keeps attached indexes in sync with changes
+ *
+ * Table notifies index before values in key columns are changed and when rows are
+ * added, erased or moved. Rows that are added or modified are marked as pending and
+ * are inserted into index the next time index is searched, this way rows can be added
+ * and values set cell by cell without index reading values that isn't set yet.
+ * Rows with null value in any key column are not indexed.
+ *
+ * Searching is const and may run in many threads at the same time. The first
+ * reader that finds pending rows inserts them while holding `m_mutexFlush`, other
+ * readers wait for the lock and then read the updated index. Index storage that
+ * is updated by flush is `mutable`. Table can't be modified while it is searched.
+ *
+ * Indexes are created with `table_column_buffer::index_add`, table owns the index.
+ */
+class index_column : public index_base
+{
+public:
+   /// state for row in index
+   enum enumRowState : uint8_t
+   {
+      eRowStateNone     = 0,  ///< row isn't in index
+      eRowStateIndexed  = 1,  ///< row is in index
+      eRowStatePending  = 2,  ///< row is inserted into index when index is searched
+   };
+
+// ## construction -------------------------------------------------------------
+public:
+   index_column( const table_column_buffer* ptable, const std::vector<unsigned>& vectorColumn ): m_ptable( ptable ), m_vectorColumn( vectorColumn ) {}
+   // copy, index is bound to table and can't be copied
+   index_column( const index_column& o ) = delete;
+   index_column& operator=( const index_column& o ) = delete;
+
+   virtual ~index_column() {}
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   const table_column_buffer* get_table() const noexcept { return m_ptable; }
+   void set_table( const table_column_buffer* ptable ) noexcept { m_ptable = ptable; }
+   const std::vector<unsigned>& get_columns() const noexcept { return m_vectorColumn; }
+   /// check if column is part of key for index
+   bool is_key( unsigned uColumn ) const noexcept;
+   /// number of rows in index, pending rows are inserted first
+   virtual uint64_t size() const;
+//@}
+
+/** \name NOTIFY
+* Called by table when rows are modified
+*///@{
+   /// rows are added to table
+   virtual void on_add( uint64_t uFrom, uint64_t uCount );
+   /// value in key column for row is about to change, values in row still holds indexed values
+   virtual void on_set( uint64_t uRow );
+   /// rows are about to be erased, rows after erased rows are moved up
+   virtual void on_erase( uint64_t uFrom, uint64_t uCount );
+   /// rows are reordered, row at uFrom + n has got data from row in vectorRow[n]
+   virtual void on_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow );
+   /// all rows in table are removed
+   virtual void on_clear();
+//@}
+
+   /// insert pending rows into index, safe to call from many threads
+   void flush() const;
+   /// check if there are rows or blocks that is updated when index is read
+   bool is_pending() const noexcept { return m_bPending.load( std::memory_order_acquire ); }
+
+protected:
+/** \name INTERNAL
+*///@{
+   /// insert row into index, values are read from table (called by flush)
+   virtual void insert( uint64_t uRow ) const = 0;
+   /// insert rows into index, override if index can do this faster than inserting one row at a time
+   virtual void insert( const std::vector<uint64_t>& vectorRow ) const { for( auto uRow : vectorRow ) insert( uRow ); }
+   /// remove row from index, values in table still holds indexed values
+   virtual void remove( uint64_t uRow ) = 0;
+   /// rows from uFrom are moved up uCount rows (rows that are removed have been removed)
+   virtual void shift( uint64_t uFrom, uint64_t uCount ) = 0;
+   /// rows from uFrom are moved, row at uFrom + n is moved to vectorNewRow[n]
+   virtual void renumber( uint64_t uFrom, const std::vector<uint64_t>& vectorNewRow ) = 0;
+   /// remove all rows from index
+   virtual void reset() = 0;
+
+   /// check if any key value in row is null
+   bool is_null( uint64_t uRow ) const;
+   /// compare key values in two rows
+   int compare( uint64_t uRow1, uint64_t uRow2 ) const;
+   /// compare key values in row with key, key may have fewer values than key columns (leading columns are compared)
+   int compare( uint64_t uRow, const std::vector<gd::variant_view>& vectorKey ) const;
+   /// convert key values to types in key columns, converted values are stored in vectorBuffer
+   bool convert( const std::vector<gd::variant_view>& vectorKey, std::vector<gd::variant_view>& vectorValue, std::vector<gd::variant>& vectorBuffer ) const;
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   const table_column_buffer* m_ptable;   ///< table index is attached to
+   std::vector<unsigned> m_vectorColumn;  ///< key columns
+   mutable std::vector<uint8_t> m_vectorState;    ///< state for each row in table (`enumRowState`)
+   mutable std::vector<uint64_t> m_vectorPending; ///< rows waiting to be inserted into index
+   mutable std::atomic<bool> m_bPending = false;  ///< set when index need to be updated before it is read
+   mutable std::mutex m_mutexFlush;               ///< lock for readers updating index
+
+
+// ## free functions ------------------------------------------------------------
+public:
+   /// compare two values, null is less than any value and text is compared as bytes
+   static int compare_s( const gd::variant_view& v1, const gd::variant_view& v2 );
+   /// hash for value, text is hashed on bytes so utf8 and ascii text get the same hash
+   static uint64_t hash_s( const gd::variant_view& variantviewValue, uint64_t uSeed );
+};
+
+/** ===========================================================================
+ * \brief hash index, find rows with equal values in key columns
+ *
+ * Open addressing hash table with hash and row for each indexed row. Lookup is
+ * O(1), values are converted to column types before they are hashed.
+ *
+ \code
+auto pindex = table.index_add( { 0, 1 }, gd::table::tag_index_hash{} );
+int64_t iRow = pindex->find( { "Stockholm", 2024 } );
+std::vector<uint64_t> vectorRow;
+pindex->find( { "Stockholm", 2024 }, vectorRow );
+ \endcode
+ */
+class index_hash : public index_column
+{
+public:
+   /// slot in hash table, row is `eSlotEmpty` or `eSlotDeleted` if slot isn't used
+   struct slot
+   {
+      uint64_t m_uHash;
+      uint64_t m_uRow;
+   };
+
+   enum : uint64_t
+   {
+      eSlotEmpty   = (uint64_t)-1,
+      eSlotDeleted = (uint64_t)-2,
+   };
+
+// ## construction -------------------------------------------------------------
+public:
+   index_hash( const table_column_buffer* ptable, const std::vector<unsigned>& vectorColumn ): index_column( ptable, vectorColumn ) {}
+   ~index_hash() override {}
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name FIND
+*///@{
+   /// find first row with key values, -1 if not found
+   int64_t find( const std::vector<gd::variant_view>& vectorKey ) const;
+   int64_t find( const std::initializer_list<gd::variant_view>& listKey ) const { return find( std::vector<gd::variant_view>( listKey ) ); }
+   /// find all rows with key values
+   void find( const std::vector<gd::variant_view>& vectorKey, std::vector<uint64_t>& vectorRow ) const;
+   void find( const std::initializer_list<gd::variant_view>& listKey, std::vector<uint64_t>& vectorRow ) const { find( std::vector<gd::variant_view>( listKey ), vectorRow ); }
+//@}
+
+protected:
+/** \name INTERNAL
+*///@{
+   void insert( uint64_t uRow ) const override;
+   void insert( const std::vector<uint64_t>& vectorRow ) const override;
+   void remove( uint64_t uRow ) override;
+   void shift( uint64_t uFrom, uint64_t uCount ) override;
+   void renumber( uint64_t uFrom, const std::vector<uint64_t>& vectorNewRow ) override;
+   void reset() override { m_vectorSlot.clear(); m_uCount = 0; m_uUsed = 0; }
+
+   /// calculate hash for key values in row
+   uint64_t hash( uint64_t uRow ) const;
+   /// make room for more rows, hash table is rebuilt if needed
+   void reserve( uint64_t uCount ) const;
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   mutable std::vector<slot> m_vectorSlot; ///< hash table, size is power of 2
+   mutable uint64_t m_uCount = 0;          ///< number of rows in hash table
+   mutable uint64_t m_uUsed = 0;           ///< number of slots that isn't empty (rows and deleted slots)
+};
+
+/** ===========================================================================
+ * \brief ordered index, rows sorted on values in key columns
+ *
+ * Rows are kept sorted on key values (and row for equal values). Find match
+ * leading key columns, range returns rows between low and high values (both
+ * included) and prefix returns rows where text in first key column starts with
+ * text. Removed rows are collected and removed in one pass, pending rows are
+ * sorted and merged with indexed rows when index is flushed.
+ *
+ \code
+auto pindex = table.index_add( { 2 }, gd::table::tag_index_ordered{} );
+std::vector<uint64_t> vectorRow;
+pindex->range( { 10 }, { 20 }, vectorRow );
+pindex->prefix( "Stock", vectorRow );
+ \endcode
+ */
+class index_ordered : public index_column
+{
+// ## construction -------------------------------------------------------------
+public:
+   index_ordered( const table_column_buffer* ptable, const std::vector<unsigned>& vectorColumn ): index_column( ptable, vectorColumn ) {}
+   ~index_ordered() override {}
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name FIND
+*///@{
+   /// find first row in order with values in leading key columns, -1 if not found
+   int64_t find( const std::vector<gd::variant_view>& vectorKey ) const;
+   int64_t find( const std::initializer_list<gd::variant_view>& listKey ) const { return find( std::vector<gd::variant_view>( listKey ) ); }
+   /// find all rows with values in leading key columns
+   void find( const std::vector<gd::variant_view>& vectorKey, std::vector<uint64_t>& vectorRow ) const;
+   void find( const std::initializer_list<gd::variant_view>& listKey, std::vector<uint64_t>& vectorRow ) const { find( std::vector<gd::variant_view>( listKey ), vectorRow ); }
+   /// rows with key values from low to high (both included), empty low or high means no limit
+   void range( const std::vector<gd::variant_view>& vectorLow, const std::vector<gd::variant_view>& vectorHigh, std::vector<uint64_t>& vectorRow ) const;
+   void range( const std::initializer_list<gd::variant_view>& listLow, const std::initializer_list<gd::variant_view>& listHigh, std::vector<uint64_t>& vectorRow ) const { range( std::vector<gd::variant_view>( listLow ), std::vector<gd::variant_view>( listHigh ), vectorRow ); }
+   /// rows where text in first key column starts with prefix
+   void prefix( const std::string_view& stringPrefix, std::vector<uint64_t>& vectorRow ) const;
+   /// all indexed rows in key order
+   const std::vector<uint64_t>& rows() const { flush(); return m_vectorRow; }
+//@}
+
+protected:
+/** \name INTERNAL
+*///@{
+   void insert( uint64_t uRow ) const override { insert( std::vector<uint64_t>{ uRow } ); }
+   void insert( const std::vector<uint64_t>& vectorRow ) const override;
+   void remove( uint64_t uRow ) override { m_vectorRemove.push_back( uRow ); }
+   void shift( uint64_t uFrom, uint64_t uCount ) override;
+   void renumber( uint64_t uFrom, const std::vector<uint64_t>& vectorNewRow ) override;
+   void reset() override { m_vectorRow.clear(); m_vectorRemove.clear(); }
+
+   /// remove rows collected by remove from sorted rows
+   void compact() const;
+
+   /// position for first row with key values that isn't less than key
+   std::size_t lower_bound( const std::vector<gd::variant_view>& vectorKey ) const;
+   /// compare rows on key values and row number for equal values
+   bool less( uint64_t uRow1, uint64_t uRow2 ) const { int iCompare = compare( uRow1, uRow2 ); return iCompare != 0 ? iCompare < 0 : uRow1 < uRow2; }
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   mutable std::vector<uint64_t> m_vectorRow;    ///< rows sorted on key values
+   mutable std::vector<uint64_t> m_vectorRemove; ///< rows that are removed from index, removed in `compact`
+};
+
+
+/** ===========================================================================
+ * \brief zone map, min, max and null count for each key column in blocks of rows
+ *
+ * Scans in table (`find`, `find_variant_view` for sorted columns and `filter`)
+ * use zone map for the column to skip blocks where no value can match, blocks
+ * where all values match are selected without reading values. Works with number
+ * columns and reference columns (codes for values, only equal and in filters).
+ *
+ * Statistics are updated when zone map is read. Each block knows how many rows
+ * that are summarized, rows added at the end only widen min and max. Block is
+ * summarized again if value in summarized row is changed or rows are erased or
+ * moved (sort).
+ *
+ \code
+table.index_add( { 0 }, gd::table::tag_index_zone{} );                          // column 0 holds time for event
+gd::table::selection selectionRow;
+table.filter( 0, gd::table::eFilterBetween, { iFrom, iTo }, selectionRow );    // only blocks with time in window are read
+ \endcode
+ */
+class index_zone : public index_column
+{
+public:
+   enum { eSpaceZoneRows = 4096 };                                             ///< default number of rows in block
+
+   /// how values in key column are compared
+   enum enumKind : uint8_t
+   {
+      eKindNone      = 0,  ///< column type do not have statistics, blocks are never skipped
+      eKindInt64     = 1,  ///< signed integer and bool values
+      eKindUInt64    = 2,  ///< unsigned integer values
+      eKindDouble    = 3,  ///< decimal values
+      eKindCode      = 4,  ///< code for value in reference column, only equal is tested
+   };
+
+   /// result when filter is tested against block
+   enum enumMatch
+   {
+      eMatchNone     = 0,  ///< no value in block match
+      eMatchSome     = 1,  ///< values in block need to be tested
+      eMatchAll      = 2,  ///< all values that isn't null match
+   };
+
+   /// statistics for one key column in block
+   struct zone
+   {
+      union { int64_t i; uint64_t u; double d; } m_min;
+      union { int64_t i; uint64_t u; double d; } m_max;
+      uint32_t m_uNullCount;  ///< null values in block
+      uint32_t m_uNaN;        ///< 1 if decimal column has NaN values in block, then block is always tested
+   };
+
+// ## construction -------------------------------------------------------------
+public:
+   index_zone( const table_column_buffer* ptable, const std::vector<unsigned>& vectorColumn, unsigned uBlockRows = eSpaceZoneRows );
+   ~index_zone() override {}
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   /// number of rows in block
+   uint64_t get_block_rows() const noexcept { return (uint64_t)1 << m_uBlockShift; }
+   /// block for row
+   uint64_t get_block( uint64_t uRow ) const noexcept { return uRow >> m_uBlockShift; }
+   /// number of blocks
+   uint64_t get_block_count() const noexcept { return m_vectorRowCount.size(); }
+   /// key index for column, -1 if column isn't in zone map
+   int find_key( unsigned uColumn ) const noexcept;
+   /// statistics for key in block, call `update` before statistics is read
+   const zone& get( uint64_t uBlock, unsigned uKey ) const { assert( uBlock < get_block_count() ); return m_vectorZone[uBlock * m_vectorColumn.size() + uKey]; }
+   /// rows in block, last block may have fewer rows
+   uint64_t get_block_row_count( uint64_t uBlock ) const noexcept { uint64_t uFirst = uBlock << m_uBlockShift; return std::min( get_block_rows(), m_uRowCount - uFirst ); }
+   uint64_t size() const override { return m_uRowCount; }
+//@}
+
+/** \name OPERATION
+*///@{
+   /// summarize rows that isn't summarized, safe to call from many threads
+   void update() const;
+   /// test filter against values in block, filter values are converted to column type
+   enumMatch match( uint64_t uBlock, unsigned uKey, enumFilter eFilter, const gd::variant_view& v1_, const gd::variant_view& v2_ ) const;
+//@}
+
+/** \name NOTIFY
+*///@{
+   void on_add( uint64_t uFrom, uint64_t uCount ) override;
+   void on_set( uint64_t uRow ) override;
+   void on_erase( uint64_t uFrom, uint64_t uCount ) override;
+   void on_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow ) override;
+   void on_clear() override;
+//@}
+
+protected:
+/** \name INTERNAL
+* zone map handle notifications without row state, methods for rows are not used
+*///@{
+   void insert( uint64_t ) const override {}
+   void remove( uint64_t ) override {}
+   void shift( uint64_t, uint64_t ) override {}
+   void renumber( uint64_t, const std::vector<uint64_t>& ) override {}
+   void reset() override { m_vectorZone.clear(); m_vectorRowCount.clear(); m_bPending = false; }
+
+   /// mark blocks for rows as not summarized
+   void invalidate( uint64_t uFrom, uint64_t uCount );
+   /// add values in rows to statistics for key column
+   void summarize( unsigned uKey, uint64_t uFrom, uint64_t uEnd, zone* pzone ) const;
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   unsigned m_uBlockShift;                   ///< row shifted with this value is block for row
+   uint64_t m_uRowCount = 0;                 ///< rows in table
+   std::vector<enumKind> m_vectorKind;       ///< how values are compared for each key column
+   mutable std::vector<zone> m_vectorZone;          ///< statistics, one for each key column in each block
+   mutable std::vector<uint32_t> m_vectorRowCount;  ///< summarized rows in each block
+};
+
+
+/** ===========================================================================
+ * \brief cache with hash for values in key columns for each row
+ *
+ * Hash is calculated when it is read and kept until row is modified. Rows that
+ * are modified, moved or added get their hash calculated again next time they
+ * are read. Used by `diff` in table to avoid hashing rows that isn't modified.
+ *
+ \code
+auto pindex = table.index_add( { 0, 1, 2 }, gd::table::tag_index_row_hash{} );
+uint64_t uHash = pindex->get( 10 );                                            // hash for row 10
+ \endcode
+ */
+class index_row_hash : public index_column
+{
+// ## construction -------------------------------------------------------------
+public:
+   index_row_hash( const table_column_buffer* ptable, const std::vector<unsigned>& vectorColumn ): index_column( ptable, vectorColumn ) {}
+   ~index_row_hash() override {}
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   /// hash for row, calculated if row is modified
+   uint64_t get( uint64_t uRow ) const;
+   uint64_t size() const override { return m_vectorHash.size(); }
+//@}
+
+/** \name NOTIFY
+*///@{
+   void on_add( uint64_t uFrom, uint64_t uCount ) override;
+   void on_set( uint64_t uRow ) override { if( uRow < m_vectorHash.size() ) m_vectorHash[uRow] = eHashNone; }
+   void on_erase( uint64_t uFrom, uint64_t uCount ) override;
+   void on_move( uint64_t uFrom, const std::vector<uint64_t>& vectorRow ) override;
+   void on_clear() override { reset(); }
+//@}
 
+protected:
+/** \name INTERNAL
+* row hash handle notifications without row state, methods for rows are not used
+*///@{
+   void insert( uint64_t ) const override {}
+   void remove( uint64_t ) override {}
+   void shift( uint64_t, uint64_t ) override {}
+   void renumber( uint64_t, const std::vector<uint64_t>& ) override {}
+   void reset() override { m_vectorHash.clear(); }
+//@}
 
+// ## attributes ----------------------------------------------------------------
+public:
+   enum : uint64_t { eHashNone = 0 };                                          ///< hash isn't calculated, calculated hash with this value is changed to 1
+   mutable std::vector<uint64_t> m_vectorHash;                                 ///< hash for each row in table, cells are read and written with atomic_ref
+};
 
 
 template<typename INDEX, typename TABlE>
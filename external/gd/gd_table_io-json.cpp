@@ -0,0 +1,554 @@
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#  define GD_JSON_SSE2
+#  include <emmintrin.h>
+#endif
+
+#include "gd_csv.h"
+
+#include "gd_table_io.h"
+
+#if defined( __clang__ )
+   #pragma GCC diagnostic push
+   #pragma clang diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#elif defined( __GNUC__ )
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#elif defined( _MSC_VER )
+   #pragma warning(push)
+   #pragma warning( disable : 4996 )
+#endif
+
+_GD_TABLE_BEGIN
+
+namespace {
+   /// bit masks for 64 characters, bit is set for each character that match
+   struct block_mask
+   {
+      uint64_t m_uQuote;         ///< `"`
+      uint64_t m_uBackslash;     ///< `\`
+      uint64_t m_uStructural;    ///< `{`, `}`, `[`, `]`, `:` and `,`
+   };
+
+   /// classify 64 characters, `puBlock` need to have 64 readable bytes
+   inline void classify_s( const uint8_t* puBlock, block_mask& mask_ )
+   {
+#ifdef GD_JSON_SSE2
+      const __m128i iQuote = _mm_set1_epi8( '\"' );
+      const __m128i iBackslash = _mm_set1_epi8( '\\' );
+      const __m128i iLower = _mm_set1_epi8( 0x20 );
+      const __m128i iBraceOpen = _mm_set1_epi8( '{' );                         // `[` | 0x20 == `{`
+      const __m128i iBraceClose = _mm_set1_epi8( '}' );                        // `]` | 0x20 == `}`
+      const __m128i iColon = _mm_set1_epi8( ':' );
+      const __m128i iComma = _mm_set1_epi8( ',' );
+
+      mask_ = block_mask{ 0, 0, 0 };
+      for( unsigned u = 0; u < 4; u++ )
+      {
+         __m128i i16Byte = _mm_loadu_si128( (const __m128i*)( puBlock + u * 16 ) );
+         __m128i i16Lower = _mm_or_si128( i16Byte, iLower );
+         __m128i iStructural = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( i16Lower, iBraceOpen ), _mm_cmpeq_epi8( i16Lower, iBraceClose ) ),
+                                             _mm_or_si128( _mm_cmpeq_epi8( i16Byte, iColon ), _mm_cmpeq_epi8( i16Byte, iComma ) ) );
+         mask_.m_uQuote |= (uint64_t)(uint16_t)_mm_movemask_epi8( _mm_cmpeq_epi8( i16Byte, iQuote ) ) << ( u * 16 );
+         mask_.m_uBackslash |= (uint64_t)(uint16_t)_mm_movemask_epi8( _mm_cmpeq_epi8( i16Byte, iBackslash ) ) << ( u * 16 );
+         mask_.m_uStructural |= (uint64_t)(uint16_t)_mm_movemask_epi8( iStructural ) << ( u * 16 );
+      }
+#else
+      mask_ = block_mask{ 0, 0, 0 };
+      for( unsigned u = 0; u < 64; u++ )
+      {
+         uint8_t uCharacter = puBlock[u];
+         uint64_t uBit = uint64_t(1) << u;
+         if( uCharacter == '\"' ) mask_.m_uQuote |= uBit;
+         else if( uCharacter == '\\' ) mask_.m_uBackslash |= uBit;
+         else if( uCharacter == ':' || uCharacter == ',' || ( uCharacter | 0x20 ) == '{' || ( uCharacter | 0x20 ) == '}' ) mask_.m_uStructural |= uBit;
+      }
+#endif
+   }
+
+   /// each bit is xor of all bits up to and including bit, marks characters between quote pairs
+   inline uint64_t prefix_xor_s( uint64_t uBits )
+   {
+      uBits ^= uBits << 1;
+      uBits ^= uBits << 2;
+      uBits ^= uBits << 4;
+      uBits ^= uBits << 8;
+      uBits ^= uBits << 16;
+      uBits ^= uBits << 32;
+      return uBits;
+   }
+
+   /** ------------------------------------------------------------------------
+    * @brief Find positions for structural characters and quotes in json text
+    *
+    * Text is classified in blocks of 64 characters into bit masks. Escaped
+    * quotes are removed, characters inside strings are found with prefix xor on
+    * quote mask and structural characters inside strings are removed. Position
+    * for each remaining bit is added to index, strings are marked with both
+    * start and end quote.
+    *
+    * @param stringJson json text, max 4 GB
+    * @param vectorIndex positions for structural characters and quotes
+    * @return true if ok, false if string in text do not end
+   */
+   bool index_s( const std::string_view& stringJson, std::vector<uint32_t>& vectorIndex )
+   {
+      const uint8_t* puJson = (const uint8_t*)stringJson.data();
+      const std::size_t uSize = stringJson.length();
+      uint64_t uInString = 0;          // all bits set if previous block ended inside string
+      bool bEscape = false;            // true if previous block ended with backslash that escapes first character in next block
+      block_mask mask_;
+
+      vectorIndex.clear();
+      vectorIndex.reserve( uSize / 8 + 16 );
+
+      for( std::size_t uPosition = 0; uPosition < uSize; uPosition += 64 )
+      {
+         if( uSize - uPosition >= 64 ) classify_s( puJson + uPosition, mask_ );
+         else
+         {
+            uint8_t puLast[64];                                                // last block is padded with space
+            memset( puLast, ' ', sizeof( puLast ) );
+            memcpy( puLast, puJson + uPosition, uSize - uPosition );
+            classify_s( puLast, mask_ );
+         }
+
+         // ## find characters escaped with backslash, backslash that is escaped do not escape next character
+         uint64_t uEscaped = 0;
+         if( mask_.m_uBackslash != 0 || bEscape == true )
+         {
+            uint64_t uBackslash = mask_.m_uBackslash;
+            if( bEscape == true ) { uEscaped = 1; uBackslash &= ~uint64_t(1); }
+            bEscape = false;
+            while( uBackslash != 0 )
+            {
+               unsigned uBit = (unsigned)std::countr_zero( uBackslash );
+               uBackslash &= uBackslash - 1;
+               if( uBit == 63 ) { bEscape = true; break; }
+               uEscaped |= uint64_t(1) << ( uBit + 1 );
+               uBackslash &= ~( uint64_t(1) << ( uBit + 1 ) );
+            }
+         }
+
+         uint64_t uQuote = mask_.m_uQuote & ~uEscaped;
+         uint64_t uString = prefix_xor_s( uQuote ) ^ uInString;
+         uInString = (uint64_t)( (int64_t)uString >> 63 );                    // all bits set if block ends inside string
+
+         uint64_t uBits = ( mask_.m_uStructural & ~uString ) | uQuote;
+         while( uBits != 0 )
+         {
+            vectorIndex.push_back( (uint32_t)( uPosition + (unsigned)std::countr_zero( uBits ) ) );
+            uBits &= uBits - 1;
+         }
+      }
+
+      return uInString == 0;
+   }
+
+   /// type for value in json
+   enum enumValue
+   {
+      eValueRow,           ///< start of row, no value
+      eValueNull,
+      eValueNumber,
+      eValueBool,
+      eValueText,          ///< text without quotes, text may have escape sequences
+      eValueJson,          ///< object or array as json text
+   };
+
+   inline bool is_space_s( char chCharacter ) { return chCharacter == ' ' || chCharacter == '\t' || chCharacter == '\n' || chCharacter == '\r'; }
+
+   /** ------------------------------------------------------------------------
+    * @brief Walk rows in json array using index with structural characters
+    *
+    * Rows are objects or arrays, callback is called with `eValueRow` at start of
+    * each row and then for each value in row. Values that are objects or arrays
+    * are passed as json text.
+    *
+    * @param stringJson json text
+    * @param vectorIndex index from `index_s`
+    * @param callback_ called with row, value type, value position in row, key (empty for arrays) and value. return false to stop
+    * @return true if ok, false and error information on error, error text is empty if callback stopped
+   */
+   template<typename FUNCTION>
+   std::pair<bool, std::string> walk_s( const std::string_view& stringJson, const std::vector<uint32_t>& vectorIndex, FUNCTION&& callback_ )
+   {
+      const char* pbszJson = stringJson.data();
+      const uint32_t* puIndex = vectorIndex.data();
+      const std::size_t uCount = vectorIndex.size();
+      auto at_ = [pbszJson, puIndex, uCount]( std::size_t uIndex ) -> char { return uIndex < uCount ? pbszJson[puIndex[uIndex]] : '\0'; };
+      auto view_ = [pbszJson]( uint32_t uBegin, uint32_t uEnd ) { return std::string_view( pbszJson + uBegin, uEnd - uBegin ); };
+      auto error_ = []( uint64_t uRow, const char* pbszText ) { return std::pair<bool, std::string>( false, std::string( pbszText ) + " in row " + std::to_string( uRow ) ); };
+
+      if( at_( 0 ) != '[' ) return { false, "Json text is not an array" };
+
+      std::size_t uIndex = 1;
+      if( at_( uIndex ) == ']' ) return { true, "" };                          // empty array
+
+      for( uint64_t uRow = 0;; uRow++ )
+      {
+         char chCharacter = at_( uIndex );
+         if( chCharacter != '{' && chCharacter != '[' ) return error_( uRow, "Expected object or array" );
+         const bool bObject = chCharacter == '{';
+         const char chEnd = bObject == true ? '}' : ']';
+         if( callback_( uRow, eValueRow, 0u, std::string_view(), std::string_view() ) == false ) return { false, "" };
+         uIndex++;
+
+         // ## check for empty row, text between brackets in array can be a value
+         bool bEmpty = false;
+         if( at_( uIndex ) == chEnd )
+         {
+            bEmpty = true;
+            for( uint32_t u = puIndex[uIndex - 1] + 1; u < puIndex[uIndex] && bEmpty == true; u++ ) bEmpty = is_space_s( pbszJson[u] );
+            if( bEmpty == true ) uIndex++;
+         }
+
+         for( unsigned uPosition = 0; bEmpty == false; uPosition++ )
+         {
+            std::string_view stringKey;
+            if( bObject == true )
+            {
+               if( at_( uIndex ) != '\"' || at_( uIndex + 1 ) != '\"' ) return error_( uRow, "Expected key" );
+               stringKey = view_( puIndex[uIndex] + 1, puIndex[uIndex + 1] );
+               uIndex += 2;
+               if( at_( uIndex ) != ':' ) return error_( uRow, "Expected ':'" );
+               uIndex++;
+            }
+
+            // ## read value, scalar values are between previous and next structural character
+            std::string_view stringValue;
+            enumValue eValue;
+            chCharacter = at_( uIndex );
+            if( chCharacter == '\"' )
+            {
+               stringValue = view_( puIndex[uIndex] + 1, puIndex[uIndex + 1] );
+               uIndex += 2;
+               eValue = eValueText;
+            }
+            else if( chCharacter == '{' || chCharacter == '[' )
+            {
+               uint32_t uBegin = puIndex[uIndex];
+               int iDepth = 0;
+               do
+               {
+                  chCharacter = at_( uIndex );
+                  if( chCharacter == '{' || chCharacter == '[' ) iDepth++;
+                  else if( chCharacter == '}' || chCharacter == ']' ) iDepth--;
+                  else if( chCharacter == '\"' ) uIndex++;                     // skip end quote
+                  else if( chCharacter == '\0' ) return error_( uRow, "Unterminated value" );
+                  uIndex++;
+               } while( iDepth > 0 );
+               stringValue = view_( uBegin, puIndex[uIndex - 1] + 1 );
+               eValue = eValueJson;
+            }
+            else
+            {
+               if( uIndex >= uCount ) return error_( uRow, "Unterminated row" );
+               const char* pbszValue = pbszJson + puIndex[uIndex - 1] + 1;
+               const char* pbszValueEnd = pbszJson + puIndex[uIndex];
+               while( pbszValue < pbszValueEnd && is_space_s( *pbszValue ) == true ) pbszValue++;
+               while( pbszValueEnd > pbszValue && is_space_s( pbszValueEnd[-1] ) == true ) pbszValueEnd--;
+               stringValue = std::string_view( pbszValue, pbszValueEnd - pbszValue );
+
+               if( stringValue.empty() == true ) return error_( uRow, "Missing value" );
+               if( stringValue == "null" ) eValue = eValueNull;
+               else if( stringValue == "true" || stringValue == "false" ) eValue = eValueBool;
+               else if( stringValue[0] == '-' || ( stringValue[0] >= '0' && stringValue[0] <= '9' ) ) eValue = eValueNumber;
+               else return error_( uRow, ( "Invalid value '" + std::string( stringValue ) + "'" ).c_str() );
+            }
+
+            if( callback_( uRow, eValue, uPosition, stringKey, stringValue ) == false ) return { false, "" };
+
+            chCharacter = at_( uIndex );
+            if( chCharacter == ',' ) { uIndex++; continue; }
+            if( chCharacter == chEnd ) { uIndex++; break; }
+            return error_( uRow, "Expected ',' or end of row" );
+         }
+
+         chCharacter = at_( uIndex );
+         if( chCharacter == ',' ) { uIndex++; continue; }
+         if( chCharacter == ']' ) break;
+         return error_( uRow, "Expected ',' or end of array" );
+      }
+
+      return { true, "" };
+   }
+
+   /// append utf8 for code point
+   void append_utf8_s( uint32_t uCodePoint, std::string& stringOut )
+   {
+      if( uCodePoint < 0x80 ) stringOut += (char)uCodePoint;
+      else if( uCodePoint < 0x800 ) { stringOut += (char)( 0xc0 | ( uCodePoint >> 6 ) ); stringOut += (char)( 0x80 | ( uCodePoint & 0x3f ) ); }
+      else if( uCodePoint < 0x10000 ) { stringOut += (char)( 0xe0 | ( uCodePoint >> 12 ) ); stringOut += (char)( 0x80 | ( ( uCodePoint >> 6 ) & 0x3f ) ); stringOut += (char)( 0x80 | ( uCodePoint & 0x3f ) ); }
+      else { stringOut += (char)( 0xf0 | ( uCodePoint >> 18 ) ); stringOut += (char)( 0x80 | ( ( uCodePoint >> 12 ) & 0x3f ) ); stringOut += (char)( 0x80 | ( ( uCodePoint >> 6 ) & 0x3f ) ); stringOut += (char)( 0x80 | ( uCodePoint & 0x3f ) ); }
+   }
+
+   /// read four hex digits, returns false if not hex
+   bool read_hex4_s( const char* pbsz, uint32_t& uValue )
+   {
+      uValue = 0;
+      for( unsigned u = 0; u < 4; u++ )
+      {
+         char ch = pbsz[u];
+         uValue <<= 4;
+         if( ch >= '0' && ch <= '9' ) uValue |= ch - '0';
+         else if( ( ch | 0x20 ) >= 'a' && ( ch | 0x20 ) <= 'f' ) uValue |= ( ch | 0x20 ) - 'a' + 10;
+         else return false;
+      }
+      return true;
+   }
+
+   /** ------------------------------------------------------------------------
+    * @brief Remove escape sequences in json text, `\uXXXX` is converted to utf8
+    * @param stringText json text without quotes
+    * @param stringOut unescaped text
+    * @return true if ok, false if escape sequence is invalid
+   */
+   bool unescape_s( const std::string_view& stringText, std::string& stringOut )
+   {
+      stringOut.clear();
+      const char* pbszPosition = stringText.data();
+      const char* pbszEnd = pbszPosition + stringText.length();
+      while( pbszPosition < pbszEnd )
+      {
+         const char* pbszBackslash = (const char*)memchr( pbszPosition, '\\', pbszEnd - pbszPosition );
+         if( pbszBackslash == nullptr ) { stringOut.append( pbszPosition, pbszEnd ); break; }
+         stringOut.append( pbszPosition, pbszBackslash );
+         if( pbszBackslash + 1 >= pbszEnd ) return false;
+
+         pbszPosition = pbszBackslash + 2;
+         switch( pbszBackslash[1] )
+         {
+         case '\"': stringOut += '\"'; break;
+         case '\\': stringOut += '\\'; break;
+         case '/':  stringOut += '/'; break;
+         case 'b':  stringOut += '\b'; break;
+         case 'f':  stringOut += '\f'; break;
+         case 'n':  stringOut += '\n'; break;
+         case 'r':  stringOut += '\r'; break;
+         case 't':  stringOut += '\t'; break;
+         case 'u':
+         {
+            uint32_t uCodePoint;
+            if( pbszEnd - pbszPosition < 4 || read_hex4_s( pbszPosition, uCodePoint ) == false ) return false;
+            pbszPosition += 4;
+            if( uCodePoint >= 0xd800 && uCodePoint <= 0xdbff )                 // surrogate pair
+            {
+               uint32_t uLow;
+               if( pbszEnd - pbszPosition < 6 || pbszPosition[0] != '\\' || pbszPosition[1] != 'u' || read_hex4_s( pbszPosition + 2, uLow ) == false ) return false;
+               if( uLow < 0xdc00 || uLow > 0xdfff ) return false;
+               uCodePoint = 0x10000 + ( ( uCodePoint - 0xd800 ) << 10 ) + ( uLow - 0xdc00 );
+               pbszPosition += 6;
+            }
+            append_utf8_s( uCodePoint, stringOut );
+         }
+         break;
+         default: return false;
+         }
+      }
+      return true;
+   }
+
+   /// text with escape sequences is unescaped into buffer
+   inline bool text_s( const std::string_view& stringText, std::string& stringBuffer, std::string_view& stringOut )
+   {
+      if( memchr( stringText.data(), '\\', stringText.length() ) == nullptr ) { stringOut = stringText; return true; }
+      if( unescape_s( stringText, stringBuffer ) == false ) return false;
+      stringOut = stringBuffer;
+      return true;
+   }
+
+   /// found value types for column, used to select column type
+   enum enumInfer : unsigned
+   {
+      eInferInteger  = 0x01,
+      eInferDecimal  = 0x02,
+      eInferBool     = 0x04,
+      eInferText     = 0x08,
+   };
+
+   /** ------------------------------------------------------------------------
+    * @brief Add columns to table from values in json rows
+    *
+    * Objects add one column for each key in the order keys are found, arrays add
+    * one column for each position. Column type is selected from all values in
+    * column, integers and decimals are `double`, mixed types or text are `rstring`.
+    *
+    * @param table table columns are added to, table need to be without columns
+    * @param stringJson json text
+    * @param vectorIndex index from `index_s`
+    * @return true if ok, false and error information on error
+   */
+   std::pair<bool, std::string> infer_s( dto::table& table, const std::string_view& stringJson, const std::vector<uint32_t>& vectorIndex )
+   {                                                                                               assert( table.get_column_count() == 0 );
+      std::vector<std::pair<std::string, unsigned>> vectorColumn;              // column name and found value types
+      std::unordered_map<std::string, unsigned> mapKey;                        // key name and column index
+      std::vector<std::pair<std::string_view, unsigned>> vectorCache;          // last key and column for position in object
+      std::string stringBuffer;
+      std::string stringError;
+
+      auto result_ = walk_s( stringJson, vectorIndex, [&]( uint64_t uRow, enumValue eValue, unsigned uPosition, std::string_view stringKey, std::string_view stringValue ) -> bool {
+         if( eValue == eValueRow ) return true;
+
+         unsigned uColumn = uPosition;
+         if( stringKey.data() != nullptr )
+         {
+            if( uPosition < vectorCache.size() && vectorCache[uPosition].first == stringKey ) uColumn = vectorCache[uPosition].second;
+            else
+            {
+               std::string_view stringName;
+               if( text_s( stringKey, stringBuffer, stringName ) == false ) { stringError = "Invalid escape in key in row " + std::to_string( uRow ); return false; }
+               auto [it, bInsert] = mapKey.try_emplace( std::string( stringName ), (unsigned)vectorColumn.size() );
+               if( bInsert == true ) vectorColumn.emplace_back( std::string( stringName ), 0u );
+               uColumn = it->second;
+               if( uPosition >= vectorCache.size() ) vectorCache.resize( uPosition + 1 );
+               vectorCache[uPosition] = { stringKey, uColumn };
+            }
+         }
+         else
+         {
+            while( vectorColumn.size() <= uColumn ) vectorColumn.emplace_back( "column" + std::to_string( vectorColumn.size() + 1 ), 0u );
+         }
+
+         unsigned& uInfer = vectorColumn[uColumn].second;
+         switch( eValue )
+         {
+         case eValueNumber: uInfer |= stringValue.find_first_of( ".eE" ) == std::string_view::npos ? eInferInteger : eInferDecimal; break;
+         case eValueBool:   uInfer |= eInferBool; break;
+         case eValueText:
+         case eValueJson:   uInfer |= eInferText; break;
+         default: break;
+         }
+         return true;
+      });
+      if( result_.first == false ) return { false, stringError.empty() == false ? stringError : result_.second };
+      if( vectorColumn.empty() == true ) return { true, "" };                  // no values, table is not prepared
+
+      for( const auto& it : vectorColumn )
+      {
+         const unsigned uInfer = it.second;
+         std::string_view stringType = "rstring";
+         if( ( uInfer & eInferText ) == 0 )
+         {
+            if( ( uInfer & eInferBool ) != 0 ) { if( ( uInfer & ( eInferInteger | eInferDecimal ) ) == 0 ) stringType = "bool"; }
+            else if( ( uInfer & eInferDecimal ) != 0 ) stringType = "double";
+            else if( ( uInfer & eInferInteger ) != 0 ) stringType = "int64";
+         }
+         table.column_add( stringType, 0, it.first );
+      }
+
+      if( vectorColumn.size() <= 64 ) table.set_flags( table.get_flags() | ( vectorColumn.size() <= 32 ? dto::table::eTableFlagNull32 : dto::table::eTableFlagNull64 ) );
+      return table.prepare();
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Read json array with objects or arrays into table
+ *
+ * Text is indexed in one pass before values are read, positions for structural
+ * characters outside strings are found 64 characters at a time (sse2 when
+ * available). Rows are then read from index without scanning characters in
+ * strings again.
+ *
+ * Rows that are objects are matched to columns by key name, key is matched
+ * once for each position in object and reused while objects have keys in same
+ * order. Keys without column are skipped. Rows that are arrays are matched to
+ * columns by position. Values are converted directly to column type and written
+ * to cell, `null` or missing values are null.
+ *
+ * If table do not have columns, columns are added from json with type selected
+ * from values (`int64`, `double`, `bool` or `rstring`). Table with columns need
+ * to be prepared. If json do not have any values nothing is added to table.
+ *
+ * @param table table rows are added to
+ * @param stringJson json text with array of objects or arrays
+ * @return true if ok, false and error information on error
+ *
+ * @code
+std::string stringJson = R"([{"id":1,"name":"a"},{"id":2,"name":"b"}])";
+gd::table::dto::table tableOrder;
+auto result_ = gd::table::read_g( tableOrder, stringJson, gd::table::tag_io_json{} );
+ * @endcode
+*/
+std::pair<bool, std::string> read_g( dto::table& table, const std::string_view& stringJson, tag_io_json )
+{
+   if( stringJson.length() > 0xffff'ffff ) return { false, "Json text is too large" };
+
+   std::vector<uint32_t> vectorIndex;
+   if( index_s( stringJson, vectorIndex ) == false ) return { false, "Unterminated string in json text" };
+
+   if( table.get_column_count() == 0 )
+   {
+      auto result_ = infer_s( table, stringJson, vectorIndex );
+      if( result_.first == false ) return result_;
+      if( table.get_column_count() == 0 ) return { true, "" };                 // empty array or rows without values
+   }
+
+   gd::csv::decoder decoder_( table );
+   const unsigned uColumnCount = table.get_column_count();
+   const uint64_t uRowStart = table.get_row_count();
+   std::vector<std::pair<std::string_view, int>> vectorCache;                  // last key and column for position in object
+   std::string stringBuffer;
+   std::string stringError;
+   uint64_t uRowTable = 0;                                                     // row in table for current json row
+
+   auto result_ = walk_s( stringJson, vectorIndex, [&]( uint64_t uRow, enumValue eValue, unsigned uPosition, std::string_view stringKey, std::string_view stringValue ) -> bool {
+      if( eValue == eValueRow )
+      {
+         uRowTable = table.get_row_count();
+         if( table.is_null() == true ) table.row_add( tag_null{} );
+         else                          table.row_add();
+         return true;
+      }
+
+      // ## find column for value
+      int iColumn = (int)uPosition;
+      if( stringKey.data() != nullptr )
+      {
+         if( uPosition < vectorCache.size() && vectorCache[uPosition].first == stringKey ) iColumn = vectorCache[uPosition].second;
+         else
+         {
+            std::string_view stringName;
+            if( text_s( stringKey, stringBuffer, stringName ) == false ) { stringError = "Invalid escape in key in row " + std::to_string( uRow ); return false; }
+            iColumn = table.column_find_index( stringName );
+            if( uPosition >= vectorCache.size() ) vectorCache.resize( uPosition + 1 );
+            vectorCache[uPosition] = { stringKey, iColumn };
+         }
+      }
+      if( iColumn < 0 || (unsigned)iColumn >= uColumnCount || eValue == eValueNull ) return true;
+
+      if( eValue == eValueText && text_s( stringValue, stringBuffer, stringValue ) == false )
+      {
+         stringError = "Invalid escape in row " + std::to_string( uRow ) + ", column " + std::to_string( iColumn ) + " (" + std::string( table.column_get_name( iColumn ) ) + ")";
+         return false;
+      }
+
+      if( decoder_.set( table, uRowTable, (unsigned)iColumn, stringValue ) == false )
+      {
+         stringError = "Invalid value in row " + std::to_string( uRow ) + ", column " + std::to_string( iColumn ) + " (" + std::string( table.column_get_name( iColumn ) ) + "): " + std::string( stringValue );
+         return false;
+      }
+      return true;
+   });
+
+   if( result_.first == false )
+   {
+      table.set_row_count( uRowStart );                                        // remove rows added from json text
+      return { false, stringError.empty() == false ? stringError : result_.second };
+   }
+
+   return { true, "" };
+}
+
+_GD_TABLE_END
+
+#if defined(__clang__)
+   #pragma clang diagnostic pop
+#elif defined(__GNUC__)
+   #pragma GCC diagnostic pop
+#elif defined(_MSC_VER)
+   #pragma warning(pop)
+#endif
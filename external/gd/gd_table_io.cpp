@@ -1,4 +1,18 @@
 #include <numeric>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 #include "gd_parse.h"
 #include "gd_sql_value.h"
@@ -70,8 +84,10 @@ std::pair<bool, std::string> to_table( const std::string_view& stringTableData,
 }
 */
 
+namespace {
 /// convert table to csv
-void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_csv )
+template <typename TABLE>
+void to_string_s( const TABLE& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_csv )
 {
    unsigned uOptions = 0;
    std::function<bool(std::string_view, std::string& stringNew)> functionFormat( format_copy );
@@ -140,35 +156,48 @@ void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const
    if( stringOut.empty() == true ) stringOut = std::move( stringResult );
    else stringOut += stringResult;
 }
+} // namespace
+
+void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_csv ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_csv{} );
+}
+
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_csv ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_csv{} );
+}
 
 
+namespace {
 /// convert table (both header and body) to json array
-void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_csv)
+template <typename TABLE>
+void to_string_s( const TABLE& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_csv )
 {
    std::string stringResult;   // result string with table data
 
-   auto it = table.column_begin(), itEnd = table.column_end();
+   unsigned uColumn = 0, uColumnCount = table.get_column_count();
 
-   if(it != itEnd)
+   if(uColumn < uColumnCount)
    {
+      const auto& column_ = table.column_get( uColumn );
       stringResult += '\"';
-      if(it->alias() != 0) { stringResult += table.column_get_alias( *it ); }
-      else { stringResult += table.column_get_name( *it ); }
+      if(column_.alias() != 0) { stringResult += table.column_get_alias( column_ ); }
+      else { stringResult += table.column_get_name( column_ ); }
       stringResult += '\"';
-      it++;
+      uColumn++;
    }
 
    std::string stringName;
-   for(; it < itEnd; it++)
+   for(; uColumn < uColumnCount; uColumn++)
    {
+      const auto& column_ = table.column_get( uColumn );
       stringResult += std::string_view( ",\"" );
-      if(it->alias() != 0)
+      if(column_.alias() != 0)
       {
-         stringName = table.column_get_alias( *it );
+         stringName = table.column_get_alias( column_ );
       }
       else 
       {
-         stringName = table.column_get_name( *it );
+         stringName = table.column_get_name( column_ );
       }
 
       gd::parse::escape_g( stringName, gd::parse::tag_csv{});
@@ -188,6 +217,15 @@ void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const
    if( stringOut.empty() == true ) stringOut = std::move( stringResult );
    else stringOut += stringResult;
 }
+} // namespace
+
+void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_csv ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_header{}, tag_io_csv{} );
+}
+
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_csv ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_header{}, tag_io_csv{} );
+}
 
 
 void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, bool (*pformat_text_)(unsigned uColumn, unsigned uType, const gd::variant_view&, std::string& stringNew), std::string& stringOut, tag_io_csv )
@@ -320,8 +358,10 @@ std::pair<bool, const char*> read_g(std::vector<std::string>& vectorHeader, cons
 
 // std::pair< bool, std::string >
 
+namespace {
 /// convert table to json array
-void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json )
+template <typename TABLE>
+void to_string_s( const TABLE& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json )
 {
    unsigned uOptions = 0;
    std::function<bool(std::string_view, std::string& stringNew)> functionFormat( format_copy );
@@ -381,6 +421,15 @@ void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const
    if( stringOut.empty() == true ) stringOut = std::move( stringResult );
    else stringOut += stringResult;
 }
+} // namespace
+
+void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_json{} );
+}
+
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_json{} );
+}
 
 /// convert table to json array for selected rows
 void to_string( const dto::table& table, const std::vector<uint64_t>& vectorRow, const gd::argument::arguments& argumentsOption, const std::function<bool (const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json )
@@ -446,31 +495,24 @@ void to_string( const dto::table& table, const std::vector<uint64_t>& vectorRow,
 }
 
 namespace internal {
-   void header_to_string(const dto::table& table, std::string& stringOut, tag_io_json)
+   template <typename TABLE>
+   void header_to_string(const TABLE& table, std::string& stringOut, tag_io_json)
    {
       stringOut += '[';   // result string with table data
 
-      auto it = table.column_begin(), itEnd = table.column_end();
-
-      if(it != itEnd)
+      for(unsigned uColumn = 0, uColumnCount = table.get_column_count(); uColumn < uColumnCount; uColumn++)
       {
-         stringOut += '\"';
-         if(it->alias() != 0) { stringOut += table.column_get_alias( *it ); }
-         else { stringOut += table.column_get_name( *it ); }
-         stringOut += '\"';
-         it++;
-      }
+         const auto& column_ = table.column_get( uColumn );
+         if(uColumn == 0) { stringOut += '\"'; }
+         else { stringOut += std::string_view( ",\"" ); }
 
-      for(; it < itEnd; it++)
-      {
-         stringOut += std::string_view( ",\"" );
-         if(it->alias() != 0)
+         if(column_.alias() != 0)
          {
-            stringOut += table.column_get_alias( *it );
+            stringOut += table.column_get_alias( column_ );
          }
          else 
          {
-            stringOut += table.column_get_name( *it );
+            stringOut += table.column_get_name( column_ );
          }
 
          stringOut += '\"';
@@ -480,8 +522,10 @@ namespace internal {
    }
 }
 
+namespace {
 /// convert table (both header and body) to json array
-void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_json)
+template <typename TABLE>
+void to_string_s( const TABLE& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_json )
 {
    std::string stringResult;
    internal::header_to_string( table, stringResult, tag_io_json{} );
@@ -496,6 +540,15 @@ void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const
    if( stringOut.empty() == true ) stringOut = std::move( stringResult );
    else stringOut += stringResult;
 }
+} // namespace
+
+void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_json ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_header{}, tag_io_json{} );
+}
+
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_json ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_header{}, tag_io_json{} );
+}
 
 /// convert table (both header and body) to json array
 void to_string(const dto::table& table, const std::vector<uint64_t>& vectorRow, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_json)
@@ -511,8 +564,10 @@ void to_string(const dto::table& table, const std::vector<uint64_t>& vectorRow,
 }
 
 
+namespace {
 /// Convert table data to json arrays where each row is placed in array as an object. key for value is the name for column
-void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json, tag_io_name)
+template <typename TABLE>
+void to_string_s( const TABLE& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json, tag_io_name )
 {
    unsigned uOptions = 0;
    std::function<bool(std::string_view, std::string& stringNew)> functionFormat( format_copy );
@@ -536,8 +591,6 @@ void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const
       vectorValue.clear();
       table.row_get_variant_view( uRow, vectorValue );                         assert( vectorName.size() == vectorValue.size() );
 
-      unsigned uColumn = 0;
-
       for( unsigned uColumn = 0, uColumnMax = (unsigned)vectorValue.size(); uColumn < uColumnMax; uColumn++ )
       {
          if( uColumn > 0 ) stringResult += ",";                                // add `,` to separate columns
@@ -578,8 +631,6 @@ void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const
             else                              stringResult += value_.as_string();
 
          }
-
-         uColumn++;
       }
 
       stringResult += std::string_view("}");
@@ -589,6 +640,15 @@ void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const
    if( stringOut.empty() == true ) stringOut = std::move( stringResult );
    else stringOut += stringResult;
 }
+} // namespace
+
+void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json, tag_io_name ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_json{}, tag_io_name{} );
+}
+
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json, tag_io_name ) {
+   to_string_s( table, uBegin, uCount, argumentsOption, format_text_, stringOut, tag_io_json{}, tag_io_name{} );
+}
 
 namespace {
 
@@ -1051,6 +1111,16 @@ void to_string(const table& table, uint64_t uBegin, uint64_t uCount, std::vector
    to_string_s( table, uBegin, uCount, vectorWidth, vectorcolumn, argumentOption, stringOut );
 }
 
+void to_string(const table_view& table, const gd::argument::arguments& argumentOption, std::string& stringOut, tag_io_header, tag_io_cli)
+{
+   to_string_s( table, argumentOption, stringOut, tag_io_header{});
+}
+
+void to_string(const table_view& table, uint64_t uBegin, uint64_t uCount, std::vector<unsigned> vectorWidth, const gd::argument::arguments& argumentOption, std::string& stringOut, tag_io_cli)
+{
+   to_string_s( table, uBegin, uCount, vectorWidth, argumentOption, stringOut );
+}
+
 
 
 namespace {
@@ -1202,4 +1272,360 @@ void write_insert_g(const std::string_view& stringTableName, const dto::table& t
 }
 
 
+// ## BINARY IO ---------------------------------------------------------------
+
+namespace {
+   /// header in binary table file, values are stored in native byte order
+   struct binary_header
+   {
+      char m_pbszMagic[8];          ///< "GDTABLE" and zero termination
+      uint32_t m_uVersion;          ///< file format version
+      uint32_t m_uByteOrder;        ///< 0x01020304 in byte order used to write file
+      uint32_t m_uFlags;            ///< table flags
+      uint32_t m_uRowSize;          ///< row size in bytes
+      uint32_t m_uRowMetaSize;      ///< meta size in bytes for each row
+      uint32_t m_uColumnCount;      ///< number of columns
+      uint32_t m_uNamesSize;        ///< bytes in buffer with column names
+      uint32_t m_uReserved;         ///< not used
+      uint64_t m_uRowCount;         ///< rows with values
+      uint64_t m_uReservedRowCount; ///< rows in data block
+      uint64_t m_uDataOffset;       ///< offset to data block, aligned to 64 bytes
+      uint64_t m_uDataSize;         ///< data block size in bytes
+      uint64_t m_uReferenceOffset;  ///< offset to values for reference columns
+      uint64_t m_uReferenceCount;   ///< number of reference values
+      uint64_t m_uFileSize;         ///< total file size, used to check that file is complete
+   };
+   static_assert( sizeof( binary_header ) == 96 );
+
+   /// column information in binary table file
+   struct binary_column
+   {
+      uint32_t m_uState;
+      uint32_t m_uType;
+      uint32_t m_uCType;
+      uint32_t m_uPosition;
+      uint32_t m_uSize;
+      uint32_t m_uPrimitiveSize;
+      uint32_t m_uNameOffset;
+      uint32_t m_uAliasOffset;
+   };
+
+   /// reference value in binary table file, value bytes follows and are padded to 8 bytes
+   struct binary_reference
+   {
+      uint32_t m_uType;
+      uint32_t m_uLength;
+      uint32_t m_uSize;
+      int32_t m_iReferenceCount;
+   };
+
+   constexpr char pbszBinaryMagic_s[8] = "GDTABLE";
+   constexpr uint32_t uBinaryByteOrder_s = 0x01020304;
+
+   constexpr uint64_t align_s( uint64_t uOffset, uint64_t uAlign ) { return ( uOffset + uAlign - 1 ) & ~( uAlign - 1 ); }
+
+   /** ------------------------------------------------------------------------
+    * @brief Read table from binary file data
+    * If `pFileOwner` is set the data block in file is used as table data, otherwise
+    * data is copied to block allocated by table.
+    * @param table table that gets columns and values from file
+    * @param puFile pointer to file data
+    * @param uFileSize file size in bytes
+    * @param pFileOwner owner for file data when file data is used by table
+    * @return true if ok, false and error information if failed
+    */
+   std::pair<bool, std::string> read_binary_s( dto::table& table, uint8_t* puFile, uint64_t uFileSize, std::shared_ptr<void> pFileOwner )
+   {
+      if( uFileSize < sizeof( binary_header ) ) return { false, "file is too small to be a binary table file" };
+
+      binary_header header;
+      memcpy( &header, puFile, sizeof( binary_header ) );
+      if( memcmp( header.m_pbszMagic, pbszBinaryMagic_s, sizeof( pbszBinaryMagic_s ) ) != 0 ) return { false, "file is not a binary table file" };
+      if( header.m_uByteOrder != uBinaryByteOrder_s ) return { false, "binary table file is written with other byte order" };
+      if( header.m_uVersion != uBinaryVersion_g ) return { false, "binary table file version " + std::to_string( header.m_uVersion ) + " is not supported" };
+      if( header.m_uFileSize != uFileSize ) return { false, "binary table file size do not match size in header, file is incomplete" };
+
+      uint64_t uColumnOffset = sizeof( binary_header );
+      uint64_t uNamesOffset = uColumnOffset + (uint64_t)header.m_uColumnCount * sizeof( binary_column );
+      if( header.m_uColumnCount == 0 || uNamesOffset + header.m_uNamesSize > header.m_uDataOffset || ( header.m_uDataOffset % 64 ) != 0 ||
+          header.m_uDataOffset + header.m_uDataSize > header.m_uReferenceOffset || header.m_uReferenceOffset > uFileSize ||
+          header.m_uRowCount > header.m_uReservedRowCount || header.m_uDataSize != (uint64_t)( header.m_uRowSize + header.m_uRowMetaSize ) * header.m_uReservedRowCount )
+      {
+         return { false, "binary table file has invalid section sizes" };
+      }
+
+      // ## check flags, columns and reference values before table is changed
+      const uint32_t uFlagsKnown = table_column_buffer::eTableFlagNull32 | table_column_buffer::eTableFlagNull64 | table_column_buffer::eTableFlagRowStatus | table_column_buffer::eTableFlagColumnar | table_column_buffer::eTableFlagDictionary;// segmented tables are written as one block
+      if( ( header.m_uFlags & ~uFlagsKnown ) != 0 ) return { false, "binary table file has invalid table flags" };
+      if( header.m_uNamesSize >= 0xf000 ) return { false, "binary table file has too many column names" };// names buffer use 16 bit offsets
+
+      const uint8_t* puNames = puFile + uNamesOffset;
+      auto is_name_s = [&header, puNames]( uint32_t uOffset ) -> bool {        // offset 0 is column without name
+         if( uOffset == 0 ) return true;
+         if( uOffset < sizeof( uint16_t ) || uOffset >= header.m_uNamesSize ) return false;
+         uint16_t uLength;
+         memcpy( &uLength, puNames + uOffset - sizeof( uint16_t ), sizeof( uint16_t ) );// name length is stored before name
+         return (uint64_t)uOffset + uLength < header.m_uNamesSize;             // name and zero terminator is in buffer
+      };
+
+      std::vector<binary_column> vectorColumn( header.m_uColumnCount );
+      for( uint32_t u = 0; u < header.m_uColumnCount; u++ )
+      {
+         binary_column& columnFile = vectorColumn[u];
+         memcpy( &columnFile, puFile + uColumnOffset + u * sizeof( binary_column ), sizeof( binary_column ) );
+         if( gd::types::validate_number_type_g( columnFile.m_uCType ) == false || ( columnFile.m_uCType & 0xff ) == gd::types::eTypeNumberUnknown ) return { false, "binary table file has invalid type for column " + std::to_string( u ) };
+         if( is_name_s( columnFile.m_uNameOffset ) == false || is_name_s( columnFile.m_uAliasOffset ) == false ) return { false, "binary table file has invalid name for column " + std::to_string( u ) };
+      }
+
+      uint64_t uReferenceOffset = header.m_uReferenceOffset;
+      for( uint64_t u = 0; u < header.m_uReferenceCount; u++ )
+      {
+         binary_reference referenceFile;
+         if( uReferenceOffset + sizeof( binary_reference ) > uFileSize ) return { false, "binary table file has invalid reference values" };
+         memcpy( &referenceFile, puFile + uReferenceOffset, sizeof( binary_reference ) );
+         uReferenceOffset += sizeof( binary_reference );
+         if( uReferenceOffset + referenceFile.m_uSize > uFileSize || gd::types::validate_number_type_g( referenceFile.m_uType ) == false ||
+             referenceFile.m_uLength > referenceFile.m_uSize || gd::types::value_size_g( referenceFile.m_uType, referenceFile.m_uLength ) > referenceFile.m_uSize )
+         {
+            return { false, "binary table file has invalid reference values" };
+         }
+         uReferenceOffset += align_s( referenceFile.m_uSize, 8 );
+      }
+
+      table.clear();
+      table.set_flags( header.m_uFlags );
+
+      // ## columns and column names
+      for( const auto& columnFile : vectorColumn )
+      {
+         table_column_buffer::column column_( columnFile.m_uCType, columnFile.m_uType, columnFile.m_uSize );
+         column_.state( columnFile.m_uState );
+         column_.position( columnFile.m_uPosition );
+         column_.primitive_size( columnFile.m_uPrimitiveSize );
+         column_.name( columnFile.m_uNameOffset );
+         column_.alias( columnFile.m_uAliasOffset );
+         table.m_vectorColumn.push_back( column_ );
+      }
+
+      if( header.m_uNamesSize > 0 )
+      {
+         table.m_namesColumn.reserve( header.m_uNamesSize );
+         memcpy( table.m_namesColumn.data(), puFile + uNamesOffset, header.m_uNamesSize );
+         table.m_namesColumn.m_uSize = (uint16_t)header.m_uNamesSize;
+      }
+
+      // ## data block
+      uint8_t* puData = puFile + header.m_uDataOffset;
+      std::pair<bool, std::string> result_;
+      if( pFileOwner != nullptr )
+      {
+         result_ = table.prepare( puData, header.m_uRowCount, header.m_uReservedRowCount, std::move( pFileOwner ) );
+      }
+      else
+      {
+         table.set_reserved_row_count( header.m_uReservedRowCount );
+         result_ = table.prepare();
+      }
+      if( result_.first == true && ( table.size_row() != header.m_uRowSize || table.size_row_meta() != header.m_uRowMetaSize || table.get_reserved_row_count() != header.m_uReservedRowCount ) )
+      {
+         result_ = { false, "row layout in binary table file do not match table" };
+      }
+      if( result_.first == false ) { table.clear(); return result_; }
+
+      if( table.is_data_external() == false )
+      {
+         memcpy( table.m_puData, puData, header.m_uDataSize );                 // data and meta block is placed after each other
+         table.set_row_count( header.m_uRowCount );
+      }
+
+      // ## values for reference columns, added in same order to keep codes
+      const uint8_t* puReference = puFile + header.m_uReferenceOffset;
+      for( uint64_t u = 0; u < header.m_uReferenceCount; u++ )
+      {
+         binary_reference referenceFile;                                       // reference values are checked before table is cleared
+         memcpy( &referenceFile, puReference, sizeof( binary_reference ) );
+         puReference += sizeof( binary_reference );
+
+         uint64_t uIndex = table.m_references.add( gd::variant_view( referenceFile.m_uType, (void*)puReference, (size_t)referenceFile.m_uLength ) );
+         reference* preference = table.m_references.at( uIndex );
+         preference->set_reference_count( referenceFile.m_iReferenceCount );     // cells using value
+         DEBUG_RELEASE_EXECUTE( preference->clone_d() );
+         puReference += align_s( referenceFile.m_uSize, 8 );
+      }
+
+      return { true, "" };
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Write table to file in binary format
+ * Columns, column names, data block and reference values are written as they are
+ * stored in table. Row based tables write rows with values, columnar tables write
+ * the complete data block. Segmented tables are written as one data block.
+ * @code
+gd::table::write_g( tableResult, "result.gdtable", gd::table::tag_io_binary{} );
+gd::table::dto::table tableLoad;
+auto result_ = gd::table::read_g( tableLoad, "result.gdtable", gd::table::tag_io_binary{}, gd::table::tag_io_mmap{} );
+ * @endcode
+ * @param table table written to file
+ * @param stringFileName name of file to write
+ * @return true if ok, false and error information if failed
+ */
+std::pair<bool, std::string> write_g( const dto::table& table, const std::string_view& stringFileName, tag_io_binary )
+{                                                                                                  assert( table.get_column_count() > 0 );
+   const auto& references_ = table.get_references();
+   const names& namesColumn = table.get_names();
+   const uint64_t uRowCount = table.get_row_count();
+
+   binary_header header;
+   memset( &header, 0, sizeof( binary_header ) );
+   memcpy( header.m_pbszMagic, pbszBinaryMagic_s, sizeof( pbszBinaryMagic_s ) );
+   header.m_uVersion = uBinaryVersion_g;
+   header.m_uByteOrder = uBinaryByteOrder_s;
+   header.m_uFlags = table.get_flags() & ~table_column_buffer::eTableFlagSegmented;// rows are written as one block
+   header.m_uRowSize = table.size_row();
+   header.m_uRowMetaSize = table.size_row_meta();
+   header.m_uColumnCount = table.get_column_count();
+   header.m_uNamesSize = namesColumn.empty() == false ? (uint32_t)namesColumn.size() : 0;
+   header.m_uRowCount = uRowCount;
+   header.m_uReservedRowCount = table.is_columnar() == true ? table.get_reserved_row_count() : uRowCount;// column arrays are placed in block based on reserved rows
+   header.m_uDataOffset = align_s( sizeof( binary_header ) + header.m_uColumnCount * sizeof( binary_column ) + header.m_uNamesSize, 64 );
+   header.m_uDataSize = (uint64_t)( header.m_uRowSize + header.m_uRowMetaSize ) * header.m_uReservedRowCount;
+   header.m_uReferenceOffset = align_s( header.m_uDataOffset + header.m_uDataSize, 8 );
+   header.m_uReferenceCount = references_.size();
+   header.m_uFileSize = header.m_uReferenceOffset;
+   for( std::size_t u = 0; u < references_.size(); u++ ) header.m_uFileSize += sizeof( binary_reference ) + align_s( references_.at( u )->size(), 8 );
+
+   std::ofstream ofstreamFile( std::string( stringFileName ), std::ios::binary | std::ios::trunc );
+   if( ofstreamFile.is_open() == false ) return { false, "FILE OPEN ERROR: " + std::string( stringFileName ) };
+
+   uint64_t uPosition = 0;                                                     // position in file
+   auto write_ = [&ofstreamFile, &uPosition]( const void* p_, uint64_t uSize ) {
+      ofstreamFile.write( (const char*)p_, (std::streamsize)uSize );
+      uPosition += uSize;
+   };
+   auto pad_ = [&write_, &uPosition]( uint64_t uOffset ) {                     // write zeros until offset
+      const char pbZero[64] = {};                                                                  assert( uOffset >= uPosition ); assert( uOffset - uPosition <= sizeof( pbZero ) );
+      write_( pbZero, uOffset - uPosition );
+   };
+
+   write_( &header, sizeof( binary_header ) );
+
+   // ## columns and column names
+   for( const auto& it : table.m_vectorColumn )
+   {
+      binary_column columnFile = { it.state(), it.type(), it.ctype(), it.position(), it.size(), it.primitive_size(), it.name(), it.alias() };
+      write_( &columnFile, sizeof( binary_column ) );
+   }
+   if( header.m_uNamesSize > 0 ) write_( namesColumn.data(), header.m_uNamesSize );
+   pad_( header.m_uDataOffset );
+
+   // ## data block
+   if( table.is_columnar() == true )
+   {
+      write_( table.m_puData, header.m_uDataSize );
+   }
+   else
+   {
+      // rows are written in blocks of rows stored after each other, meta data for rows is written after rows
+      for( uint64_t uRow = 0; uRow < uRowCount; )
+      {
+         uint64_t uBlock = std::min( table.row_get_contiguous( uRow ), uRowCount - uRow );
+         write_( table.row_get( uRow ), uBlock * header.m_uRowSize );
+         uRow += uBlock;
+      }
+      for( uint64_t uRow = 0; uRow < uRowCount && header.m_uRowMetaSize > 0; )
+      {
+         uint64_t uBlock = std::min( table.row_get_contiguous( uRow ), uRowCount - uRow );
+         write_( table.row_get_meta( uRow ), uBlock * header.m_uRowMetaSize );
+         uRow += uBlock;
+      }
+   }
+   pad_( header.m_uReferenceOffset );
+
+   // ## reference values
+   for( std::size_t u = 0; u < references_.size(); u++ )
+   {
+      const reference* preference = references_.at( u );
+      binary_reference referenceFile = { preference->ctype(), preference->length(), preference->size(), preference->reference_count() };
+      write_( &referenceFile, sizeof( binary_reference ) );
+      write_( preference->data(), preference->size() );
+      pad_( align_s( uPosition, 8 ) );
+   }
+                                                                                                   assert( uPosition == header.m_uFileSize );
+   ofstreamFile.close();
+   if( ofstreamFile.fail() == true ) return { false, "FILE WRITE ERROR: " + std::string( stringFileName ) };
+
+   return { true, "" };
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Read table from binary file, values are copied to table
+ * @param table table that gets columns and values from file, table is cleared before read
+ * @param stringFileName name of file to read
+ * @return true if ok, false and error information if failed
+ */
+std::pair<bool, std::string> read_g( dto::table& table, const std::string_view& stringFileName, tag_io_binary )
+{
+   std::ifstream ifstreamFile( std::string( stringFileName ), std::ios::binary | std::ios::ate );
+   if( ifstreamFile.is_open() == false ) return { false, "FILE OPEN ERROR: " + std::string( stringFileName ) };
+
+   uint64_t uFileSize = (uint64_t)ifstreamFile.tellg();
+   std::unique_ptr<uint8_t[]> puFile( new uint8_t[uFileSize] );
+   ifstreamFile.seekg( 0 );
+   ifstreamFile.read( (char*)puFile.get(), (std::streamsize)uFileSize );
+   if( ifstreamFile.fail() == true ) return { false, "FILE READ ERROR: " + std::string( stringFileName ) };
+
+   return read_binary_s( table, puFile.get(), uFileSize, nullptr );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Memory map binary file and use data block in file as table data
+ * File is mapped private (copy on write), values in table can be modified and
+ * modified pages are copied by the operating system, file is never changed.
+ * Mapping is released when table is cleared, destroyed or needs to grow (then
+ * rows are copied to memory owned by table). Reference values are copied to table.
+ * @param table table that gets columns and values from file, table is cleared before read
+ * @param stringFileName name of file to map
+ * @return true if ok, false and error information if failed
+ */
+std::pair<bool, std::string> read_g( dto::table& table, const std::string_view& stringFileName, tag_io_binary, tag_io_mmap )
+{
+   std::string stringFile( stringFileName );
+#if defined(_WIN32)
+   HANDLE hFile = ::CreateFileA( stringFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+   if( hFile == INVALID_HANDLE_VALUE ) return { false, "FILE OPEN ERROR: " + stringFile };
+
+   LARGE_INTEGER largeintegerSize;
+   if( ::GetFileSizeEx( hFile, &largeintegerSize ) == FALSE || largeintegerSize.QuadPart == 0 ) { ::CloseHandle( hFile ); return { false, "FILE SIZE ERROR: " + stringFile }; }
+   uint64_t uFileSize = (uint64_t)largeintegerSize.QuadPart;
+
+   HANDLE hMap = ::CreateFileMappingA( hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+   ::CloseHandle( hFile );
+   if( hMap == nullptr ) return { false, "FILE MAP ERROR: " + stringFile };
+
+   void* pView = ::MapViewOfFile( hMap, FILE_MAP_COPY, 0, 0, 0 );
+   ::CloseHandle( hMap );                                                      // view keeps mapping open
+   if( pView == nullptr ) return { false, "FILE MAP ERROR: " + stringFile };
+
+   std::shared_ptr<void> pMap( pView, []( void* p_ ) { ::UnmapViewOfFile( p_ ); } );
+#else
+   int iFile = ::open( stringFile.c_str(), O_RDONLY );
+   if( iFile < 0 ) return { false, "FILE OPEN ERROR: " + std::string( std::strerror( errno ) ) };
+
+   struct stat statFile;
+   if( ::fstat( iFile, &statFile ) != 0 || statFile.st_size == 0 ) { ::close( iFile ); return { false, "FILE SIZE ERROR: " + stringFile }; }
+   uint64_t uFileSize = (uint64_t)statFile.st_size;
+
+   void* pView = ::mmap( nullptr, uFileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, iFile, 0 );
+   ::close( iFile );                                                           // mapping keeps file open
+   if( pView == MAP_FAILED ) return { false, "FILE MAP ERROR: " + std::string( std::strerror( errno ) ) };
+
+   std::shared_ptr<void> pMap( pView, [uFileSize]( void* p_ ) { ::munmap( p_, uFileSize ); } );
+#endif
+
+   return read_binary_s( table, (uint8_t*)pView, uFileSize, pMap );
+}
+
+
 _GD_TABLE_END
@@ -27,6 +27,7 @@
 #include "gd_table_column-buffer.h"
 #include "gd_table_table.h"
 #include "gd_table_aggregate.h"
+#include "gd_table_view.h"
 
 
 
@@ -71,6 +72,10 @@ struct tag_io_cli {};
 struct tag_io_uri {};
 /// tag dispatcher for sql formatting
 struct tag_io_sql {};
+/// tag dispatcher for binary table format
+struct tag_io_binary {};
+/// tag dispatcher for memory mapped files
+struct tag_io_mmap {};
 
 
 bool format_if( const std::string_view& stringText, std::string& stringNew, tag_io_uri );
@@ -146,7 +151,7 @@ inline std::string to_string( const dto::table& table, tag_io_header, tag_io_jso
 void to_string( const dto::table& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool (const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json, tag_io_name );
 
 inline void to_string(const dto::table& table, uint64_t uBegin, uint64_t uCount, const std::function<bool(const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json, tag_io_name) {
-   return to_string( table, uBegin, uCount, gd::argument::arguments(), format_text_, stringOut, tag_io_header{}, tag_io_json{});
+   return to_string( table, uBegin, uCount, gd::argument::arguments(), format_text_, stringOut, tag_io_json{}, tag_io_name{});
 }
 
 inline void to_string( const dto::table& table, const std::function<bool( const std::string_view&, std::string& stringNew )>& format_text_, std::string& stringOut, tag_io_json, tag_io_name ) {
@@ -173,6 +178,9 @@ inline std::string to_string( const dto::table& table, tag_io_json, tag_io_name
 void to_string( const dto::table& table, std::string& stringOut, tag_io_json, tag_io_column );
 void to_string( const dto::table& table, std::string& stringOut, const std::vector<gd::argument::arguments>& vectorExtra, tag_io_json, tag_io_column );
 
+// ### read json array with objects or arrays into table, columns are added from json if table do not have columns (gd_table_io-json.cpp)
+std::pair<bool, std::string> read_g( dto::table& table, const std::string_view& stringJson, tag_io_json );
+
 
 // ## CLI IO (command line interface) -----------------------------------------
 //    CLI output is to produce good formating for command line interface
@@ -298,6 +306,63 @@ inline std::string to_string( const table& table, tag_io_cli ) {
    return stringResult;
 }
 
+// ## TABLE VIEW IO -----------------------------------------------------------
+
+/** \name table_view
+* Write values in view, same format as for table but only rows and columns in view are written
+*///@{
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool (const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_csv );
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool (const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_csv );
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool (const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json );
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool (const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_header, tag_io_json );
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, const gd::argument::arguments& argumentsOption, const std::function<bool (const std::string_view&, std::string& stringNew)>& format_text_, std::string& stringOut, tag_io_json, tag_io_name );
+void to_string( const table_view& table, const gd::argument::arguments& argumentOption, std::string& stringOut, tag_io_header, tag_io_cli );
+void to_string( const table_view& table, uint64_t uBegin, uint64_t uCount, std::vector<unsigned> vectorWidth, const gd::argument::arguments& argumentOption, std::string& stringOut, tag_io_cli );
+
+inline std::string to_string( const table_view& table, tag_io_csv ) {
+   std::string stringOut;
+   to_string( table, uint64_t(0), table.get_row_count(), {}, nullptr, stringOut, tag_io_csv{});
+   return stringOut;
+}
+
+inline std::string to_string( const table_view& table, tag_io_header, tag_io_csv ) {
+   std::string stringOut;
+   to_string( table, uint64_t(0), table.get_row_count(), {}, nullptr, stringOut, tag_io_header{}, tag_io_csv{});
+   return stringOut;
+}
+
+inline std::string to_string( const table_view& table, tag_io_json ) {
+   std::string stringOut;
+   to_string( table, uint64_t(0), table.get_row_count(), {}, nullptr, stringOut, tag_io_json{});
+   return stringOut;
+}
+
+inline std::string to_string( const table_view& table, tag_io_header, tag_io_json ) {
+   std::string stringOut;
+   to_string( table, uint64_t(0), table.get_row_count(), {}, nullptr, stringOut, tag_io_header{}, tag_io_json{});
+   return stringOut;
+}
+
+inline std::string to_string( const table_view& table, tag_io_json, tag_io_name ) {
+   std::string stringOut;
+   to_string( table, uint64_t(0), table.get_row_count(), {}, nullptr, stringOut, tag_io_json{}, tag_io_name{});
+   return stringOut;
+}
+
+/// convert view to string in grid format formated with proper column withds
+inline std::string to_string( const table_view& table, const gd::argument::arguments& argumentsOption, tag_io_cli ) {
+   std::vector<unsigned> vectorWidth;
+   gd::table::aggregate aggregate_( &table );
+   aggregate_.max( vectorWidth, tag_length{} );
+   aggregate_.fix( vectorWidth, tag_text{} );
+   std::string stringResult;
+   to_string( table, 0, table.get_row_count(), vectorWidth, argumentsOption, stringResult, tag_io_cli{} );
+   return stringResult;
+}
+
+inline std::string to_string( const table_view& table, tag_io_cli ) { return to_string( table, gd::argument::arguments(), tag_io_cli{} ); }
+/// @}
+
 // ## SQL IO ------------------------------------------------------------------
 
 /** \name write_insert_g
@@ -330,6 +395,27 @@ void write_insert_g( const std::string_view& stringTableName, const dto::table&
 /// @}
 
 
+// ## BINARY IO ---------------------------------------------------------------
+
+/** \name binary table file
+* Binary file format for tables, values are stored as they are placed in table memory
+* 
+* File starts with header (magic text and format version), then columns, column names,
+* table data block and last values for reference columns. Data block is aligned to 64
+* bytes in file and can be used as table data without copying when file is memory mapped.
+*///@{
+/// current version for binary table file format
+constexpr uint32_t uBinaryVersion_g = 1;
+
+/// write table to file in binary format
+std::pair<bool, std::string> write_g( const dto::table& table, const std::string_view& stringFileName, tag_io_binary );
+/// read table from binary file, file data is copied to table
+std::pair<bool, std::string> read_g( dto::table& table, const std::string_view& stringFileName, tag_io_binary );
+/// memory map binary file and use data block in file as table data, pages are copied first when values are modified
+std::pair<bool, std::string> read_g( dto::table& table, const std::string_view& stringFileName, tag_io_binary, tag_io_mmap );
+/// @}
+
+
 
 _GD_TABLE_END
 
@@ -0,0 +1,241 @@
+/**
+ * \file gd_table_parallel.h
+ *
+ * \brief Run table operations for row ranges in parallel
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "gd_types.h"
+#include "gd_variant_view.h"
+#include "gd_table.h"
+#include "gd_table_column-buffer.h"
+#include "gd_table_index.h"
+#include "gd_table_aggregate.h"
+#include "gd_parallel.h"
+
+#ifndef _GD_TABLE_BEGIN
+#  define _GD_TABLE_BEGIN namespace gd { namespace table {
+#  define _GD_TABLE_END } }
+#endif
+
+_GD_TABLE_BEGIN
+
+/*-----------------------------------------------------------------------------
+ * Operations in this file split rows into ranges that are run as tasks in
+ * task pool, rows are not copied. Ranges start at rows that are a multiple of
+ * 64 so null bits for columnar tables are never shared between ranges.
+ *
+ * Partial results are merged in range order and ranges only depend on grain,
+ * results are the same for any number of threads.
+ *
+ * Table must not be modified by other threads while operation runs. Operations
+ * that write to table runs in one thread if table has indexes, shares segments
+ * or if column holds reference values.
+ *
+ * @code
+gd::table::parallel_for_rows( table, 0, [&table]( uint64_t uFrom, uint64_t uTo ) {
+   for( uint64_t uRow = uFrom; uRow < uTo; uRow++ ) { ... }
+} );
+auto accumulator_ = gd::table::parallel_aggregate( table, 2 );               // count, sum, min and max for column 2
+ * @endcode
+ *---------------------------------------------------------------------------*/
+
+/// default number of rows in each range
+constexpr uint64_t uParallelGrain_g = 0x4000;
+
+/// grain rounded up to multiple of 64 rows, 0 gives default grain
+inline uint64_t parallel_grain_g( uint64_t uGrain ) noexcept { return uGrain == 0 ? uParallelGrain_g : ( uGrain + 63 ) & ~uint64_t( 63 ); }
+
+/** ---------------------------------------------------------------------------
+ * @brief Call callback for ranges of rows in table, ranges are run in pool
+ * @param pool_ pool that runs ranges
+ * @param table_ table with rows
+ * @param uGrain number of rows in each range, 0 = `uParallelGrain_g`
+ * @param callback_ called with `uFrom` and `uTo` for each range
+*/
+template< typename TABLE, typename FUNCTION >
+void parallel_for_rows( gd::parallel::task_pool& pool_, const TABLE& table_, uint64_t uGrain, FUNCTION&& callback_ )
+{
+   gd::parallel::parallel_for( pool_, 0, table_.get_row_count(), parallel_grain_g( uGrain ), callback_ );
+}
+
+template< typename TABLE, typename FUNCTION >
+void parallel_for_rows( const TABLE& table_, uint64_t uGrain, FUNCTION&& callback_ ) { parallel_for_rows( gd::parallel::task_pool::get_default_s(), table_, uGrain, callback_ ); }
+
+/** ---------------------------------------------------------------------------
+ * @brief Copy values in column into span, read `harvest` in table
+ * @param pool_ pool that runs ranges
+ * @param table_ table values are copied from
+ * @param uColumn column values are copied from
+ * @param uFrom first row
+ * @param spanValue span that gets values, number of values is span size
+ * @param puNull optional bit array that gets one bit for each value, bit is set if value is null
+ * @param uGrain number of rows in each range, 0 = `uParallelGrain_g`
+*/
+template< typename TYPE >
+void parallel_harvest( gd::parallel::task_pool& pool_, const dto::table& table_, unsigned uColumn, uint64_t uFrom, std::span<TYPE> spanValue, uint64_t* puNull = nullptr, uint64_t uGrain = 0 )
+{
+   gd::parallel::parallel_for( pool_, 0, spanValue.size(), parallel_grain_g( uGrain ), [&]( uint64_t uBegin, uint64_t uEnd ) {
+      table_.harvest( uColumn, uFrom + uBegin, spanValue.subspan( uBegin, uEnd - uBegin ), puNull != nullptr ? puNull + ( uBegin >> 6 ) : nullptr );
+   } );
+}
+
+template< typename TYPE >
+void parallel_harvest( const dto::table& table_, unsigned uColumn, uint64_t uFrom, std::span<TYPE> spanValue, uint64_t* puNull = nullptr ) { parallel_harvest( gd::parallel::task_pool::get_default_s(), table_, uColumn, uFrom, spanValue, puNull ); }
+
+/** ---------------------------------------------------------------------------
+ * @brief Fill cells in column with value, read `column_fill` in table
+ * @param pool_ pool that runs ranges
+ * @param table_ table with column to fill
+ * @param uColumn column to fill
+ * @param variantviewValue value set in all cells, type must match column type
+ * @param uGrain number of rows in each range, 0 = `uParallelGrain_g`
+*/
+inline void parallel_column_fill( gd::parallel::task_pool& pool_, dto::table& table_, unsigned uColumn, const gd::variant_view& variantviewValue, uint64_t uGrain = 0 )
+{
+   if( table_.get_row_count() == 0 ) return;
+   if( table_.is_notify() == true || table_.column_get( uColumn ).is_reference() == true ) { table_.column_fill( uColumn, variantviewValue ); return; }// shared state in table is modified
+
+   parallel_for_rows( pool_, table_, uGrain, [&]( uint64_t uFrom, uint64_t uTo ) { table_.column_fill( uColumn, variantviewValue, uFrom, uTo ); } );
+}
+
+inline void parallel_column_fill( dto::table& table_, unsigned uColumn, const gd::variant_view& variantviewValue ) { parallel_column_fill( gd::parallel::task_pool::get_default_s(), table_, uColumn, variantviewValue ); }
+
+/// zone map is updated before ranges are searched, zone maps update themselves when they are read
+inline void parallel_prepare_find_s( const dto::table& table_, unsigned uColumn )
+{
+   if( table_.index_size() == 0 ) return;
+   const index_zone* pzone = table_.index_get_zone( uColumn );
+   if( pzone != nullptr ) pzone->update();
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Find first row with value in column, read `find` in table
+ * Ranges after range where value is found are skipped.
+ * @param pool_ pool that runs ranges
+ * @param table_ table to search
+ * @param uColumn column to search
+ * @param variantviewFind value to find
+ * @param uGrain number of rows in each range, 0 = `uParallelGrain_g`
+ * @return int64_t first row with value or -1 if not found
+*/
+inline int64_t parallel_find( gd::parallel::task_pool& pool_, const dto::table& table_, unsigned uColumn, const gd::variant_view& variantviewFind, uint64_t uGrain = 0 )
+{
+   parallel_prepare_find_s( table_, uColumn );
+   std::atomic<int64_t> iFirst{ INT64_MAX };
+   parallel_for_rows( pool_, table_, uGrain, [&]( uint64_t uFrom, uint64_t uTo ) {
+      if( (int64_t)uFrom > iFirst.load( std::memory_order_relaxed ) ) return; // value is found in earlier range
+      int64_t iRow = table_.find( uColumn, uFrom, uTo - uFrom, variantviewFind );
+      if( iRow == -1 ) return;
+      int64_t iCurrent = iFirst.load( std::memory_order_relaxed );
+      while( iRow < iCurrent && iFirst.compare_exchange_weak( iCurrent, iRow, std::memory_order_relaxed ) == false ) {}
+   } );
+   return iFirst.load() == INT64_MAX ? -1 : iFirst.load();
+}
+
+inline int64_t parallel_find( const dto::table& table_, unsigned uColumn, const gd::variant_view& variantviewFind ) { return parallel_find( gd::parallel::task_pool::get_default_s(), table_, uColumn, variantviewFind ); }
+
+/** ---------------------------------------------------------------------------
+ * @brief Check if any row has value in column, ranges stop when value is found
+ * @param pool_ pool that runs ranges
+ * @param table_ table to search
+ * @param uColumn column to search
+ * @param variantviewFind value to find
+ * @param uGrain number of rows in each range, 0 = `uParallelGrain_g`
+ * @return true if value is found
+*/
+inline bool parallel_find_any( gd::parallel::task_pool& pool_, const dto::table& table_, unsigned uColumn, const gd::variant_view& variantviewFind, uint64_t uGrain = 0 )
+{
+   parallel_prepare_find_s( table_, uColumn );
+   std::atomic<bool> bFound{ false };
+   parallel_for_rows( pool_, table_, uGrain, [&]( uint64_t uFrom, uint64_t uTo ) {
+      if( bFound.load( std::memory_order_relaxed ) == true ) return;
+      if( table_.find( uColumn, uFrom, uTo - uFrom, variantviewFind ) != -1 ) bFound.store( true, std::memory_order_relaxed );
+   } );
+   return bFound.load();
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Find all rows with value in column, rows are returned in table order
+ * @param pool_ pool that runs ranges
+ * @param table_ table to search
+ * @param uColumn column to search
+ * @param variantviewFind value to find
+ * @param uGrain number of rows in each range, 0 = `uParallelGrain_g`
+ * @return std::vector<uint64_t> rows with value
+*/
+inline std::vector<uint64_t> parallel_find_all( gd::parallel::task_pool& pool_, const dto::table& table_, unsigned uColumn, const gd::variant_view& variantviewFind, uint64_t uGrain = 0 )
+{
+   parallel_prepare_find_s( table_, uColumn );
+   uGrain = parallel_grain_g( uGrain );
+   std::vector< std::vector<uint64_t> > vectorPart( ( table_.get_row_count() + uGrain - 1 ) / uGrain );
+   parallel_for_rows( pool_, table_, uGrain, [&]( uint64_t uFrom, uint64_t uTo ) {
+      auto& vectorRow = vectorPart[uFrom / uGrain];
+      for( int64_t iRow = table_.find( uColumn, uFrom, uTo - uFrom, variantviewFind ); iRow != -1; iRow = table_.find( uColumn, (uint64_t)iRow + 1, uTo - (uint64_t)iRow - 1, variantviewFind ) )
+      {
+         vectorRow.push_back( (uint64_t)iRow );
+         if( (uint64_t)iRow + 1 >= uTo ) break;
+      }
+   } );
+
+   std::vector<uint64_t> vectorRow;
+   for( const auto& it : vectorPart ) vectorRow.insert( vectorRow.end(), it.begin(), it.end() );
+   return vectorRow;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Count, sum, min and max for values in column, null values are skipped
+ * Partial results for ranges are merged in range order, min and max is the
+ * first found value if several values are equal.
+ * @code
+auto accumulator_ = gd::table::parallel_aggregate( pool_, table, 2 );
+double dAverage = accumulator_.avg();
+ * @endcode
+ * @param pool_ pool that runs ranges
+ * @param table_ table with values
+ * @param uColumn column with values
+ * @param uGrain number of rows in each range, 0 = `uParallelGrain_g`
+ * @return aggregate<dto::table>::accumulator result with count, integer and decimal sum, min and max
+*/
+inline aggregate<dto::table>::accumulator parallel_aggregate( gd::parallel::task_pool& pool_, const dto::table& table_, unsigned uColumn, uint64_t uGrain = 0 )
+{
+   uGrain = parallel_grain_g( uGrain );
+   aggregate<dto::table> aggregate_( &table_ );
+   std::vector< aggregate<dto::table>::accumulator > vectorPart( ( table_.get_row_count() + uGrain - 1 ) / uGrain );
+   parallel_for_rows( pool_, table_, uGrain, [&]( uint64_t uFrom, uint64_t uTo ) {
+      vectorPart[uFrom / uGrain] = aggregate_.calculate( uColumn, uFrom, uTo - uFrom );
+   } );
+
+   aggregate<dto::table>::accumulator accumulatorResult;
+   for( auto& it : vectorPart ) accumulatorResult.merge( it );
+   return accumulatorResult;
+}
+
+inline aggregate<dto::table>::accumulator parallel_aggregate( const dto::table& table_, unsigned uColumn ) { return parallel_aggregate( gd::parallel::task_pool::get_default_s(), table_, uColumn ); }
+
+/// number of values in column that isn't null
+inline uint64_t parallel_count( const dto::table& table_, unsigned uColumn ) { return parallel_aggregate( table_, uColumn ).m_uCount; }
+/// sum for values in column, integer values are summed as int64 and decimal values as double
+template< typename TYPE >
+TYPE parallel_sum( const dto::table& table_, unsigned uColumn ) { auto accumulator_ = parallel_aggregate( table_, uColumn ); return (TYPE)accumulator_.m_iSum + (TYPE)accumulator_.m_dSum; }
+/// min value in column, null if column only has null values
+inline gd::variant_view parallel_min( const dto::table& table_, unsigned uColumn ) { return parallel_aggregate( table_, uColumn ).m_variantviewMin; }
+/// max value in column, null if column only has null values
+inline gd::variant_view parallel_max( const dto::table& table_, unsigned uColumn ) { return parallel_aggregate( table_, uColumn ).m_variantviewMax; }
+/// average for values in column
+inline double parallel_avg( const dto::table& table_, unsigned uColumn ) { return parallel_aggregate( table_, uColumn ).avg(); }
+
+_GD_TABLE_END
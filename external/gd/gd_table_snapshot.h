@@ -0,0 +1,121 @@
+/**
+ * \file gd_table_snapshot.h
+ *
+ * \brief Publish versions of table to readers in other threads
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "gd_table.h"
+#include "gd_table_column-buffer.h"
+
+#ifndef _GD_TABLE_BEGIN
+#  define _GD_TABLE_BEGIN namespace gd { namespace table {
+#  define _GD_TABLE_END } }
+#endif
+
+_GD_TABLE_BEGIN
+
+/** ===========================================================================
+ * \brief Holds published version of table, readers get immutable version and writer publish new versions
+ *
+ * Readers call `get` and keep returned version as long as they need it, version
+ * is never modified and is released when last reader and snapshot has released it.
+ * Getting version do not copy anything and readers do not wait for writer.
+ *
+ * Writer calls `edit` to get a writable version of current version and then
+ * `publish` to replace current version. Segmented tables share segments between
+ * versions (copy on write), only segments with modified rows are copied. Tables
+ * that isn't segmented are copied in `edit`. Reference values are copied in `edit`.
+ *
+ * Only one writer at a time, versions published by two writers editing the same
+ * version will overwrite each other. Indexes and zone maps update themselves when
+ * they are read so they should not be attached to published versions.
+ *
+ \code
+gd::table::dto::table tableResult( gd::table::dto::table::eTableFlagSegmented, { { "int64", 0, "id" }, { "rstring", 0, "name" } }, gd::table::tag_prepare{} );
+gd::table::table_snapshot snapshot( std::move( tableResult ) );
+
+// ## ui thread
+auto ptable = snapshot.get();                                                 // ptable never changes, render rows
+for( uint64_t uRow = 0; uRow < ptable->get_row_count(); uRow++ ) { ... }
+
+// ## loader thread
+auto ptableEdit = snapshot.edit();                                           // shares segments with current version
+ptableEdit->row_add( { 100, "Stockholm" }, gd::table::tag_convert{} );         // last segment is copied
+snapshot.publish( std::move( ptableEdit ) );
+ \endcode
+ */
+class table_snapshot
+{
+// ## construction -------------------------------------------------------------
+public:
+   table_snapshot(): m_ptable( std::make_shared<const dto::table>() ) {}
+   explicit table_snapshot( dto::table&& table ) { publish( std::move( table ) ); }
+   // copy, snapshot is shared between threads and can't be copied
+   table_snapshot( const table_snapshot& ) = delete;
+   table_snapshot& operator=( const table_snapshot& ) = delete;
+
+   ~table_snapshot() {}
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   /// current version, version is immutable and kept as long as caller holds it
+   std::shared_ptr<const dto::table> get() const noexcept { return m_ptable.load( std::memory_order_acquire ); }
+   /// number of published versions
+   uint64_t get_version() const noexcept { return m_uVersion.load( std::memory_order_acquire ); }
+//@}
+
+/** \name OPERATION
+*///@{
+   /// writable version of current version, segments are shared with current version until they are modified
+   std::shared_ptr<dto::table> edit() const;
+   /// replace current version, readers calling `get` after this get the new version
+   void publish( std::shared_ptr<dto::table>&& ptable );
+   void publish( dto::table&& table ) { publish( std::make_shared<dto::table>( std::move( table ) ) ); }
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   std::atomic< std::shared_ptr<const dto::table> > m_ptable; ///< current version
+   std::atomic<uint64_t> m_uVersion = 0;                       ///< number of published versions
+};
+
+/** ---------------------------------------------------------------------------
+ * @brief Writable version of current version
+ * Rows in segmented tables are not copied, segments are copied when rows in
+ * segment are modified. Do not modify table data through pointers to rows in
+ * returned table without calling `segment_write` for rows first.
+ * @return std::shared_ptr<dto::table> table that can be modified and published
+ */
+inline std::shared_ptr<dto::table> table_snapshot::edit() const
+{
+   auto ptable = get();
+   return std::make_shared<dto::table>( *ptable, tag_copy_on_write{} );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Publish version, table must not be modified after it is published
+ * Segments in segmented tables get shared owners so next version can share them.
+ * @param ptable table published as current version
+ */
+inline void table_snapshot::publish( std::shared_ptr<dto::table>&& ptable )
+{                                                                                                  assert( ptable != nullptr ); assert( ptable->index_size() == 0 );
+   if( ptable->is_segmented() == true && ptable->segment_size() > 0 ) ptable->segment_share();
+   m_ptable.store( std::shared_ptr<const dto::table>( std::move( ptable ) ), std::memory_order_release );
+   m_uVersion.fetch_add( 1, std::memory_order_acq_rel );
+}
+
+_GD_TABLE_END
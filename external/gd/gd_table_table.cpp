@@ -173,9 +173,16 @@ table::table( detail::columns* pcolumns, const table_column_buffer* ptable, uint
 {
    common_construct( pcolumns );
 
-   m_uFlags             = ptable->m_uFlags; 
-   m_uRowSize           = ptable->m_uRowSize;  
-   m_uRowMetaSize       = ptable->m_uRowMetaSize;
+   m_uFlags             = ptable->m_uFlags & ~(table_column_buffer::eTableFlagColumnar|table_column_buffer::eTableFlagSegmented|table_column_buffer::eTableFlagDictionary);// table is always row based in one block
+   if( ( ptable->m_uFlags & table_column_buffer::eTableFlagDictionary ) != 0 )
+   {
+      prepare();                                                               // dictionary codes are 32 bit, reference cells in table are 64 bit so row layout is calculated again
+   }
+   else
+   {
+      m_uRowSize        = ptable->m_uRowSize;  
+      m_uRowMetaSize    = ptable->m_uRowMetaSize;
+   }
 
    if( (uFrom + uCount) >= ptable->get_row_count() )
    {
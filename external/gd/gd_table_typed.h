@@ -0,0 +1,396 @@
+/**
+ * \file gd_table_typed.h
+ *
+ * \brief Typed access to table where column types are known at compile time
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "gd_types.h"
+#include "gd_variant_view.h"
+#include "gd_table.h"
+#include "gd_table_column-buffer.h"
+
+#ifndef _GD_TABLE_BEGIN
+#  define _GD_TABLE_BEGIN namespace gd { namespace table {
+#  define _GD_TABLE_END } }
+#endif
+
+_GD_TABLE_BEGIN
+
+/// column type for reference string column ("rstring"), value is read as `std::string_view`
+struct rstring {};
+/// column type for reference utf8 column ("rutf8"), value is read as `std::string_view`
+struct rutf8 {};
+
+/** ---------------------------------------------------------------------------
+ * @brief Information about column type used in typed table
+ * Primitive types are stored in cell and read with pointer, reference types
+ * store code to value in references.
+ */
+template<typename TYPE>
+struct typed_column_traits
+{                                                                                                  static_assert( std::is_arithmetic_v<TYPE> == true, "only primitive types or reference markers can be used in typed table" );
+   using value_type = TYPE;
+   static constexpr bool is_reference() { return false; }
+   static constexpr unsigned type_number() { return (unsigned)gd::types::type_g<TYPE>( gd::types::tag_ask_compiler{} ) & 0xff; }
+};
+
+template<>
+struct typed_column_traits<rstring>
+{
+   using value_type = std::string_view;
+   static constexpr bool is_reference() { return true; }
+   static constexpr unsigned type_number() { return gd::types::eTypeNumberString; }
+};
+
+template<>
+struct typed_column_traits<rutf8>
+{
+   using value_type = std::string_view;
+   static constexpr bool is_reference() { return true; }
+   static constexpr unsigned type_number() { return gd::types::eTypeNumberUtf8String; }
+};
+
+/** ===========================================================================
+ * \brief Typed facade for table where column types are template arguments
+ *
+ * Columns in table are checked once when typed table is bound to table, after
+ * that values are read and written with column index as template argument.
+ * Column offsets are stored when table is bound so each access is the row
+ * pointer plus offset, no `variant_view` or vectors are created. Row iterator
+ * steps row pointer with row size for rows stored after each other.
+ *
+ * Typed table do not own table and table must live longer than typed table.
+ * Columns can't be added or removed in table while it is bound, adding rows is ok.
+ * Values read from reference columns are views into table references.
+ *
+ * Null flags are not checked when values are read, call `is_null` for columns
+ * that may have null values. Writing a value clears null flag.
+ *
+ \code
+gd::table::dto::table tableCity( 0, { { "int64", 0, "id" }, { "double", 0, "population" }, { "rstring", 0, "name" } }, gd::table::tag_prepare{} );
+gd::table::typed_table<int64_t, double, gd::table::rstring> typedCity;
+auto result_ = typedCity.bind( &tableCity );                                   assert( result_.first == true );
+
+typedCity.row_add( 1, 975000.0, "Stockholm" );
+double dSum = 0.0;
+for( auto it : typedCity ) { dSum += it.get<1>(); }                            // it.get<2>() returns std::string_view
+typedCity.set<1>( 0, 980000.0 );
+ \endcode
+ */
+template<typename... TYPES>
+class typed_table
+{
+public:
+   static constexpr unsigned uColumnCount_s = (unsigned)sizeof...( TYPES );
+   /// column type as template argument, for reference columns this is the marker type
+   template<unsigned INDEX> using column_type = std::tuple_element_t<INDEX, std::tuple<TYPES...>>;
+   /// type for values read from column
+   template<unsigned INDEX> using value_type = typename typed_column_traits<column_type<INDEX>>::value_type;
+   /// type for values in one row
+   using row_value_type = std::tuple<typename typed_column_traits<TYPES>::value_type...>;
+
+   /**
+    * @brief Row in typed table, holds pointer to row data for row based tables
+   */
+   struct row_ref
+   {
+      row_ref(): m_ptyped(nullptr), m_uRow(0), m_puRow(nullptr) {}
+      row_ref( const typed_table* ptyped, uint64_t uRow, const uint8_t* puRow ): m_ptyped(ptyped), m_uRow(uRow), m_puRow(puRow) {}
+
+      uint64_t get_row() const noexcept { return m_uRow; }
+      template<unsigned INDEX>
+      value_type<INDEX> get() const noexcept { return m_ptyped->template read<INDEX>( m_puRow != nullptr ? m_puRow + m_ptyped->m_arrayOffset[INDEX] : m_ptyped->template cell_get<INDEX>( m_uRow ) ); }
+      template<unsigned INDEX>
+      bool is_null() const noexcept { return m_ptyped->template is_null<INDEX>( m_uRow ); }
+      row_value_type get_row_value() const { return m_ptyped->row_get( m_uRow ); }
+
+      const typed_table* m_ptyped;  ///< typed table row belongs to
+      uint64_t m_uRow;              ///< row index
+      const uint8_t* m_puRow;       ///< pointer to row data, null for columnar tables
+   };
+
+   /**
+    * @brief iterator for rows in typed table
+    * Row pointer is moved with row size, when rows aren't stored after each other
+    * (new segment in segmented table) pointer is read from table.
+   */
+   struct const_iterator
+   {
+      const_iterator(): m_uContiguousEnd(0) {}
+      const_iterator( const typed_table* ptyped, uint64_t uRow ): m_row( ptyped, uRow, nullptr ), m_uContiguousEnd(uRow) {}
+
+      row_ref operator*() { update(); return m_row; }
+      bool operator==( const const_iterator& o ) const noexcept { return m_row.m_uRow == o.m_row.m_uRow; }
+      bool operator!=( const const_iterator& o ) const noexcept { return m_row.m_uRow != o.m_row.m_uRow; }
+
+      const_iterator& operator++() noexcept {
+         m_row.m_uRow++;
+         if( m_row.m_puRow != nullptr ) m_row.m_puRow += m_row.m_ptyped->m_ptable->size_row();
+         return *this;
+      }
+      const_iterator operator++(int) noexcept { const_iterator it_ = *this; ++(*this); return it_; }
+
+      /// read row pointer from table if row isn't stored after previous row
+      void update() noexcept {
+         if( m_row.m_ptyped->m_ptable->is_columnar() == true || m_row.m_uRow < m_uContiguousEnd ) return;
+         const auto* ptable = m_row.m_ptyped->m_ptable;
+         m_row.m_puRow = ptable->row_get( m_row.m_uRow );
+         m_uContiguousEnd = m_row.m_uRow + ptable->row_get_contiguous( m_row.m_uRow );
+      }
+
+      row_ref m_row;                ///< current row
+      uint64_t m_uContiguousEnd;    ///< end for rows that can be stepped with row size
+   };
+
+// ## construction -------------------------------------------------------------
+public:
+   typed_table() {}
+   /// bind to table, table columns need to match types
+   explicit typed_table( dto::table* ptable, unsigned uFirstColumn = 0 ) { auto result_ = bind( ptable, uFirstColumn );   assert( result_.first == true ); (void)result_; }
+   // copy
+   typed_table( const typed_table& o ) = default;
+   typed_table& operator=( const typed_table& o ) = default;
+
+   ~typed_table() {}
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   dto::table* get_table() const noexcept { return m_ptable; }
+   uint64_t get_row_count() const noexcept { assert( m_ptable != nullptr ); return m_ptable->get_row_count(); }
+   static constexpr unsigned get_column_count() noexcept { return uColumnCount_s; }
+   /// column index in table for column in typed table
+   unsigned column_get_source( unsigned uColumn ) const noexcept { assert( uColumn < uColumnCount_s ); return m_arrayColumn[uColumn]; }
+   bool is_bound() const noexcept { return m_ptable != nullptr; }
+//@}
+
+/** \name OPERATION
+*///@{
+   std::pair<bool, std::string> bind( dto::table* ptable, unsigned uFirstColumn = 0 );
+
+   /// pointer to cell value
+   template<unsigned INDEX>
+   const uint8_t* cell_get( uint64_t uRow ) const noexcept;
+   template<unsigned INDEX>
+   uint8_t* cell_get( uint64_t uRow ) noexcept { return const_cast<uint8_t*>( std::as_const( *this ).template cell_get<INDEX>( uRow ) ); }
+
+   /// read value in cell, null flag isn't checked
+   template<unsigned INDEX>
+   value_type<INDEX> get( uint64_t uRow ) const noexcept { assert( uRow < m_ptable->get_row_count() ); return read<INDEX>( cell_get<INDEX>( uRow ) ); }
+   /// write value to cell and clear null flag
+   template<unsigned INDEX>
+   void set( uint64_t uRow, const value_type<INDEX>& value_ );
+   template<unsigned INDEX>
+   bool is_null( uint64_t uRow ) const noexcept { static_assert( INDEX < uColumnCount_s ); return m_ptable->is_null() == true && m_ptable->cell_is_null( uRow, m_arrayColumn[INDEX] ) == true; }
+   template<unsigned INDEX>
+   void set_null( uint64_t uRow ) { static_assert( INDEX < uColumnCount_s ); m_ptable->cell_set( uRow, m_arrayColumn[INDEX], gd::variant_view() ); }
+
+   /// read all values in row
+   row_value_type row_get( uint64_t uRow ) const { return row_get( uRow, std::make_integer_sequence<unsigned, uColumnCount_s>{} ); }
+   /// write all values in row
+   void row_set( uint64_t uRow, const typename typed_column_traits<TYPES>::value_type&... values_ ) { row_set( uRow, std::make_integer_sequence<unsigned, uColumnCount_s>{}, values_... ); }
+   /// add row with values, returns index to added row
+   uint64_t row_add( const typename typed_column_traits<TYPES>::value_type&... values_ );
+   /// add rows with values from array, table grows once for all rows. Returns index to first added row
+   uint64_t row_add( std::span<const row_value_type> spanRow );
+
+   /// call callback with value for each row where callback takes `row_ref`
+   template<typename FUNCTION>
+   void for_each( FUNCTION&& callback_ ) const { for( auto it = begin(), itEnd = end(); it != itEnd; ++it ) callback_( *it ); }
+//@}
+
+/** \name ITERATOR
+*///@{
+   const_iterator begin() const noexcept { assert( m_ptable != nullptr ); return const_iterator( this, 0 ); }
+   const_iterator end() const noexcept { assert( m_ptable != nullptr ); return const_iterator( this, m_ptable->get_row_count() ); }
+//@}
+
+   /// read value from cell buffer
+   template<unsigned INDEX>
+   value_type<INDEX> read( const uint8_t* puCell ) const noexcept;
+
+protected:
+   template<unsigned... INDEX>
+   row_value_type row_get( uint64_t uRow, std::integer_sequence<unsigned, INDEX...> ) const { return row_value_type( get<INDEX>( uRow )... ); }
+   template<unsigned... INDEX>
+   void row_set( uint64_t uRow, std::integer_sequence<unsigned, INDEX...>, const typename typed_column_traits<TYPES>::value_type&... values_ ) { ( set<INDEX>( uRow, values_ ), ... ); }
+
+// ## attributes ----------------------------------------------------------------
+public:
+   dto::table* m_ptable = nullptr;                      ///< bound table
+   std::array<unsigned, sizeof...(TYPES)> m_arrayColumn{};///< column index in table for each column
+   std::array<unsigned, sizeof...(TYPES)> m_arrayOffset{};///< column position in row (offset to column array in columnar tables)
+   std::array<unsigned, sizeof...(TYPES)> m_arrayWidth{};///< distance between values in column array for columnar tables
+
+// ## free functions ------------------------------------------------------------
+public:
+   /// check that column in table match column type
+   template<unsigned INDEX>
+   static bool is_match_s( const dto::table* ptable, unsigned uColumn ) noexcept;
+   template<unsigned... INDEX>
+   static int find_mismatch_s( const dto::table* ptable, unsigned uFirstColumn, std::integer_sequence<unsigned, INDEX...> ) noexcept;
+};
+
+/** ---------------------------------------------------------------------------
+ * @brief Bind typed table to table, columns from first column need to match types
+ * @code
+gd::table::typed_table<int64_t, double> typedValue;
+auto result_ = typedValue.bind( &tableValue, 2 );                              // column 2 is int64, column 3 is double
+if( result_.first == false ) { std::cout << result_.second; }
+ * @endcode
+ * @param ptable table to bind, table has to be prepared
+ * @param uFirstColumn column in table that is first column in typed table
+ * @return std::pair<bool, std::string> true if ok, false and error information if columns do not match
+ */
+template<typename... TYPES>
+std::pair<bool, std::string> typed_table<TYPES...>::bind( dto::table* ptable, unsigned uFirstColumn )
+{                                                                                                  assert( ptable != nullptr );
+   m_ptable = nullptr;
+   if( ptable->size_row() == 0 ) return { false, "table is not prepared" };
+   if( ( uFirstColumn + uColumnCount_s ) > ptable->get_column_count() ) return { false, "table has " + std::to_string( ptable->get_column_count() ) + " columns, typed table needs " + std::to_string( uFirstColumn + uColumnCount_s ) };
+
+   int iColumn = find_mismatch_s( ptable, uFirstColumn, std::make_integer_sequence<unsigned, uColumnCount_s>{} );
+   if( iColumn != -1 ) return { false, "column " + std::to_string( iColumn ) + " type do not match, table type is " + std::string( gd::types::type_name_g( ptable->column_get_ctype_number( (unsigned)iColumn ) ) ) };
+
+   for( unsigned u = 0; u < uColumnCount_s; u++ )
+   {
+      unsigned uColumn = uFirstColumn + u;
+      m_arrayColumn[u] = uColumn;
+      m_arrayOffset[u] = ptable->column_get( uColumn ).position();
+      m_arrayWidth[u] = ptable->column_get_width( uColumn );
+   }
+
+   m_ptable = ptable;
+   return { true, "" };
+}
+
+/// pointer to cell value, row tables add column offset to row pointer and columnar tables step in column array
+template<typename... TYPES>
+template<unsigned INDEX>
+const uint8_t* typed_table<TYPES...>::cell_get( uint64_t uRow ) const noexcept {                   assert( m_ptable != nullptr ); assert( uRow < m_ptable->get_reserved_row_count() );
+   if( m_ptable->is_columnar() == true ) return m_ptable->m_puData + (uint64_t)m_arrayOffset[INDEX] * m_ptable->get_reserved_row_count() + uRow * m_arrayWidth[INDEX];
+   return m_ptable->row_get( uRow ) + m_arrayOffset[INDEX];
+}
+
+/// read value from cell, reference columns read value from table references
+template<typename... TYPES>
+template<unsigned INDEX>
+typename typed_table<TYPES...>::template value_type<INDEX> typed_table<TYPES...>::read( const uint8_t* puCell ) const noexcept {
+   using traits_ = typed_column_traits<column_type<INDEX>>;
+   if constexpr( traits_::is_reference() == true )
+   {
+      const reference* preference = m_ptable->get_references().at( m_ptable->cell_get_code( puCell ) );
+      return std::string_view( reinterpret_cast<const char*>( preference->data() ), preference->length() );
+   }
+   else
+   {
+      value_type<INDEX> value_;
+      std::memcpy( &value_, puCell, sizeof( value_ ) );
+      return value_;
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Write value to cell
+ * Primitive values are written directly to cell. Reference values and tables
+ * with indexes or shared segments are updated through `cell_set` in table.
+ * @param uRow row index
+ * @param value_ value to set
+ */
+template<typename... TYPES>
+template<unsigned INDEX>
+void typed_table<TYPES...>::set( uint64_t uRow, const value_type<INDEX>& value_ ) {                assert( m_ptable != nullptr ); assert( uRow < m_ptable->get_row_count() );
+   using traits_ = typed_column_traits<column_type<INDEX>>;
+   if constexpr( traits_::is_reference() == true )
+   {
+      if constexpr( traits_::type_number() == gd::types::eTypeNumberUtf8String ) m_ptable->cell_set( uRow, m_arrayColumn[INDEX], gd::variant_view( gd::variant_type::utf8( value_.data(), value_.length() ) ) );
+      else                                                                        m_ptable->cell_set( uRow, m_arrayColumn[INDEX], gd::variant_view( value_ ) );
+   }
+   else
+   {
+      if( m_ptable->is_notify() == true ) { m_ptable->cell_set( uRow, m_arrayColumn[INDEX], gd::variant_view( value_ ) ); return; }
+      std::memcpy( cell_get<INDEX>( uRow ), &value_, sizeof( value_ ) );
+      if( m_ptable->is_null() == true ) m_ptable->cell_set_not_null( uRow, m_arrayColumn[INDEX] );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add row with values
+ * Columns in table that isn't part of typed table are set to null.
+ * @return uint64_t index to added row
+ */
+template<typename... TYPES>
+uint64_t typed_table<TYPES...>::row_add( const typename typed_column_traits<TYPES>::value_type&... values_ ) { assert( m_ptable != nullptr );
+   if( m_ptable->is_null() == true ) m_ptable->row_add( tag_null{} );
+   else                              m_ptable->row_add();
+   uint64_t uRow = m_ptable->get_row_count() - 1;
+   row_set( uRow, values_... );
+   return uRow;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Add rows with values from array
+ * Table reserves space for all rows before values are written.
+ * @code
+std::vector< std::tuple<int64_t, double, std::string_view> > vectorRow = { { 1, 10.0, "A" }, { 2, 20.0, "B" } };
+typedValue.row_add( vectorRow );
+ * @endcode
+ * @param spanRow values for rows to add
+ * @return uint64_t index to first added row
+ */
+template<typename... TYPES>
+uint64_t typed_table<TYPES...>::row_add( std::span<const row_value_type> spanRow ) {              assert( m_ptable != nullptr );
+   uint64_t uFirstRow = m_ptable->get_row_count();
+   if( spanRow.empty() == true ) return uFirstRow;
+   if( m_ptable->is_null() == true ) m_ptable->row_add( spanRow.size(), tag_null{} );
+   else                              m_ptable->row_add( spanRow.size() );
+
+   uint64_t uRow = uFirstRow;
+   for( const auto& it : spanRow )
+   {
+      std::apply( [this, uRow]( const auto&... values_ ) { row_set( uRow, values_... ); }, it );
+      uRow++;
+   }
+   return uFirstRow;
+}
+
+template<typename... TYPES>
+template<unsigned INDEX>
+bool typed_table<TYPES...>::is_match_s( const dto::table* ptable, unsigned uColumn ) noexcept {
+   using traits_ = typed_column_traits<column_type<INDEX>>;
+   const auto& column_ = ptable->column_get( uColumn );
+   if( column_.is_reference() != traits_::is_reference() ) return false;
+   if( column_.ctype_number() != traits_::type_number() ) return false;
+   if constexpr( traits_::is_reference() == false ) { if( column_.primitive_size() != sizeof( typename traits_::value_type ) ) return false; }
+   return true;
+}
+
+/// index for first column in table that do not match type, -1 if all match
+template<typename... TYPES>
+template<unsigned... INDEX>
+int typed_table<TYPES...>::find_mismatch_s( const dto::table* ptable, unsigned uFirstColumn, std::integer_sequence<unsigned, INDEX...> ) noexcept {
+   int iColumn = -1;
+   ( ( iColumn == -1 && is_match_s<INDEX>( ptable, uFirstColumn + INDEX ) == false ? ( iColumn = (int)( uFirstColumn + INDEX ) ) : 0 ), ... );
+   return iColumn;
+}
+
+_GD_TABLE_END
@@ -0,0 +1,229 @@
+#include <algorithm>
+
+#include "gd_table_view.h"
+
+_GD_TABLE_BEGIN
+
+/// row indexes in table for all rows in view
+std::vector<uint64_t> table_view::get_row( tag_row ) const
+{                                                                                                  assert( m_ptable != nullptr );
+   if( is_row_selection() == true ) return m_vectorRow;
+
+   std::vector<uint64_t> vectorRow( m_ptable->get_row_count() );
+   for( uint64_t uRow = 0; uRow < vectorRow.size(); uRow++ ) vectorRow[uRow] = uRow;
+   return vectorRow;
+}
+
+/// column indexes in table for all columns in view
+std::vector<unsigned> table_view::get_column( tag_column ) const
+{                                                                                                  assert( m_ptable != nullptr );
+   if( is_column_selection() == true ) return m_vectorColumn;
+
+   std::vector<unsigned> vectorColumn( m_ptable->get_column_count() );
+   for( unsigned uColumn = 0; uColumn < vectorColumn.size(); uColumn++ ) vectorColumn[uColumn] = uColumn;
+   return vectorColumn;
+}
+
+/// names for columns in view
+std::vector<std::string_view> table_view::column_get_name() const
+{
+   std::vector<std::string_view> vectorName;
+   vectorName.reserve( get_column_count() );
+   for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ ) vectorName.push_back( column_get_name( uColumn ) );
+   return vectorName;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief find index for column in view
+ * @param stringName column name
+ * @return int index to column in view or -1 if column isn't found in view
+*/
+int table_view::column_find_index( const std::string_view& stringName ) const noexcept
+{                                                                                                  assert( m_ptable != nullptr );
+   int iIndex = m_ptable->column_find_index( stringName );
+   if( iIndex == -1 || is_column_selection() == false ) return iIndex;
+
+   auto it = std::find( m_vectorColumn.begin(), m_vectorColumn.end(), (unsigned)iIndex );
+   if( it == m_vectorColumn.end() ) return -1;
+   return (int)std::distance( m_vectorColumn.begin(), it );
+}
+
+/// column indexes in view for column names
+std::vector<unsigned> table_view::column_get_index( const std::vector<std::string_view>& vectorName ) const noexcept
+{
+   std::vector<unsigned> vectorColumn;
+   for( const auto& it : vectorName ) vectorColumn.push_back( column_get_index( it ) );
+   return vectorColumn;
+}
+
+/// get values for row in view
+void table_view::row_get_variant_view( uint64_t uRow, std::vector<gd::variant_view>& vectorValue ) const
+{
+   uint64_t uRowSource = row_get_source( uRow );
+   if( is_column_selection() == false ) { m_ptable->row_get_variant_view( uRowSource, vectorValue ); return; }
+   m_ptable->row_get_variant_view( uRowSource, m_vectorColumn, vectorValue );
+}
+
+/// get values for row in view as arguments, null values are skipped
+void table_view::row_get_arguments( uint64_t uRow, gd::argument::arguments& argumentsValue ) const
+{
+   uint64_t uRowSource = row_get_source( uRow );
+   for( unsigned uColumn = 0, uMax = get_column_count(); uColumn < uMax; uColumn++ )
+   {
+      unsigned uColumnSource = column_get_source( uColumn );
+      gd::variant_view variantValue = m_ptable->cell_get_variant_view( uRowSource, uColumnSource );
+      if( variantValue.is_null() == false ) { argumentsValue.append_argument( m_ptable->column_get_name( uColumnSource ), variantValue ); }
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief harvest row values in view into vector with arguments
+ * @param uBeginRow start row in view
+ * @param uCount number of rows to harvest values from
+ * @param vectorArguments vector where harvested arguments are inserted to
+*/
+void table_view::harvest( uint64_t uBeginRow, uint64_t uCount, std::vector<gd::argument::arguments>& vectorArguments ) const
+{
+   uint64_t uEndRow = std::min( uBeginRow + uCount, get_row_count() );
+   for( auto uRow = uBeginRow; uRow < uEndRow; uRow++ )
+   {
+      gd::argument::arguments arguments;
+      row_get_arguments( uRow, arguments );
+      vectorArguments.push_back( std::move( arguments ) );
+   }
+}
+
+/// harvest row values in view into vector with vectors for each row
+void table_view::harvest( std::vector< std::vector<gd::variant_view> >& vectorRowValue ) const
+{
+   vectorRowValue.reserve( vectorRowValue.size() + get_row_count() );
+   for( uint64_t uRow = 0, uMax = get_row_count(); uRow < uMax; uRow++ )
+   {
+      std::vector< gd::variant_view > vectorValue;
+      vectorValue.reserve( get_column_count() );
+      row_get_variant_view( uRow, vectorValue );
+      vectorRowValue.emplace_back( std::move( vectorValue ) );
+   }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief create view with rows where value in column matches filter
+ *
+ * Filter is done with `filter` in table that marks matching rows in selection
+ * for all rows in table (zone maps are used if they are added to table).
+ * Rows in view keep their order.
+ * @code
+auto viewActive = view_.filter( "status", eFilterEqual, { 1 } );
+ * @endcode
+ * @param uColumn column index in view
+ * @param eFilter filter operation
+ * @param vectorValue values to compare with
+ * @return table_view view with matching rows
+*/
+table_view table_view::filter( unsigned uColumn, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue ) const
+{                                                                                                  assert( m_ptable != nullptr );
+   selection selectionMatch;
+   m_ptable->filter( column_get_source( uColumn ), eFilter, vectorValue, selectionMatch );
+
+   table_view view_( *this );
+   view_.m_uFlags |= eViewFlagRow;
+   if( is_row_selection() == false ) { view_.m_vectorRow = selectionMatch.to_rows(); return view_; }
+
+   view_.m_vectorRow.clear();
+   for( auto uRow : m_vectorRow ) { if( selectionMatch.is_set( uRow ) == true ) view_.m_vectorRow.push_back( uRow ); }
+   return view_;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief create view with rows where callback returns true
+ * @code
+auto viewShort = view_.filter( []( const auto& view_, uint64_t uRow ) { return view_.cell_get_length( uRow, 1 ) < 10; } );
+ * @endcode
+ * @param callback_ callback that gets view and row index in view
+ * @return table_view view with rows where callback returned true
+*/
+table_view table_view::filter( const std::function<bool( const table_view&, uint64_t )>& callback_ ) const
+{
+   table_view view_( *this );
+   view_.m_uFlags |= eViewFlagRow;
+   view_.m_vectorRow.clear();
+   for( uint64_t uRow = 0, uMax = get_row_count(); uRow < uMax; uRow++ )
+   {
+      if( callback_( *this, uRow ) == true ) view_.m_vectorRow.push_back( row_get_source( uRow ) );
+   }
+   return view_;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief create view with rows sorted, only row indexes are sorted
+ *
+ * Row order is calculated with typed sort in table, read `sort` in table
+ * for more information on how values are compared.
+ * @param vectorKey columns in view to sort on, first key is most significant
+ * @param bStable if true then rows with equal keys keep their order
+ * @return table_view view with sorted rows
+*/
+table_view table_view::sort( const std::vector<sort_key>& vectorKey, bool bStable ) const
+{                                                                                                  assert( m_ptable != nullptr );
+   std::vector<sort_key> vectorKeySource;                                       // keys with column index in table
+   for( const auto& it : vectorKey ) vectorKeySource.emplace_back( column_get_source( it.column() ), it.is_ascending() );
+
+   table_view view_( *this );
+   view_.m_uFlags |= eViewFlagRow;
+   view_.m_vectorRow = get_row( tag_row{} );
+   m_ptable->sort( vectorKeySource, bStable, view_.m_vectorRow, tag_sort_typed{} );
+   return view_;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief create view with selected columns
+ * @param vectorColumn column indexes in view, same column can be selected more than once
+ * @return table_view view with selected columns
+*/
+table_view table_view::select( const std::vector<unsigned>& vectorColumn ) const
+{
+   table_view view_( *this );
+   view_.m_uFlags |= eViewFlagColumn;
+   view_.m_vectorColumn.clear();
+   for( auto uColumn : vectorColumn ) view_.m_vectorColumn.push_back( column_get_source( uColumn ) );
+   return view_;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief create view with rows in range
+ * @param uFrom first row in view
+ * @param uCount max number of rows
+ * @return table_view view with rows in range
+*/
+table_view table_view::range( uint64_t uFrom, uint64_t uCount ) const
+{
+   uint64_t uRowCount = get_row_count();
+   uint64_t uEnd = uFrom < uRowCount ? std::min( uFrom + uCount, uRowCount ) : uFrom;
+
+   table_view view_( *this );
+   view_.m_uFlags |= eViewFlagRow;
+   view_.m_vectorRow.clear();
+   view_.m_vectorRow.reserve( uEnd - uFrom );
+   for( uint64_t uRow = uFrom; uRow < uEnd; uRow++ ) view_.m_vectorRow.push_back( row_get_source( uRow ) );
+   return view_;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief copy values in view to table
+ *
+ * If result table do not have columns then columns are created from columns in
+ * view and null flags are taken from viewed table, otherwise rows are added to
+ * result table.
+ * @param tableResult table that gets values from view
+*/
+void table_view::materialize( dto::table& tableResult ) const
+{                                                                                                  assert( m_ptable != nullptr ); assert( &tableResult != m_ptable );
+   if( tableResult.column_empty() == true && tableResult.get_flags() == 0 )
+   {
+      tableResult.set_flags( m_ptable->get_flags() & ( dto::table::eTableFlagNull32 | dto::table::eTableFlagNull64 ) );
+   }
+
+   m_ptable->harvest( get_column( tag_column{} ), get_row( tag_row{} ), tableResult );
+}
+
+_GD_TABLE_END
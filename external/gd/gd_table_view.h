@@ -0,0 +1,261 @@
+/**
+ * \file gd_table_view.h
+ *
+ * \brief View over rows and columns in table without copying table data
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gd_arguments.h"
+#include "gd_variant_view.h"
+#include "gd_table.h"
+#include "gd_table_column-buffer.h"
+
+#ifndef _GD_TABLE_BEGIN
+#  define _GD_TABLE_BEGIN namespace gd { namespace table {
+#  define _GD_TABLE_END } }
+#endif
+
+_GD_TABLE_BEGIN
+
+/** ===========================================================================
+ * \brief Read only view over table with selected rows and/or selected columns
+ *
+ * View holds pointer to table, a vector with row indexes and a vector with
+ * column indexes. No table data is copied, values are read from table when
+ * they are asked for. If no rows are selected all rows in table are visible
+ * and if no columns are selected all columns are visible.
+ *
+ * Methods that filter, sort or select columns return new views so operations
+ * can be chained without creating tables for each step. Call `materialize` to
+ * get a table with values in view.
+ *
+ * Table must live longer than view and rows in table must not be removed or
+ * moved while view is used.
+ *
+ \code
+gd::table::dto::table tableCity( 0, { { "int64", 0, "id" }, { "rstring", 0, "name" }, { "double", 0, "population" } }, gd::table::tag_prepare{} );
+// ... add rows
+
+gd::table::table_view view_( &tableCity );
+auto viewLarge = view_.filter( 2, gd::table::eFilterGreater, { 1000000.0 } ).sort( { { 2, false } } ).select( { "name", "population" } );
+std::string stringCsv = gd::table::to_string( viewLarge, gd::table::tag_io_header{}, gd::table::tag_io_csv{} );
+
+gd::table::dto::table tableLarge = viewLarge.materialize();   // copy values in view to new table
+ \endcode
+ */
+class table_view
+{
+public:
+   /// flags marking what is selected in view
+   enum enumViewFlag
+   {
+      eViewFlagRow      = 0x0001,   ///< view has selected rows, without flag all rows in table are visible
+      eViewFlagColumn   = 0x0002,   ///< view has selected columns, without flag all columns in table are visible
+   };
+
+   /**
+    * @brief iterator to move trough rows in view
+   */
+   struct const_iterator_row
+   {
+      const_iterator_row(): m_uRow(0), m_ptableview(nullptr) {}
+      const_iterator_row( uint64_t uRow, const table_view* ptableview ): m_uRow(uRow), m_ptableview(ptableview) {}
+
+      auto operator*() const { return gd::table::row<const table_view>( m_ptableview, m_uRow ); }
+      operator uint64_t() const noexcept { return m_uRow; }
+
+      bool operator==( const const_iterator_row& o ) const { assert( o.m_ptableview == m_ptableview ); return o.m_uRow == m_uRow; }
+      bool operator!=( const const_iterator_row& o ) const { assert( o.m_ptableview == m_ptableview ); return o.m_uRow != m_uRow; }
+
+      const_iterator_row& operator++() { m_uRow++; return *this; }
+      const_iterator_row operator++(int) { const_iterator_row it_ = *this; ++(*this); return it_; }
+      const_iterator_row& operator--() { m_uRow--; return *this; }
+      const_iterator_row operator--(int) { const_iterator_row it_ = *this; --(*this); return it_; }
+
+      std::vector< gd::variant_view > get_variant_view() const { return m_ptableview->row_get_variant_view( m_uRow ); }
+      gd::variant_view cell_get_variant_view( unsigned uIndex ) const { return m_ptableview->cell_get_variant_view( m_uRow, uIndex ); }
+      gd::variant_view cell_get_variant_view( const std::string_view& stringName ) const { return m_ptableview->cell_get_variant_view( m_uRow, stringName ); }
+
+      uint64_t m_uRow;                    ///< active row index in view
+      const table_view* m_ptableview;     ///< pointer to view that owns the iterator
+   };
+
+public:
+   using column = dto::table::column;
+   using row_const_iterator = const_iterator_row;
+   using const_iterator = const_iterator_row;
+   using difference_type = std::ptrdiff_t;
+
+// ## construction -------------------------------------------------------------
+public:
+   table_view(): m_uFlags(0), m_ptable(nullptr) {}
+   explicit table_view( const dto::table* ptable ): m_uFlags(0), m_ptable(ptable) { assert( ptable != nullptr ); }
+   table_view( const dto::table* ptable, std::vector<uint64_t> vectorRow ): m_uFlags(eViewFlagRow), m_ptable(ptable), m_vectorRow( std::move( vectorRow ) ) { assert( ptable != nullptr ); }
+   table_view( const dto::table* ptable, std::vector<uint64_t> vectorRow, std::vector<unsigned> vectorColumn ): m_uFlags(eViewFlagRow|eViewFlagColumn), m_ptable(ptable), m_vectorRow( std::move( vectorRow ) ), m_vectorColumn( std::move( vectorColumn ) ) { assert( ptable != nullptr ); }
+   table_view( const dto::table* ptable, const selection& selectionRow ): m_uFlags(eViewFlagRow), m_ptable(ptable), m_vectorRow( selectionRow.to_rows() ) { assert( ptable != nullptr ); assert( selectionRow.size() == ptable->get_row_count() ); }
+   table_view( const dto::table* ptable, std::vector<unsigned> vectorColumn, tag_column ): m_uFlags(eViewFlagColumn), m_ptable(ptable), m_vectorColumn( std::move( vectorColumn ) ) { assert( ptable != nullptr ); }
+   // copy
+   table_view( const table_view& o ) = default;
+   table_view( table_view&& o ) noexcept = default;
+   // assign
+   table_view& operator=( const table_view& o ) = default;
+   table_view& operator=( table_view&& o ) noexcept = default;
+
+   ~table_view() {}
+
+// ## operator -----------------------------------------------------------------
+public:
+   gd::variant_view operator()( uint64_t uRow, unsigned uColumn ) const { return cell_get_variant_view( uRow, uColumn ); }
+   gd::variant_view operator()( uint64_t uRow, const std::string_view& stringName ) const { return cell_get_variant_view( uRow, stringName ); }
+
+// ## methods ------------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   const dto::table* get_table() const noexcept { return m_ptable; }
+   uint64_t get_row_count() const noexcept { assert( m_ptable != nullptr ); return is_row_selection() == true ? (uint64_t)m_vectorRow.size() : m_ptable->get_row_count(); }
+   unsigned get_column_count() const noexcept { assert( m_ptable != nullptr ); return is_column_selection() == true ? (unsigned)m_vectorColumn.size() : m_ptable->get_column_count(); }
+   /// row indexes in table for rows in view, only valid if view has selected rows
+   const std::vector<uint64_t>& get_row() const noexcept { return m_vectorRow; }
+   /// column indexes in table for columns in view, only valid if view has selected columns
+   const std::vector<unsigned>& get_column() const noexcept { return m_vectorColumn; }
+   /// row indexes in table for all rows in view
+   std::vector<uint64_t> get_row( tag_row ) const;
+   /// column indexes in table for all columns in view
+   std::vector<unsigned> get_column( tag_column ) const;
+//@}
+
+/** \name OPERATION
+*///@{
+   bool is_row_selection() const noexcept { return ( m_uFlags & eViewFlagRow ) == eViewFlagRow; }
+   bool is_column_selection() const noexcept { return ( m_uFlags & eViewFlagColumn ) == eViewFlagColumn; }
+   bool empty() const noexcept { return m_ptable == nullptr || get_row_count() == 0; }
+
+   /// row index in table for row in view
+   uint64_t row_get_source( uint64_t uRow ) const noexcept { assert( uRow < get_row_count() ); return is_row_selection() == true ? m_vectorRow[uRow] : uRow; }
+   /// column index in table for column in view
+   unsigned column_get_source( unsigned uColumn ) const noexcept { assert( uColumn < get_column_count() ); return is_column_selection() == true ? m_vectorColumn[uColumn] : uColumn; }
+
+   // ## column information, column index is index in view
+
+   const column& column_get( unsigned uColumn ) const { return m_ptable->column_get( column_get_source( uColumn ) ); }
+   unsigned column_get_type( unsigned uColumn ) const { return m_ptable->column_get_type( column_get_source( uColumn ) ); }
+   unsigned column_get_ctype( unsigned uColumn ) const { return m_ptable->column_get_ctype( column_get_source( uColumn ) ); }
+   std::string_view column_get_name( unsigned uColumn ) const { return m_ptable->column_get_name( column_get_source( uColumn ) ); }
+   std::string_view column_get_name( const column& column_ ) const { return m_ptable->column_get_name( column_ ); }
+   std::vector<std::string_view> column_get_name() const;
+   std::string_view column_get_alias( unsigned uColumn ) const { return m_ptable->column_get_alias( column_get_source( uColumn ) ); }
+   std::string_view column_get_alias( const column& column_ ) const { return m_ptable->column_get_alias( column_ ); }
+   int column_find_index( const std::string_view& stringName ) const noexcept;
+   unsigned column_get_index( const std::string_view& stringName ) const noexcept { int iIndex = column_find_index( stringName ); assert( iIndex != -1 ); return (unsigned)iIndex; }
+   std::vector<unsigned> column_get_index( const std::vector<std::string_view>& vectorName ) const noexcept;
+
+   // ## cell values, row and column index is index in view
+
+   gd::variant_view cell_get_variant_view( uint64_t uRow, unsigned uColumn ) const noexcept { return m_ptable->cell_get_variant_view( row_get_source( uRow ), column_get_source( uColumn ) ); }
+   gd::variant_view cell_get_variant_view( uint64_t uRow, const std::string_view& stringName ) const noexcept { return cell_get_variant_view( uRow, column_get_index( stringName ) ); }
+   bool cell_is_null( uint64_t uRow, unsigned uColumn ) const noexcept { return m_ptable->cell_is_null( row_get_source( uRow ), column_get_source( uColumn ) ); }
+   unsigned cell_get_length( uint64_t uRow, unsigned uColumn ) const noexcept { return m_ptable->cell_get_length( row_get_source( uRow ), column_get_source( uColumn ) ); }
+
+   // ## row values
+
+   std::vector<gd::variant_view> row_get_variant_view( uint64_t uRow ) const { std::vector<gd::variant_view> vectorValue; row_get_variant_view( uRow, vectorValue ); return vectorValue; }
+   void row_get_variant_view( uint64_t uRow, std::vector<gd::variant_view>& vectorValue ) const;
+   void row_get_arguments( uint64_t uRow, gd::argument::arguments& argumentsValue ) const;
+
+   const_iterator_row row_begin() const { return const_iterator_row( (uint64_t)0, this ); }
+   const_iterator_row row_end() const { return const_iterator_row( get_row_count(), this ); }
+   const_iterator_row row_cbegin() const { return const_iterator_row( (uint64_t)0, this ); }
+   const_iterator_row row_cend() const { return const_iterator_row( get_row_count(), this ); }
+   const_iterator begin() const { return row_begin(); }
+   const_iterator end() const { return row_end(); }
+   const_iterator cbegin() const { return row_cbegin(); }
+   const_iterator cend() const { return row_cend(); }
+
+   // ## harvest values from view
+
+   template<typename TYPE>
+   std::vector< TYPE > harvest( unsigned uColumn, uint64_t uFrom, uint64_t uCount ) const;
+   template<typename TYPE>
+   std::vector< TYPE > harvest( unsigned uColumn ) const { return harvest<TYPE>( uColumn, (uint64_t)0, get_row_count() ); }
+   template<typename TYPE>
+   std::vector< TYPE > harvest( const std::string_view& stringColumnName ) const { return harvest<TYPE>( column_get_index( stringColumnName ), (uint64_t)0, get_row_count() ); }
+   void harvest( uint64_t uBeginRow, uint64_t uCount, std::vector<gd::argument::arguments>& vectorArguments ) const;
+   void harvest( std::vector<gd::argument::arguments>& vectorArguments ) const { harvest( 0, get_row_count(), vectorArguments ); }
+   void harvest( std::vector< std::vector<gd::variant_view> >& vectorRowValue ) const;
+
+   // ## create new views from view, table data is not copied
+
+   /// view with rows from view where value in column matches filter
+   table_view filter( unsigned uColumn, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue ) const;
+   table_view filter( const std::string_view& stringName, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue ) const { return filter( column_get_index( stringName ), eFilter, vectorValue ); }
+   /// view with rows from view where callback returns true, callback gets view and row index in view
+   table_view filter( const std::function<bool( const table_view&, uint64_t )>& callback_ ) const;
+   /// view with rows from view sorted on columns in view, rows in table are not moved
+   table_view sort( const std::vector<sort_key>& vectorKey, bool bStable = false ) const;
+   table_view sort( unsigned uColumn, bool bAscending ) const { return sort( std::vector<sort_key>{ sort_key( uColumn, bAscending ) } ); }
+   /// view with selected columns from view
+   table_view select( const std::vector<unsigned>& vectorColumn ) const;
+   table_view select( const std::vector<std::string_view>& vectorName ) const { return select( column_get_index( vectorName ) ); }
+   table_view select( std::initializer_list<std::string_view> listName ) const { return select( std::vector<std::string_view>( listName ) ); }
+   /// view with rows in range from view
+   table_view range( uint64_t uFrom, uint64_t uCount ) const;
+
+   // ## copy values in view to table
+
+   void materialize( dto::table& tableResult ) const;
+   dto::table materialize() const { dto::table tableResult; materialize( tableResult ); return tableResult; }
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   unsigned m_uFlags;                     ///< flags for what is selected in view, @see enumViewFlag
+   const dto::table* m_ptable;            ///< table view reads values from
+   std::vector<uint64_t> m_vectorRow;     ///< row indexes in table for rows in view
+   std::vector<unsigned> m_vectorColumn;  ///< column indexes in table for columns in view
+};
+
+/** ---------------------------------------------------------------------------
+ * @brief get vector with values from column in view
+ * @param uColumn column index in view values are taken from
+ * @param uFrom start row in view where harvesting starts
+ * @param uCount number of values (rows) to harvest
+ * @return vector std::vector< TYPE > vector with harvested values
+*/
+template<typename TYPE>
+inline std::vector< TYPE > table_view::harvest( unsigned uColumn, uint64_t uFrom, uint64_t uCount ) const { assert( (uFrom + uCount) <= get_row_count() );
+   std::vector< TYPE > vector_;
+   vector_.reserve( uCount );
+   auto uEndRow = uFrom + uCount;
+   auto eType = gd::types::type_g<TYPE>( gd::types::tag_ask_compiler{});
+   unsigned uColumnSource = column_get_source( uColumn );
+   if( (( unsigned )eType & 0xff) == (m_ptable->column_get_ctype( uColumnSource ) & 0xff) ) // same type, no conversion is needed
+   {
+      for( auto uRow = uFrom; uRow < uEndRow; uRow++ ) vector_.push_back( (TYPE)m_ptable->cell_get_variant_view( row_get_source( uRow ), uColumnSource ) );
+   }
+   else
+   {                                                                           // return type do not match column type, convert value to requested type
+      gd::variant variantConverted;
+      for( auto uRow = uFrom; uRow < uEndRow; uRow++ )
+      {
+         m_ptable->cell_get_variant_view( row_get_source( uRow ), uColumnSource ).convert_to( eType, variantConverted );
+         vector_.push_back( (TYPE)variantConverted );
+      }
+   }
+
+   return vector_;
+}
+
+_GD_TABLE_END
@@ -0,0 +1,298 @@
+#include <cmath>
+#include <cstring>
+
+#include "gd_table_writer.h"
+
+#if defined( __clang__ )
+   #pragma GCC diagnostic push
+   #pragma clang diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#elif defined( __GNUC__ )
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#elif defined( _MSC_VER )
+   #pragma warning(push)
+   #pragma warning( disable : 4996 )
+#endif
+
+_GD_TABLE_BEGIN
+
+std::pair<bool, std::string> sink_file::open( const std::string_view& stringFileName )
+{
+   close();
+   m_pfile = std::fopen( std::string( stringFileName ).c_str(), "wb" );
+   if( m_pfile == nullptr ) return { false, "Failed to create file: " + std::string( stringFileName ) };
+   m_bOwner = true;
+   return { true, "" };
+}
+
+void sink_file::close()
+{
+   if( m_pfile != nullptr && m_bOwner == true ) std::fclose( m_pfile );
+   m_pfile = nullptr;
+   m_bOwner = false;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Write buffer to sink
+ * If sink fails writer stops writing, check with `is_ok`.
+ * @return true if buffer was written
+*/
+bool writer::flush()
+{
+   if( m_uSize > 0 )
+   {
+      if( m_bOk == true ) m_bOk = m_psink->write( m_vectorBuffer.data(), m_uSize );
+      if( m_bOk == true ) m_uWritten += m_uSize;
+      m_uSize = 0;
+   }
+   return m_bOk;
+}
+
+/// append text, text larger than buffer is written directly to sink
+void writer::append( const std::string_view& stringText )
+{
+   if( m_vectorBuffer.size() - m_uSize < stringText.length() )
+   {
+      flush();
+      if( stringText.length() > m_vectorBuffer.size() )
+      {
+         if( m_bOk == true ) m_bOk = m_psink->write( stringText.data(), stringText.length() );
+         if( m_bOk == true ) m_uWritten += stringText.length();
+         return;
+      }
+   }
+   memcpy( m_vectorBuffer.data() + m_uSize, stringText.data(), stringText.length() );
+   m_uSize += stringText.length();
+}
+
+void writer::compile_s( const dto::table& table, std::vector<enumFormat>& vectorFormat )
+{
+   vectorFormat.clear();
+   for( unsigned uColumn = 0, uMax = table.get_column_count(); uColumn < uMax; uColumn++ )
+   {
+      enumFormat eFormat = eFormatOther;
+      switch( table.column_get_ctype_number( uColumn ) )
+      {
+      case gd::types::eTypeNumberInt8:       eFormat = eFormatInt8; break;
+      case gd::types::eTypeNumberUInt8:      eFormat = eFormatUInt8; break;
+      case gd::types::eTypeNumberInt16:      eFormat = eFormatInt16; break;
+      case gd::types::eTypeNumberUInt16:     eFormat = eFormatUInt16; break;
+      case gd::types::eTypeNumberInt32:      eFormat = eFormatInt32; break;
+      case gd::types::eTypeNumberUInt32:     eFormat = eFormatUInt32; break;
+      case gd::types::eTypeNumberInt64:      eFormat = eFormatInt64; break;
+      case gd::types::eTypeNumberUInt64:     eFormat = eFormatUInt64; break;
+      case gd::types::eTypeNumberFloat:      eFormat = eFormatFloat; break;
+      case gd::types::eTypeNumberDouble:     eFormat = eFormatDouble; break;
+      case gd::types::eTypeNumberBool:       eFormat = eFormatBool; break;
+      case gd::types::eTypeNumberString:
+      case gd::types::eTypeNumberUtf8String: eFormat = eFormatText; break;
+      }
+      vectorFormat.push_back( eFormat );
+   }
+}
+
+namespace {
+   template<typename TYPE>
+   inline TYPE read_s( const uint8_t* puValue ) { TYPE value_; memcpy( &value_, puValue, sizeof( TYPE ) ); return value_; }
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Append value from cell that is a number or bool
+ * Decimal values that are not finite are written as `null` in json. Text and
+ * other types (date, uuid, binary, ...) are not appended, writers quote and
+ * escape them as text.
+ * @param eFormat format for column
+ * @param value_ raw value from `cell_get( uRow, uColumn, tag_raw{} )`, not null
+ * @param bJson true if value is written as json
+ * @return true if value was appended, false for values that are written as text
+*/
+bool writer::append_value( enumFormat eFormat, const std::pair<const uint8_t*, unsigned>& value_, bool bJson )
+{                                                                                                  assert( value_.first != nullptr );
+   const uint8_t* puValue = value_.first;
+   switch( eFormat )
+   {
+   case eFormatInt8:    append_number( read_s<int8_t>( puValue ) ); break;
+   case eFormatUInt8:   append_number( read_s<uint8_t>( puValue ) ); break;
+   case eFormatInt16:   append_number( read_s<int16_t>( puValue ) ); break;
+   case eFormatUInt16:  append_number( read_s<uint16_t>( puValue ) ); break;
+   case eFormatInt32:   append_number( read_s<int32_t>( puValue ) ); break;
+   case eFormatUInt32:  append_number( read_s<uint32_t>( puValue ) ); break;
+   case eFormatInt64:   append_number( read_s<int64_t>( puValue ) ); break;
+   case eFormatUInt64:  append_number( read_s<uint64_t>( puValue ) ); break;
+   case eFormatFloat:
+   case eFormatDouble:
+   {
+      double dValue = eFormat == eFormatFloat ? (double)read_s<float>( puValue ) : read_s<double>( puValue );
+      if( bJson == true && std::isfinite( dValue ) == false ) append( std::string_view( "null" ) );
+      else if( eFormat == eFormatFloat ) append_number( read_s<float>( puValue ) );
+      else                               append_number( dValue );
+   }
+   break;
+   case eFormatBool:    append( *puValue != 0 ? std::string_view( "true" ) : std::string_view( "false" ) ); break;
+   default:             return false;                                          // text and other types
+   }
+   return true;
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Append quoted csv text, quotes in text are doubled
+*/
+void writer_csv::append_text( const std::string_view& stringText )
+{
+   append( '\"' );
+   const char* pbszPosition = stringText.data();
+   const char* pbszEnd = pbszPosition + stringText.length();
+   while( pbszPosition < pbszEnd )
+   {
+      const char* pbszQuote = (const char*)memchr( pbszPosition, '\"', pbszEnd - pbszPosition );
+      if( pbszQuote == nullptr ) { append( std::string_view( pbszPosition, pbszEnd - pbszPosition ) ); break; }
+      append( std::string_view( pbszPosition, pbszQuote + 1 - pbszPosition ) );
+      append( '\"' );
+      pbszPosition = pbszQuote + 1;
+   }
+   append( '\"' );
+}
+
+bool writer_csv::write_header( const dto::table& table )
+{
+   for( unsigned uColumn = 0, uMax = table.get_column_count(); uColumn < uMax; uColumn++ )
+   {
+      if( uColumn > 0 ) append( m_chDelimiter );
+      const auto& column_ = table.column_get( uColumn );
+      append_text( column_.alias() != 0 ? table.column_get_alias( column_ ) : table.column_get_name( column_ ) );
+   }
+   append( '\n' );
+   return is_ok();
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Write rows as csv, each row ends with new line
+ * @param table table with rows
+ * @param uBegin first row
+ * @param uCount number of rows
+ * @return true if ok, false if sink failed
+*/
+bool writer_csv::write( const dto::table& table, uint64_t uBegin, uint64_t uCount )
+{                                                                                                  assert( uBegin + uCount <= table.get_row_count() );
+   compile_s( table, m_vectorFormat );
+   const unsigned uColumnCount = table.get_column_count();
+   for( uint64_t uRow = uBegin, uEnd = uBegin + uCount; uRow < uEnd && is_ok() == true; uRow++ )
+   {
+      for( unsigned uColumn = 0; uColumn < uColumnCount; uColumn++ )
+      {
+         if( uColumn > 0 ) append( m_chDelimiter );
+         auto value_ = table.cell_get( uRow, uColumn, tag_raw{} );
+         if( value_.first == nullptr ) continue;                               // null is empty value
+
+         if( append_value( m_vectorFormat[uColumn], value_, false ) == false )
+         {
+            if( m_vectorFormat[uColumn] == eFormatText )
+            {
+               unsigned uLength = value_.second > 0 && value_.first[value_.second - 1] == 0 ? value_.second - 1 : value_.second;// remove zero termination
+               append_text( std::string_view( (const char*)value_.first, uLength ) );
+            }
+            else append_text( table.cell_get_variant_view( uRow, uColumn ).as_string() );
+         }
+      }
+      append( '\n' );
+   }
+   return is_ok();
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Append quoted json text, quote, backslash and control characters are escaped
+*/
+void writer_json::append_text( const std::string_view& stringText )
+{
+   static const char pbszHex_s[] = "0123456789abcdef";
+   append( '\"' );
+   const char* pbszPosition = stringText.data();
+   const char* pbszEnd = pbszPosition + stringText.length();
+   const char* pbszCopy = pbszPosition;                                        // start of characters that do not need escape
+   for( ; pbszPosition < pbszEnd; pbszPosition++ )
+   {
+      uint8_t uCharacter = (uint8_t)*pbszPosition;
+      if( uCharacter >= 0x20 && uCharacter != '\"' && uCharacter != '\\' ) continue;
+
+      if( pbszCopy < pbszPosition ) append( std::string_view( pbszCopy, pbszPosition - pbszCopy ) );
+      pbszCopy = pbszPosition + 1;
+      append( '\\' );
+      switch( uCharacter )
+      {
+      case '\"': append( '\"' ); break;
+      case '\\': append( '\\' ); break;
+      case '\n': append( 'n' ); break;
+      case '\r': append( 'r' ); break;
+      case '\t': append( 't' ); break;
+      case '\b': append( 'b' ); break;
+      case '\f': append( 'f' ); break;
+      default:
+         append( std::string_view( "u00" ) );
+         append( pbszHex_s[uCharacter >> 4] );
+         append( pbszHex_s[uCharacter & 0x0f] );
+      }
+   }
+   if( pbszCopy < pbszEnd ) append( std::string_view( pbszCopy, pbszEnd - pbszCopy ) );
+   append( '\"' );
+}
+
+/** ---------------------------------------------------------------------------
+ * @brief Write rows as json, `[` is written before first row and rows are separated with `,`
+ * @param table table with rows
+ * @param uBegin first row
+ * @param uCount number of rows
+ * @return true if ok, false if sink failed
+*/
+bool writer_json::write( const dto::table& table, uint64_t uBegin, uint64_t uCount )
+{                                                                                                  assert( uBegin + uCount <= table.get_row_count() );
+   compile_s( table, m_vectorFormat );
+   const unsigned uColumnCount = table.get_column_count();
+   for( uint64_t uRow = uBegin, uEnd = uBegin + uCount; uRow < uEnd && is_ok() == true; uRow++ )
+   {
+      append( m_uRowCount == 0 ? std::string_view( "[\n" ) : std::string_view( ",\n" ) );
+      m_uRowCount++;
+
+      append( m_bObject == true ? '{' : '[' );
+      for( unsigned uColumn = 0; uColumn < uColumnCount; uColumn++ )
+      {
+         if( uColumn > 0 ) append( ',' );
+         if( m_bObject == true )
+         {
+            append_text( table.column_get_name( uColumn ) );
+            append( ':' );
+         }
+
+         auto value_ = table.cell_get( uRow, uColumn, tag_raw{} );
+         if( value_.first == nullptr ) { append( std::string_view( "null" ) ); continue; }
+
+         if( append_value( m_vectorFormat[uColumn], value_, true ) == false )
+         {
+            if( m_vectorFormat[uColumn] == eFormatText )
+            {
+               unsigned uLength = value_.second > 0 && value_.first[value_.second - 1] == 0 ? value_.second - 1 : value_.second;// remove zero termination
+               append_text( std::string_view( (const char*)value_.first, uLength ) );
+            }
+            else append_text( table.cell_get_variant_view( uRow, uColumn ).as_string() );
+         }
+      }
+      append( m_bObject == true ? '}' : ']' );
+   }
+   return is_ok();
+}
+
+bool writer_json::close()
+{
+   append( m_uRowCount == 0 ? std::string_view( "[]\n" ) : std::string_view( "\n]\n" ) );
+   if( flush() == false ) return false;
+   return m_psink->flush();
+}
+
+_GD_TABLE_END
+
+#if defined(__clang__)
+   #pragma clang diagnostic pop
+#elif defined(__GNUC__)
+   #pragma GCC diagnostic pop
+#elif defined(_MSC_VER)
+   #pragma warning(pop)
+#endif
@@ -0,0 +1,267 @@
+/**
+ * \file gd_table_writer.h
+ *
+ * \brief Write table as csv or json to sink, output is formated in buffer and flushed in blocks
+ *
+ *
+ *
+ *
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gd_types.h"
+#include "gd_variant.h"
+#include "gd_variant_view.h"
+#include "gd_table.h"
+#include "gd_table_column-buffer.h"
+
+#if defined( __clang__ )
+   #pragma GCC diagnostic push
+   #pragma clang diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#elif defined( __GNUC__ )
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#elif defined( _MSC_VER )
+   #pragma warning(push)
+   #pragma warning( disable : 4996 )
+#endif
+
+_GD_TABLE_BEGIN
+
+/** ===========================================================================
+ * \brief Destination for text written by writers
+ */
+class sink
+{
+public:
+   virtual ~sink() {}
+   /// write bytes, return false if bytes could not be written
+   virtual bool write( const char* pbszData, std::size_t uSize ) = 0;
+   /// flush data written to sink
+   virtual bool flush() { return true; }
+};
+
+/** ===========================================================================
+ * \brief Sink that writes to file, file is opened by sink or passed as file handle
+ */
+class sink_file : public sink
+{
+public:
+   sink_file() {}
+   /// write to file handle, handle is not closed by sink
+   explicit sink_file( std::FILE* pfile ): m_pfile( pfile ) {}
+   sink_file( const sink_file& ) = delete;
+   sink_file& operator=( const sink_file& ) = delete;
+   ~sink_file() override { close(); }
+
+   /// create file, existing file is replaced
+   std::pair<bool, std::string> open( const std::string_view& stringFileName );
+   void close();
+
+   bool write( const char* pbszData, std::size_t uSize ) override { assert( m_pfile != nullptr ); return std::fwrite( pbszData, 1, uSize, m_pfile ) == uSize; }
+   bool flush() override { return m_pfile != nullptr && std::fflush( m_pfile ) == 0; }
+
+   std::FILE* m_pfile = nullptr;    ///< file written to
+   bool m_bOwner = false;           ///< true if file was opened by sink and is closed by sink
+};
+
+/** ===========================================================================
+ * \brief Sink that calls callback with each block, callback can pass block to socket, ring buffer or compression
+ */
+class sink_callback : public sink
+{
+public:
+   explicit sink_callback( std::function<bool( std::string_view )> callback_ ): m_callback( std::move( callback_ ) ) {}
+
+   bool write( const char* pbszData, std::size_t uSize ) override { return m_callback( std::string_view( pbszData, uSize ) ); }
+
+   std::function<bool( std::string_view )> m_callback;   ///< called with each block
+};
+
+/** ===========================================================================
+ * \brief Sink that appends to string
+ */
+class sink_string : public sink
+{
+public:
+   explicit sink_string( std::string& stringOut ): m_pstringOut( &stringOut ) {}
+
+   bool write( const char* pbszData, std::size_t uSize ) override { m_pstringOut->append( pbszData, uSize ); return true; }
+
+   std::string* m_pstringOut;       ///< string text is appended to
+};
+
+/** ===========================================================================
+ * \brief Base for writers, text is formated in buffer and buffer is written to sink when it is full
+ *
+ * Numbers are formated with `std::to_chars` directly in buffer and cell values
+ * are read as raw values, no temporary strings are created for values with
+ * primitive types or text. Memory used do not depend on number of rows written.
+ */
+class writer
+{
+public:
+   enum { eSpaceBuffer = 0x10'0000 };                                         // 1 MB
+
+   /// how value in column is formated
+   enum enumFormat : uint8_t
+   {
+      eFormatInt8,
+      eFormatUInt8,
+      eFormatInt16,
+      eFormatUInt16,
+      eFormatInt32,
+      eFormatUInt32,
+      eFormatInt64,
+      eFormatUInt64,
+      eFormatFloat,
+      eFormatDouble,
+      eFormatBool,
+      eFormatText,         ///< utf8 or ascii text
+      eFormatOther,        ///< other types are formated with `variant_view::as_string` and written as text
+   };
+
+// ## construction ------------------------------------------------------------
+public:
+   writer( sink* psink, std::size_t uBufferSize = eSpaceBuffer ): m_psink( psink ), m_vectorBuffer( uBufferSize > 64 ? uBufferSize : 64 ) { assert( psink != nullptr ); }
+   writer( const writer& ) = delete;
+   writer& operator=( const writer& ) = delete;
+   ~writer() { flush(); }
+
+// ## methods -----------------------------------------------------------------
+public:
+/** \name GET/SET
+*///@{
+   /// false if sink failed to write, nothing more is written after failure
+   bool is_ok() const noexcept { return m_bOk; }
+   /// number of bytes written to sink
+   uint64_t get_written() const noexcept { return m_uWritten; }
+//@}
+
+/** \name OPERATION
+*///@{
+   /// write buffer to sink
+   bool flush();
+   void append( char chCharacter ) { if( m_uSize == m_vectorBuffer.size() ) flush(); m_vectorBuffer[m_uSize++] = chCharacter; }
+   void append( const std::string_view& stringText );
+   template<typename TYPE>
+   void append_number( TYPE value_ ) {
+      reserve( 32 );
+      auto result_ = std::to_chars( m_vectorBuffer.data() + m_uSize, m_vectorBuffer.data() + m_vectorBuffer.size(), value_ ); assert( result_.ec == std::errc() );
+      m_uSize = result_.ptr - m_vectorBuffer.data();
+   }
+//@}
+
+protected:
+/** \name INTERNAL
+*///@{
+   /// make room for bytes in buffer, buffer is flushed if needed
+   void reserve( std::size_t uSize ) { if( m_vectorBuffer.size() - m_uSize < uSize ) flush(); }
+   /// format for each column in table
+   static void compile_s( const dto::table& table, std::vector<enumFormat>& vectorFormat );
+   /// append number or bool value, returns false if value is written as text
+   bool append_value( enumFormat eFormat, const std::pair<const uint8_t*, unsigned>& value_, bool bJson );
+//@}
+
+// ## attributes ----------------------------------------------------------------
+public:
+   sink* m_psink;                      ///< destination for text
+   std::vector<char> m_vectorBuffer;   ///< buffer where text is formated
+   std::size_t m_uSize = 0;            ///< number of bytes in buffer
+   uint64_t m_uWritten = 0;            ///< bytes written to sink
+   bool m_bOk = true;                  ///< false if sink failed
+};
+
+/** ===========================================================================
+ * \brief Write table rows as csv
+ *
+ * Text values are quoted and quotes in text are doubled, null values are empty.
+ * Rows can be written in parts with `write` and output is the same as writing
+ * all rows in one call.
+ *
+ \code
+gd::table::sink_file sinkFile;
+if( sinkFile.open( "orders.csv" ).first == false ) return;
+gd::table::writer_csv writerCsv( &sinkFile );
+writerCsv.write_header( tableOrder );
+writerCsv.write( tableOrder );
+writerCsv.flush();
+ \endcode
+ */
+class writer_csv : public writer
+{
+public:
+   writer_csv( sink* psink, char chDelimiter = ',', std::size_t uBufferSize = eSpaceBuffer ): writer( psink, uBufferSize ), m_chDelimiter( chDelimiter ) {}
+
+   /// write line with column names (alias if column has alias)
+   bool write_header( const dto::table& table );
+   /// write rows
+   bool write( const dto::table& table, uint64_t uBegin, uint64_t uCount );
+   bool write( const dto::table& table ) { return write( table, 0, table.get_row_count() ); }
+
+protected:
+   void append_text( const std::string_view& stringText );
+
+public:
+   char m_chDelimiter;                    ///< character between values
+   std::vector<enumFormat> m_vectorFormat;///< format for each column in last written table
+};
+
+/** ===========================================================================
+ * \brief Write table rows as json array
+ *
+ * Rows are written as arrays (`[1,"a"]`) or as objects with column names as keys
+ * (`{"id":1,"name":"a"}`). Array start is written with first row and array end
+ * is written by `close`, rows can be written in parts between.
+ *
+ \code
+std::string stringJson;
+gd::table::sink_string sinkString( stringJson );
+gd::table::writer_json writerJson( &sinkString, gd::table::tag_name{} );
+writerJson.write( tableOrder );
+writerJson.close();                                                           // writes `]` and flushes
+ \endcode
+ */
+class writer_json : public writer
+{
+public:
+   writer_json( sink* psink, std::size_t uBufferSize = eSpaceBuffer ): writer( psink, uBufferSize ) {}
+   /// write rows as objects with column names
+   writer_json( sink* psink, tag_name, std::size_t uBufferSize = eSpaceBuffer ): writer( psink, uBufferSize ), m_bObject( true ) {}
+
+   /// write rows
+   bool write( const dto::table& table, uint64_t uBegin, uint64_t uCount );
+   bool write( const dto::table& table ) { return write( table, 0, table.get_row_count() ); }
+   /// end array and flush, empty array is written if no rows are written
+   bool close();
+
+protected:
+   void append_text( const std::string_view& stringText );
+
+public:
+   bool m_bObject = false;                ///< rows are written as objects
+   uint64_t m_uRowCount = 0;              ///< number of rows written
+   std::vector<enumFormat> m_vectorFormat;///< format for each column in last written table
+};
+
+_GD_TABLE_END
+
+#if defined(__clang__)
+   #pragma clang diagnostic pop
+#elif defined(__GNUC__)
+   #pragma GCC diagnostic pop
+#elif defined(_MSC_VER)
+   #pragma warning(pop)
+#endif
@@ -0,0 +1,136 @@
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_index.h"
+#include "gd/gd_csv.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with one column for each type decoder converts
+   dto::table make_decoder_table_s( unsigned uFlags )
+   {
+      dto::table table_( 64u, dto::table::eTableFlagNull32 | uFlags );
+      for( auto stringType : { "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64", "uint64", "float", "double", "bool" } ) table_.column_add( stringType, 0, stringType );
+      table_.column_add( "rstring", 0, "rstring" );
+      table_.column_add( "string", 16, "string" );
+      table_.prepare();
+      return table_;
+   }
+
+   /// record text for row, every 9th row has only empty values and every 4th row has spaces around numbers
+   std::string make_record_s( int iRow )
+   {
+      if( iRow % 9 == 0 ) return ",,,,,,,,,,,,";
+      std::string stringSpace = iRow % 4 == 0 ? " " : "";
+      int iValue = ( iRow % 200 ) - 100;
+      std::string stringRecord;
+      for( int i = 0; i < 8; i++ )
+      {
+         bool bUnsigned = i % 2 == 1;
+         stringRecord += stringSpace + std::to_string( bUnsigned == true ? iValue + 100 : iValue ) + stringSpace + ",";
+      }
+      stringRecord += stringSpace + std::to_string( iValue ) + ".25" + stringSpace + ",";
+      stringRecord += ( iRow % 3 == 0 && iValue >= 0 ? "+" : "" ) + std::to_string( iValue ) + ".5e1,";
+      stringRecord += std::string( iRow % 2 == 0 ? "true" : "0" ) + ",";
+      stringRecord += "\"r, " + std::to_string( iRow % 17 ) + "\",";
+      stringRecord += "s" + std::to_string( iRow % 5 );
+      return stringRecord;
+   }
+
+   /// compare decoded row with values set with tag_convert, returns description for first difference
+   std::string compare_row_s( const dto::table& table_, uint64_t uRow, int iRow )
+   {
+      dto::table tableExpect = make_decoder_table_s( 0 );
+      tableExpect.row_add( tag_null{} );
+      {
+         std::string stringRecord = make_record_s( iRow );
+         std::vector<std::string_view> vectorValue;
+         gd::csv::split_record_g( stringRecord.data(), stringRecord.data() + stringRecord.length(), gd::csv::options(), vectorValue );
+         for( unsigned uColumn = 0; uColumn < vectorValue.size(); uColumn++ )
+         {
+            std::string stringValue( vectorValue[uColumn] );
+            if( stringValue.empty() == true && uColumn < 11 ) continue;        // empty value is null in number columns and empty text in text columns
+            if( uColumn < 11 ) { stringValue.erase( 0, stringValue.find_first_not_of( ' ' ) ); stringValue.erase( stringValue.find_last_not_of( ' ' ) + 1 ); }
+            if( uColumn == 10 ) tableExpect.cell_set( 0, uColumn, gd::variant_view( stringValue == "true" ) );
+            else if( uColumn == 8 ) tableExpect.cell_set( 0, uColumn, gd::variant_view( std::stof( stringValue ) ) );
+            else if( uColumn == 9 ) tableExpect.cell_set( 0, uColumn, gd::variant_view( std::stod( stringValue ) ) );
+            else tableExpect.cell_set( 0, uColumn, gd::variant_view( stringValue ), tag_convert{} );
+         }
+      }
+
+      for( unsigned uColumn = 0; uColumn < tableExpect.get_column_count(); uColumn++ )
+      {
+         auto v1_ = tableExpect.cell_get_variant_view( 0, uColumn );
+         auto v2_ = table_.cell_get_variant_view( uRow, uColumn );
+         if( v1_.is_null() != v2_.is_null() || ( v1_.is_null() == false && v1_.as_string() != v2_.as_string() ) ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn ) + ": " + v2_.as_string() + " != " + v1_.as_string();
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[csv] decoder converts values to column types", "[csv]" ) {
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      for( bool bIndex : { false, true } )
+      {
+         INFO( "flags: " << uFlags << ", index: " << bIndex );
+         auto table_ = make_decoder_table_s( uFlags );
+         index_hash* pindex = nullptr;
+         if( bIndex == true ) pindex = table_.index_add( { 4 }, tag_index_hash{} );   // values are set with cell_set when table has indexes
+
+         gd::csv::decoder decoder_( table_ );
+         REQUIRE( decoder_.m_vectorDecode.size() == table_.get_column_count() );
+         REQUIRE( decoder_.m_vectorDecode[0] == gd::csv::decoder::eDecodeInt8 );
+         REQUIRE( decoder_.m_vectorDecode[9] == gd::csv::decoder::eDecodeDouble );
+         REQUIRE( decoder_.m_vectorDecode[10] == gd::csv::decoder::eDecodeBool );
+         REQUIRE( decoder_.m_vectorDecode[11] == gd::csv::decoder::eDecodeText );
+         REQUIRE( decoder_.m_vectorDecode[12] == gd::csv::decoder::eDecodeText );
+
+         for( int iRow = 0; iRow < 1000; iRow++ )
+         {
+            std::string stringRecord = make_record_s( iRow );
+            REQUIRE( decoder_.add( table_, stringRecord.data(), stringRecord.data() + stringRecord.length(), gd::csv::options() ) == -1 );
+            REQUIRE( decoder_.size() == 13 );
+         }
+         REQUIRE( table_.get_row_count() == 1000 );
+         for( int iRow = 0; iRow < 1000; iRow++ ) REQUIRE( compare_row_s( table_, (uint64_t)iRow, iRow ) == "" );
+
+         if( pindex != nullptr )
+         {
+            std::vector<uint64_t> vectorRow;
+            pindex->find( { 5 }, vectorRow );
+            REQUIRE( vectorRow.size() == 5 );                                  // rows 105, 305, 505, 705 and 905
+         }
+      }
+   }
+}
+
+TEST_CASE( "[csv] decoder rejects invalid values", "[csv]" ) {
+   auto table_ = make_decoder_table_s( 0 );
+   gd::csv::decoder decoder_( table_ );
+   gd::csv::options options_;
+
+   // ## fewer values than columns, missing values are null
+   std::string stringRecord = "1,2";
+   REQUIRE( decoder_.add( table_, stringRecord.data(), stringRecord.data() + stringRecord.length(), options_ ) == -1 );
+   REQUIRE( table_.cell_get_variant_view( 0, 1u ).as_int64() == 2 );
+   REQUIRE( table_.cell_is_null( 0, 2u ) == true );
+   REQUIRE( table_.cell_is_null( 0, 11u ) == true );
+
+   // ## value that can't be converted, row is removed and column is returned
+   for( const auto& [stringBad, iColumn] : std::vector< std::pair<std::string, int> >{ { "300", 0 }, { ",-1", 1 }, { ",,,,,,,,,,maybe", 10 }, { ",,,,,,,,1.5x", 8 }, { "1 2", 0 }, { ",,,,,99999999999", 5 } } )
+   {
+      INFO( "record: " << stringBad );
+      std::string stringText = stringBad;
+      REQUIRE( decoder_.add( table_, stringText.data(), stringText.data() + stringText.length(), options_ ) == iColumn );
+      REQUIRE( table_.get_row_count() == 1 );
+   }
+   stringRecord = "x";
+   REQUIRE( decoder_.add( table_, stringRecord.data(), stringRecord.data() + stringRecord.length(), options_ ) == 0 );
+   REQUIRE( decoder_.get_value( 0 ) == "x" );
+}
@@ -0,0 +1,94 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_csv.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// write csv file with header and quoted values with line breaks, line breaks in values make quote parity needed to find records
+   void write_csv_s( const std::string& stringFile, int iCount )
+   {
+      std::ofstream ofstreamCsv( stringFile, std::ios::binary );
+      ofstreamCsv << "id,name,price\n";
+      for( int i = 0; i < iCount; i++ )
+      {
+         ofstreamCsv << i << ",";
+         if( i % 7 == 0 ) ofstreamCsv << "\"q, \"\"x\"\"\n li\nne " << i % 13 << "\"";
+         else if( i % 11 != 0 ) ofstreamCsv << "n" << i % 29;                  // empty name is read as empty text, not null
+         ofstreamCsv << ",";
+         if( i % 5 != 0 ) ofstreamCsv << i * 0.5;
+         ofstreamCsv << ( i % 3 == 0 ? "\r\n" : "\n" );
+      }
+   }
+
+   /// compare rows in table with rows in other table starting at offset, returns description for first difference
+   std::string compare_table_s( const dto::table& tableExpect, const dto::table& table_, uint64_t uOffset )
+   {
+      if( table_.get_row_count() != tableExpect.get_row_count() + uOffset ) return "row count " + std::to_string( table_.get_row_count() );
+      for( uint64_t uRow = 0; uRow < tableExpect.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < tableExpect.get_column_count(); uColumn++ )
+         {
+            auto v1_ = tableExpect.cell_get_variant_view( uRow, uColumn );
+            auto v2_ = table_.cell_get_variant_view( uRow + uOffset, uColumn );
+            if( v1_.is_null() != v2_.is_null() || ( v1_.is_null() == false && v1_.as_string() != v2_.as_string() ) ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn );
+         }
+      }
+      return std::string();
+   }
+
+   dto::table make_csv_table_s( unsigned uFlags ) { return dto::table( dto::table::eTableFlagNull32 | uFlags, { { "int64", 0, "id" }, { "rstring", 0, "name" }, { "double", 0, "price" } }, tag_prepare{} ); }
+}
+
+TEST_CASE( "[csv] parallel csv read gives same rows as sequential read", "[csv]" ) {
+   std::string stringFile = ( std::filesystem::temp_directory_path() / "test_csv_parallel.csv" ).string();
+   write_csv_s( stringFile, 5000 );
+
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      gd::csv::options options_( ',', true );
+      auto tableSequential = make_csv_table_s( uFlags );
+      REQUIRE( gd::csv::read( tableSequential, stringFile, options_ ).first == true );
+      REQUIRE( tableSequential.get_row_count() == 5000 );
+      REQUIRE( tableSequential.cell_is_null( 11, 1u ) == false );
+      REQUIRE( tableSequential.cell_get_variant_view( 11, 1u ).as_string() == "" );
+
+      for( unsigned uThreadCount : { 1u, 2u, 4u } )
+      {
+         for( uint64_t uChunkSize : std::vector<uint64_t>{ 256, 4096 } )
+         {
+            INFO( "flags: " << uFlags << ", threads: " << uThreadCount << ", chunk: " << uChunkSize );
+            options_.m_uChunkSize = uChunkSize;                                // small parts, records with line breaks are split between parts
+            auto tableParallel = make_csv_table_s( uFlags );
+            tableParallel.row_add( { (int64_t)99, "first", 1.0 }, tag_convert{} );   // rows already in table are kept
+            uint64_t uLastRow = 0;
+            auto result_ = gd::csv::read( tableParallel, stringFile, options_, [&uLastRow]( uint64_t, uint64_t, uint64_t uRowCount ) { uLastRow = uRowCount; return true; }, uThreadCount );
+            REQUIRE( result_.first == true );
+            REQUIRE( compare_table_s( tableSequential, tableParallel, 1 ) == "" );
+            REQUIRE( tableParallel.cell_get_variant_view( 0, 1u ).as_string() == "first" );
+            REQUIRE( tableParallel.cell_is_null( 12, 1u ) == false );          // row 11 in file, empty name
+            REQUIRE( tableParallel.get_references().size() == tableSequential.get_references().size() + 1 );
+            REQUIRE( uLastRow > 0 );
+         }
+      }
+   }
+
+   // ## error in record is reported
+   {
+      std::ofstream ofstreamCsv( stringFile, std::ios::binary );
+      for( int i = 0; i < 1000; i++ ) ofstreamCsv << i << ",n," << ( i == 700 ? "x" : "1.5" ) << "\n";
+   }
+   gd::csv::options options_( ',' );
+   options_.m_uChunkSize = 256;
+   auto table_ = make_csv_table_s( 0 );
+   REQUIRE( gd::csv::read( table_, stringFile, options_, nullptr, 4 ).first == false );
+
+   std::filesystem::remove( stringFile );
+}
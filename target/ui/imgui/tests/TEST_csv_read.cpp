@@ -0,0 +1,143 @@
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_csv.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// values written to csv file for one record, empty optional is written as empty value
+   struct record_
+   {
+      int64_t m_iId = 0;
+      std::string m_stringName;
+      std::optional<double> m_dPrice;
+   };
+
+   /// write csv file with header, quoted values, line breaks in quoted values and \r\n line ends
+   std::vector<record_> write_csv_s( const std::string& stringFile, int iCount )
+   {
+      std::vector<record_> vectorRecord;
+      std::ofstream ofstreamCsv( stringFile, std::ios::binary );
+      ofstreamCsv << "id,name,price\n";
+      for( int i = 0; i < iCount; i++ )
+      {
+         record_ record;
+         record.m_iId = i;
+         ofstreamCsv << i << ",";
+         if( i % 7 == 0 ) { record.m_stringName = "q, \"x\"\n line " + std::to_string( i % 13 ); ofstreamCsv << "\"q, \"\"x\"\"\n line " << i % 13 << "\""; }
+         else if( i % 11 != 0 ) { record.m_stringName = "n" + std::to_string( i % 29 ); ofstreamCsv << record.m_stringName; }
+         ofstreamCsv << ",";
+         if( i % 5 != 0 ) { record.m_dPrice = i * 0.5; ofstreamCsv << i * 0.5; }
+         ofstreamCsv << ( i % 3 == 0 ? "\r\n" : "\n" );
+         if( i % 100 == 99 ) ofstreamCsv << "\n";                              // empty line is skipped
+         vectorRecord.push_back( record );
+      }
+      return vectorRecord;
+   }
+
+   /// compare table rows from first row with records, returns description for first difference
+   std::string compare_csv_s( const dto::table& table_, uint64_t uFirstRow, const std::vector<record_>& vectorRecord )
+   {
+      if( table_.get_row_count() != uFirstRow + vectorRecord.size() ) return "row count " + std::to_string( table_.get_row_count() );
+      for( std::size_t u = 0; u < vectorRecord.size(); u++ )
+      {
+         uint64_t uRow = uFirstRow + u;
+         const auto& record = vectorRecord[u];
+         if( table_.cell_get_variant_view( uRow, 0u ).as_int64() != record.m_iId ) return "id in row " + std::to_string( uRow );
+         if( table_.cell_is_null( uRow, 1u ) == true || table_.cell_get_variant_view( uRow, 1u ).as_string() != record.m_stringName ) return "name in row " + std::to_string( uRow );
+         if( table_.cell_is_null( uRow, 2u ) != ( record.m_dPrice.has_value() == false ) ) return "null price in row " + std::to_string( uRow );
+         if( record.m_dPrice.has_value() == true && table_.cell_get_variant_view( uRow, 2u ).as_double() != *record.m_dPrice ) return "price in row " + std::to_string( uRow );
+      }
+      return std::string();
+   }
+
+   dto::table make_csv_table_s( unsigned uFlags ) { return dto::table( dto::table::eTableFlagNull32 | uFlags, { { "int64", 0, "id" }, { "rstring", 0, "name" }, { "double", 0, "price" } }, tag_prepare{} ); }
+}
+
+TEST_CASE( "[csv] read csv file in chunks", "[csv]" ) {
+   std::string stringFile = ( std::filesystem::temp_directory_path() / "test_csv_read.csv" ).string();
+   auto vectorRecord = write_csv_s( stringFile, 3000 );
+
+   for( uint64_t uChunkSize : std::vector<uint64_t>{ 16, 100, 4096, gd::csv::options::eSpaceChunkSize } )
+   {
+      for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagDictionary, (unsigned)dto::table::eTableFlagColumnar } )
+      {
+         INFO( "chunk: " << uChunkSize << ", flags: " << uFlags );
+         gd::csv::options options_( ',', true );
+         options_.m_uChunkSize = uChunkSize;                                   // records span chunks
+         auto table_ = make_csv_table_s( uFlags );
+         table_.row_add( { (int64_t)-1, "first", 0.0 }, tag_convert{} );       // rows are appended
+
+         uint64_t uProgress = 0, uLastRead = 0;
+         auto result_ = gd::csv::read( table_, stringFile, options_, [&]( uint64_t uByteRead, uint64_t uByteSize, uint64_t ) { uProgress++; uLastRead = uByteRead; return uByteRead <= uByteSize; } );
+         REQUIRE( result_.first == true );
+         REQUIRE( compare_csv_s( table_, 1, vectorRecord ) == "" );
+         REQUIRE( uProgress > 0 );
+         REQUIRE( uLastRead == std::filesystem::file_size( stringFile ) );
+      }
+   }
+
+   // ## cancel in progress
+   gd::csv::options options_( ',', true );
+   options_.m_uChunkSize = 1024;
+   auto table_ = make_csv_table_s( 0 );
+   auto result_ = gd::csv::read( table_, stringFile, options_, []( uint64_t, uint64_t, uint64_t uRowCount ) { return uRowCount < 100; } );
+   REQUIRE( result_.first == false );
+   REQUIRE( table_.get_row_count() < 3000 );
+
+   std::filesystem::remove( stringFile );
+}
+
+TEST_CASE( "[csv] read csv with errors", "[csv]" ) {
+   std::string stringFile = ( std::filesystem::temp_directory_path() / "test_csv_read_error.csv" ).string();
+   auto table_ = make_csv_table_s( 0 );
+   REQUIRE( gd::csv::read( table_, stringFile + ".missing", gd::csv::options() ).first == false );
+
+   {
+      std::ofstream ofstreamCsv( stringFile, std::ios::binary );
+      ofstreamCsv << "1,a,1.5\n2,b,x\n";
+   }
+   auto result_ = gd::csv::read( table_, stringFile, gd::csv::options() );
+   REQUIRE( result_.first == false );
+   REQUIRE( result_.second.find( "record 2" ) != std::string::npos );
+   REQUIRE( table_.get_row_count() == 1 );
+
+   // ## semicolon and fewer values than columns, missing values are null
+   {
+      std::ofstream ofstreamCsv( stringFile, std::ios::binary );
+      ofstreamCsv << "1;a\n2\n";
+   }
+   auto tableSemicolon = make_csv_table_s( 0 );
+   REQUIRE( gd::csv::read( tableSemicolon, stringFile, gd::csv::options( ';' ) ).first == true );
+   REQUIRE( tableSemicolon.get_row_count() == 2 );
+   REQUIRE( tableSemicolon.cell_get_variant_view( 0, 1u ).as_string() == "a" );
+   REQUIRE( tableSemicolon.cell_is_null( 0, 2u ) == true );
+   REQUIRE( tableSemicolon.cell_is_null( 1, 1u ) == true );
+   std::filesystem::remove( stringFile );
+}
+
+TEST_CASE( "[csv] split records and values", "[csv]" ) {
+   gd::csv::options options_;
+   std::string stringText = "a,\"b,\"\"c\"\"\n d\",,e\r\nnext";
+   const char* pbszEnd = stringText.data() + stringText.length();
+   const char* pbszNext = gd::csv::next_record_g( stringText.data(), pbszEnd, options_ );
+   REQUIRE( pbszNext != nullptr );
+   REQUIRE( std::string_view( pbszNext ) == "next" );
+   REQUIRE( gd::csv::next_record_g( pbszNext, pbszEnd, options_ ) == nullptr );    // record do not end in buffer
+   REQUIRE( gd::csv::next_record_g( stringText.data(), stringText.data() + 8, options_ ) == nullptr );   // line break in quote
+
+   std::vector<std::string_view> vectorValue;
+   gd::csv::split_record_g( stringText.data(), const_cast<char*>( pbszNext ) - 1, options_, vectorValue );
+   REQUIRE( vectorValue.size() == 4 );
+   REQUIRE( vectorValue[0] == "a" );
+   REQUIRE( vectorValue[1] == "b,\"c\"\n d" );
+   REQUIRE( vectorValue[2] == "" );
+   REQUIRE( vectorValue[3] == "e" );
+}
@@ -0,0 +1,195 @@
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_expression_program.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// values in one row, null values are empty
+   struct row_
+   {
+      std::optional<int64_t> a;
+      std::optional<int64_t> b;
+      std::optional<double> price;
+      std::optional<std::string> name;
+      std::optional<std::string> tag;
+   };
+
+   /// value in row for row index, same values are added to table
+   row_ make_row_s( uint64_t uRow )
+   {
+      row_ row;
+      if( uRow % 17 != 0 ) row.a = (int64_t)( uRow % 23 ) - 5;
+      if( uRow % 29 != 1 ) row.b = (int64_t)( uRow % 7 );
+      if( uRow % 31 != 2 ) row.price = ( uRow % 50 ) * 0.75;
+      if( uRow % 11 != 3 ) row.name = "n" + std::to_string( uRow % 9 );
+      if( uRow % 13 != 4 ) row.tag = std::string( 1, (char)( 'a' + uRow % 5 ) );
+      return row;
+   }
+
+   /// table with int64, int32, double, reference text and text columns, some values are null
+   dto::table make_program_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 | uFlags );
+      table_.column_add( "int64", 0, "a" );
+      table_.column_add( "int32", 0, "b" );
+      table_.column_add( "double", 0, "price" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "string", 8, "tag" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         row_ row = make_row_s( u );
+         table_.row_add( { (int64_t)0, 0, 0.0, "", "" }, tag_convert{} );
+         uint64_t uRow = table_.get_row_count() - 1;
+         if( row.a ) table_.cell_set( uRow, 0u, gd::variant_view( *row.a ), tag_convert{} ); else table_.cell_set_null( uRow, 0u );
+         if( row.b ) table_.cell_set( uRow, 1u, gd::variant_view( *row.b ), tag_convert{} ); else table_.cell_set_null( uRow, 1u );
+         if( row.price ) table_.cell_set( uRow, 2u, gd::variant_view( *row.price ), tag_convert{} ); else table_.cell_set_null( uRow, 2u );
+         if( row.name ) table_.cell_set( uRow, 3u, gd::variant_view( *row.name ), tag_convert{} ); else table_.cell_set_null( uRow, 3u );
+         if( row.tag ) table_.cell_set( uRow, 4u, gd::variant_view( *row.tag ), tag_convert{} ); else table_.cell_set_null( uRow, 4u );
+      }
+      return table_;
+   }
+
+   /// compare with null is false, null values in and/or are false
+   template<typename TYPE>
+   bool compare_s( const std::optional<TYPE>& left_, const std::optional<TYPE>& right_, const std::function<bool( const TYPE&, const TYPE& )>& compare_ ) {
+      return left_.has_value() == true && right_.has_value() == true && compare_( *left_, *right_ );
+   }
+
+   std::optional<int64_t> add_s( const std::optional<int64_t>& l_, const std::optional<int64_t>& r_ ) { if( !l_ || !r_ ) return {}; return *l_ + *r_; }
+   std::optional<int64_t> multiply_s( const std::optional<int64_t>& l_, const std::optional<int64_t>& r_ ) { if( !l_ || !r_ ) return {}; return *l_ * *r_; }
+   std::optional<int64_t> c_s( int64_t i ) { return i; }
+   std::optional<double> to_double_s( const std::optional<int64_t>& v_ ) { if( !v_ ) return {}; return (double)*v_; }
+   bool is_true_s( const std::optional<int64_t>& v_ ) { return v_.has_value() == true && *v_ != 0; }
+
+   /// expression and same expression evaluated for one row
+   struct expression_
+   {
+      std::string m_stringExpression;
+      std::function<bool( const row_& )> m_evaluate;
+   };
+
+   /// compare rows from program filter with rows where expression is true, returns description for first difference
+   std::string compare_filter_s( const dto::table& table_, const std::vector<expression_>& vectorExpression )
+   {
+      gd::expression::program program_;
+      for( const auto& it : vectorExpression )
+      {
+         auto result_ = program_.compile( it.m_stringExpression, &table_ );
+         if( result_.first == false ) return "compile '" + it.m_stringExpression + "': " + result_.second;
+         if( program_.is_predicate() == false ) return "not predicate '" + it.m_stringExpression + "'";
+
+         gd::table::selection selection_;
+         program_.filter( selection_ );
+         for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+         {
+            bool bExpected = it.m_evaluate( make_row_s( uRow ) );
+            if( selection_.is_set( uRow ) != bExpected ) return "'" + it.m_stringExpression + "' row " + std::to_string( uRow ) + " is " + std::to_string( selection_.is_set( uRow ) );
+         }
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[expression] program filter match row by row evaluation", "[expression]" ) {
+   using std::optional;
+   const std::vector<expression_> vectorExpression = {
+      // ## precedence and associativity
+      { "a + b * 2 > 10", []( const row_& r ) { return compare_s<int64_t>( add_s( r.a, multiply_s( r.b, c_s( 2 ) ) ), c_s( 10 ), std::greater<>{} ); } },
+      { "(a + b) * 2 > 10", []( const row_& r ) { return compare_s<int64_t>( multiply_s( add_s( r.a, r.b ), c_s( 2 ) ), c_s( 10 ), std::greater<>{} ); } },
+      { "a - b - 3 = 0", []( const row_& r ) { return compare_s<int64_t>( add_s( add_s( r.a, multiply_s( r.b, c_s( -1 ) ) ), c_s( -3 ) ), c_s( 0 ), std::equal_to<>{} ); } },
+      { "-a * 2 < -10", []( const row_& r ) { return compare_s<int64_t>( multiply_s( multiply_s( r.a, c_s( -1 ) ), c_s( 2 ) ), c_s( -10 ), std::less<>{} ); } },
+      { "a % 4 = 1", []( const row_& r ) { return compare_s<int64_t>( r.a ? optional<int64_t>( *r.a % 4 ) : optional<int64_t>(), c_s( 1 ), std::equal_to<>{} ); } },
+      { "a / 2 = 1.5", []( const row_& r ) { return compare_s<double>( r.a ? optional<double>( *r.a / 2.0 ) : optional<double>(), optional<double>( 1.5 ), std::equal_to<>{} ); } },
+      { "a > 5 or b < 2 and price > 20", []( const row_& r ) { return compare_s<int64_t>( r.a, c_s( 5 ), std::greater<>{} ) || ( compare_s<int64_t>( r.b, c_s( 2 ), std::less<>{} ) && compare_s<double>( r.price, 20.0, std::greater<>{} ) ); } },
+      { "(a > 5 or b < 2) and price > 20", []( const row_& r ) { return ( compare_s<int64_t>( r.a, c_s( 5 ), std::greater<>{} ) || compare_s<int64_t>( r.b, c_s( 2 ), std::less<>{} ) ) && compare_s<double>( r.price, 20.0, std::greater<>{} ); } },
+      { "not a > 5 and b = 3", []( const row_& r ) { return !compare_s<int64_t>( r.a, c_s( 5 ), std::greater<>{} ) && compare_s<int64_t>( r.b, c_s( 3 ), std::equal_to<>{} ); } },
+      { "! (a > 5 || b = 3)", []( const row_& r ) { return !( compare_s<int64_t>( r.a, c_s( 5 ), std::greater<>{} ) || compare_s<int64_t>( r.b, c_s( 3 ), std::equal_to<>{} ) ); } },
+      { "price * b >= a + 30", []( const row_& r ) { return compare_s<double>( !r.price || !r.b ? optional<double>() : optional<double>( *r.price * *r.b ), to_double_s( add_s( r.a, c_s( 30 ) ) ), std::greater_equal<>{} ); } },
+
+      // ## null values in and, or and not, null values as boolean are false
+      { "a and b", []( const row_& r ) { return is_true_s( r.a ) && is_true_s( r.b ); } },
+      { "a or b", []( const row_& r ) { return is_true_s( r.a ) || is_true_s( r.b ); } },
+      { "not a", []( const row_& r ) { return !is_true_s( r.a ); } },
+      { "a = a", []( const row_& r ) { return r.a.has_value(); } },
+      { "a != a or true", []( const row_& ) { return true; } },
+      { "a + b = a + b and false", []( const row_& ) { return false; } },
+      { "not ( a > 0 ) and not ( a <= 0 )", []( const row_& r ) { return !r.a.has_value(); } },
+
+      // ## text, reference column compare codes and other compare text
+      { "name = 'n3'", []( const row_& r ) { return r.name == std::string( "n3" ); } },
+      { "name <> 'n3'", []( const row_& r ) { return r.name.has_value() == true && *r.name != "n3"; } },
+      { "'n3' = name", []( const row_& r ) { return r.name == std::string( "n3" ); } },
+      { "name = 'missing'", []( const row_& ) { return false; } },
+      { "name != 'missing'", []( const row_& r ) { return r.name.has_value(); } },
+      { "name < 'n4'", []( const row_& r ) { return compare_s<std::string>( r.name, std::string( "n4" ), std::less<>{} ); } },
+      { "name >= 'n7' and a > 0", []( const row_& r ) { return compare_s<std::string>( r.name, std::string( "n7" ), std::greater_equal<>{} ) && compare_s<int64_t>( r.a, c_s( 0 ), std::greater<>{} ); } },
+      { "tag = 'c'", []( const row_& r ) { return r.tag == std::string( "c" ); } },
+      { "tag > 'b' or name = 'n1'", []( const row_& r ) { return compare_s<std::string>( r.tag, std::string( "b" ), std::greater<>{} ) || r.name == std::string( "n1" ); } },
+      { "tag = name", []( const row_& r ) { return compare_s<std::string>( r.tag, r.name, std::equal_to<>{} ); } },
+   };
+
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      INFO( "flags: " << uFlags );
+      auto table_ = make_program_table_s( uFlags, 3000 );                       // more than one batch
+      REQUIRE( compare_filter_s( table_, vectorExpression ) == "" );
+   }
+}
+
+TEST_CASE( "[expression] constant parts are folded in compile", "[expression]" ) {
+   auto table_ = make_program_table_s( 0, 100 );
+   gd::expression::program program_;
+
+   REQUIRE( program_.compile( "1 + 2 * 3 = 7", &table_ ).first == true );
+   REQUIRE( program_.is_constant() == true );
+   REQUIRE( program_.filter( tag_row{} ).size() == 100 );
+
+   REQUIRE( program_.compile( "(1 + 2) * 3 = 7 or false", &table_ ).first == true );
+   REQUIRE( program_.is_constant() == true );
+   REQUIRE( program_.filter( tag_row{} ).empty() == true );
+
+   REQUIRE( program_.compile( "'abc' < 'abd'", &table_ ).first == true );
+   REQUIRE( program_.is_constant() == true );
+
+   REQUIRE( program_.compile( "7 / 2", &table_ ).first == true );
+   REQUIRE( program_.is_constant() == true );
+   REQUIRE( program_.get_type() == gd::expression::program::eValueDouble );
+   REQUIRE( program_.m_vectorNode[program_.m_iRoot].m_dValue == 3.5 );
+
+   // ## constant part in expression with column is one node
+   REQUIRE( program_.compile( "a > 2 * 3 - 1", &table_ ).first == true );
+   REQUIRE( program_.is_constant() == false );
+   const auto& nodeRoot = program_.m_vectorNode[program_.m_iRoot];
+   REQUIRE( program_.m_vectorNode[nodeRoot.m_iRight].m_eNode == gd::expression::program::eNodeConstant );
+   REQUIRE( program_.m_vectorNode[nodeRoot.m_iRight].m_iValue == 5 );
+
+   // ## modulo by zero is null and not folded
+   REQUIRE( program_.compile( "5 % 0 = 0", &table_ ).first == true );
+   REQUIRE( program_.filter( tag_row{} ).empty() == true );
+}
+
+TEST_CASE( "[expression] compile errors", "[expression]" ) {
+   auto table_ = make_program_table_s( 0, 10 );
+   gd::expression::program program_;
+   for( const char* pbszExpression : { "", "a +", "(a > 1", "a > 1 )", "unknown > 1", "name + 1", "name > 1", "not name", "-tag", "name and a > 1", "* 2", "a > > 1" } )
+   {
+      INFO( "expression: " << pbszExpression );
+      auto result_ = program_.compile( pbszExpression, &table_ );
+      REQUIRE( result_.first == false );
+      REQUIRE( result_.second.empty() == false );
+      REQUIRE( program_.empty() == true );
+   }
+
+   REQUIRE( program_.compile( "unknown > 1", &table_ ).second.find( "unknown" ) != std::string::npos );
+   REQUIRE( program_.compile( "a + b", &table_ ).first == true );
+   REQUIRE( program_.is_predicate() == false );
+}
@@ -0,0 +1,153 @@
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gd/gd_parallel.h"
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_aggregate.h"
+#include "gd/gd_table_parallel.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with id, value and name, some values are null
+   dto::table make_parallel_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 | uFlags );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "int32", 0, "group" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "name" + std::to_string( u % 37 );
+         table_.row_add( { (int64_t)u, ( u % 1013 ) * 0.5, (int)( u % 97 ), stringName }, tag_convert{} );
+         if( u % 61 == 0 ) table_.cell_set_null( (uint64_t)u, 1u );
+      }
+      return table_;
+   }
+
+   /// sum for numbers with nested tasks, each task splits range in two and waits for both parts
+   uint64_t sum_nested_s( gd::parallel::task_pool& pool_, uint64_t uFrom, uint64_t uTo )
+   {
+      if( uTo - uFrom <= 100 ) { uint64_t uSum = 0; for( uint64_t u = uFrom; u < uTo; u++ ) uSum += u; return uSum; }
+      uint64_t uMiddle = uFrom + ( uTo - uFrom ) / 2;
+      uint64_t uLeft = 0, uRight = 0;
+      gd::parallel::task_group group_;
+      pool_.submit( group_, [&]() { uLeft = sum_nested_s( pool_, uFrom, uMiddle ); } );
+      pool_.submit( group_, [&]() { uRight = sum_nested_s( pool_, uMiddle, uTo ); } );
+      pool_.wait( group_ );
+      return uLeft + uRight;
+   }
+}
+
+TEST_CASE( "[parallel] task pool runs all tasks in group", "[parallel]" ) {
+   for( unsigned uThreadCount : { 1u, 4u } )
+   {
+      INFO( "threads: " << uThreadCount );
+      gd::parallel::task_pool pool_( uThreadCount );
+      REQUIRE( pool_.size() == uThreadCount );
+
+      std::atomic<uint64_t> uSum{ 0 };
+      gd::parallel::task_group group_;
+      for( uint64_t u = 0; u < 1000; u++ ) pool_.submit( group_, [&uSum, u]() { uSum += u; } );
+      pool_.wait( group_ );
+      REQUIRE( group_.is_done() == true );
+      REQUIRE( uSum.load() == 999 * 1000 / 2 );
+
+      // ## nested wait do not block workers
+      REQUIRE( sum_nested_s( pool_, 0, 100000 ) == 99999ull * 100000ull / 2 );
+
+      // ## exception in task is thrown in wait
+      gd::parallel::task_group groupThrow;
+      for( int i = 0; i < 10; i++ ) pool_.submit( groupThrow, [i]() { if( i == 5 ) throw std::runtime_error( "task" ); } );
+      REQUIRE_THROWS_AS( pool_.wait( groupThrow ), std::runtime_error );
+      REQUIRE( groupThrow.is_done() == true );
+
+      // ## parallel_for calls callback once for each range and ranges cover all values
+      for( uint64_t uGrain : { 1ull, 7ull, 64ull, 5000ull } )
+      {
+         INFO( "grain: " << uGrain );
+         std::vector<std::atomic<int>> vectorCount( 1000 );
+         std::atomic<bool> bLarge{ false };                                    // assertions are only checked in test thread
+         gd::parallel::parallel_for( pool_, 0, 1000, uGrain, [&]( uint64_t uFrom, uint64_t uTo ) {
+            if( uTo - uFrom > uGrain ) bLarge = true;
+            for( uint64_t u = uFrom; u < uTo; u++ ) vectorCount[u]++;
+         } );
+         REQUIRE( bLarge.load() == false );
+         for( const auto& it : vectorCount ) REQUIRE( it.load() == 1 );
+      }
+   }
+}
+
+TEST_CASE( "[parallel] parallel table operations give same result as single thread", "[parallel]" ) {
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      for( unsigned uThreadCount : { 1u, 4u } )
+      {
+         INFO( "flags: " << uFlags << ", threads: " << uThreadCount );
+         gd::parallel::task_pool pool_( uThreadCount );
+         auto table_ = make_parallel_table_s( uFlags, 50000 );
+         const uint64_t uRowCount = table_.get_row_count();
+
+         // ## rows are visited once
+         std::atomic<uint64_t> uVisit{ 0 }, uUnaligned{ 0 };
+         parallel_for_rows( pool_, table_, 1000, [&]( uint64_t uFrom, uint64_t uTo ) {
+            if( uFrom % 64 != 0 ) uUnaligned++;                                 // ranges start at null word boundary
+            uVisit += uTo - uFrom;
+         } );
+         REQUIRE( uVisit.load() == uRowCount );
+         REQUIRE( uUnaligned.load() == 0 );
+
+         // ## harvest
+         std::vector<double> vectorValue( uRowCount - 100 ), vectorParallel( uRowCount - 100 );
+         std::vector<uint64_t> vectorNull( ( uRowCount + 63 ) / 64 ), vectorNullParallel( ( uRowCount + 63 ) / 64 );
+         table_.harvest( 1u, 64, std::span<double>( vectorValue ), vectorNull.data() );
+         parallel_harvest( pool_, table_, 1u, 64, std::span<double>( vectorParallel ), vectorNullParallel.data(), 1000 );
+         REQUIRE( vectorParallel == vectorValue );
+         REQUIRE( vectorNullParallel == vectorNull );
+
+         // ## find
+         for( int iGroup : { 0, 50, 96, 200 } )
+         {
+            INFO( "group: " << iGroup );
+            gd::variant_view variantviewFind( iGroup );
+            std::vector<uint64_t> vectorFind;
+            for( int64_t iRow = table_.find( 2u, variantviewFind ); iRow != -1; iRow = (uint64_t)iRow + 1 < uRowCount ? table_.find( 2u, (uint64_t)iRow + 1, uRowCount - (uint64_t)iRow - 1, variantviewFind ) : -1 ) vectorFind.push_back( (uint64_t)iRow );
+            REQUIRE( parallel_find( pool_, table_, 2u, variantviewFind, 640 ) == table_.find( 2u, variantviewFind ) );
+            REQUIRE( parallel_find_any( pool_, table_, 2u, variantviewFind, 640 ) == ( vectorFind.empty() == false ) );
+            REQUIRE( parallel_find_all( pool_, table_, 2u, variantviewFind, 640 ) == vectorFind );
+         }
+
+         // ## aggregate
+         aggregate<dto::table> aggregate_( &table_ );
+         for( unsigned uColumn : { 0u, 1u, 2u } )
+         {
+            INFO( "column: " << uColumn );
+            auto accumulator_ = aggregate_.calculate( uColumn, 0, uRowCount );
+            auto accumulatorParallel = parallel_aggregate( pool_, table_, uColumn, 1000 );
+            REQUIRE( accumulatorParallel.m_uCount == accumulator_.m_uCount );
+            REQUIRE( accumulatorParallel.m_iSum == accumulator_.m_iSum );
+            REQUIRE( accumulatorParallel.m_dSum == Catch::Approx( accumulator_.m_dSum ) );
+            REQUIRE( accumulatorParallel.m_variantviewMin.as_double() == accumulator_.m_variantviewMin.as_double() );
+            REQUIRE( accumulatorParallel.m_variantviewMax.as_double() == accumulator_.m_variantviewMax.as_double() );
+         }
+         REQUIRE( parallel_aggregate( pool_, table_, 1u ).m_uCount == uRowCount - ( uRowCount + 60 ) / 61 );
+
+         // ## column fill, reference column is filled in one thread
+         parallel_column_fill( pool_, table_, 1u, gd::variant_view( 2.5 ), 1000 );
+         parallel_column_fill( pool_, table_, 3u, gd::variant_view( "filled" ), 1000 );
+         for( uint64_t uRow = 0; uRow < uRowCount; uRow += 7 )
+         {
+            REQUIRE( table_.cell_get_variant_view( uRow, 1u ).as_double() == 2.5 );
+            REQUIRE( table_.cell_get_variant_view( uRow, 3u ).as_string() == "filled" );
+         }
+      }
+   }
+}
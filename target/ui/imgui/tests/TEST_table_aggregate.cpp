@@ -0,0 +1,128 @@
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_aggregate.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// key columns group and region (both with null values) and value columns amount, price and code
+   dto::table make_aggregate_table_s( unsigned uRowCount )
+   {
+      dto::table table_( dto::table::eTableFlagNull32, { { "int32", 0, "group"}, { "rstring", 0, "region"}, { "int64", 0, "amount"}, { "double", 0, "price"}, { "int32", 0, "code"} }, tag_prepare{} );
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringRegion = "r" + std::to_string( ( u / 3 ) % 5 );
+         table_.row_add( { (int)( u % 37 ), stringRegion, (int64_t)( u % 101 ) - 50, ( u % 13 ) * 0.25, (int)( u % 17 ) }, tag_convert{} );
+         uint64_t uRow = table_.get_row_count() - 1;
+         if( u % 41 == 0 ) table_.cell_set_null( uRow, 0u );
+         if( u % 43 == 0 ) table_.cell_set_null( uRow, 1u );
+         if( u % 7 == 0 ) table_.cell_set_null( uRow, 2u );
+         if( u % 19 == 0 ) table_.cell_set_null( uRow, 4u );
+      }
+      return table_;
+   }
+
+   /// expected values for group, calculated row by row
+   struct group_expect
+   {
+      uint64_t m_uCount = 0;
+      int64_t m_iSum = 0;
+      int64_t m_iMin = 0;
+      int64_t m_iMax = 0;
+      double m_dSum = 0;
+      uint64_t m_uPriceCount = 0;
+      std::set<int64_t> m_setCode;
+   };
+
+   std::string key_s( const gd::variant_view& v_ ) { return v_.is_null() == true ? std::string( "<null>" ) : v_.as_string(); }
+}
+
+TEST_CASE( "[table] group by compared with row by row aggregation", "[table]" ) {
+   auto table_ = make_aggregate_table_s( 40000 );                              // enough rows to use more than one thread
+
+   // ## calculate expected groups, order is first row found for group
+   std::vector<std::string> vectorGroupOrder;
+   std::map<std::string, group_expect> mapExpect;
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      std::string stringKey = key_s( table_.cell_get_variant_view( uRow, 0u ) ) + "|" + key_s( table_.cell_get_variant_view( uRow, 1u ) );
+      auto [it, bInsert] = mapExpect.try_emplace( stringKey );
+      if( bInsert == true ) vectorGroupOrder.push_back( stringKey );
+      group_expect& expect_ = it->second;
+      auto amount_ = table_.cell_get_variant_view( uRow, 2u );
+      if( amount_.is_null() == false )
+      {
+         int64_t iAmount = amount_.as_int64();
+         if( expect_.m_uCount == 0 || iAmount < expect_.m_iMin ) expect_.m_iMin = iAmount;
+         if( expect_.m_uCount == 0 || iAmount > expect_.m_iMax ) expect_.m_iMax = iAmount;
+         expect_.m_uCount++;
+         expect_.m_iSum += iAmount;
+      }
+      expect_.m_dSum += table_.cell_get_variant_view( uRow, 3u ).as_double();
+      expect_.m_uPriceCount++;
+      auto code_ = table_.cell_get_variant_view( uRow, 4u );
+      if( code_.is_null() == false ) expect_.m_setCode.insert( code_.as_int64() );
+   }
+
+   const std::vector<aggregate_column> vectorAggregate = { { eAggregateCount, 2 }, { eAggregateSum, 2 }, { eAggregateMin, 2 }, { eAggregateMax, 2 }, { eAggregateAvg, 3, "avg" }, { eAggregateCountDistinct, 4, "codes" } };
+   for( unsigned uThreadCount : { 1u, 4u } )
+   {
+      dto::table tableResult( 64u, 0 );
+      aggregate<dto::table>( &table_ ).group_by( { 0, 1 }, vectorAggregate, tableResult, uThreadCount );
+      REQUIRE( tableResult.get_column_count() == 8 );
+      REQUIRE( tableResult.column_get_name( 6 ) == std::string_view( "avg" ) );
+      REQUIRE( tableResult.get_row_count() == vectorGroupOrder.size() );
+
+      for( uint64_t uRow = 0; uRow < tableResult.get_row_count(); uRow++ )
+      {
+         std::string stringKey = key_s( tableResult.cell_get_variant_view( uRow, 0u ) ) + "|" + key_s( tableResult.cell_get_variant_view( uRow, 1u ) );
+         INFO( "threads: " << uThreadCount << ", group: " << stringKey );
+         REQUIRE( stringKey == vectorGroupOrder[uRow] );
+         const group_expect& expect_ = mapExpect[stringKey];
+         REQUIRE( tableResult.cell_get_variant_view( uRow, 2u ).as_uint64() == expect_.m_uCount );
+         if( expect_.m_uCount > 0 )
+         {
+            REQUIRE( tableResult.cell_get_variant_view( uRow, 3u ).as_int64() == expect_.m_iSum );
+            REQUIRE( tableResult.cell_get_variant_view( uRow, 4u ).as_int64() == expect_.m_iMin );
+            REQUIRE( tableResult.cell_get_variant_view( uRow, 5u ).as_int64() == expect_.m_iMax );
+         }
+         else REQUIRE( tableResult.cell_get_variant_view( uRow, 3u ).is_null() == true );
+         REQUIRE( tableResult.cell_get_variant_view( uRow, 6u ).as_double() == Catch::Approx( expect_.m_dSum / expect_.m_uPriceCount ) );
+         REQUIRE( tableResult.cell_get_variant_view( uRow, 7u ).as_uint64() == expect_.m_setCode.size() );
+      }
+   }
+}
+
+TEST_CASE( "[table] aggregate values in one column", "[table]" ) {
+   auto table_ = make_aggregate_table_s( 1000 );
+   aggregate<dto::table> aggregate_( &table_ );
+
+   uint64_t uCount = 0;
+   int64_t iMin = 1000, iMax = -1000;
+   double dSum = 0;
+   std::set<int64_t> setAmount;
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      auto amount_ = table_.cell_get_variant_view( uRow, 2u );
+      if( amount_.is_null() == true ) continue;                                // null values are skipped
+      int64_t iAmount = amount_.as_int64();
+      uCount++;
+      dSum += (double)iAmount;
+      iMin = std::min( iMin, iAmount );
+      iMax = std::max( iMax, iAmount );
+      setAmount.insert( iAmount );
+   }
+
+   REQUIRE( aggregate_.count( 2 ) == uCount );
+   REQUIRE( aggregate_.min( 2 ).as_int64() == iMin );
+   REQUIRE( aggregate_.max( 2 ).as_int64() == iMax );
+   REQUIRE( aggregate_.avg( 2 ) == Catch::Approx( dSum / uCount ) );
+   REQUIRE( aggregate_.count_distinct( 2 ) == setAmount.size() );
+   REQUIRE( aggregate_.count_distinct( 1 ) == 5 );
+}
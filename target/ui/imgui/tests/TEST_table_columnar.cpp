@@ -0,0 +1,93 @@
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// add columns and rows, table with same flags except columnar get the same values
+   void make_columnar_table_s( dto::table& table_, unsigned uRowCount )
+   {
+      table_.column_add( "int32", 0, "key" );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "string", 20, "code" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "uint8", 0, "small" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringCode = "code" + std::to_string( u % 40 );
+         std::string stringName = "name" + std::to_string( u % 7 );
+         table_.row_add( { (int)( u % 31 ) - 15, (int64_t)u * 1000, u * 0.25, stringCode, stringName, (unsigned)( u % 200 ) }, tag_convert{} );
+         if( u % 9 == 0 ) table_.cell_set_null( (uint64_t)u, u % 6 );
+      }
+   }
+
+   /// compare all values in two tables, returns description for first difference or empty string if equal
+   std::string compare_columnar_s( const dto::table& t1, const dto::table& t2 )
+   {
+      if( t1.get_row_count() != t2.get_row_count() ) return "row count";
+      for( uint64_t uRow = 0; uRow < t1.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < t1.get_column_count(); uColumn++ )
+         {
+            auto v1_ = t1.cell_get_variant_view( uRow, uColumn );
+            auto v2_ = t2.cell_get_variant_view( uRow, uColumn );
+            if( v1_.is_null() != v2_.is_null() || ( v1_.is_null() == false && v1_.as_string() != v2_.as_string() ) ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn );
+         }
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] columnar table has same values as row table", "[table]" ) {
+   dto::table tableRow( 10u, dto::table::eTableFlagNull32 | dto::table::eTableFlagRowStatus );
+   dto::table tableColumnar( 10u, dto::table::eTableFlagNull32 | dto::table::eTableFlagRowStatus | dto::table::eTableFlagColumnar );
+   make_columnar_table_s( tableRow, 300 );                                      // tables grow several times
+   make_columnar_table_s( tableColumnar, 300 );
+   REQUIRE( tableColumnar.is_columnar() == true );
+   REQUIRE( compare_columnar_s( tableRow, tableColumnar ) == "" );
+
+   for( auto* ptable : { &tableRow, &tableColumnar } )
+   {
+      ptable->swap( 3, 250 );
+      ptable->erase( 10, 20 );
+      ptable->cell_set( 5, 4u, gd::variant_view( "changed" ), tag_convert{} );
+      ptable->cell_set_null( 6, 1u );
+      ptable->row_add( { 1, (int64_t)2, 3.0, "four", "five", 6u }, tag_convert{} );
+   }
+   REQUIRE( compare_columnar_s( tableRow, tableColumnar ) == "" );
+   REQUIRE( tableRow.count_used_rows() == tableColumnar.count_used_rows() );
+
+   for( auto* ptable : { &tableRow, &tableColumnar } ) ptable->sort( { { 0 }, { 2, false } }, tag_sort_typed{} );
+   REQUIRE( compare_columnar_s( tableRow, tableColumnar ) == "" );
+
+   for( int64_t iFind : { (int64_t)0, (int64_t)42000, (int64_t)299000, (int64_t)-1 } )
+   {
+      INFO( "find: " << iFind );
+      REQUIRE( tableRow.find( 1u, gd::variant_view( iFind ) ) == tableColumnar.find( 1u, gd::variant_view( iFind ) ) );
+   }
+   REQUIRE( tableRow.find( 3u, gd::variant_view( "code17" ) ) == tableColumnar.find( 3u, gd::variant_view( "code17" ) ) );
+}
+
+TEST_CASE( "[table] columnar table stores each column in its own array", "[table]" ) {
+   dto::table table_( 10u, dto::table::eTableFlagNull32 | dto::table::eTableFlagColumnar );
+   make_columnar_table_s( table_, 200 );
+
+   const unsigned uColumn = 1;                                                 // int64 column
+   REQUIRE( table_.cell_get_stride( uColumn ) == sizeof( int64_t ) );
+   const uint8_t* puValue = table_.column_get_data( uColumn );
+   const uint64_t* puNull = table_.column_get_null( uColumn );
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++, puValue += table_.cell_get_stride( uColumn ) )
+   {
+      INFO( "row: " << uRow );
+      bool bNull = ( puNull[uRow >> 6] & ( 1ull << ( uRow & 63 ) ) ) != 0;
+      REQUIRE( bNull == ( uRow % 9 == 0 && uRow % 6 == uColumn ) );
+      REQUIRE( table_.cell_get( uRow, uColumn ) == puValue );
+      if( bNull == false ) REQUIRE( *(const int64_t*)puValue == (int64_t)uRow * 1000 );
+   }
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_index.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with key, name and value columns
+   dto::table make_diff_table_s()
+   {
+      return dto::table( dto::table::eTableFlagNull32, { { "int64", 0, "key" }, { "rstring", 0, "name" }, { "double", 0, "value" } }, tag_prepare{} );
+   }
+
+   /// row values as text with key as map key, null values are "<null>"
+   std::map<int64_t, std::string> read_rows_s( const dto::table& table_ )
+   {
+      std::map<int64_t, std::string> mapRow;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         std::string stringRow;
+         for( unsigned uColumn = 1; uColumn < table_.get_column_count(); uColumn++ )
+         {
+            auto value_ = table_.cell_get_variant_view( uRow, uColumn );
+            stringRow += ( value_.is_null() == true ? std::string( "<null>" ) : value_.as_string() ) + "|";
+         }
+         mapRow[table_.cell_get_variant_view( uRow, 0u ).as_int64()] = stringRow;
+      }
+      return mapRow;
+   }
+
+   /// find row for key, returns -1 if not found
+   int64_t find_key_s( const dto::table& table_, int64_t iKey )
+   {
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ ) { if( table_.cell_get_variant_view( uRow, 0u ).as_int64() == iKey ) return (int64_t)uRow; }
+      return -1;
+   }
+}
+
+TEST_CASE( "[table] diff and apply between table versions", "[table]" ) {
+   for( bool bCache : { false, true } )
+   {
+      INFO( "row hash cache: " << bCache );
+      auto tableOld = make_diff_table_s();
+      auto tableNew = make_diff_table_s();
+      for( int i = 0; i < 1000; i++ )
+      {
+         std::string stringName = "name" + std::to_string( i % 50 );
+         tableOld.row_add( { (int64_t)i, stringName, i * 0.5 }, tag_convert{} );
+         if( i % 13 == 0 ) tableOld.cell_set_null( (uint64_t)i, 2u );
+      }
+
+      // ## new version in other order, names are added in other order so reference codes differ
+      for( int i = 1049; i >= 0; i-- )
+      {
+         if( i < 1000 && i % 10 == 3 ) continue;                               // deleted
+         std::string stringName = "name" + std::to_string( i % 50 );
+         double dValue = i * 0.5;
+         if( i < 1000 && i % 7 == 0 ) { dValue = -1.0; }                       // modified
+         if( i < 1000 && i % 11 == 0 ) { stringName = "other"; }               // modified
+         tableNew.row_add( { (int64_t)i, stringName, dValue }, tag_convert{} );
+         if( i % 13 == 0 && !( i < 1000 && i % 7 == 0 ) ) tableNew.cell_set_null( tableNew.get_row_count() - 1, 2u );
+      }
+
+      if( bCache == true )
+      {
+         tableOld.index_add( { 0, 1, 2 }, tag_index_row_hash{} );
+         tableNew.index_add( { 0, 1, 2 }, tag_index_row_hash{} );
+         tableOld.cell_set( 0, 2u, gd::variant_view( 0.0 ), tag_convert{} );   // cached hash is cleared when row is modified
+      }
+
+      auto mapOld = read_rows_s( tableOld );
+      auto mapNew = read_rows_s( tableNew );
+      auto diff_ = tableOld.diff( tableNew, { 0 } );
+
+      // ## compare diff with result from maps
+      std::vector<int64_t> vectorInsert, vectorDelete, vectorModify;
+      for( const auto& [iKey, stringRow] : mapNew ) { if( mapOld.find( iKey ) == mapOld.end() ) vectorInsert.push_back( iKey ); }
+      for( const auto& [iKey, stringRow] : mapOld )
+      {
+         auto itNew = mapNew.find( iKey );
+         if( itNew == mapNew.end() ) vectorDelete.push_back( iKey );
+         else if( itNew->second != stringRow ) vectorModify.push_back( iKey );
+      }
+
+      std::vector<int64_t> vectorDiffInsert, vectorDiffDelete, vectorDiffModify;
+      for( auto uRow : diff_.m_vectorInsert ) vectorDiffInsert.push_back( tableNew.cell_get_variant_view( uRow, 0u ).as_int64() );
+      for( auto uRow : diff_.m_vectorDelete ) vectorDiffDelete.push_back( tableOld.cell_get_variant_view( uRow, 0u ).as_int64() );
+      for( const auto& it : diff_.m_vectorModify )
+      {
+         REQUIRE( tableOld.cell_get_variant_view( it.first, 0u ).as_int64() == tableNew.cell_get_variant_view( it.second, 0u ).as_int64() );
+         vectorDiffModify.push_back( tableOld.cell_get_variant_view( it.first, 0u ).as_int64() );
+      }
+      std::sort( vectorDiffInsert.begin(), vectorDiffInsert.end() );
+      std::sort( vectorDiffModify.begin(), vectorDiffModify.end() );
+      REQUIRE( vectorDiffInsert == vectorInsert );
+      REQUIRE( vectorDiffDelete == vectorDelete );
+      REQUIRE( vectorDiffModify == vectorModify );
+
+      // ## old table get same rows as new table
+      tableOld.apply( tableNew, diff_ );
+      REQUIRE( tableOld.get_row_count() == tableNew.get_row_count() );
+      REQUIRE( read_rows_s( tableOld ) == mapNew );
+      REQUIRE( tableOld.diff( tableNew, { 0 } ).empty() == true );
+   }
+}
+
+TEST_CASE( "[table] row hash for equal rows in different tables", "[table]" ) {
+   auto table1 = make_diff_table_s();
+   auto table2 = make_diff_table_s();
+   table2.row_add( { (int64_t)-1, "first", 0.0 }, tag_convert{} );           // reference codes differ between tables
+   for( int i = 0; i < 100; i++ )
+   {
+      table1.row_add( { (int64_t)i, "name" + std::to_string( i ), i * 1.0 }, tag_convert{} );
+      table2.row_add( { (int64_t)i, "name" + std::to_string( i ), i * 1.0 }, tag_convert{} );
+   }
+   table1.cell_set_null( 5, 2u );
+   table2.cell_set_null( 7, 2u );                                             // key 6, table2 has one row before keys
+
+   for( int64_t iKey = 0; iKey < 100; iKey++ )
+   {
+      INFO( "key: " << iKey );
+      uint64_t uRow1 = (uint64_t)find_key_s( table1, iKey ), uRow2 = (uint64_t)find_key_s( table2, iKey );
+      bool bEqual = iKey != 5 && iKey != 6;
+      REQUIRE( ( table1.row_hash( uRow1 ) == table2.row_hash( uRow2 ) ) == bEqual );
+      REQUIRE( table1.row_hash( uRow1, { 0, 1 } ) == table2.row_hash( uRow2, { 0, 1 } ) );
+   }
+   REQUIRE( table1.row_hash( 1 ) != table1.row_hash( 2 ) );
+
+   // ## cached hash match calculated hash after rows are modified and moved
+   auto* pindex = table1.index_add( { 0, 1, 2 }, tag_index_row_hash{} );
+   REQUIRE( table1.index_get_row_hash() == pindex );
+   for( uint64_t uRow = 0; uRow < table1.get_row_count(); uRow++ ) REQUIRE( pindex->get( uRow ) == table1.row_hash( uRow ) );
+   table1.cell_set( 10, 1u, gd::variant_view( "changed" ), tag_convert{} );
+   table1.swap( 20, 30 );
+   table1.erase( 40, 5 );
+   table1.row_add( { (int64_t)1000, "added", 1.0 }, tag_convert{} );
+   REQUIRE( pindex->size() == table1.get_row_count() );
+   for( uint64_t uRow = 0; uRow < table1.get_row_count(); uRow++ )
+   {
+      INFO( "row: " << uRow );
+      REQUIRE( pindex->get( uRow ) == table1.row_hash( uRow ) );
+   }
+}
@@ -0,0 +1,115 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with group, city, value and name, some groups and cities are null
+   dto::table make_distinct_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 | uFlags );
+      table_.column_add( "int32", 0, "group" );
+      table_.column_add( "rstring", 0, "city" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringCity = "city" + std::to_string( ( u * 7 ) % 23 );
+         std::string stringName = "name" + std::to_string( u % 3 );
+         table_.row_add( { (int)( u % 5 ), stringCity, ( u % 4 ) * 0.5, stringName }, tag_convert{} );
+         if( u % 19 == 0 ) table_.cell_set_null( (uint64_t)u, 0u );
+         if( u % 29 == 0 ) table_.cell_set_null( (uint64_t)u, 1u );
+      }
+      return table_;
+   }
+
+   /// key for values in columns, null is "<null>"
+   std::string key_s( const dto::table& table_, uint64_t uRow, const std::vector<unsigned>& vectorColumn )
+   {
+      std::string stringKey;
+      for( auto uColumn : vectorColumn )
+      {
+         auto value_ = table_.cell_get_variant_view( uRow, uColumn );
+         stringKey += ( value_.is_null() == true ? std::string( "<null>" ) : value_.as_string() ) + "|";
+      }
+      return stringKey;
+   }
+
+   /// compare distinct rows and counts with result from map, returns description for first difference
+   std::string compare_distinct_s( const dto::table& table_, const std::vector<unsigned>& vectorColumn )
+   {
+      std::vector<unsigned> vectorKey = vectorColumn;
+      if( vectorKey.empty() == true ) { for( unsigned u = 0; u < table_.get_column_count(); u++ ) vectorKey.push_back( u ); }
+
+      std::map<std::string, std::pair<uint64_t, uint64_t>> mapKey;             // key -> first row and count
+      std::vector<uint64_t> vectorExpected;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         auto [it, bInsert] = mapKey.try_emplace( key_s( table_, uRow, vectorKey ), uRow, 0 );
+         if( bInsert == true ) vectorExpected.push_back( uRow );
+         it->second.second++;
+      }
+
+      std::vector<uint64_t> vectorRow, vectorCount;
+      table_.distinct( vectorColumn, vectorRow, &vectorCount );
+      if( vectorRow != vectorExpected ) return "rows, " + std::to_string( vectorRow.size() ) + " != " + std::to_string( vectorExpected.size() );
+      if( vectorCount.size() != vectorRow.size() ) return "count size";
+      for( std::size_t u = 0; u < vectorRow.size(); u++ )
+      {
+         if( vectorCount[u] != mapKey[key_s( table_, vectorRow[u], vectorKey )].second ) return "count for row " + std::to_string( vectorRow[u] );
+      }
+      if( table_.distinct( vectorColumn, tag_row{} ) != vectorExpected ) return "rows with tag_row";
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] distinct rows and counts", "[table]" ) {
+   for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagDictionary, (unsigned)dto::table::eTableFlagColumnar } )
+   {
+      INFO( "flags: " << uFlags );
+      auto table_ = make_distinct_table_s( uFlags, 5000 );                     // more unique values than first hash table size
+      table_.cell_set( 4000, 3u, gd::variant_view( "unique" ), tag_convert{} );
+
+      for( const auto& vectorColumn : std::vector< std::vector<unsigned> >{ { 0 }, { 1 }, { 0, 1 }, { 1, 0, 3 }, { 2 }, {} } )
+      {
+         INFO( "columns: " << vectorColumn.size() );
+         REQUIRE( compare_distinct_s( table_, vectorColumn ) == "" );
+      }
+
+      // ## null key is one distinct value
+      std::vector<uint64_t> vectorRow, vectorCount;
+      table_.distinct( { 0 }, vectorRow, &vectorCount );
+      REQUIRE( vectorRow.size() == 6 );
+      REQUIRE( vectorRow[0] == 0 );                                              // row 0 has null group
+      REQUIRE( table_.cell_is_null( vectorRow[0], 0u ) == true );
+      REQUIRE( vectorCount[0] == ( 5000 + 18 ) / 19 );
+   }
+}
+
+TEST_CASE( "[table] distinct rows to table", "[table]" ) {
+   auto table_ = make_distinct_table_s( 0, 1000 );
+
+   dto::table tableDistinct;
+   table_.distinct( { 1, 3 }, tableDistinct );
+   REQUIRE( tableDistinct.get_column_count() == 2 );
+   REQUIRE( tableDistinct.is_null() == true );
+
+   auto vectorRow = table_.distinct( { 1, 3 }, tag_row{} );
+   REQUIRE( tableDistinct.get_row_count() == vectorRow.size() );
+   for( uint64_t u = 0; u < vectorRow.size(); u++ )
+   {
+      INFO( "row: " << u );
+      REQUIRE( tableDistinct.cell_is_null( u, 0u ) == table_.cell_is_null( vectorRow[u], 1u ) );
+      if( tableDistinct.cell_is_null( u, 0u ) == false ) { REQUIRE( tableDistinct.cell_get_variant_view( u, 0u ).as_string() == table_.cell_get_variant_view( vectorRow[u], 1u ).as_string() ); }
+      REQUIRE( tableDistinct.cell_get_variant_view( u, 1u ).as_string() == table_.cell_get_variant_view( vectorRow[u], 3u ).as_string() );
+   }
+
+   dto::table tableEmpty( dto::table::eTableFlagNull32, { { "int32", 0, "group" }, { "rstring", 0, "city" }, { "double", 0, "value" }, { "rstring", 0, "name" } }, tag_prepare{} );
+   REQUIRE( tableEmpty.distinct( { 0 }, tag_row{} ).empty() == true );
+}
@@ -0,0 +1,206 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with number and text columns, every 11th row has null values
+   dto::table make_filter_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 64u, dto::table::eTableFlagNull32 | uFlags );
+      table_.column_add( "int32", 0, "int32" );
+      table_.column_add( "int64", 0, "int64" );
+      table_.column_add( "double", 0, "double" );
+      table_.column_add( "uint16", 0, "uint16" );
+      table_.column_add( "rstring", 0, "text" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         int iValue = (int)( u % 21 ) - 10;
+         std::string stringText = "t" + std::to_string( u % 9 );
+         table_.row_add( { iValue, (int64_t)iValue * 1000, iValue + 0.5, (unsigned)( u % 500 ), stringText }, tag_convert{} );
+         if( u % 11 == 0 ) { for( unsigned uColumn = 0; uColumn < 5; uColumn++ ) table_.cell_set_null( (uint64_t)u, uColumn ); }
+      }
+      return table_;
+   }
+
+   /// check one value against filter, same logic as filter in table but row by row
+   bool filter_match_s( const gd::variant_view& value_, enumFilter eFilter, const std::vector<gd::variant_view>& vectorValue )
+   {
+      if( eFilter == eFilterNull ) return value_.is_null();
+      if( eFilter == eFilterNotNull ) return value_.is_null() == false;
+      if( value_.is_null() == true ) return false;
+
+      auto compare_ = [&value_]( const gd::variant_view& v_ ) -> int {
+         if( value_.is_string() == true ) { std::string s1 = value_.as_string(), s2 = v_.as_string(); return s1 < s2 ? -1 : ( s2 < s1 ? 1 : 0 ); }
+         double d1 = value_.as_double(), d2 = v_.as_double();
+         return d1 < d2 ? -1 : ( d2 < d1 ? 1 : 0 );
+      };
+
+      switch( eFilter )
+      {
+      case eFilterEqual:        return compare_( vectorValue[0] ) == 0;
+      case eFilterNotEqual:     return compare_( vectorValue[0] ) != 0;
+      case eFilterLess:         return compare_( vectorValue[0] ) < 0;
+      case eFilterLessEqual:    return compare_( vectorValue[0] ) <= 0;
+      case eFilterGreater:      return compare_( vectorValue[0] ) > 0;
+      case eFilterGreaterEqual: return compare_( vectorValue[0] ) >= 0;
+      case eFilterBetween:      return compare_( vectorValue[0] ) >= 0 && compare_( vectorValue[1] ) <= 0;
+      case eFilterIn:           for( const auto& it : vectorValue ) { if( compare_( it ) == 0 ) return true; } return false;
+      default: return false;
+      }
+   }
+
+   /// compare number value with filter values at full precision
+   bool filter_number_s( double dValue, enumFilter eFilter, double d1, double d2 )
+   {
+      switch( eFilter )
+      {
+      case eFilterEqual:        return dValue == d1;
+      case eFilterNotEqual:     return dValue != d1;
+      case eFilterLess:         return dValue < d1;
+      case eFilterLessEqual:    return dValue <= d1;
+      case eFilterGreater:      return dValue > d1;
+      case eFilterGreaterEqual: return dValue >= d1;
+      case eFilterBetween:      return dValue >= d1 && dValue <= d2;
+      default: return false;
+      }
+   }
+
+   /// compare filter result with row by row check, returns description for first row that differs
+   std::string compare_filter_s( const dto::table& table_, unsigned uColumn, enumFilter eFilter, double d1, double d2, const selection& selectionRow )
+   {
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         auto value_ = table_.cell_get_variant_view( uRow, uColumn );
+         bool bExpect = value_.is_null() == false && filter_number_s( value_.as_double(), eFilter, d1, d2 );
+         if( selectionRow.is_set( uRow ) != bExpect ) return "row " + std::to_string( uRow ) + ", column " + std::string( table_.column_get_name( uColumn ) ) + ", filter " + std::to_string( eFilter ) + ", value " + std::to_string( d1 ) + ", cell " + value_.as_string();
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] filter compared with row by row check", "[table]" ) {
+   // ## filter values for each column, first two are used for compare operators and between
+   const std::vector< std::vector<gd::variant_view> > vectorColumnValue = {
+      { gd::variant_view( 3 ), gd::variant_view( 7 ), gd::variant_view( -2 ) },
+      { gd::variant_view( (int64_t)-4000 ), gd::variant_view( (int64_t)2000 ), gd::variant_view( (int64_t)9000 ) },
+      { gd::variant_view( -3.5 ), gd::variant_view( 4.5 ), gd::variant_view( 0.5 ) },
+      { gd::variant_view( 100u ), gd::variant_view( 420u ), gd::variant_view( 7u ) },
+      { gd::variant_view( "t2" ), gd::variant_view( "t6" ), gd::variant_view( "t8" ) },
+   };
+
+   for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagColumnar } )
+   {
+      auto table_ = make_filter_table_s( uFlags, 1000 );                         // 1000 rows, last 64 bit block in selection is partly used
+      for( unsigned uColumn = 0; uColumn < table_.get_column_count(); uColumn++ )
+      {
+         for( unsigned uFilter = eFilterEqual; uFilter <= eFilterNotNull; uFilter++ )
+         {
+            std::vector<gd::variant_view> vectorValue = vectorColumnValue[uColumn];
+            if( uFilter == eFilterBetween ) vectorValue.resize( 2 );
+            else if( uFilter != eFilterIn ) vectorValue.resize( 1 );
+
+            selection selectionRow;
+            table_.filter( uColumn, (enumFilter)uFilter, vectorValue, selectionRow );
+            REQUIRE( selectionRow.size() == table_.get_row_count() );
+            for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+            {
+               INFO( "flags: " << uFlags << ", column: " << uColumn << ", filter: " << uFilter << ", row: " << uRow );
+               REQUIRE( selectionRow.is_set( uRow ) == filter_match_s( table_.cell_get_variant_view( uRow, uColumn ), (enumFilter)uFilter, vectorValue ) );
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE( "[table] filter with fraction and out of range values", "[table]" ) {
+   const std::vector<std::string_view> vectorType = { "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64", "uint64", "float", "double" };
+   const std::vector<double> vectorFilter = { 2, 2.5, -2.5, 0.1, 127.5, 300, -300, 70000, -70000, 5e9, -5e9, 1e20, -1e20 };
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+
+   for( bool bZone : { false, true } )
+   {
+      for( unsigned uFlags : vectorFlags )
+      {
+         dto::table table_( 64u, dto::table::eTableFlagNull32 | uFlags );
+         for( auto stringType : vectorType ) table_.column_add( stringType, 0, stringType );
+         table_.prepare();
+         if( bZone == true ) table_.index_add( { 0, 1, 4, 5, 6, 8 }, 64, tag_index_zone{} );
+
+         for( int iRow = 0; iRow < 9000; iRow++ )                               // more rows than in one segment, filter cross segment boundaries
+         {
+            table_.row_add( tag_null{} );
+            if( iRow % 17 == 0 ) continue;                                    // null row
+            int iValue = ( iRow % 11 ) - 5;
+            for( unsigned uColumn = 0; uColumn < vectorType.size(); uColumn++ )
+            {
+               bool bUnsigned = vectorType[uColumn][0] == 'u';
+               int64_t iCell = bUnsigned == true ? iValue + 5 : iValue;
+               if( iRow % 300 > 250 ) iCell += bUnsigned == true ? 120 : -120; // values near limits for int8 and uint8
+               if( vectorType[uColumn] == "float" || vectorType[uColumn] == "double" ) table_.cell_set( (uint64_t)iRow, uColumn, gd::variant_view( (double)iCell + ( iRow % 2 == 0 ? 0.5 : 0.0 ) ), tag_convert{} );
+               else table_.cell_set( (uint64_t)iRow, uColumn, gd::variant_view( iCell ), tag_convert{} );
+            }
+         }
+
+         for( unsigned uColumn = 0; uColumn < vectorType.size(); uColumn++ )
+         {
+            for( unsigned uFilter = eFilterEqual; uFilter <= eFilterBetween; uFilter++ )
+            {
+               for( double d1 : vectorFilter )
+               {
+                  double d2 = d1 + 3.5;
+                  std::vector<gd::variant_view> vectorValue = { gd::variant_view( d1 ), gd::variant_view( d2 ) };
+                  if( d1 == std::floor( d1 ) && std::abs( d1 ) < 1e18 ) vectorValue[0] = gd::variant_view( (int64_t)d1 );  // integer filter values are also tested
+                  if( uFilter != eFilterBetween ) vectorValue.resize( 1 );
+
+                  selection selectionRow;
+                  table_.filter( uColumn, (enumFilter)uFilter, vectorValue, selectionRow );
+                  INFO( "zone: " << bZone << ", flags: " << uFlags );
+                  REQUIRE( compare_filter_s( table_, uColumn, (enumFilter)uFilter, d1, d2, selectionRow ) == "" );
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE( "[table] combine filter selections", "[table]" ) {
+   auto table_ = make_filter_table_s( 0, 300 );
+
+   selection selectionLess, selectionText;
+   table_.filter( 0u, eFilterLess, gd::variant_view( 0 ), selectionLess );
+   table_.filter( 4u, eFilterEqual, gd::variant_view( "t4" ), selectionText );
+
+   selection selectionAnd = selectionLess;
+   selectionAnd &= selectionText;
+   selection selectionOr = selectionLess;
+   selectionOr |= selectionText;
+
+   selection selectionFilterAnd = selectionLess;                               // filter on selected rows
+   table_.filter( 4u, eFilterEqual, { gd::variant_view( "t4" ) }, selectionFilterAnd, true );
+
+   std::vector<uint64_t> vectorAnd;
+   uint64_t uOrCount = 0;
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      auto key_ = table_.cell_get_variant_view( uRow, 0u );
+      bool bLess = key_.is_null() == false && key_.as_int64() < 0;
+      bool bText = table_.cell_get_variant_view( uRow, 4u ).is_null() == false && table_.cell_get_variant_view( uRow, 4u ).as_string() == "t4";
+      if( bLess == true && bText == true ) vectorAnd.push_back( uRow );
+      if( bLess == true || bText == true ) uOrCount++;
+   }
+
+   REQUIRE( vectorAnd.empty() == false );
+   REQUIRE( selectionAnd.to_rows() == vectorAnd );
+   REQUIRE( selectionFilterAnd.to_rows() == vectorAnd );
+   REQUIRE( selectionOr.count() == uOrCount );
+
+   selectionOr.invert();
+   REQUIRE( selectionOr.count() == table_.get_row_count() - uOrCount );
+}
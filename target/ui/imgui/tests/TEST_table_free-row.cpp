@@ -0,0 +1,101 @@
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// find first free row by reading row state for each reserved row
+   int64_t find_free_row_s( const dto::table& table_, uint64_t uStartRow )
+   {
+      for( uint64_t uRow = uStartRow; uRow < table_.get_reserved_row_count(); uRow++ )
+      {
+         if( table_.row_is_use( uRow ) == false ) return (int64_t)uRow;
+      }
+      return -1;
+   }
+
+   /// compare free row bitmap with row state values, returns description for first difference or empty string if equal
+   std::string compare_free_row_s( const dto::table& table_ )
+   {
+      uint64_t uUsed = 0;
+      for( uint64_t uRow = 0; uRow < table_.get_reserved_row_count(); uRow++ ) { if( table_.row_is_use( uRow ) == true ) uUsed++; }
+      if( table_.count_used_rows() != uUsed ) return "used rows " + std::to_string( table_.count_used_rows() ) + " != " + std::to_string( uUsed );
+      if( table_.count_free_rows() != table_.get_reserved_row_count() - uUsed ) return "free rows";
+      for( uint64_t uStart : { 0ull, 1ull, 63ull, 64ull, 100ull, 500ull, 1023ull } )
+      {
+         if( table_.find_first_free_row( uStart ) != find_free_row_s( table_, uStart ) ) return "first free row from " + std::to_string( uStart );
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] free row bitmap match row state", "[table]" ) {
+   for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagSegmented } )
+   {
+      INFO( "flags: " << uFlags );
+      dto::table table_( 1024u, dto::table::eTableFlagNull32 | dto::table::eTableFlagRowStatus | uFlags );
+      if( uFlags != 0 ) table_.segment_set_row_count( 256 );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.prepare();
+      for( int i = 0; i < 600; i++ ) table_.row_add( { (int64_t)i, "name" + std::to_string( i % 7 ) }, tag_convert{} );
+      REQUIRE( table_.count_used_rows() == 0 );                                  // rows are marked as used by caller
+      for( uint64_t uRow = 0; uRow < 600; uRow++ ) table_.row_set_state( uRow, dto::table::eRowStateUse );
+      REQUIRE( compare_free_row_s( table_ ) == "" );
+      REQUIRE( table_.count_used_rows() == 600 );
+
+      // ## free rows are updated in bitmap when state is set
+      for( uint64_t uRow = 0; uRow < 600; uRow += 3 ) table_.row_set_state( uRow, 0 );
+      REQUIRE( compare_free_row_s( table_ ) == "" );
+      REQUIRE( table_.find_first_free_row() == 0 );
+      table_.row_set_state( 0, dto::table::eRowStateUse );
+      REQUIRE( table_.find_first_free_row() == 3 );
+      table_.row_set_state( 3, dto::table::eRowStateUse, 0 );
+      REQUIRE( compare_free_row_s( table_ ) == "" );
+
+      // ## operations that move rows
+      table_.swap( 1, 500 );
+      REQUIRE( compare_free_row_s( table_ ) == "" );
+      table_.erase( 10, 40 );
+      REQUIRE( compare_free_row_s( table_ ) == "" );
+
+      // ## state written without row_set_state needs invalidate
+      *table_.row_get_state( 4 ) = 0;
+      table_.row_free_invalidate();
+      REQUIRE( compare_free_row_s( table_ ) == "" );
+   }
+}
+
+TEST_CASE( "[table] vacuum remove rows that are not used", "[table]" ) {
+   dto::table table_( 100u, dto::table::eTableFlagNull32 | dto::table::eTableFlagRowStatus );
+   table_.column_add( "int64", 0, "id" );
+   table_.column_add( "rstring", 0, "name" );
+   table_.prepare();
+   for( int i = 0; i < 1000; i++ ) table_.row_add( { (int64_t)i, "name" + std::to_string( i ) }, tag_convert{} );
+
+   std::vector<int64_t> vectorKeep;
+   for( uint64_t uRow = 0; uRow < 1000; uRow++ )
+   {
+      if( uRow % 4 == 1 ) continue;
+      table_.row_set_state( uRow, dto::table::eRowStateUse );
+      vectorKeep.push_back( (int64_t)uRow );
+   }
+   uint64_t uReferenceCount = table_.get_references().size();
+
+   REQUIRE( table_.vacuum() == 250 );
+   REQUIRE( table_.get_row_count() == 750 );
+   REQUIRE( table_.count_used_rows() == 750 );
+   REQUIRE( compare_free_row_s( table_ ) == "" );
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      INFO( "row: " << uRow );
+      REQUIRE( table_.cell_get_variant_view( uRow, 0u ).as_int64() == vectorKeep[uRow] );   // used rows keep their order
+      REQUIRE( table_.cell_get_variant_view( uRow, 1u ).as_string() == "name" + std::to_string( vectorKeep[uRow] ) );
+   }
+   REQUIRE( table_.get_references().size() == uReferenceCount - 250 );       // names for removed rows are removed from references
+   REQUIRE( table_.vacuum() == 0 );
+}
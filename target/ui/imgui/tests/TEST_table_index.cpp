@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_index.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// rows where key and name have values that match, found with table scan
+   std::vector<uint64_t> index_scan_s( const dto::table& table_, const gd::variant_view* pkey, const std::string* pstringName )
+   {
+      std::vector<uint64_t> vectorRow;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         auto key_ = table_.cell_get_variant_view( uRow, 0u );
+         auto name_ = table_.cell_get_variant_view( uRow, 1u );
+         if( pkey != nullptr && ( key_.is_null() == true || key_.as_int64() != pkey->as_int64() ) ) continue;
+         if( pstringName != nullptr && ( name_.is_null() == true || name_.as_string() != *pstringName ) ) continue;
+         vectorRow.push_back( uRow );
+      }
+      return vectorRow;
+   }
+
+   /// check all indexes in table against table scan, returns description for first difference
+   std::string index_check_s( const dto::table& table_, const index_hash* phash, const index_hash* phash2, const index_ordered* pordered )
+   {
+      for( int64_t iKey = -1; iKey < 25; iKey++ )
+      {
+         gd::variant_view key_( iKey );
+         std::vector<uint64_t> vectorRow;
+         phash->find( { key_ }, vectorRow );
+         std::sort( vectorRow.begin(), vectorRow.end() );
+         if( vectorRow != index_scan_s( table_, &key_, nullptr ) ) return "hash find key " + std::to_string( iKey );
+
+         std::string stringName = "n" + std::to_string( iKey % 7 );
+         vectorRow.clear();
+         phash2->find( { key_, gd::variant_view( stringName ) }, vectorRow );
+         std::sort( vectorRow.begin(), vectorRow.end() );
+         if( vectorRow != index_scan_s( table_, &key_, &stringName ) ) return "hash find key and name " + std::to_string( iKey );
+      }
+
+      // ## ordered index has all rows with values sorted on name and key
+      const auto& vectorOrdered = pordered->rows();
+      uint64_t uValueCount = 0;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ ) { if( table_.cell_get_variant_view( uRow, 0u ).is_null() == false && table_.cell_get_variant_view( uRow, 1u ).is_null() == false ) uValueCount++; }
+      if( vectorOrdered.size() != uValueCount ) return "ordered row count";
+      for( std::size_t u = 1; u < vectorOrdered.size(); u++ )
+      {
+         std::string string1 = table_.cell_get_variant_view( vectorOrdered[u - 1], 1u ).as_string();
+         std::string string2 = table_.cell_get_variant_view( vectorOrdered[u], 1u ).as_string();
+         if( string1 > string2 ) return "ordered name at " + std::to_string( u );
+         if( string1 == string2 && table_.cell_get_variant_view( vectorOrdered[u - 1], 0u ).as_int64() > table_.cell_get_variant_view( vectorOrdered[u], 0u ).as_int64() ) return "ordered key at " + std::to_string( u );
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] hash and ordered index follow table changes", "[table]" ) {
+   dto::table table_( 64u, dto::table::eTableFlagNull32 );
+   table_.column_add( "int64", 0, "key" );
+   table_.column_add( "rstring", 0, "name" );
+   table_.column_add( "int32", 0, "value" );
+   table_.prepare();
+   auto* phash = table_.index_add( { 0 }, tag_index_hash{} );
+   auto* phash2 = table_.index_add( { 0, 1 }, tag_index_hash{} );
+   auto* pordered = table_.index_add( { 1, 0 }, tag_index_ordered{} );
+
+   for( int i = 0; i < 500; i++ )
+   {
+      std::string stringName = "n" + std::to_string( i % 7 );
+      table_.row_add( { (int64_t)( i % 23 ), stringName, i }, tag_convert{} );
+   }
+   REQUIRE( index_check_s( table_, phash, phash2, pordered ) == "" );
+
+   // ## rows are filled cell by cell, indexes are updated when searched
+   for( int i = 0; i < 100; i++ )
+   {
+      table_.row_add( tag_null{} );
+      uint64_t uRow = table_.get_row_count() - 1;
+      table_.cell_set( uRow, 0u, gd::variant_view( (int64_t)( i % 5 ) ), tag_convert{} );
+      if( i % 3 != 0 ) table_.cell_set( uRow, 1u, gd::variant_view( "n" + std::to_string( i % 4 ) ), tag_convert{} );
+   }
+   REQUIRE( index_check_s( table_, phash, phash2, pordered ) == "" );
+
+   table_.cell_set( 10, 0u, gd::variant_view( (int64_t)24 ), tag_convert{} );
+   table_.cell_set_null( 11, 0u );
+   table_.cell_set( 12, 1u, gd::variant_view( "n0" ), tag_convert{} );
+   REQUIRE( index_check_s( table_, phash, phash2, pordered ) == "" );
+
+   table_.swap( 0, 400 );
+   REQUIRE( index_check_s( table_, phash, phash2, pordered ) == "" );
+
+   table_.sort( { { 2, false } }, tag_sort_typed{} );
+   REQUIRE( index_check_s( table_, phash, phash2, pordered ) == "" );
+
+   table_.erase( 50, 100 );
+   table_.row_delete();
+   REQUIRE( index_check_s( table_, phash, phash2, pordered ) == "" );
+
+   table_.row_clear();
+   REQUIRE( phash->find( { gd::variant_view( (int64_t)1 ) } ) == -1 );
+   REQUIRE( pordered->rows().empty() == true );
+}
+
+TEST_CASE( "[table] ordered index range and prefix", "[table]" ) {
+   dto::table table_( dto::table::eTableFlagNull32, { { "rstring", 0, "name"}, { "int32", 0, "value"} }, tag_prepare{} );
+   auto* pordered = table_.index_add( { 0, 1 }, tag_index_ordered{} );
+   for( int i = 0; i < 300; i++ )
+   {
+      std::string stringName = ( i % 2 == 0 ? "alpha" : "beta" ) + std::to_string( i % 13 );
+      table_.row_add( { stringName, i % 50 }, tag_convert{} );
+   }
+
+   std::vector<uint64_t> vectorRow;
+   pordered->range( { gd::variant_view( "alpha3" ) }, { gd::variant_view( "beta1" ) }, vectorRow );
+   std::vector<uint64_t> vectorExpect;
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      std::string stringName = table_.cell_get_variant_view( uRow, 0u ).as_string();
+      if( stringName >= "alpha3" && stringName <= "beta1" ) vectorExpect.push_back( uRow );
+   }
+   REQUIRE( vectorRow.size() == vectorExpect.size() );
+   std::sort( vectorRow.begin(), vectorRow.end() );
+   REQUIRE( vectorRow == vectorExpect );
+
+   vectorRow.clear();
+   pordered->prefix( "beta1", vectorRow );                                      // beta1, beta10, beta11 and beta12
+   vectorExpect.clear();
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      if( table_.cell_get_variant_view( uRow, 0u ).as_string().rfind( "beta1", 0 ) == 0 ) vectorExpect.push_back( uRow );
+   }
+   REQUIRE( vectorRow.size() == vectorExpect.size() );
+   std::sort( vectorRow.begin(), vectorRow.end() );
+   REQUIRE( vectorRow == vectorExpect );
+
+   auto iRow = pordered->find( { gd::variant_view( "alpha4" ), gd::variant_view( 4 ) } );
+   REQUIRE( iRow != -1 );
+   REQUIRE( table_.cell_get_variant_view( (uint64_t)iRow, 0u ).as_string() == "alpha4" );
+   REQUIRE( table_.cell_get_variant_view( (uint64_t)iRow, 1u ).as_int64() == 4 );
+}
+
+TEST_CASE( "[table] search indexes with pending rows from many threads", "[table]" ) {
+   dto::table table_( 64u, dto::table::eTableFlagNull32 );
+   table_.column_add( "int64", 0, "key" );
+   table_.column_add( "rstring", 0, "name" );
+   table_.prepare();
+   auto* phash = table_.index_add( { 0 }, tag_index_hash{} );
+   auto* pordered = table_.index_add( { 1, 0 }, tag_index_ordered{} );
+   table_.index_add( { 0 }, 64, tag_index_zone{} );
+
+   for( int iRound = 0; iRound < 4; iRound++ )
+   {
+      // ## add and modify rows, indexes get pending rows that is inserted by first reader
+      for( int i = 0; i < 2000; i++ )
+      {
+         table_.row_add( tag_null{} );
+         uint64_t uRow = table_.get_row_count() - 1;
+         table_.cell_set( uRow, 0, gd::variant_view( (int64_t)( uRow % 97 ) ), tag_convert{} );
+         table_.cell_set( uRow, 1, gd::variant_view( ( "n" + std::to_string( uRow % 13 ) ).c_str() ), tag_convert{} );
+      }
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow += 7 ) table_.cell_set( uRow, 0, gd::variant_view( (int64_t)( uRow % 89 ) ), tag_convert{} );
+
+      std::vector<uint64_t> vectorExpect;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ ) { if( table_.cell_get_variant_view( uRow, 0u ).as_int64() == 5 ) vectorExpect.push_back( uRow ); }
+
+      std::vector<unsigned> vectorMismatch( 4, 0 );
+      std::vector<std::thread> vectorThread;
+      for( unsigned uThread = 0; uThread < 4; uThread++ )
+      {
+         vectorThread.emplace_back( [&, uThread]() {
+            std::vector<uint64_t> vectorRow;
+            phash->find( { (int64_t)5 }, vectorRow );
+            std::sort( vectorRow.begin(), vectorRow.end() );
+            if( vectorRow != vectorExpect ) vectorMismatch[uThread]++;
+
+            selection selectionRow;
+            table_.filter( 0, eFilterEqual, gd::variant_view( (int64_t)5 ), selectionRow );
+            for( auto uRow : vectorExpect ) { if( selectionRow.is_set( uRow ) == false ) vectorMismatch[uThread]++; }
+
+            if( pordered->rows().size() != table_.get_row_count() ) vectorMismatch[uThread]++;
+         } );
+      }
+      for( auto& it : vectorThread ) it.join();
+
+      for( auto uMismatch : vectorMismatch ) REQUIRE( uMismatch == 0 );
+      unsigned uOrder = 0;                                                     // rows out of order in ordered index
+      const auto& vectorRow = pordered->rows();
+      for( std::size_t u = 1; u < vectorRow.size(); u++ )
+      {
+         if( table_.cell_get_variant_view( vectorRow[u - 1], 1u ).as_string() > table_.cell_get_variant_view( vectorRow[u], 1u ).as_string() ) uOrder++;
+      }
+      REQUIRE( uOrder == 0 );
+   }
+}
@@ -0,0 +1,172 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_io.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with number, text and reference columns, some values are null
+   dto::table make_binary_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 | uFlags );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "rstring", 0, "name", "alias_name" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "string", 16, "code" );
+      table_.column_add( "int8", 0, "small" );
+      table_.column_add( "rutf8", 0, "text" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "name" + std::to_string( u % 61 );
+         std::string stringCode = "c" + std::to_string( u );
+         std::string stringText = "åäö " + std::to_string( u % 5 );
+         table_.row_add( { (int64_t)u, stringName, u * 0.125, stringCode, (int)( u % 100 ) - 50, stringText }, tag_convert{} );
+         if( u % 11 == 0 ) table_.cell_set_null( (uint64_t)u, u % 6 );
+      }
+      return table_;
+   }
+
+   /// compare columns and values in two tables, returns description for first difference or empty string if equal
+   std::string compare_binary_s( const dto::table& t1, const dto::table& t2 )
+   {
+      if( t1.get_column_count() != t2.get_column_count() ) return "column count";
+      for( unsigned uColumn = 0; uColumn < t1.get_column_count(); uColumn++ )
+      {
+         if( t1.column_get_name( uColumn ) != t2.column_get_name( uColumn ) ) return "name for column " + std::to_string( uColumn );
+         if( t1.column_get_alias( uColumn ) != t2.column_get_alias( uColumn ) ) return "alias for column " + std::to_string( uColumn );
+         if( t1.column_get_ctype( uColumn ) != t2.column_get_ctype( uColumn ) ) return "type for column " + std::to_string( uColumn );
+      }
+      if( t1.get_row_count() != t2.get_row_count() ) return "row count";
+      for( uint64_t uRow = 0; uRow < t1.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < t1.get_column_count(); uColumn++ )
+         {
+            auto v1_ = t1.cell_get_variant_view( uRow, uColumn );
+            auto v2_ = t2.cell_get_variant_view( uRow, uColumn );
+            if( v1_.is_null() != v2_.is_null() || ( v1_.is_null() == false && v1_.as_string() != v2_.as_string() ) ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn );
+         }
+      }
+      return std::string();
+   }
+
+   /// copy file and change 32 bit value at offset, used to test that damaged files are rejected
+   void write_changed_file_s( const std::string& stringFrom, const std::string& stringTo, uint64_t uOffset, uint32_t uValue )
+   {
+      std::ifstream ifstreamFile( stringFrom, std::ios::binary );
+      std::string stringData( ( std::istreambuf_iterator<char>( ifstreamFile ) ), std::istreambuf_iterator<char>() );
+      memcpy( stringData.data() + uOffset, &uValue, sizeof( uint32_t ) );
+      std::ofstream ofstreamFile( stringTo, std::ios::binary );
+      ofstreamFile.write( stringData.data(), stringData.size() );
+   }
+}
+
+TEST_CASE( "[table] write and read binary table file", "[table]" ) {
+   std::string stringFile = ( std::filesystem::temp_directory_path() / "test_table_io-binary.bin" ).string();
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      INFO( "flags: " << uFlags );
+      auto table_ = make_binary_table_s( uFlags, 5000 );
+      auto result_ = write_g( table_, stringFile, tag_io_binary{} );
+      REQUIRE( result_.first == true );
+
+      dto::table tableRead;
+      result_ = read_g( tableRead, stringFile, tag_io_binary{} );
+      REQUIRE( result_.first == true );
+      REQUIRE( compare_binary_s( table_, tableRead ) == "" );
+      REQUIRE( tableRead.is_columnar() == table_.is_columnar() );
+      REQUIRE( tableRead.is_dictionary() == table_.is_dictionary() );
+
+      // ## memory mapped table is copied to own memory when it grows
+      dto::table tableMap;
+      result_ = read_g( tableMap, stringFile, tag_io_binary{}, tag_io_mmap{} );
+      REQUIRE( result_.first == true );
+      REQUIRE( compare_binary_s( table_, tableMap ) == "" );
+      tableMap.cell_set( 0, 1u, gd::variant_view( "changed" ), tag_convert{} );
+      for( int i = 0; i < 3000; i++ ) tableMap.row_add( { (int64_t)i, "added", 0.5, "a", 1, "b" }, tag_convert{} );
+      REQUIRE( tableMap.get_row_count() == 8000 );
+      REQUIRE( tableMap.cell_get_variant_view( 0, 1u ).as_string() == "changed" );
+      REQUIRE( tableMap.cell_get_variant_view( 4999, 0u ).as_int64() == 4999 );
+      REQUIRE( tableMap.cell_get_variant_view( 7999, 1u ).as_string() == "added" );
+
+      dto::table tableAgain;                                                   // file is not changed by edits in mapped table
+      result_ = read_g( tableAgain, stringFile, tag_io_binary{} );
+      REQUIRE( result_.first == true );
+      REQUIRE( compare_binary_s( table_, tableAgain ) == "" );
+   }
+   std::filesystem::remove( stringFile );
+}
+
+TEST_CASE( "[table] read binary table from invalid file", "[table]" ) {
+   std::string stringFile = ( std::filesystem::temp_directory_path() / "test_table_io-binary_invalid.bin" ).string();
+   dto::table table_;
+   REQUIRE( read_g( table_, stringFile + ".missing", tag_io_binary{} ).first == false );
+
+   {
+      std::ofstream ofstreamFile( stringFile, std::ios::binary );
+      ofstreamFile << "this is not a table file, this is not a table file, this is not a table file";
+   }
+   REQUIRE( read_g( table_, stringFile, tag_io_binary{} ).first == false );
+   REQUIRE( read_g( table_, stringFile, tag_io_binary{}, tag_io_mmap{} ).first == false );
+   std::filesystem::remove( stringFile );
+}
+
+TEST_CASE( "[table] read damaged binary table file", "[table]" ) {
+   std::string stringFile = ( std::filesystem::temp_directory_path() / "test_table_io-binary_damaged.bin" ).string();
+   std::string stringChanged = stringFile + ".changed";
+   auto table_ = make_binary_table_s( 0, 100 );
+   REQUIRE( write_g( table_, stringFile, tag_io_binary{} ).first == true );
+
+   uint64_t uReferenceOffset;
+   {
+      std::ifstream ifstreamFile( stringFile, std::ios::binary );
+      ifstreamFile.seekg( 72 );                                                 // m_uReferenceOffset in header
+      ifstreamFile.read( (char*)&uReferenceOffset, sizeof( uint64_t ) );
+   }
+
+   // ## offset in file, value written and text expected in error
+   const uint64_t uColumn = 96 + 32;                                           // second column, first column has no alias
+   for( const auto& [uOffset, uValue, stringError] : std::vector< std::tuple<uint64_t, uint32_t, std::string> >{
+      { 16, dto::table::eTableFlagNull32 | dto::table::eTableFlagColumnar | dto::table::eTableFlagSegmented, "flags" },
+      { 16, 0x1000, "flags" },
+      { 32, 0xf000, "" },                                                      // names size do not fit in 16 bit
+      { uColumn + 8, 200, "type for column 1" },                               // m_uCType
+      { uColumn + 8, 0, "type for column 1" },
+      { uColumn + 24, 1, "name for column 1" },                                // m_uNameOffset before first name
+      { uColumn + 24, 0xfff, "name for column 1" },                            // m_uNameOffset after names
+      { uColumn + 28, 0xfff, "name for column 1" },                            // m_uAliasOffset
+      { uReferenceOffset, 200, "reference" },                                  // m_uType
+      { uReferenceOffset + 4, 0xffff, "reference" },                           // m_uLength larger than m_uSize
+      { uReferenceOffset + 8, 0xffffff, "reference" } } )                      // m_uSize larger than file
+   {
+      INFO( "offset: " << uOffset << ", value: " << uValue );
+      write_changed_file_s( stringFile, stringChanged, uOffset, uValue );
+      for( bool bMap : { false, true } )
+      {
+         dto::table tableRead;
+         auto result_ = bMap == true ? read_g( tableRead, stringChanged, tag_io_binary{}, tag_io_mmap{} ) : read_g( tableRead, stringChanged, tag_io_binary{} );
+         INFO( "error: " << result_.second );
+         REQUIRE( result_.first == false );
+         REQUIRE( result_.second.find( stringError ) != std::string::npos );
+         REQUIRE( tableRead.get_column_count() == 0 );                          // table is not changed
+      }
+   }
+
+   // ## unchanged copy is read
+   write_changed_file_s( stringFile, stringChanged, 36, 0 );                    // m_uReserved is not used
+   dto::table tableRead;
+   REQUIRE( read_g( tableRead, stringChanged, tag_io_binary{} ).first == true );
+   REQUIRE( compare_binary_s( table_, tableRead ) == "" );
+
+   std::filesystem::remove( stringFile );
+   std::filesystem::remove( stringChanged );
+}
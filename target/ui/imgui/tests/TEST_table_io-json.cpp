@@ -0,0 +1,216 @@
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_io.h"
+#include "gd/gd_table_writer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// values in one json row, empty optional is null or missing key
+   struct row_
+   {
+      int64_t m_iId = 0;
+      std::optional<double> m_dPrice;
+      std::optional<std::string> m_stringName;
+      std::optional<bool> m_bActive;
+   };
+
+   /// json text for row values, escapes in names and key order is changed for some rows
+   std::string make_json_row_s( const row_& row, unsigned uRow )
+   {
+      std::string stringName = "null";
+      if( row.m_stringName.has_value() == true )
+      {
+         stringName = "\"";
+         for( char ch : *row.m_stringName )
+         {
+            if( ch == '\"' ) stringName += "\\\"";
+            else if( ch == '\\' ) stringName += "\\\\";
+            else if( ch == '\n' ) stringName += "\\n";
+            else stringName += ch;
+         }
+         stringName += "\"";
+      }
+      std::string stringPrice = row.m_dPrice.has_value() == true ? std::to_string( *row.m_dPrice ) : "null";
+      std::string stringId = "\"id\": " + std::to_string( row.m_iId );
+      std::string stringActive = row.m_bActive.has_value() == true ? ( *row.m_bActive == true ? ",\"active\":true" : ",\"active\":false" ) : "";   // missing key is null
+
+      if( uRow % 10 == 3 ) return "{\"name\":" + stringName + ", \"price\" : " + stringPrice + "," + stringId + stringActive + "}";
+      if( uRow % 10 == 7 ) return "{ " + stringId + ",\"unknown\":{\"a\":[1,\"]\"]},\"price\":" + stringPrice + ",\"name\":" + stringName + stringActive + " }";
+      return "{" + stringId + ",\"price\":" + stringPrice + ",\"name\":" + stringName + stringActive + "}";
+   }
+
+   /// generate rows, some names are longer than one 64 byte block and have quotes and backslash
+   std::vector<row_> make_rows_s( unsigned uCount )
+   {
+      std::vector<row_> vectorRow;
+      for( unsigned u = 0; u < uCount; u++ )
+      {
+         row_ row;
+         row.m_iId = (int64_t)u * 3 - 50;
+         if( u % 6 != 0 ) row.m_dPrice = u * 0.25;
+         if( u % 9 != 0 ) row.m_stringName = u % 4 == 0 ? std::string( 70 + u % 30, 'x' ) + "\"q\"\\" + std::to_string( u ) + "\n" : "n" + std::to_string( u % 31 );
+         if( u % 5 != 0 ) row.m_bActive = u % 2 == 0;
+         vectorRow.push_back( row );
+      }
+      return vectorRow;
+   }
+
+   /// compare table rows from first row with json rows, returns description for first difference
+   std::string compare_rows_s( const dto::table& table_, uint64_t uFirstRow, const std::vector<row_>& vectorRow )
+   {
+      if( table_.get_row_count() != uFirstRow + vectorRow.size() ) return "row count " + std::to_string( table_.get_row_count() );
+      for( std::size_t u = 0; u < vectorRow.size(); u++ )
+      {
+         uint64_t uRow = uFirstRow + u;
+         const auto& row = vectorRow[u];
+         std::string stringRow = "row " + std::to_string( uRow );
+         if( table_.cell_get_variant_view( uRow, "id" ).as_int64() != row.m_iId ) return "id in " + stringRow;
+         if( table_.cell_get_variant_view( uRow, "price" ).is_null() != ( row.m_dPrice.has_value() == false ) ) return "null price in " + stringRow;
+         if( row.m_dPrice.has_value() == true && table_.cell_get_variant_view( uRow, "price" ).as_double() != *row.m_dPrice ) return "price in " + stringRow;
+         if( table_.cell_get_variant_view( uRow, "name" ).is_null() != ( row.m_stringName.has_value() == false ) ) return "null name in " + stringRow;
+         if( row.m_stringName.has_value() == true && table_.cell_get_variant_view( uRow, "name" ).as_string() != *row.m_stringName ) return "name in " + stringRow;
+         if( table_.cell_get_variant_view( uRow, "active" ).is_null() != ( row.m_bActive.has_value() == false ) ) return "null active in " + stringRow;
+         if( row.m_bActive.has_value() == true && table_.cell_get_variant_view( uRow, "active" ).as_bool() != *row.m_bActive ) return "active in " + stringRow;
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] read json objects into table with columns", "[table]" ) {
+   auto vectorRow = make_rows_s( 2000 );
+   std::string stringJson = "[\n";
+   for( unsigned u = 0; u < vectorRow.size(); u++ ) stringJson += ( u > 0 ? ",\n" : "" ) + make_json_row_s( vectorRow[u], u );
+   stringJson += "\n]";
+
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      INFO( "flags: " << uFlags );
+      dto::table table_( 64u, dto::table::eTableFlagNull32 | uFlags );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "double", 0, "price" );
+      table_.column_add( "bool", 0, "active" );
+      table_.prepare();
+      table_.row_add( { (int64_t)-1, "first", 1.0, true }, tag_convert{} );   // rows are appended
+
+      auto result_ = read_g( table_, stringJson, tag_io_json{} );
+      INFO( result_.second );
+      REQUIRE( result_.first == true );
+      REQUIRE( compare_rows_s( table_, 1, vectorRow ) == "" );
+      REQUIRE( table_.cell_get_variant_view( 0, "name" ).as_string() == "first" );
+   }
+}
+
+TEST_CASE( "[table] read json and add columns from values", "[table]" ) {
+   std::string stringJson = R"([
+      {"id":1,"price":2,"name":"a","active":true,"mixed":1,"tags":["x","y"]},
+      {"id":2,"price":2.5,"name":"é😀","active":false,"mixed":"b","tags":null},
+      {"id":3,"price":null,"name":null}
+   ])";
+   dto::table table_;
+   auto result_ = read_g( table_, stringJson, tag_io_json{} );
+   INFO( result_.second );
+   REQUIRE( result_.first == true );
+   REQUIRE( table_.get_column_count() == 6 );
+   REQUIRE( table_.get_row_count() == 3 );
+   REQUIRE( table_.is_null() == true );
+   REQUIRE( table_.column_get_name( 0u ) == "id" );
+   REQUIRE( table_.column_get_name( 5u ) == "tags" );
+   REQUIRE( table_.column_get_type( 0u ) == gd::types::eTypeInt64 );
+   REQUIRE( table_.column_get_type( 1u ) == gd::types::eTypeCDouble );         // integer and decimal values
+   REQUIRE( table_.column_get_type( 3u ) == gd::types::eTypeBool );
+   REQUIRE( table_.column_get_type( 4u ) == gd::types::eTypeRString );         // mixed types
+
+   REQUIRE( table_.cell_get_variant_view( 1, "price" ).as_double() == 2.5 );
+   REQUIRE( table_.cell_get_variant_view( 1, "name" ).as_string() == "\xc3\xa9\xf0\x9f\x98\x80" );
+   REQUIRE( table_.cell_get_variant_view( 0, "tags" ).as_string() == "[\"x\",\"y\"]" );   // nested value is stored as json text
+   REQUIRE( table_.cell_is_null( 1, 5u ) == true );
+   REQUIRE( table_.cell_is_null( 2, 2u ) == true );
+   REQUIRE( table_.cell_is_null( 2, 3u ) == true );                            // missing key
+
+   // ## array rows, columns are matched by position
+   dto::table tableArray;
+   REQUIRE( read_g( tableArray, "[[1,\"a\"],[2,\"b\",true],[]]", tag_io_json{} ).first == true );
+   REQUIRE( tableArray.get_column_count() == 3 );
+   REQUIRE( tableArray.get_row_count() == 3 );
+   REQUIRE( tableArray.column_get_name( 1u ) == "column2" );
+   REQUIRE( tableArray.cell_get_variant_view( 1, 1u ).as_string() == "b" );
+   REQUIRE( tableArray.cell_is_null( 0, 2u ) == true );
+   REQUIRE( tableArray.cell_is_null( 2, 0u ) == true );
+
+   // ## json without values do not add columns or rows
+   for( std::string_view stringEmpty : { "[]", " [ ] ", "[{}]", "[[],{}]" } )
+   {
+      INFO( "json: " << stringEmpty );
+      dto::table tableEmpty;
+      auto result_ = read_g( tableEmpty, stringEmpty, tag_io_json{} );
+      INFO( result_.second );
+      REQUIRE( result_.first == true );
+      REQUIRE( tableEmpty.get_column_count() == 0 );
+      REQUIRE( tableEmpty.get_row_count() == 0 );
+   }
+}
+
+TEST_CASE( "[table] read json with errors", "[table]" ) {
+   dto::table table_( dto::table::eTableFlagNull32, { { "int64", 0, "id" }, { "rstring", 0, "name" } }, tag_prepare{} );
+   table_.row_add( { (int64_t)1, "first" }, tag_convert{} );
+
+   for( const auto& [stringJson, stringError] : std::vector< std::pair<std::string, std::string> >{
+      { "{\"id\":1}", "not an array" },
+      { "[{\"id\":1},{\"id\":\"x\"}]", "row 1" },                             // text in integer column
+      { "[{\"id\":1},{\"id\":2,\"name\":\"a}]", "Unterminated" },
+      { "[{\"id\":1},{\"id\":tru}]", "row 1" },
+      { "[{\"id\":1},{\"id\" 2}]", "row 1" },
+      { "[{\"id\":1} {\"id\":2}]", "row 0" },
+      { "[{\"id\":1,\"name\":\"a\\x\"}]", "row 0" },                          // invalid escape
+      { "[1,2]", "row 0" } } )
+   {
+      INFO( "json: " << stringJson );
+      auto result_ = read_g( table_, stringJson, tag_io_json{} );
+      REQUIRE( result_.first == false );
+      INFO( "error: " << result_.second );
+      REQUIRE( result_.second.find( stringError ) != std::string::npos );
+      REQUIRE( table_.get_row_count() == 1 );                                 // rows added by failed read are removed
+   }
+}
+
+TEST_CASE( "[table] json written by writer is read back", "[table]" ) {
+   auto vectorRow = make_rows_s( 500 );
+   dto::table table_( 64u, dto::table::eTableFlagNull32 );
+   table_.column_add( "int64", 0, "id" );
+   table_.column_add( "double", 0, "price" );
+   table_.column_add( "rstring", 0, "name" );
+   table_.column_add( "bool", 0, "active" );
+   table_.prepare();
+   for( const auto& row : vectorRow )
+   {
+      table_.row_add( tag_null{} );
+      uint64_t uRow = table_.get_row_count() - 1;
+      table_.cell_set( uRow, 0u, gd::variant_view( row.m_iId ) );
+      if( row.m_dPrice.has_value() == true ) table_.cell_set( uRow, 1u, gd::variant_view( *row.m_dPrice ) );
+      if( row.m_stringName.has_value() == true ) table_.cell_set( uRow, 2u, gd::variant_view( *row.m_stringName ), tag_convert{} );
+      if( row.m_bActive.has_value() == true ) table_.cell_set( uRow, 3u, gd::variant_view( *row.m_bActive ) );
+   }
+
+   for( bool bObject : { false, true } )
+   {
+      INFO( "object: " << bObject );
+      std::string stringJson;
+      sink_string sinkString( stringJson );
+      if( bObject == true ) { writer_json writerJson( &sinkString, tag_name{} ); writerJson.write( table_ ); writerJson.close(); }
+      else                  { writer_json writerJson( &sinkString ); writerJson.write( table_ ); writerJson.close(); }
+
+      dto::table tableRead( table_, tag_columns{} );
+      auto result_ = read_g( tableRead, stringJson, tag_io_json{} );
+      INFO( result_.second );
+      REQUIRE( result_.first == true );
+      REQUIRE( compare_rows_s( tableRead, 0, vectorRow ) == "" );
+   }
+}
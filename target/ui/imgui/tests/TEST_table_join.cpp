@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   using match_t = std::vector< std::pair<uint64_t, uint64_t> >;
+
+   /// true if keys in both rows have values and values are equal
+   bool join_match_s( const dto::table& t1, uint64_t uRow1, const std::vector<unsigned>& vectorColumn1, const dto::table& t2, uint64_t uRow2, const std::vector<unsigned>& vectorColumn2 )
+   {
+      for( std::size_t u = 0; u < vectorColumn1.size(); u++ )
+      {
+         auto v1_ = t1.cell_get_variant_view( uRow1, vectorColumn1[u] );
+         auto v2_ = t2.cell_get_variant_view( uRow2, vectorColumn2[u] );
+         if( v1_.is_null() == true || v2_.is_null() == true ) return false;
+         if( v1_.as_string() != v2_.as_string() ) return false;
+      }
+      return true;
+   }
+
+   /// join with nested loops, result is used to check hash join
+   match_t join_naive_s( const dto::table& t1, const std::vector<unsigned>& vectorColumn1, const dto::table& t2, const std::vector<unsigned>& vectorColumn2, bool bInner, bool bMatched )
+   {
+      match_t vectorMatch;
+      for( uint64_t uRow1 = 0; uRow1 < t1.get_row_count(); uRow1++ )
+      {
+         bool bFound = false;
+         for( uint64_t uRow2 = 0; uRow2 < t2.get_row_count(); uRow2++ )
+         {
+            if( join_match_s( t1, uRow1, vectorColumn1, t2, uRow2, vectorColumn2 ) == false ) continue;
+            bFound = true;
+            if( bMatched == true ) vectorMatch.push_back( { uRow1, uRow2 } );
+         }
+         if( bInner == false && bFound == false ) vectorMatch.push_back( { uRow1, uint64_t(-1) } );
+      }
+      std::sort( vectorMatch.begin(), vectorMatch.end() );
+      return vectorMatch;
+   }
+
+   /// orders with customer key (some null) and region, customers with id and region
+   void make_join_tables_s( dto::table& tableOrder, dto::table& tableCustomer )
+   {
+      tableOrder = dto::table( dto::table::eTableFlagNull32, { { "int64", 0, "customer"}, { "rstring", 0, "region"}, { "int32", 0, "amount"} }, tag_prepare{} );
+      tableCustomer = dto::table( dto::table::eTableFlagNull32, { { "int64", 0, "id"}, { "rstring", 0, "region"}, { "rstring", 0, "name"} }, tag_prepare{} );
+      for( int i = 0; i < 700; i++ )
+      {
+         std::string stringRegion = "r" + std::to_string( i % 3 );
+         tableOrder.row_add( { (int64_t)( i % 60 ), stringRegion, i }, tag_convert{} );
+         if( i % 23 == 0 ) tableOrder.cell_set_null( (uint64_t)( tableOrder.get_row_count() - 1 ), 0u );
+      }
+      for( int i = 0; i < 50; i++ )                                            // customer 0 - 49, some duplicated
+      {
+         std::string stringRegion = "r" + std::to_string( i % 3 );
+         std::string stringName = "c" + std::to_string( i );
+         tableCustomer.row_add( { (int64_t)i, stringRegion, stringName }, tag_convert{} );
+         if( i % 10 == 0 ) tableCustomer.row_add( { (int64_t)i, stringRegion, stringName + "b" }, tag_convert{} );
+      }
+   }
+}
+
+TEST_CASE( "[table] hash join compared with nested loop join", "[table]" ) {
+   dto::table tableOrder, tableCustomer;
+   make_join_tables_s( tableOrder, tableCustomer );
+
+   for( const auto& pairColumn : { std::pair< std::vector<unsigned>, std::vector<unsigned> >{ { 0 }, { 0 } }, { { 0, 1 }, { 0, 1 } } } )
+   {
+      match_t vectorInner = join_naive_s( tableOrder, pairColumn.first, tableCustomer, pairColumn.second, true, true );
+      match_t vectorLeft = join_naive_s( tableOrder, pairColumn.first, tableCustomer, pairColumn.second, false, true );
+      match_t vectorAnti = join_naive_s( tableOrder, pairColumn.first, tableCustomer, pairColumn.second, false, false );
+      REQUIRE( vectorInner.empty() == false );
+      REQUIRE( vectorAnti.empty() == false );
+
+      for( unsigned uThreadCount : { 1u, 4u } )
+      {
+         INFO( "key count: " << pairColumn.first.size() << ", threads: " << uThreadCount );
+         match_t vectorMatch;
+         table_column_buffer::join_s( &tableOrder, pairColumn.first, &tableCustomer, pairColumn.second, vectorMatch, uThreadCount, tag_join_inner{} );
+         std::sort( vectorMatch.begin(), vectorMatch.end() );
+         REQUIRE( vectorMatch == vectorInner );
+
+         vectorMatch.clear();
+         table_column_buffer::join_s( &tableOrder, pairColumn.first, &tableCustomer, pairColumn.second, vectorMatch, uThreadCount, tag_join_left{} );
+         std::sort( vectorMatch.begin(), vectorMatch.end() );
+         REQUIRE( vectorMatch == vectorLeft );
+
+         vectorMatch.clear();
+         table_column_buffer::join_s( &tableOrder, pairColumn.first, &tableCustomer, pairColumn.second, vectorMatch, uThreadCount, tag_join_anti{} );
+         std::sort( vectorMatch.begin(), vectorMatch.end() );
+         REQUIRE( vectorMatch == vectorAnti );
+      }
+
+      // ## swap tables, hash table is built on the other table
+      match_t vectorMatch;
+      table_column_buffer::join_s( &tableCustomer, pairColumn.second, &tableOrder, pairColumn.first, vectorMatch, tag_join_left{} );
+      std::sort( vectorMatch.begin(), vectorMatch.end() );
+      REQUIRE( vectorMatch == join_naive_s( tableCustomer, pairColumn.second, tableOrder, pairColumn.first, false, true ) );
+   }
+}
+
+TEST_CASE( "[table] materialize left join into table", "[table]" ) {
+   dto::table tableOrder, tableCustomer;
+   make_join_tables_s( tableOrder, tableCustomer );
+
+   dto::table tableJoin;
+   table_column_buffer::join_s( &tableOrder, { 0 }, &tableCustomer, { 0 }, tableJoin, 1, tag_join_left{} );
+   REQUIRE( tableJoin.get_column_count() == 6 );
+   REQUIRE( tableJoin.get_row_count() == join_naive_s( tableOrder, { 0 }, tableCustomer, { 0 }, false, true ).size() );
+
+   for( uint64_t uRow = 0; uRow < tableJoin.get_row_count(); uRow++ )
+   {
+      INFO( "row: " << uRow );
+      auto customer_ = tableJoin.cell_get_variant_view( uRow, 0u );
+      auto id_ = tableJoin.cell_get_variant_view( uRow, 3u );
+      bool bMatch = customer_.is_null() == false && customer_.as_int64() < 50;
+      REQUIRE( id_.is_null() == !bMatch );
+      if( bMatch == true )
+      {
+         REQUIRE( id_.as_int64() == customer_.as_int64() );
+         REQUIRE( tableJoin.cell_get_variant_view( uRow, 5u ).as_string().substr( 0, 1 ) == "c" );
+      }
+   }
+}
+
+TEST_CASE( "[table] join key columns with different types", "[table]" ) {
+   dto::table tableOrder( 64u, dto::table::eTableFlagNull32 );
+   tableOrder.column_add( "int64", 0, "customer" );
+   tableOrder.column_add( "int32", 0, "amount" );
+   tableOrder.prepare();
+   dto::table tableCustomer( 64u, dto::table::eTableFlagNull32 );
+   tableCustomer.column_add( "int32", 0, "id" );
+   tableCustomer.column_add( "int64", 0, "key" );
+   tableCustomer.prepare();
+   for( int i = 0; i < 10; i++ )
+   {
+      tableOrder.row_add( { i, i * 10 }, tag_convert{} );
+      tableCustomer.row_add( { i, i }, tag_convert{} );
+   }
+
+   std::vector< std::pair<uint64_t, uint64_t> > vectorMatch;
+   auto result_ = table_column_buffer::join_s( &tableOrder, { 0 }, &tableCustomer, { 0 }, vectorMatch, tag_join_inner{} );   // int64 and int32
+   REQUIRE( result_.first == false );
+   REQUIRE( vectorMatch.empty() == true );
+
+   result_ = table_column_buffer::join_s( &tableOrder, { 0 }, &tableCustomer, { 0, 1 }, vectorMatch, tag_join_left{} );       // different number of keys
+   REQUIRE( result_.first == false );
+
+   result_ = table_column_buffer::join_s( &tableOrder, { 0 }, &tableCustomer, { 1 }, vectorMatch, tag_join_inner{} );
+   REQUIRE( result_.first == true );
+   REQUIRE( vectorMatch.size() == 10 );
+}
@@ -0,0 +1,80 @@
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// read all values in table as text, null values are read as "<null>"
+   std::vector<std::string> read_values_s( const dto::table& table_ )
+   {
+      std::vector<std::string> vectorValue;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < table_.get_column_count(); uColumn++ )
+         {
+            auto value_ = table_.cell_get_variant_view( uRow, uColumn );
+            vectorValue.push_back( value_.is_null() == true ? std::string( "<null>" ) : value_.as_string() );
+         }
+      }
+      return vectorValue;
+   }
+}
+
+TEST_CASE( "[table] compact references keeps values used by cells", "[table]" ) {
+   for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagDictionary } )
+   {
+      INFO( "flags: " << uFlags );
+      dto::table table_( dto::table::eTableFlagNull32 | uFlags, { { "rstring", 0, "city"}, { "int32", 0, "value"}, { "rstring", 0, "name"} }, tag_prepare{} );
+      const std::string stringLarge( 100'000, 'x' );                            // larger than slab, gets its own slab
+      for( int i = 0; i < 1000; i++ )
+      {
+         std::string stringCity = "city" + std::to_string( i % 200 );
+         std::string stringName = "name" + std::to_string( i % 150 );
+         table_.row_add( { stringCity, i, stringName }, tag_convert{} );
+      }
+      table_.cell_set( 3, 2u, gd::variant_view( stringLarge ), tag_convert{} );
+      REQUIRE( table_.get_references().size() == 351 );
+
+      // ## change values, old values are left in references
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         if( uRow % 2 == 0 ) table_.cell_set( uRow, 0u, gd::variant_view( "city" + std::to_string( uRow % 10 ) ), tag_convert{} );
+         if( uRow % 5 == 0 ) table_.cell_set_null( uRow, 2u );
+      }
+
+      std::set<std::string> setUsed;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn : { 0u, 2u } ) { auto value_ = table_.cell_get_variant_view( uRow, uColumn ); if( value_.is_null() == false ) setUsed.insert( value_.as_string() ); }
+      }
+      REQUIRE( setUsed.size() < table_.get_references().size() );
+
+      auto vectorBefore = read_values_s( table_ );
+      uint64_t uReferenceCount = table_.get_references().size();
+      uint64_t uRemoved = table_.references_compact();
+      REQUIRE( uRemoved == uReferenceCount - setUsed.size() );
+      REQUIRE( table_.get_references().size() == setUsed.size() );
+      REQUIRE( read_values_s( table_ ) == vectorBefore );
+      REQUIRE( table_.references_compact() == 0 );
+
+      // ## values are found and reused after compact
+      int64_t iCode = table_.cell_get_code( 1, 0u );
+      table_.cell_set( 0, 0u, table_.cell_get_variant_view( 1, 0u ), tag_convert{} );
+      REQUIRE( table_.cell_get_code( 0, 0u ) == iCode );
+      REQUIRE( table_.get_references().find( gd::variant_view( stringLarge ) ) == table_.cell_get_code( 3, 2u ) );
+      table_.cell_set( 0, 2u, gd::variant_view( "new value" ), tag_convert{} );
+      REQUIRE( table_.get_references().size() == setUsed.size() + 1 );
+
+      // ## copied table gets its own slabs
+      dto::table tableCopy( table_ );
+      REQUIRE( read_values_s( tableCopy ) == read_values_s( table_ ) );
+      table_.cell_set( 3, 2u, gd::variant_view( "changed" ), tag_convert{} );
+      table_.references_compact();
+      REQUIRE( tableCopy.cell_get_variant_view( 3, 2u ).as_string() == stringLarge );
+   }
+}
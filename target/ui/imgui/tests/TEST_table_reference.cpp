@@ -0,0 +1,149 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_aggregate.h"
+#include "gd/gd_table_table.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with id and name, name is reference column with 50 unique values and some nulls
+   dto::table make_reference_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( dto::table::eTableFlagNull32 | uFlags, { { "int32", 0, "id"}, { "rstring", 0, "name"} }, tag_prepare{} );
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "name" + std::to_string( ( u * 7 ) % 50 );
+         table_.row_add( { (int)u, stringName }, tag_convert{} );
+         if( u % 31 == 0 ) table_.cell_set_null( (uint64_t)u, 1u );
+      }
+      return table_;
+   }
+}
+
+TEST_CASE( "[table] reference values are stored once and found by code", "[table]" ) {
+   for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagDictionary } )
+   {
+      INFO( "flags: " << uFlags );
+      auto table_ = make_reference_table_s( uFlags, 2000 );
+      REQUIRE( table_.is_dictionary() == ( uFlags != 0 ) );
+      const auto& references_ = table_.get_references();
+      REQUIRE( references_.size() == 50 );
+
+      std::map<std::string, int64_t> mapCode;                                  // same value always has same code
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         INFO( "row: " << uRow );
+         int64_t iCode = table_.cell_get_code( uRow, 1u );
+         if( uRow % 31 == 0 ) { REQUIRE( iCode == -1 ); continue; }
+         std::string stringName = table_.cell_get_variant_view( uRow, 1u ).as_string();
+         REQUIRE( references_.find( gd::variant_view( stringName ) ) == iCode );
+         auto [it, bInsert] = mapCode.try_emplace( stringName, iCode );
+         REQUIRE( it->second == iCode );
+      }
+      REQUIRE( mapCode.size() == 50 );
+      REQUIRE( references_.find( gd::variant_view( "missing" ) ) == -1 );
+      REQUIRE( table_.cell_get_code( 1, 0u ) == -1 );                           // not reference column
+   }
+}
+
+TEST_CASE( "[table] filter, find and group by on dictionary encoded column", "[table]" ) {
+   auto tableRow = make_reference_table_s( 0, 2000 );
+   auto tableDictionary = make_reference_table_s( dto::table::eTableFlagDictionary, 2000 );
+
+   for( auto stringFind : { "name7", "name49", "missing" } )
+   {
+      INFO( "find: " << stringFind );
+      REQUIRE( tableRow.find( 1u, gd::variant_view( stringFind ) ) == tableDictionary.find( 1u, gd::variant_view( stringFind ) ) );
+      for( auto eFilter : { eFilterEqual, eFilterNotEqual } )
+      {
+         selection selection1, selection2;
+         tableRow.filter( 1u, eFilter, gd::variant_view( stringFind ), selection1 );
+         tableDictionary.filter( 1u, eFilter, gd::variant_view( stringFind ), selection2 );
+         REQUIRE( selection1.to_rows() == selection2.to_rows() );
+         uint64_t uExpect = 0;
+         for( uint64_t uRow = 0; uRow < tableRow.get_row_count(); uRow++ )
+         {
+            auto name_ = tableRow.cell_get_variant_view( uRow, 1u );
+            if( name_.is_null() == false && ( name_.as_string() == stringFind ) == ( eFilter == eFilterEqual ) ) uExpect++;
+         }
+         REQUIRE( selection2.count() == uExpect );
+      }
+   }
+
+   selection selectionIn;
+   tableDictionary.filter( 1u, eFilterIn, { gd::variant_view( "name1" ), gd::variant_view( "name2" ), gd::variant_view( "missing" ) }, selectionIn );
+   std::vector<uint64_t> vectorIn;
+   for( uint64_t uRow = 0; uRow < tableDictionary.get_row_count(); uRow++ )
+   {
+      auto name_ = tableDictionary.cell_get_variant_view( uRow, 1u );
+      if( name_.is_null() == false && ( name_.as_string() == "name1" || name_.as_string() == "name2" ) ) vectorIn.push_back( uRow );
+   }
+   REQUIRE( vectorIn.empty() == false );
+   REQUIRE( selectionIn.to_rows() == vectorIn );
+
+   dto::table tableGroup( 64u, 0 );
+   aggregate<dto::table>( &tableDictionary ).group_by( { 1 }, { { eAggregateCount, 0 } }, tableGroup );
+   REQUIRE( tableGroup.get_row_count() == 51 );                                  // 50 names and null
+   std::map<std::string, uint64_t> mapCount;
+   for( uint64_t uRow = 0; uRow < tableDictionary.get_row_count(); uRow++ ) mapCount[tableDictionary.cell_get_variant_view( uRow, 1u ).as_string()]++;
+   for( uint64_t uRow = 0; uRow < tableGroup.get_row_count(); uRow++ )
+   {
+      REQUIRE( tableGroup.cell_get_variant_view( uRow, 1u ).as_uint64() == mapCount[tableGroup.cell_get_variant_view( uRow, 0u ).as_string()] );
+   }
+}
+
+TEST_CASE( "[table] references hash finds values after growing", "[table]" ) {
+   references references_;
+   for( int i = 0; i < 5000; i++ )
+   {
+      std::string stringValue = "value " + std::to_string( i );
+      REQUIRE( references_.add( gd::variant_view( stringValue ) ) == (uint64_t)i );
+   }
+   for( int i = 0; i < 5000; i += 7 )
+   {
+      std::string stringValue = "value " + std::to_string( i );
+      REQUIRE( references_.find( gd::variant_view( stringValue ) ) == i );
+   }
+
+   references referencesCopy;
+   referencesCopy = references_;
+   REQUIRE( referencesCopy.size() == 5000 );
+   REQUIRE( referencesCopy.find( gd::variant_view( "value 4999" ) ) == 4999 );
+}
+
+TEST_CASE( "[table] split dictionary encoded table into row tables", "[table]" ) {
+   for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagDictionary } )
+   {
+      INFO( "flags: " << uFlags );
+      dto::table table_( dto::table::eTableFlagNull32 | uFlags, { { "int32", 0, "id"}, { "rstring", 0, "name"}, { "double", 0, "value"}, { "rstring", 0, "code"} }, tag_prepare{} );
+      for( unsigned u = 0; u < 1000; u++ )
+      {
+         std::string stringName = "name" + std::to_string( ( u * 7 ) % 50 ), stringCode = "code" + std::to_string( u % 13 );
+         table_.row_add( { (int)u, stringName, u * 0.5, stringCode }, tag_convert{} );
+         if( u % 31 == 0 ) table_.cell_set_null( (uint64_t)u, 1u );
+      }
+
+      std::vector<table> vectorSplit;
+      table_.split( 300, vectorSplit );                                        // reference cells in row tables are 64 bit
+      REQUIRE( vectorSplit.size() == 4 );
+      uint64_t uRow = 0;
+      for( const auto& tableSplit : vectorSplit )
+      {
+         for( uint64_t u = 0; u < tableSplit.get_row_count(); u++, uRow++ )
+         {
+            INFO( "row: " << uRow );
+            REQUIRE( tableSplit.cell_get_variant_view( u, 0u ).as_int64() == table_.cell_get_variant_view( uRow, 0u ).as_int64() );
+            REQUIRE( tableSplit.cell_is_null( u, 1u ) == table_.cell_is_null( uRow, 1u ) );
+            REQUIRE( tableSplit.cell_get_variant_view( u, 1u ).as_string() == table_.cell_get_variant_view( uRow, 1u ).as_string() );
+            REQUIRE( tableSplit.cell_get_variant_view( u, 2u ).as_double() == table_.cell_get_variant_view( uRow, 2u ).as_double() );
+            REQUIRE( tableSplit.cell_get_variant_view( u, 3u ).as_string() == table_.cell_get_variant_view( uRow, 3u ).as_string() );
+         }
+      }
+      REQUIRE( uRow == 1000 );
+   }
+}
@@ -0,0 +1,103 @@
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// add columns and rows, row table and segmented table get same values
+   void make_segmented_table_s( dto::table& table_, unsigned uRowCount )
+   {
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "string", 12, "code" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "name" + std::to_string( u % 97 );
+         std::string stringCode = "c" + std::to_string( u % 1000 );
+         table_.row_add( { (int64_t)u, stringName, ( u % 311 ) * 0.5, stringCode }, tag_convert{} );
+         if( u % 13 == 0 ) table_.cell_set_null( (uint64_t)u, u % 4 );
+      }
+   }
+
+   /// compare all values in two tables, returns description for first difference or empty string if equal
+   std::string compare_segmented_s( const dto::table& t1, const dto::table& t2 )
+   {
+      if( t1.get_row_count() != t2.get_row_count() ) return "row count";
+      for( uint64_t uRow = 0; uRow < t1.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < t1.get_column_count(); uColumn++ )
+         {
+            auto v1_ = t1.cell_get_variant_view( uRow, uColumn );
+            auto v2_ = t2.cell_get_variant_view( uRow, uColumn );
+            if( v1_.is_null() != v2_.is_null() || ( v1_.is_null() == false && v1_.as_string() != v2_.as_string() ) ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn );
+         }
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] segmented table has same values as row table", "[table]" ) {
+   for( uint64_t uSegmentRows : { 64ull, 4096ull } )
+   {
+      INFO( "segment rows: " << uSegmentRows );
+      dto::table tableRow( 10u, dto::table::eTableFlagNull32 | dto::table::eTableFlagRowStatus );
+      dto::table tableSegmented( 10u, dto::table::eTableFlagNull32 | dto::table::eTableFlagRowStatus | dto::table::eTableFlagSegmented );
+      tableSegmented.segment_set_row_count( uSegmentRows );
+      make_segmented_table_s( tableRow, 10000 );
+      make_segmented_table_s( tableSegmented, 10000 );
+      REQUIRE( tableSegmented.is_segmented() == true );
+      REQUIRE( tableSegmented.segment_get_row_count() == uSegmentRows );
+      REQUIRE( tableSegmented.segment_size() == ( 10000 + uSegmentRows - 1 ) / uSegmentRows );
+      REQUIRE( compare_segmented_s( tableRow, tableSegmented ) == "" );
+
+      for( auto* ptable : { &tableRow, &tableSegmented } )
+      {
+         ptable->swap( 5, 9000 );
+         ptable->erase( 4000, 300 );                                          // erase over segment boundary
+         ptable->cell_set( 4100, 1u, gd::variant_view( "changed" ), tag_convert{} );
+      }
+      REQUIRE( compare_segmented_s( tableRow, tableSegmented ) == "" );
+      REQUIRE( tableRow.count_used_rows() == tableSegmented.count_used_rows() );
+
+      for( auto* ptable : { &tableRow, &tableSegmented } ) ptable->sort( { { 2, false }, { 0 } }, tag_sort_typed{} );
+      REQUIRE( compare_segmented_s( tableRow, tableSegmented ) == "" );
+
+      for( int64_t iFind : { (int64_t)0, (int64_t)4500, (int64_t)9999, (int64_t)4100 } )
+      {
+         INFO( "find: " << iFind );
+         REQUIRE( tableRow.find( 0u, gd::variant_view( iFind ) ) == tableSegmented.find( 0u, gd::variant_view( iFind ) ) );
+      }
+
+      selection selection1, selection2;
+      tableRow.filter( 2u, eFilterBetween, { gd::variant_view( 10.0 ), gd::variant_view( 100.5 ) }, selection1 );
+      tableSegmented.filter( 2u, eFilterBetween, { gd::variant_view( 10.0 ), gd::variant_view( 100.5 ) }, selection2 );
+      REQUIRE( selection1.to_rows() == selection2.to_rows() );
+
+      dto::table tableCopy( tableSegmented );
+      REQUIRE( compare_segmented_s( tableRow, tableCopy ) == "" );
+   }
+}
+
+TEST_CASE( "[table] segmented table do not move rows when it grows", "[table]" ) {
+   dto::table table_( 10u, dto::table::eTableFlagNull32 | dto::table::eTableFlagSegmented );
+   table_.segment_set_row_count( 256 );
+   make_segmented_table_s( table_, 300 );
+
+   const uint8_t* puRow0 = table_.row_get( 0 );
+   const uint8_t* puRow299 = table_.row_get( 299 );
+   for( int i = 0; i < 2000; i++ ) table_.row_add( { (int64_t)i, "added", 1.0, "a" }, tag_convert{} );
+   REQUIRE( table_.row_get( 0 ) == puRow0 );
+   REQUIRE( table_.row_get( 299 ) == puRow299 );
+   REQUIRE( table_.cell_get_variant_view( 299, 0u ).as_int64() == 299 );
+
+   REQUIRE( table_.row_get_contiguous( 0 ) == 256 );
+   REQUIRE( table_.row_get_contiguous( 250 ) == 6 );
+   REQUIRE( table_.row_get_contiguous( 256 ) == 256 );
+   REQUIRE( table_.row_get( 255 ) - table_.row_get( 254 ) == table_.row_get( 1 ) - table_.row_get( 0 ) );     // rows in segment are placed after each other
+}
@@ -0,0 +1,144 @@
+#include <atomic>
+#include <functional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_snapshot.h"
+#include "gd/gd_table_typed.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// segmented table with id, value and name, 64 rows in each segment
+   dto::table make_snapshot_table_s( unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 | dto::table::eTableFlagSegmented );
+      table_.segment_set_row_count( 64 );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "name" + std::to_string( u % 13 );
+         table_.row_add( { (int64_t)u, u * 0.5, stringName }, tag_convert{} );
+      }
+      return table_;
+   }
+
+   /// read all values in table as text, null values are read as "<null>"
+   std::vector<std::string> read_values_s( const dto::table& table_ )
+   {
+      std::vector<std::string> vectorValue;
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < table_.get_column_count(); uColumn++ )
+         {
+            auto value_ = table_.cell_get_variant_view( uRow, uColumn );
+            vectorValue.push_back( value_.is_null() == true ? std::string( "<null>" ) : value_.as_string() );
+         }
+      }
+      return vectorValue;
+   }
+}
+
+TEST_CASE( "[table] edit in snapshot do not change published version", "[table]" ) {
+   const std::vector< std::pair< std::string, std::function<void( dto::table& )> > > vectorEdit = {
+      { "cell_set", []( dto::table& t_ ) { t_.cell_set( 70, 1u, gd::variant_view( -1.0 ), tag_convert{} ); t_.cell_set( 71, 2u, gd::variant_view( "changed" ), tag_convert{} ); } },
+      { "cell_set_null", []( dto::table& t_ ) { t_.cell_set_null( 130, 0u ); } },
+      { "column_fill", []( dto::table& t_ ) { t_.column_fill( 1u, gd::variant_view( 9.0 ), tag_convert{} ); } },
+      { "plant_span", []( dto::table& t_ ) { std::vector<double> vectorValue( 150, 7.0 ); t_.plant( 1u, std::span<const double>( vectorValue ), 20 ); } },
+      { "typed_set", []( dto::table& t_ ) { typed_table<int64_t, double, rstring> typed_( &t_ ); typed_.set<1>( 130, -2.0 ); typed_.set<0>( 190, -190 ); typed_.set<2>( 10, "typed" ); } },
+      { "row_set", []( dto::table& t_ ) { t_.row_set( 5, { (int64_t)-5, 5.5, "row" }, tag_convert{} ); } },
+      { "row_add", []( dto::table& t_ ) { t_.row_add( { (int64_t)1000, 1.0, "added" }, tag_convert{} ); } },
+      { "swap", []( dto::table& t_ ) { t_.swap( 1, 150 ); } },
+      { "sort", []( dto::table& t_ ) { t_.sort( { { 2, false }, { 0 } }, tag_sort_typed{} ); } },
+      { "erase", []( dto::table& t_ ) { t_.erase( 60, 10 ); } },
+      { "references_compact", []( dto::table& t_ ) { t_.column_fill( 2u, gd::variant_view( "same" ) ); t_.references_compact(); } },
+   };
+
+   for( const auto& [stringEdit, edit_] : vectorEdit )
+   {
+      INFO( "edit: " << stringEdit );
+      table_snapshot snapshot_( make_snapshot_table_s( 200 ) );                 // 200 rows, last segment is partly used
+      auto ptablePublished = snapshot_.get();
+      const auto vectorPublished = read_values_s( *ptablePublished );
+
+      auto ptableEdit = snapshot_.edit();
+      edit_( *ptableEdit );
+      REQUIRE( read_values_s( *ptableEdit ) != vectorPublished );
+      REQUIRE( read_values_s( *ptablePublished ) == vectorPublished );          // published version is not changed
+
+      auto vectorEdit = read_values_s( *ptableEdit );
+      snapshot_.publish( std::move( ptableEdit ) );
+      REQUIRE( snapshot_.get_version() == 2 );
+      REQUIRE( read_values_s( *snapshot_.get() ) == vectorEdit );
+      REQUIRE( read_values_s( *ptablePublished ) == vectorPublished );
+
+      auto ptableNext = snapshot_.edit();                                       // edit version that shares segments with two versions
+      edit_( *ptableNext );
+      REQUIRE( read_values_s( *snapshot_.get() ) == vectorEdit );
+      REQUIRE( read_values_s( *ptablePublished ) == vectorPublished );
+   }
+}
+
+TEST_CASE( "[table] read snapshot while writer publish versions", "[table]" ) {
+   auto table_ = make_snapshot_table_s( 300 );
+   table_.column_fill( 1u, gd::variant_view( -1.0 ) );
+   table_snapshot snapshot_( std::move( table_ ) );
+   std::atomic<bool> bDone = false;
+   std::atomic<uint64_t> uMismatch = 0;
+   std::atomic<uint64_t> uRead = 0;
+
+   // ## readers check that all rows in version have the same value, writer sets one value for all rows in each version
+   std::vector<std::thread> vectorReader;
+   for( unsigned uThread = 0; uThread < 2; uThread++ )
+   {
+      vectorReader.emplace_back( [&]() {
+         while( bDone.load() == false || uRead.load() == 0 )
+         {
+            auto ptable = snapshot_.get();
+            double dValue = ptable->cell_get_variant_view( 0, 1u ).as_double();
+            for( uint64_t uRow = 1; uRow < ptable->get_row_count(); uRow++ )
+            {
+               if( ptable->cell_get_variant_view( uRow, 1u ).as_double() != dValue ) { uMismatch++; break; }
+            }
+            if( ptable->get_row_count() < 300 ) uMismatch++;
+            uRead++;
+         }
+      } );
+   }
+
+   for( int iVersion = 0; iVersion < 200; iVersion++ )
+   {
+      auto ptableEdit = snapshot_.edit();
+      if( iVersion % 3 == 0 )                                                    // versions are edited with cell_set, plant and typed table
+      {
+         for( uint64_t uRow = 0; uRow < ptableEdit->get_row_count(); uRow++ ) ptableEdit->cell_set( uRow, 1u, gd::variant_view( (double)iVersion ), tag_convert{} );
+      }
+      else if( iVersion % 3 == 1 )
+      {
+         std::vector<double> vectorValue( ptableEdit->get_row_count(), (double)iVersion );
+         ptableEdit->plant( 1u, std::span<const double>( vectorValue ), 0 );
+      }
+      else
+      {
+         typed_table<int64_t, double, rstring> typed_( ptableEdit.get() );
+         for( uint64_t uRow = 0; uRow < ptableEdit->get_row_count(); uRow++ ) typed_.set<1>( uRow, (double)iVersion );
+      }
+      if( iVersion % 10 == 0 ) ptableEdit->row_add( { (int64_t)iVersion, (double)iVersion, "added" }, tag_convert{} );
+      snapshot_.publish( std::move( ptableEdit ) );
+   }
+   bDone = true;
+   for( auto& it : vectorReader ) it.join();
+
+   REQUIRE( uMismatch.load() == 0 );
+   REQUIRE( snapshot_.get_version() == 201 );
+   REQUIRE( snapshot_.get()->get_row_count() == 320 );
+   REQUIRE( snapshot_.get()->cell_get_variant_view( 319, 1u ).as_double() == 199.0 );
+}
@@ -0,0 +1,93 @@
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with int32 key (every 13th is null), double value, rstring name and original row order
+   dto::table make_sort_table_s( unsigned uRowCount )
+   {
+      dto::table table_( dto::table::eTableFlagNull32, { { "int32", 0, "key"}, { "double", 0, "value"}, { "rstring", 0, "name"}, { "int64", 0, "order"} }, tag_prepare{} );
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "n" + std::to_string( u % 17 );
+         table_.row_add( { (int)( ( u * 7 ) % 10 ) - 5, (double)( u % 50 ) - 25.5, stringName, (int64_t)u }, tag_convert{} );
+         if( u % 13 == 0 ) table_.cell_set_null( (uint64_t)u, 0u );
+      }
+      return table_;
+   }
+}
+
+TEST_CASE( "[table] typed sort on multiple keys", "[table]" ) {
+   auto table_ = make_sort_table_s( 1000 );
+
+   table_.sort( { { 0, true }, { 1, false } }, tag_sort_typed{} );                                 // key ascending, value descending
+   REQUIRE( table_.get_row_count() == 1000 );
+
+   uint64_t uNullCount = 0;
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      if( table_.cell_get_variant_view( uRow, 0u ).is_null() == false ) break;
+      uNullCount++;
+   }
+   REQUIRE( uNullCount == 77 );                                                 // nulls are placed first in ascending order
+
+   for( uint64_t uRow = uNullCount + 1; uRow < table_.get_row_count(); uRow++ )
+   {
+      INFO( "row: " << uRow );
+      int64_t iKey1 = table_.cell_get_variant_view( uRow - 1, 0u ).as_int64();
+      int64_t iKey2 = table_.cell_get_variant_view( uRow, 0u ).as_int64();
+      REQUIRE( table_.cell_get_variant_view( uRow, 0u ).is_null() == false );
+      REQUIRE( iKey1 <= iKey2 );
+      if( iKey1 == iKey2 ) REQUIRE( table_.cell_get_variant_view( uRow - 1, 1u ).as_double() >= table_.cell_get_variant_view( uRow, 1u ).as_double() );
+   }
+
+   table_.sort( 0, false, 0, table_.get_row_count(), tag_sort_typed{} );                        // descending, nulls are placed last
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+   {
+      bool bNull = table_.cell_get_variant_view( uRow, 0u ).is_null();
+      REQUIRE( bNull == ( uRow >= table_.get_row_count() - uNullCount ) );
+      if( uRow > 0 && bNull == false ) REQUIRE( table_.cell_get_variant_view( uRow - 1, 0u ).as_int64() >= table_.cell_get_variant_view( uRow, 0u ).as_int64() );
+   }
+}
+
+TEST_CASE( "[table] stable typed sort on text keeps order for equal values", "[table]" ) {
+   auto table_ = make_sort_table_s( 500 );
+   table_.sort( { { 2 } }, true, tag_sort_typed{} );
+   for( uint64_t uRow = 1; uRow < table_.get_row_count(); uRow++ )
+   {
+      INFO( "row: " << uRow );
+      std::string string1 = table_.cell_get_variant_view( uRow - 1, 2u ).as_string();
+      std::string string2 = table_.cell_get_variant_view( uRow, 2u ).as_string();
+      REQUIRE( string1 <= string2 );
+      if( string1 == string2 ) REQUIRE( table_.cell_get_variant_view( uRow - 1, 3u ).as_int64() < table_.cell_get_variant_view( uRow, 3u ).as_int64() );
+   }
+}
+
+TEST_CASE( "[table] typed sort order for rows without moving them", "[table]" ) {
+   auto table_ = make_sort_table_s( 300 );
+
+   std::vector<uint64_t> vectorRow;
+   table_.sort( { { 1 }, { 2, false } }, 100, 150, false, vectorRow, tag_sort_typed{} );        // only rows 100 - 249
+   REQUIRE( vectorRow.size() == 150 );
+   for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ ) REQUIRE( table_.cell_get_variant_view( uRow, 1u ).as_double() == (double)( uRow % 50 ) - 25.5 );
+
+   std::vector<bool> vectorFound( 150, false );
+   for( std::size_t u = 0; u < vectorRow.size(); u++ )
+   {
+      INFO( "position: " << u );
+      REQUIRE( vectorRow[u] >= 100 );
+      REQUIRE( vectorRow[u] < 250 );
+      vectorFound[vectorRow[u] - 100] = true;
+      if( u == 0 ) continue;
+      double d1 = table_.cell_get_variant_view( vectorRow[u - 1], 1u ).as_double();
+      double d2 = table_.cell_get_variant_view( vectorRow[u], 1u ).as_double();
+      REQUIRE( d1 <= d2 );
+      if( d1 == d2 ) REQUIRE( table_.cell_get_variant_view( vectorRow[u - 1], 2u ).as_string() >= table_.cell_get_variant_view( vectorRow[u], 2u ).as_string() );
+   }
+   for( auto bFound : vectorFound ) REQUIRE( bFound == true );
+}
@@ -0,0 +1,131 @@
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_typed.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with number columns and one text column, all rows are added as null
+   dto::table make_span_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 | uFlags );
+      if( table_.is_segmented() == true ) table_.segment_set_row_count( 64 );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "int16", 0, "small" );
+      table_.prepare();
+      table_.row_add( (uint64_t)uRowCount, tag_null{} );
+      return table_;
+   }
+
+   /// bit array with one bit for each value, bit is set for each row where `uRow % uStep == 0`
+   std::vector<uint64_t> make_null_bits_s( uint64_t uCount, uint64_t uStep )
+   {
+      std::vector<uint64_t> vectorNull( ( uCount + 63 ) / 64, 0 );
+      for( uint64_t u = 0; u < uCount; u += uStep ) vectorNull[u >> 6] |= ( 1ULL << ( u & 63 ) );
+      return vectorNull;
+   }
+
+   bool is_bit_s( const std::vector<uint64_t>& vectorBit, uint64_t uIndex ) { return ( ( vectorBit[uIndex >> 6] >> ( uIndex & 63 ) ) & 1 ) != 0; }
+}
+
+TEST_CASE( "[table] plant and harvest column values with span", "[table]" ) {
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      for( uint64_t uFrom : { 0ull, 64ull, 37ull } )                           // word aligned and unaligned start in null bits
+      {
+         INFO( "flags: " << uFlags << ", from: " << uFrom );
+         auto table_ = make_span_table_s( uFlags, 1000 );
+         const uint64_t uCount = 700;
+
+         std::vector<int64_t> vectorId( uCount );
+         std::vector<double> vectorValue( uCount );
+         std::vector<std::string> vectorName( uCount );
+         std::vector<std::string_view> vectorNameView;
+         std::vector<int> vectorSmall( uCount );
+         for( uint64_t u = 0; u < uCount; u++ )
+         {
+            vectorId[u] = (int64_t)u * 3;
+            vectorValue[u] = u * 0.25;
+            vectorName[u] = "name" + std::to_string( u % 40 );
+            vectorSmall[u] = (int)( u % 100 );
+         }
+         for( const auto& it : vectorName ) vectorNameView.push_back( it );
+         auto vectorNull = make_null_bits_s( uCount, 7 );
+
+         table_.plant( 0u, std::span<const int64_t>( vectorId ), uFrom );
+         table_.plant( 1u, std::span<const double>( vectorValue ), uFrom, vectorNull.data() );
+         table_.plant( 2u, std::span<const std::string_view>( vectorNameView ), uFrom );
+         table_.plant( 3u, std::span<const int>( vectorSmall ), uFrom );      // type do not match column, values are converted
+
+         for( uint64_t u = 0; u < uCount; u++ )
+         {
+            uint64_t uRow = uFrom + u;
+            REQUIRE( table_.cell_get_variant_view( uRow, 0u ).as_int64() == vectorId[u] );
+            REQUIRE( table_.cell_is_null( uRow, 1u ) == is_bit_s( vectorNull, u ) );
+            if( is_bit_s( vectorNull, u ) == false ) { REQUIRE( table_.cell_get_variant_view( uRow, 1u ).as_double() == vectorValue[u] ); }
+            REQUIRE( table_.cell_get_variant_view( uRow, 2u ).as_string() == vectorName[u] );
+            REQUIRE( table_.cell_get_variant_view( uRow, 3u ).as_int() == vectorSmall[u] );
+         }
+         REQUIRE( table_.cell_is_null( uFrom + uCount, 0u ) == true );          // rows after range are not changed
+         if( uFrom > 0 ) { REQUIRE( table_.cell_is_null( uFrom - 1, 0u ) == true ); }
+
+         // ## harvest returns planted values and null bits
+         std::vector<int64_t> vectorIdRead( uCount );
+         std::vector<double> vectorValueRead( uCount );
+         std::vector<std::string_view> vectorNameRead( uCount );
+         std::vector<int32_t> vectorSmallRead( uCount );
+         std::vector<uint64_t> vectorNullRead( ( uCount + 63 ) / 64, ~0ULL );
+         table_.harvest( 0u, uFrom, std::span<int64_t>( vectorIdRead ) );
+         table_.harvest( 1u, uFrom, std::span<double>( vectorValueRead ), vectorNullRead.data() );
+         table_.harvest( 2u, uFrom, std::span<std::string_view>( vectorNameRead ) );
+         table_.harvest( 3u, uFrom, std::span<int32_t>( vectorSmallRead ) );
+         REQUIRE( vectorIdRead == vectorId );
+         REQUIRE( vectorNullRead == vectorNull );
+         for( uint64_t u = 0; u < uCount; u++ )
+         {
+            if( is_bit_s( vectorNull, u ) == false ) { REQUIRE( vectorValueRead[u] == vectorValue[u] ); }
+            REQUIRE( vectorNameRead[u] == vectorName[u] );
+            REQUIRE( vectorSmallRead[u] == vectorSmall[u] );
+         }
+
+         // ## plant without null bits clears null flags
+         table_.plant( 1u, std::span<const double>( vectorValue ), uFrom );
+         table_.column_get_null( 1u, uFrom, uCount, vectorNullRead.data() );
+         REQUIRE( vectorNullRead == std::vector<uint64_t>( vectorNullRead.size(), 0 ) );
+      }
+   }
+}
+
+TEST_CASE( "[table] typed table add rows from span", "[table]" ) {
+   for( unsigned uFlags : { 0u, (unsigned)dto::table::eTableFlagColumnar, (unsigned)dto::table::eTableFlagSegmented } )
+   {
+      INFO( "flags: " << uFlags );
+      auto table_ = make_span_table_s( uFlags, 5 );
+      typed_table<int64_t, double, rstring, int16_t> typed_;
+      REQUIRE( typed_.bind( &table_ ).first == true );
+
+      std::vector< std::tuple<int64_t, double, std::string_view, int16_t> > vectorRow;
+      std::vector<std::string> vectorName;
+      for( int i = 0; i < 500; i++ ) vectorName.push_back( "row" + std::to_string( i ) );
+      for( int i = 0; i < 500; i++ ) vectorRow.emplace_back( (int64_t)i, i * 2.0, vectorName[i], (int16_t)( i % 300 ) );
+
+      REQUIRE( typed_.row_add( vectorRow ) == 5 );
+      REQUIRE( table_.get_row_count() == 505 );
+      for( int i = 0; i < 500; i++ )
+      {
+         REQUIRE( typed_.row_get( 5 + i ) == vectorRow[i] );
+         REQUIRE( table_.cell_is_null( 5 + i, 2u ) == false );
+      }
+      REQUIRE( typed_.row_add( std::span<const std::tuple<int64_t, double, std::string_view, int16_t>>() ) == 505 );
+      REQUIRE( table_.get_row_count() == 505 );
+   }
+}
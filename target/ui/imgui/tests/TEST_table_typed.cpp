@@ -0,0 +1,111 @@
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_typed.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with id, population, name and code columns
+   dto::table make_typed_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 | uFlags );
+      if( table_.is_segmented() == true ) table_.segment_set_row_count( 64 );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "double", 0, "population" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "int32", 0, "code" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "city" + std::to_string( u % 31 );
+         table_.row_add( { (int64_t)u, u * 1.5, stringName, (int)u - 100 }, tag_convert{} );
+      }
+      return table_;
+   }
+}
+
+TEST_CASE( "[table] typed table read and write same values as table", "[table]" ) {
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      INFO( "flags: " << uFlags );
+      auto table_ = make_typed_table_s( uFlags, 300 );
+      typed_table<int64_t, double, rstring, int32_t> typed_;
+      auto result_ = typed_.bind( &table_ );
+      REQUIRE( result_.first == true );
+      REQUIRE( typed_.get_row_count() == 300 );
+
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow++ )
+      {
+         REQUIRE( typed_.get<0>( uRow ) == table_.cell_get_variant_view( uRow, 0u ).as_int64() );
+         REQUIRE( typed_.get<1>( uRow ) == table_.cell_get_variant_view( uRow, 1u ).as_double() );
+         REQUIRE( typed_.get<2>( uRow ) == table_.cell_get_variant_view( uRow, 2u ).as_string() );
+         REQUIRE( typed_.get<3>( uRow ) == table_.cell_get_variant_view( uRow, 3u ).as_int() );
+      }
+
+      // ## iterator reads rows over segment boundaries
+      uint64_t uRow = 0;
+      double dSum = 0.0;
+      for( auto it : typed_ )
+      {
+         REQUIRE( it.get_row() == uRow );
+         REQUIRE( it.get<0>() == (int64_t)uRow );
+         REQUIRE( it.get<2>() == "city" + std::to_string( uRow % 31 ) );
+         dSum += it.get<1>();
+         uRow++;
+      }
+      REQUIRE( uRow == 300 );
+      REQUIRE( dSum == 1.5 * ( 299.0 * 300.0 / 2.0 ) );
+
+      // ## write values
+      typed_.set<1>( 10, -1.0 );
+      typed_.set<2>( 11, "changed" );
+      typed_.set<2>( 12, "city3" );
+      REQUIRE( table_.cell_get_variant_view( 10, 1u ).as_double() == -1.0 );
+      REQUIRE( table_.cell_get_variant_view( 11, 2u ).as_string() == "changed" );
+      REQUIRE( table_.cell_get_variant_view( 12, 2u ).as_string() == "city3" );
+
+      typed_.set_null<3>( 20 );
+      REQUIRE( typed_.is_null<3>( 20 ) == true );
+      REQUIRE( table_.cell_is_null( 20, 3u ) == true );
+      typed_.set<3>( 20, 7 );
+      REQUIRE( typed_.is_null<3>( 20 ) == false );                             // writing value clears null
+      REQUIRE( table_.cell_get_variant_view( 20, 3u ).as_int() == 7 );
+
+      // ## add rows
+      uint64_t uRowAdd = typed_.row_add( 1000, 0.5, "added", 42 );
+      REQUIRE( uRowAdd == 300 );
+      REQUIRE( table_.get_row_count() == 301 );
+      REQUIRE( typed_.row_get( 300 ) == std::make_tuple( (int64_t)1000, 0.5, std::string_view( "added" ), 42 ) );
+      typed_.row_set( 0, -1, 2.0, "first", 1 );
+      REQUIRE( table_.cell_get_variant_view( 0, 2u ).as_string() == "first" );
+      REQUIRE( table_.cell_get_variant_view( 0, 0u ).as_int64() == -1 );
+   }
+}
+
+TEST_CASE( "[table] bind typed table to table with other columns", "[table]" ) {
+   auto table_ = make_typed_table_s( 0, 10 );
+
+   typed_table<double, rstring> typedPart;
+   REQUIRE( typedPart.bind( &table_, 1 ).first == true );
+   REQUIRE( typedPart.column_get_source( 0 ) == 1 );
+   REQUIRE( typedPart.get<1>( 4 ) == "city4" );
+
+   typed_table<int32_t, double> typedWrong;
+   auto result_ = typedWrong.bind( &table_ );
+   REQUIRE( result_.first == false );
+   REQUIRE( typedWrong.is_bound() == false );
+
+   typed_table<int32_t, int32_t> typedTooMany;
+   REQUIRE( typedTooMany.bind( &table_, 3 ).first == false );
+
+   dto::table tableNotPrepared;
+   tableNotPrepared.column_add( "int64", 0, "id" );
+   typed_table<int64_t> typedNotPrepared;
+   REQUIRE( typedNotPrepared.bind( &tableNotPrepared ).first == false );
+}
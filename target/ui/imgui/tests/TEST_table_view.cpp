@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_view.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with id, name, value and group, some values are null
+   dto::table make_view_table_s( unsigned uRowCount )
+   {
+      dto::table table_( 10u, dto::table::eTableFlagNull32 );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "int32", 0, "group" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "name" + std::to_string( u % 17 );
+         table_.row_add( { (int64_t)u, stringName, ( u % 23 ) * 0.5, (int)( u % 5 ) }, tag_convert{} );
+         if( u % 19 == 0 ) table_.cell_set_null( (uint64_t)u, 2u );
+      }
+      return table_;
+   }
+
+   /// compare values in view with values in table, returns description for first difference or empty string if equal
+   std::string compare_view_s( const table_view& view_, const dto::table& table_ )
+   {
+      if( view_.get_row_count() != table_.get_row_count() ) return "row count";
+      if( view_.get_column_count() != table_.get_column_count() ) return "column count";
+      for( uint64_t uRow = 0; uRow < view_.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < view_.get_column_count(); uColumn++ )
+         {
+            auto v1_ = view_.cell_get_variant_view( uRow, uColumn );
+            auto v2_ = table_.cell_get_variant_view( uRow, uColumn );
+            if( v1_.is_null() != v2_.is_null() || ( v1_.is_null() == false && v1_.as_string() != v2_.as_string() ) ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn );
+         }
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] view filter, sort and select without moving rows", "[table]" ) {
+   auto table_ = make_view_table_s( 1000 );
+   const auto vectorId = table_view( &table_ ).harvest<int64_t>( 0u );
+
+   table_view view_( &table_ );
+   REQUIRE( view_.is_row_selection() == false );
+   REQUIRE( compare_view_s( view_, table_ ) == "" );
+
+   // ## filter gives same rows as filter in table
+   auto viewFilter = view_.filter( 3u, eFilterEqual, { gd::variant_view( 2 ) } );
+   selection selection_;
+   table_.filter( 3u, eFilterEqual, { gd::variant_view( 2 ) }, selection_ );
+   REQUIRE( viewFilter.get_row() == selection_.to_rows() );
+   REQUIRE( viewFilter.get_row_count() == 200 );
+
+   // ## filter on filtered view, row index in view is mapped to row in table
+   auto viewFilter2 = viewFilter.filter( []( const table_view& v_, uint64_t uRow ) { return v_.cell_get_variant_view( uRow, 0u ).as_int64() < 500; } );
+   REQUIRE( viewFilter2.get_row_count() == 100 );
+   for( uint64_t uRow = 0; uRow < viewFilter2.get_row_count(); uRow++ )
+   {
+      REQUIRE( viewFilter2.cell_get_variant_view( uRow, 3u ).as_int64() == 2 );
+      REQUIRE( viewFilter2.cell_get_variant_view( uRow, 0u ).as_int64() == (int64_t)viewFilter2.row_get_source( uRow ) );
+   }
+
+   // ## sort view, nulls are placed first and equal values are ordered on id
+   auto viewSort = viewFilter.sort( { { 2, true }, { 0, true } } );
+   REQUIRE( viewSort.get_row_count() == viewFilter.get_row_count() );
+   for( uint64_t uRow = 1; uRow < viewSort.get_row_count(); uRow++ )
+   {
+      INFO( "row: " << uRow );
+      auto vPrevious = viewSort.cell_get_variant_view( uRow - 1, 2u );
+      auto vValue = viewSort.cell_get_variant_view( uRow, 2u );
+      if( vValue.is_null() == true ) { REQUIRE( vPrevious.is_null() == true ); continue; }
+      if( vPrevious.is_null() == true ) continue;
+      REQUIRE( vPrevious.as_double() <= vValue.as_double() );
+      if( vPrevious.as_double() == vValue.as_double() ) REQUIRE( viewSort.cell_get_variant_view( uRow - 1, 0u ).as_int64() < viewSort.cell_get_variant_view( uRow, 0u ).as_int64() );
+   }
+   REQUIRE( table_view( &table_ ).harvest<int64_t>( 0u ) == vectorId );     // rows in table are not moved
+
+   // ## select and range
+   auto viewSelect = viewSort.select( { "group", "id" } );
+   REQUIRE( viewSelect.get_column_count() == 2 );
+   REQUIRE( viewSelect.column_get_name( 0 ) == "group" );
+   REQUIRE( viewSelect.column_find_index( "name" ) == -1 );
+   REQUIRE( viewSelect.cell_get_variant_view( 7, "id" ).as_int64() == viewSort.cell_get_variant_view( 7, 0u ).as_int64() );
+
+   auto viewRange = viewSelect.range( 10, 5 );
+   REQUIRE( viewRange.get_row_count() == 5 );
+   REQUIRE( viewRange.row_get_source( 0 ) == viewSort.row_get_source( 10 ) );
+   REQUIRE( viewRange.harvest<int64_t>( "id" ).size() == 5 );
+}
+
+TEST_CASE( "[table] materialize view to table", "[table]" ) {
+   auto table_ = make_view_table_s( 500 );
+   auto view_ = table_view( &table_ ).filter( 1u, eFilterIn, { gd::variant_view( "name3" ), gd::variant_view( "name11" ) } ).select( { "value", "name" } );
+
+   dto::table tableResult = view_.materialize();
+   REQUIRE( tableResult.get_column_count() == 2 );
+   REQUIRE( tableResult.column_get_name( 0u ) == "value" );
+   REQUIRE( tableResult.column_get_name( 1u ) == "name" );
+   REQUIRE( compare_view_s( view_, tableResult ) == "" );
+
+   std::vector< std::vector<gd::variant_view> > vectorRowValue;
+   view_.harvest( vectorRowValue );
+   REQUIRE( vectorRowValue.size() == view_.get_row_count() );
+   uint64_t uRow = 0;
+   for( auto it = view_.begin(); it != view_.end(); it++, uRow++ )
+   {
+      REQUIRE( uRow < vectorRowValue.size() );
+      REQUIRE( view_.row_get_variant_view( uRow ).size() == 2 );
+   }
+   REQUIRE( uRow == view_.get_row_count() );
+
+   table_view viewEmpty = table_view( &table_ ).filter( 0u, eFilterLess, { gd::variant_view( (int64_t)0 ) } );
+   REQUIRE( viewEmpty.empty() == true );
+   REQUIRE( viewEmpty.materialize().get_row_count() == 0 );
+}
@@ -0,0 +1,193 @@
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_writer.h"
+#include "gd/gd_csv.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with number and text columns, every 7th row has null values and text has quotes, delimiters and line breaks
+   dto::table make_writer_table_s( unsigned uFlags, unsigned uRowCount )
+   {
+      dto::table table_( 64u, dto::table::eTableFlagNull32 | uFlags );
+      table_.column_add( "int64", 0, "id" );
+      table_.column_add( "int8", 0, "small", "small_alias" );
+      table_.column_add( "double", 0, "price" );
+      table_.column_add( "float", 0, "weight" );
+      table_.column_add( "uint32", 0, "count" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "string", 32, "code" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = u % 5 == 0 ? "q, \"x\"\n" + std::to_string( u % 13 ) : "n" + std::to_string( u % 29 );
+         std::string stringCode = "c" + std::to_string( u );
+         table_.row_add( { (int64_t)u - 100, (int)( u % 200 ) - 100, u * 0.25 - 3, (float)( u % 17 ) * 0.5f, u * 1000u, stringName, stringCode }, tag_convert{} );
+         if( u % 7 == 0 ) { table_.cell_set_null( (uint64_t)u, 2u ); table_.cell_set_null( (uint64_t)u, 5u ); }
+      }
+      return table_;
+   }
+
+   /// compare table with table read from csv, returns description for first difference. null text is read back as empty text
+   std::string compare_table_s( const dto::table& tableExpect, const dto::table& table_ )
+   {
+      if( table_.get_row_count() != tableExpect.get_row_count() ) return "row count " + std::to_string( table_.get_row_count() );
+      for( uint64_t uRow = 0; uRow < tableExpect.get_row_count(); uRow++ )
+      {
+         for( unsigned uColumn = 0; uColumn < tableExpect.get_column_count(); uColumn++ )
+         {
+            auto v1_ = tableExpect.cell_get_variant_view( uRow, uColumn );
+            auto v2_ = table_.cell_get_variant_view( uRow, uColumn );
+            if( v1_.is_null() == true && v2_.is_string() == true ) { if( v2_.as_string() != "" ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn ) + " is not empty"; continue; }
+            if( v1_.is_null() != v2_.is_null() || ( v1_.is_null() == false && v1_.as_string() != v2_.as_string() ) ) return "row " + std::to_string( uRow ) + ", column " + std::to_string( uColumn );
+         }
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] write table as csv", "[table]" ) {
+   dto::table table_( dto::table::eTableFlagNull32, { { "int32", 0, "id" }, { "double", 0, "value" }, { "rstring", 0, "name" } }, tag_prepare{} );
+   table_.row_add( { 1, 1.5, "a" }, tag_convert{} );
+   table_.row_add( { -2, 0.1, "say \"hi\"" }, tag_convert{} );
+   table_.row_add( { 3, 0.0, "x" }, tag_convert{} );
+   table_.cell_set_null( 2, 1u );
+   table_.cell_set_null( 2, 2u );
+
+   std::string stringCsv;
+   sink_string sinkString( stringCsv );
+   {
+      writer_csv writerCsv( &sinkString );
+      REQUIRE( writerCsv.write_header( table_ ) == true );
+      REQUIRE( writerCsv.write( table_ ) == true );
+   }                                                                          // writer flush in destructor
+   REQUIRE( stringCsv == "\"id\",\"value\",\"name\"\n1,1.5,\"a\"\n-2,0.1,\"say \"\"hi\"\"\"\n3,,\n" );
+
+   stringCsv.clear();
+   writer_csv writerSemicolon( &sinkString, ';' );
+   writerSemicolon.write( table_, 1, 1 );
+   writerSemicolon.flush();
+   REQUIRE( stringCsv == "-2;0.1;\"say \"\"hi\"\"\"\n" );
+   REQUIRE( writerSemicolon.get_written() == stringCsv.length() );
+}
+
+TEST_CASE( "[table] csv written in parts and read back", "[table]" ) {
+   std::string stringFile = ( std::filesystem::temp_directory_path() / "test_table_writer.csv" ).string();
+   const std::vector<unsigned> vectorFlags = { 0, dto::table::eTableFlagColumnar, dto::table::eTableFlagDictionary, dto::table::eTableFlagSegmented };
+   for( unsigned uFlags : vectorFlags )
+   {
+      INFO( "flags: " << uFlags );
+      auto table_ = make_writer_table_s( uFlags, 3000 );
+
+      // ## one write to string compared with writes in parts through small buffer
+      std::string stringAll;
+      sink_string sinkString( stringAll );
+      writer_csv writerAll( &sinkString );
+      writerAll.write_header( table_ );
+      writerAll.write( table_ );
+      writerAll.flush();
+
+      std::string stringPart;
+      uint64_t uBlockCount = 0;
+      sink_callback sinkCallback( [&]( std::string_view stringBlock ) { uBlockCount++; stringPart += stringBlock; return true; } );
+      writer_csv writerPart( &sinkCallback, ',', 100 );
+      writerPart.write_header( table_ );
+      for( uint64_t uRow = 0; uRow < table_.get_row_count(); uRow += 333 ) writerPart.write( table_, uRow, std::min<uint64_t>( 333, table_.get_row_count() - uRow ) );
+      writerPart.flush();
+      REQUIRE( stringPart == stringAll );
+      REQUIRE( uBlockCount > 1 );
+      REQUIRE( writerPart.get_written() == stringAll.length() );
+      REQUIRE( stringAll.substr( 0, stringAll.find( '\n' ) ) == "\"id\",\"small_alias\",\"price\",\"weight\",\"count\",\"name\",\"code\"" );
+
+      // ## file is read back to table with same values
+      {
+         sink_file sinkFile;
+         REQUIRE( sinkFile.open( stringFile ).first == true );
+         writer_csv writerFile( &sinkFile );
+         writerFile.write_header( table_ );
+         REQUIRE( writerFile.write( table_ ) == true );
+         REQUIRE( writerFile.flush() == true );
+      }
+      REQUIRE( std::filesystem::file_size( stringFile ) == stringAll.length() );
+
+      auto tableRead = make_writer_table_s( uFlags, 0 );
+      REQUIRE( gd::csv::read( tableRead, stringFile, gd::csv::options( ',', true ) ).first == true );
+      REQUIRE( compare_table_s( table_, tableRead ) == "" );
+   }
+   std::filesystem::remove( stringFile );
+}
+
+TEST_CASE( "[table] write table as json", "[table]" ) {
+   dto::table table_( dto::table::eTableFlagNull32, { { "int32", 0, "id" }, { "double", 0, "value" }, { "rstring", 0, "name" } }, tag_prepare{} );
+   table_.row_add( { 1, 1.5, "a\"b\\c\nd\te\x01" }, tag_convert{} );
+   table_.row_add( { 2, std::numeric_limits<double>::quiet_NaN(), "x" }, tag_convert{} );
+   table_.row_add( { 3, 0.0, "y" }, tag_convert{} );
+   table_.cell_set_null( 2, 1u );
+
+   std::string stringJson;
+   sink_string sinkString( stringJson );
+   writer_json writerArray( &sinkString );
+   writerArray.write( table_, 0, 2 );
+   writerArray.write( table_, 2, 1 );                                          // rows are added to same array
+   REQUIRE( writerArray.close() == true );
+   REQUIRE( stringJson == "[\n[1,1.5,\"a\\\"b\\\\c\\nd\\te\\u0001\"],\n[2,null,\"x\"],\n[3,null,\"y\"]\n]\n" );
+
+   stringJson.clear();
+   writer_json writerObject( &sinkString, tag_name{} );
+   writerObject.write( table_, 2, 1 );
+   writerObject.close();
+   REQUIRE( stringJson == "[\n{\"id\":3,\"value\":null,\"name\":\"y\"}\n]\n" );
+
+   stringJson.clear();
+   writer_json writerEmpty( &sinkString );
+   writerEmpty.close();
+   REQUIRE( stringJson == "[]\n" );
+
+   // ## nothing more is written after sink fails
+   uint64_t uCall = 0;
+   sink_callback sinkFail( [&uCall]( std::string_view ) { uCall++; return false; } );
+   auto tableLarge = make_writer_table_s( 0, 1000 );
+   writer_json writerFail( &sinkFail, 64 );
+   REQUIRE( writerFail.write( tableLarge ) == false );
+   REQUIRE( writerFail.is_ok() == false );
+   REQUIRE( uCall == 1 );
+   REQUIRE( writerFail.get_written() == 0 );
+}
+
+TEST_CASE( "[table] write date, uuid and wstring values as quoted text", "[table]" ) {
+   dto::table table_( 10u, dto::table::eTableFlagNull32 );
+   table_.column_add( (unsigned)gd::types::eTypeGuid, 0, "id" );
+   table_.column_add( (unsigned)gd::types::eTypeWString, 20, "wide" );
+   table_.column_add( (unsigned)gd::types::eTypeNumberDate, 0, "day" );
+   table_.prepare();
+
+   uint8_t puUuid[16];
+   for( unsigned u = 0; u < 16; u++ ) puUuid[u] = (uint8_t)( u * 17 );
+   double dDate = 45000.5;
+   table_.row_add( tag_null{} );
+   table_.cell_set( 0, 0u, gd::variant_view( gd::types::eTypeGuid, (void*)puUuid, 16 ) );
+   table_.cell_set( 0, 1u, gd::variant_view( (const wchar_t*)u"a\"b,c", 5 ) );  // wstring is stored as utf16
+   table_.cell_set( 0, 2u, gd::variant_view( (unsigned)gd::types::eTypeNumberDate, (void*)&dDate, sizeof( double ) ) );
+   table_.row_add( tag_null{} );                                               // null values are not quoted
+
+   std::string stringDate = table_.cell_get_variant_view( 0, 2u ).as_string();   // date is written as text from variant
+   std::string stringText;
+   sink_string sinkString( stringText );
+   {
+      writer_csv writerCsv( &sinkString );
+      REQUIRE( writerCsv.write( table_ ) == true );
+   }
+   REQUIRE( stringText == "\"00112233445566778899AABBCCDDEEFF\",\"a\"\"b,c\",\"" + stringDate + "\"\n,,\n" );
+
+   stringText.clear();
+   writer_json writerJson( &sinkString, tag_name{} );
+   writerJson.write( table_ );
+   REQUIRE( writerJson.close() == true );
+   REQUIRE( stringText == "[\n{\"id\":\"00112233445566778899AABBCCDDEEFF\",\"wide\":\"a\\\"b,c\",\"day\":\"" + stringDate + "\"},\n{\"id\":null,\"wide\":null,\"day\":null}\n]\n" );
+}
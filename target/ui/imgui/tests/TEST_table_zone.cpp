@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gd/gd_table_column-buffer.h"
+#include "gd/gd_table_index.h"
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace gd::table;
+
+namespace {
+   /// table with increasing time, value, name and category, some values are null
+   void make_zone_table_s( dto::table& table_, unsigned uRowCount )
+   {
+      table_.column_add( "int64", 0, "time" );
+      table_.column_add( "double", 0, "value" );
+      table_.column_add( "rstring", 0, "name" );
+      table_.column_add( "int32", 0, "category" );
+      table_.prepare();
+      for( unsigned u = 0; u < uRowCount; u++ )
+      {
+         std::string stringName = "n" + std::to_string( ( u / 100 ) % 20 );
+         table_.row_add( { (int64_t)u * 10, ( u % 1000 ) * 0.5 - 100.0, stringName, (int)( u / 500 ) }, tag_convert{} );
+         if( u % 97 == 0 ) table_.cell_set_null( (uint64_t)u, 1u );
+      }
+   }
+
+   /// compare filter result for table with zone map and table without, returns description for first difference
+   std::string compare_zone_s( const dto::table& tableZone, const dto::table& table_ )
+   {
+      struct filter_ { unsigned m_uColumn; enumFilter m_eFilter; std::vector<gd::variant_view> m_vectorValue; };
+      const std::vector<filter_> vectorFilter = {
+         { 0, eFilterBetween, { gd::variant_view( (int64_t)12000 ), gd::variant_view( (int64_t)15000 ) } },
+         { 0, eFilterLess, { gd::variant_view( (int64_t)640 ) } },
+         { 0, eFilterGreaterEqual, { gd::variant_view( (int64_t)49000 ) } },
+         { 0, eFilterEqual, { gd::variant_view( (int64_t)33330 ) } },
+         { 1, eFilterGreater, { gd::variant_view( 390.0 ) } },
+         { 1, eFilterNull, {} },
+         { 1, eFilterNotNull, {} },
+         { 2, eFilterEqual, { gd::variant_view( "n7" ) } },
+         { 2, eFilterIn, { gd::variant_view( "n3" ), gd::variant_view( "n19" ) } },
+         { 3, eFilterNotEqual, { gd::variant_view( 4 ) } },
+         { 3, eFilterIn, { gd::variant_view( 2 ), gd::variant_view( 9 ) } },
+      };
+
+      for( std::size_t u = 0; u < vectorFilter.size(); u++ )
+      {
+         const auto& f_ = vectorFilter[u];
+         selection selection1, selection2;
+         tableZone.filter( f_.m_uColumn, f_.m_eFilter, f_.m_vectorValue, selection1 );
+         table_.filter( f_.m_uColumn, f_.m_eFilter, f_.m_vectorValue, selection2 );
+         if( selection1.to_rows() != selection2.to_rows() ) return "filter " + std::to_string( u );
+      }
+
+      for( int64_t iFind : { (int64_t)0, (int64_t)5550, (int64_t)42420, (int64_t)5555 } )
+      {
+         if( tableZone.find( 0u, gd::variant_view( iFind ) ) != table_.find( 0u, gd::variant_view( iFind ) ) ) return "find " + std::to_string( iFind );
+      }
+      return std::string();
+   }
+}
+
+TEST_CASE( "[table] zone map gives same result as table scan", "[table]" ) {
+   dto::table tableZone( 64u, dto::table::eTableFlagNull32 ), table_( 64u, dto::table::eTableFlagNull32 );
+   make_zone_table_s( tableZone, 5000 );
+   make_zone_table_s( table_, 5000 );
+   auto* pzone = tableZone.index_add( { 0, 1, 2, 3 }, 64, tag_index_zone{} );
+   REQUIRE( pzone->get_block_rows() == 64 );
+   REQUIRE( compare_zone_s( tableZone, table_ ) == "" );
+
+   for( auto* ptable : { &tableZone, &table_ } )
+   {
+      for( int i = 0; i < 300; i++ ) ptable->row_add( { (int64_t)50000 + i, 1.5, "n3", 99 }, tag_convert{} );
+      ptable->cell_set( 10, 0u, gd::variant_view( (int64_t)13000 ), tag_convert{} );
+      ptable->cell_set( 3000, 1u, gd::variant_view( 1000.0 ), tag_convert{} );
+      ptable->cell_set_null( 2000, 3u );
+   }
+   REQUIRE( compare_zone_s( tableZone, table_ ) == "" );
+
+   for( auto* ptable : { &tableZone, &table_ } ) ptable->erase( 100, 1000 );
+   REQUIRE( compare_zone_s( tableZone, table_ ) == "" );
+
+   for( auto* ptable : { &tableZone, &table_ } ) ptable->sort( { { 1, false } }, tag_sort_typed{} );
+   REQUIRE( compare_zone_s( tableZone, table_ ) == "" );
+}
+
+TEST_CASE( "[table] zone map statistics for blocks", "[table]" ) {
+   dto::table table_( 64u, dto::table::eTableFlagNull32 );
+   make_zone_table_s( table_, 1000 );
+   auto* pzone = table_.index_add( { 0, 1 }, 128, tag_index_zone{} );
+   pzone->update();
+   REQUIRE( pzone->get_block_count() == 8 );
+   REQUIRE( pzone->find_key( 1 ) == 1 );
+   REQUIRE( pzone->find_key( 2 ) == -1 );
+
+   for( uint64_t uBlock = 0; uBlock < pzone->get_block_count(); uBlock++ )
+   {
+      INFO( "block: " << uBlock );
+      uint64_t uFirst = uBlock * 128, uEnd = std::min<uint64_t>( uFirst + 128, 1000 );
+      REQUIRE( pzone->get_block_row_count( uBlock ) == uEnd - uFirst );
+      REQUIRE( pzone->get( uBlock, 0 ).m_min.i == (int64_t)uFirst * 10 );
+      REQUIRE( pzone->get( uBlock, 0 ).m_max.i == (int64_t)( uEnd - 1 ) * 10 );
+
+      uint32_t uNullCount = 0;
+      for( uint64_t uRow = uFirst; uRow < uEnd; uRow++ ) { if( uRow % 97 == 0 ) uNullCount++; }
+      REQUIRE( pzone->get( uBlock, 1 ).m_uNullCount == uNullCount );
+      REQUIRE( pzone->match( uBlock, 0, eFilterLess, gd::variant_view( (int64_t)uFirst * 10 ), gd::variant_view() ) == index_zone::eMatchNone );
+      REQUIRE( pzone->match( uBlock, 0, eFilterGreaterEqual, gd::variant_view( (int64_t)uFirst * 10 ), gd::variant_view() ) == index_zone::eMatchAll );
+   }
+}
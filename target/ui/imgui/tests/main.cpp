@@ -0,0 +1,13 @@
+#include "catch2/catch_amalgamated.hpp"
+
+/*----------------------------------------------------------------------------- 
+ * start method for console test application
+ * \param iArgumentCount number of arguments
+ * \param ppbszArgumentValue argument values
+ * \return int return 0 if no error, otherwise non zero value
+ */
+int main(int iArgumentCount, char* ppbszArgumentValue[])
+{
+	int iResult = Catch::Session().run(iArgumentCount, ppbszArgumentValue);
+	return iResult;
+}